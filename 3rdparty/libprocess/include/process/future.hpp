@@ -66,6 +66,206 @@ struct wrap;
 template <typename T>
 struct unwrap;
 
+
+// Storage for the callbacks registered on a future. The vast majority
+// of futures only ever have a single callback of each kind (e.g., the
+// `onAny` installed by `then`), so we keep the first callback inline
+// and only fall back to a heap allocated vector for any additional
+// callbacks. This saves an allocation per callback kind per future.
+template <typename C>
+class CallbackList
+{
+public:
+  bool empty() const
+  {
+    return first.isNone();
+  }
+
+  void emplace_back(C&& callback)
+  {
+    if (first.isNone()) {
+      first = std::move(callback);
+    } else {
+      rest.emplace_back(std::move(callback));
+    }
+  }
+
+  void clear()
+  {
+    first = None();
+    rest.clear();
+  }
+
+  void swap(CallbackList<C>& that)
+  {
+    std::swap(first, that.first);
+    rest.swap(that.rest);
+  }
+
+  // Invokes (and consumes) all callbacks in the order that they were
+  // added. See `internal::run` below.
+  template <typename... Arguments>
+  void run(Arguments&&... arguments)
+  {
+    if (first.isSome()) {
+      std::move(first.get())(std::forward<Arguments>(arguments)...);
+
+      for (size_t i = 0; i < rest.size(); ++i) {
+        std::move(rest[i])(std::forward<Arguments>(arguments)...);
+      }
+    }
+  }
+
+private:
+  Option<C> first;
+  std::vector<C> rest;
+};
+
+
+// A per-thread cache of fixed size memory blocks. Blocks that get
+// deallocated are kept in the cache of the deallocating thread (which
+// need not be the allocating thread) so that they can be reused by the
+// next allocation of the same size without going through the global
+// allocator. The cache is bounded so that a thread that only ever
+// frees memory (e.g., a thread that satisfies promises created
+// elsewhere) does not accumulate an unbounded number of blocks.
+template <size_t Size>
+class BlockCache
+{
+public:
+  static void* allocate()
+  {
+    if (destroyed()) {
+      return ::operator new(Size);
+    }
+
+    Cache& cache = local();
+
+    if (cache.head != nullptr) {
+      Block* block = cache.head;
+      cache.head = block->next;
+      --cache.size;
+      return block;
+    }
+
+    return ::operator new(Size);
+  }
+
+  static void deallocate(void* pointer)
+  {
+    if (destroyed()) {
+      ::operator delete(pointer);
+      return;
+    }
+
+    Cache& cache = local();
+
+    if (cache.size < CAPACITY) {
+      Block* block = static_cast<Block*>(pointer);
+      block->next = cache.head;
+      cache.head = block;
+      ++cache.size;
+      return;
+    }
+
+    ::operator delete(pointer);
+  }
+
+private:
+  static constexpr size_t CAPACITY = 1024;
+
+  struct Block
+  {
+    Block* next;
+  };
+
+  static_assert(
+      Size >= sizeof(Block),
+      "Blocks must be large enough to be linked into the cache");
+
+  struct Cache
+  {
+    ~Cache()
+    {
+      while (head != nullptr) {
+        Block* block = head;
+        head = block->next;
+        ::operator delete(block);
+      }
+
+      destroyed() = true;
+    }
+
+    Block* head = nullptr;
+    size_t size = 0;
+  };
+
+  static Cache& local()
+  {
+    static thread_local Cache cache;
+    return cache;
+  }
+
+  // Whether the cache of this thread has been destroyed. Futures can
+  // be deallocated during thread (or static) teardown after the cache,
+  // in which case they must not touch it but go straight to the global
+  // allocator. The flag has no destructor so it remains valid for the
+  // whole lifetime of the thread.
+  static bool& destroyed()
+  {
+    static thread_local bool destroyed = false;
+    return destroyed;
+  }
+};
+
+
+// An allocator for the shared state of futures that uses the
+// per-thread `BlockCache` for single object allocations. This is used
+// with `std::allocate_shared` so that the state and the reference
+// counts of a future are stored in a single, recycled, block of memory.
+template <typename T>
+struct PooledAllocator
+{
+  typedef T value_type;
+
+  PooledAllocator() = default;
+
+  template <typename U>
+  PooledAllocator(const PooledAllocator<U>&) {}
+
+  T* allocate(size_t n)
+  {
+    if (n == 1) {
+      return static_cast<T*>(BlockCache<sizeof(T)>::allocate());
+    }
+
+    return static_cast<T*>(::operator new(n * sizeof(T)));
+  }
+
+  void deallocate(T* pointer, size_t n)
+  {
+    if (n == 1) {
+      BlockCache<sizeof(T)>::deallocate(pointer);
+    } else {
+      ::operator delete(pointer);
+    }
+  }
+};
+
+
+template <typename T, typename U>
+bool operator==(const PooledAllocator<T>&, const PooledAllocator<U>&)
+{
+  return true;
+}
+
+
+template <typename T, typename U>
+bool operator!=(const PooledAllocator<T>&, const PooledAllocator<U>&)
+{
+  return false;
+}
+
 } // namespace internal {
 
 
@@ -547,14 +747,18 @@ private:
     //   3. Error, the state is FAILED; 'error()' stores the message.
     Result<T> result;
 
-    std::vector<AbandonedCallback> onAbandonedCallbacks;
-    std::vector<DiscardCallback> onDiscardCallbacks;
-    std::vector<ReadyCallback> onReadyCallbacks;
-    std::vector<FailedCallback> onFailedCallbacks;
-    std::vector<DiscardedCallback> onDiscardedCallbacks;
-    std::vector<AnyCallback> onAnyCallbacks;
+    internal::CallbackList<AbandonedCallback> onAbandonedCallbacks;
+    internal::CallbackList<DiscardCallback> onDiscardCallbacks;
+    internal::CallbackList<ReadyCallback> onReadyCallbacks;
+    internal::CallbackList<FailedCallback> onFailedCallbacks;
+    internal::CallbackList<DiscardedCallback> onDiscardedCallbacks;
+    internal::CallbackList<AnyCallback> onAnyCallbacks;
   };
 
+  // Allocates the shared state for a new future from the per-thread
+  // pool, see `internal::PooledAllocator`.
+  static std::shared_ptr<Data> allocate();
+
   // Abandons this future. Returns false if the future is already
   // associated or no longer pending. Otherwise returns true and any
   // Future::onAbandoned callbacks wil be run.
@@ -618,11 +822,9 @@ namespace internal {
 //
 // TODO(*): Invoke callbacks in another execution context.
 template <typename C, typename... Arguments>
-void run(std::vector<C>&& callbacks, Arguments&&... arguments)
+void run(CallbackList<C>&& callbacks, Arguments&&... arguments)
 {
-  for (size_t i = 0; i < callbacks.size(); ++i) {
-    std::move(callbacks[i])(std::forward<Arguments>(arguments)...);
-  }
+  callbacks.run(std::forward<Arguments>(arguments)...);
 }
 
 } // namespace internal {
@@ -1036,6 +1238,13 @@ Future<T> Future<T>::failed(const std::string& message)
 }
 
 
+template <typename T>
+std::shared_ptr<typename Future<T>::Data> Future<T>::allocate()
+{
+  return std::allocate_shared<Data>(internal::PooledAllocator<Data>());
+}
+
+
 template <typename T>
 Future<T>::Data::Data()
   : state(PENDING),
@@ -1059,7 +1268,7 @@ void Future<T>::Data::clearAllCallbacks()
 
 template <typename T>
 Future<T>::Future()
-  : data(new Data())
+  : data(allocate())
 {
   data->abandoned = true;
 }
@@ -1067,7 +1276,7 @@ Future<T>::Future()
 
 template <typename T>
 Future<T>::Future(const T& _t)
-  : data(new Data())
+  : data(allocate())
 {
   set(_t);
 }
@@ -1075,7 +1284,7 @@ Future<T>::Future(const T& _t)
 
 template <typename T>
 Future<T>::Future(T&& _t)
-  : data(new Data())
+  : data(allocate())
 {
   set(std::move(_t));
 }
@@ -1084,7 +1293,7 @@ Future<T>::Future(T&& _t)
 template <typename T>
 template <typename U>
 Future<T>::Future(const U& u)
-  : data(new Data())
+  : data(allocate())
 {
   set(u);
 }
@@ -1092,7 +1301,7 @@ Future<T>::Future(const U& u)
 
 template <typename T>
 Future<T>::Future(const Failure& failure)
-  : data(new Data())
+  : data(allocate())
 {
   fail(failure.message);
 }
@@ -1100,7 +1309,7 @@ Future<T>::Future(const Failure& failure)
 
 template <typename T>
 Future<T>::Future(const ErrnoFailure& failure)
-  : data(new Data())
+  : data(allocate())
 {
   fail(failure.message);
 }
@@ -1109,7 +1318,7 @@ Future<T>::Future(const ErrnoFailure& failure)
 template <typename T>
 template <typename E>
 Future<T>::Future(const Try<T, E>& t)
-  : data(new Data())
+  : data(allocate())
 {
   if (t.isSome()){
     set(t.get());
@@ -1123,7 +1332,7 @@ Future<T>::Future(const Try<T, E>& t)
 template <typename T>
 template <typename E>
 Future<T>::Future(const Try<Future<T>, E>& t)
-  : data(t.isSome() ? t->data : std::shared_ptr<Data>(new Data()))
+  : data(t.isSome() ? t->data : allocate())
 {
   if (!t.isSome()) {
     // TODO(chhsiao): Consider preserving the error type. See MESOS-8925.
@@ -1158,7 +1367,7 @@ bool Future<T>::discard()
 {
   bool result = false;
 
-  std::vector<DiscardCallback> callbacks;
+  internal::CallbackList<DiscardCallback> callbacks;
   synchronized (data->lock) {
     if (!data->discard && data->state == PENDING) {
       result = data->discard = true;
@@ -1183,7 +1392,7 @@ bool Future<T>::abandon(bool propagating)
 {
   bool result = false;
 
-  std::vector<AbandonedCallback> callbacks;
+  internal::CallbackList<AbandonedCallback> callbacks;
   synchronized (data->lock) {
     if (!data->abandoned &&
         data->state == PENDING &&
@@ -1278,7 +1487,8 @@ bool Future<T>::await(const Duration& duration) const
   synchronized (data->lock) {
     if (data->state == PENDING) {
       pending = true;
-      data->onAnyCallbacks.push_back(lambda::bind(&internal::awaited, latch));
+      data->onAnyCallbacks.emplace_back(
+          lambda::bind(&internal::awaited, latch));
     }
   }
 
@@ -1575,6 +1785,16 @@ template <typename T>
 template <typename X>
 Future<X> Future<T>::then(lambda::CallableOnce<Future<X>(const T&)> f) const
 {
+  // Fast path: if this future has already been satisfied there is
+  // nothing to wait for, so rather than allocating a promise and
+  // installing callbacks we can invoke `f` directly. Note that the
+  // state of a future never changes once it is no longer pending.
+  if (isReady() && !hasDiscard()) {
+    return std::move(f)(data->result.get());
+  } else if (isFailed()) {
+    return Future<X>::failed(failure());
+  }
+
   std::unique_ptr<Promise<X>> promise(new Promise<X>());
   Future<X> future = promise->future();
 
@@ -1599,6 +1819,13 @@ template <typename T>
 template <typename X>
 Future<X> Future<T>::then(lambda::CallableOnce<X(const T&)> f) const
 {
+  // Fast path: see the comment in the overload above.
+  if (isReady() && !hasDiscard()) {
+    return Future<X>(std::move(f)(data->result.get()));
+  } else if (isFailed()) {
+    return Future<X>::failed(failure());
+  }
+
   std::unique_ptr<Promise<X>> promise(new Promise<X>());
   Future<X> future = promise->future();
 
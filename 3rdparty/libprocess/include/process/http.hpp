@@ -634,7 +634,8 @@ struct Response
   // already specified.
   //
   // PATH: Attempts to perform a 'sendfile' operation on the file
-  // found at 'path'.
+  // found at 'path'. If a 'range' is set, only that part of the file
+  // is sent.
   //
   // PIPE: Splices data from the Pipe 'reader' using a "chunked"
   // 'Transfer-Encoding'. The writer uses a Pipe::Writer to
@@ -654,8 +655,17 @@ struct Response
     PIPE
   } type;
 
+  // The part of the file at 'path' to send. The range is truncated
+  // to the size of the file at the time it is sent.
+  struct Range
+  {
+    size_t offset;
+    size_t length;
+  };
+
   std::string body;
   std::string path;
+  Option<Range> range;
   Option<Pipe::Reader> reader;
 
   uint16_t code;
@@ -988,6 +998,8 @@ private:
   friend Future<Connection> connect(
       const network::Address& address, Scheme scheme);
   friend Future<Connection> connect(const URL&);
+  friend Future<Connection> connect(
+      const network::Socket& socket, const network::Address& address);
 
   // Forward declaration.
   struct Data;
@@ -1002,6 +1014,16 @@ Future<Connection> connect(const network::Address& address, Scheme scheme);
 Future<Connection> connect(const URL& url);
 
 
+/**
+ * Connects the given socket, which must not be connected yet, to the
+ * address. This allows for connecting with a socket which was created
+ * elsewhere, e.g., in the network namespace of another process.
+ */
+Future<Connection> connect(
+    const network::Socket& socket,
+    const network::Address& address);
+
+
 namespace internal {
 
 Future<Nothing> serve(
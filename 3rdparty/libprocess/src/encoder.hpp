@@ -233,14 +233,19 @@ public:
 class FileEncoder : public Encoder
 {
 public:
-  FileEncoder(int_fd _fd, size_t _size)
-    : fd(_fd), size(static_cast<off_t>(_size)), index(0)
+  // Sends `_size` bytes of the file starting at `_offset`.
+  FileEncoder(int_fd _fd, size_t _size, size_t _offset = 0)
+    : fd(_fd),
+      start(static_cast<off_t>(_offset)),
+      end(static_cast<off_t>(_offset + _size)),
+      index(start)
   {
     // NOTE: For files, we expect the size to be derived from `stat`-ing
     // the file.  The `struct stat` returns the size in `off_t` form,
     // meaning that it is a programmer error to construct the `FileEncoder`
     // with a size greater the max value of `off_t`.
-    CHECK_LE(_size, static_cast<size_t>(std::numeric_limits<off_t>::max()));
+    CHECK_LE(_offset + _size,
+             static_cast<size_t>(std::numeric_limits<off_t>::max()));
   }
 
   ~FileEncoder() override
@@ -256,27 +261,28 @@ public:
   virtual int_fd next(off_t* offset, size_t* length)
   {
     off_t temp = index;
-    index = size;
+    index = end;
     *offset = temp;
-    *length = size - temp;
+    *length = end - temp;
     return fd;
   }
 
   void backup(size_t length) override
   {
-    if (index >= static_cast<off_t>(length)) {
+    if (index - start >= static_cast<off_t>(length)) {
       index -= static_cast<off_t>(length);
     }
   }
 
   size_t remaining() const override
   {
-    return static_cast<size_t>(size - index);
+    return static_cast<size_t>(end - index);
   }
 
 private:
   int_fd fd;
-  off_t size;
+  const off_t start;
+  const off_t end;
   off_t index;
 };
 
@@ -1446,15 +1446,26 @@ Future<Connection> connect(const network::Address& address, Scheme scheme)
     return Failure("Failed to create socket: " + socket.error());
   }
 
-  return socket->connect(address)
+  return connect(socket.get(), address);
+}
+
+
+Future<Connection> connect(
+    const network::Socket& socket,
+    const network::Address& address)
+{
+  // NOTE: `Socket` is a handle, hence the copy refers to the same socket.
+  network::Socket _socket = socket;
+
+  return _socket.connect(address)
     .then([socket, address]() -> Future<Connection> {
-      Try<network::Address> localAddress = socket->address();
+      Try<network::Address> localAddress = socket.address();
       if (localAddress.isError()) {
         return Failure("Failed to get socket's local address: " +
             localAddress.error());
       }
 
-      return Connection(socket.get(), localAddress.get(), address);
+      return Connection(socket, localAddress.get(), address);
     });
 }
 
@@ -1598,9 +1609,17 @@ Future<Nothing> sendfile(
     return send(socket, InternalServerError(body), request);
   }
 
+  size_t offset = 0;
+  size_t length = static_cast<size_t>(size->bytes());
+
+  if (response.range.isSome()) {
+    offset = std::min(response.range->offset, length);
+    length = std::min(response.range->length, length - offset);
+  }
+
   // While the user is expected to properly set a 'Content-Type'
   // header, we'll fill in (or overwrite) 'Content-Length' header.
-  response.headers["Content-Length"] = stringify(size->bytes());
+  response.headers["Content-Length"] = stringify(length);
 
   // TODO(benh): If this is a TCP socket consider turning on TCP_CORK
   // for both sends and then turning it off.
@@ -1617,7 +1636,7 @@ Future<Nothing> sendfile(
     })
     .then([=]() mutable -> Future<Nothing> {
       // NOTE: the file descriptor gets closed by FileEncoder.
-      Encoder* encoder = new FileEncoder(fd.get(), size->bytes());
+      Encoder* encoder = new FileEncoder(fd.get(), length, offset);
       return send(socket, encoder)
         .onAny([=]() {
           delete encoder;
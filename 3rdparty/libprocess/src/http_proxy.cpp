@@ -10,6 +10,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License
 
+#include <algorithm>
+
 #include <process/id.hpp>
 #include <process/defer.hpp>
 
@@ -174,17 +176,26 @@ bool HttpProxy::process(const Future<Response>& future, const Request& request)
         VLOG(1) << "Returning '404 Not Found' for directory '" << path << "'";
         socket_manager->send(NotFound(), request, socket);
       } else {
+        size_t offset = 0;
+        size_t length = static_cast<size_t>(size->bytes());
+
+        if (response.range.isSome()) {
+          offset = std::min(response.range->offset, length);
+          length = std::min(response.range->length, length - offset);
+        }
+
         // While the user is expected to properly set a 'Content-Type'
         // header, we fill in (or overwrite) 'Content-Length' header.
-        response.headers["Content-Length"] = stringify(size->bytes());
+        response.headers["Content-Length"] = stringify(length);
 
-        if (size.get() == 0) {
+        if (length == 0) {
+          os::close(fd.get());
           socket_manager->send(response, request, socket);
           return true; // All done, can process next request.
         }
 
         VLOG(1) << "Sending file at '" << path << "' with length "
-                << size.get();
+                << Bytes(length) << " from offset " << offset;
 
         // TODO(benh): Consider a way to have the socket manager turn
         // on TCP_CORK for both sends and then turn it off.
@@ -195,7 +206,7 @@ bool HttpProxy::process(const Future<Response>& future, const Request& request)
 
         // Note the file descriptor gets closed by FileEncoder.
         socket_manager->send(
-            new FileEncoder(fd.get(), size->bytes()),
+            new FileEncoder(fd.get(), length, offset),
             request.keepAlive,
             socket);
       }
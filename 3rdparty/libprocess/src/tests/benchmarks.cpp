@@ -18,9 +18,13 @@
 
 #include <gmock/gmock.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
 #include <deque>
 #include <iostream>
 #include <memory>
+#include <new>
 #include <string>
 #include <thread>
 #include <vector>
@@ -66,6 +70,213 @@ using std::vector;
 
 using testing::WithParamInterface;
 
+// The number of allocations made via the global `operator new` by any
+// thread, so that the benchmarks can report allocations as well as time.
+//
+// NOTE: All the replaceable allocation and deallocation functions are
+// replaced, so that memory is always released by the function matching
+// the one it was allocated with.
+static std::atomic<uint64_t> allocations(0);
+
+
+// Returns `nullptr` on failure.
+static void* allocate(size_t size)
+{
+  allocations.fetch_add(1, std::memory_order_relaxed);
+
+  // NOTE: `malloc(0)` may return `nullptr`, which is not a valid
+  // result of `operator new`.
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+
+void* operator new(size_t size)
+{
+  void* pointer = allocate(size);
+  if (pointer == nullptr) {
+    throw std::bad_alloc();
+  }
+
+  return pointer;
+}
+
+
+void* operator new[](size_t size)
+{
+  return operator new(size);
+}
+
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+  return allocate(size);
+}
+
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+  return allocate(size);
+}
+
+
+void operator delete(void* pointer) noexcept
+{
+  std::free(pointer);
+}
+
+
+void operator delete[](void* pointer) noexcept
+{
+  std::free(pointer);
+}
+
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+  std::free(pointer);
+}
+
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+  std::free(pointer);
+}
+
+
+#ifdef __cpp_sized_deallocation
+void operator delete(void* pointer, size_t) noexcept
+{
+  std::free(pointer);
+}
+
+
+void operator delete[](void* pointer, size_t) noexcept
+{
+  std::free(pointer);
+}
+#endif // __cpp_sized_deallocation
+
+
+#ifdef __cpp_aligned_new
+// Returns `nullptr` on failure.
+static void* allocate(size_t size, std::align_val_t alignment)
+{
+  allocations.fetch_add(1, std::memory_order_relaxed);
+
+  if (size == 0) {
+    size = 1;
+  }
+
+#ifdef __WINDOWS__
+  return ::_aligned_malloc(size, static_cast<size_t>(alignment));
+#else
+  void* pointer = nullptr;
+  if (::posix_memalign(
+          &pointer,
+          std::max(static_cast<size_t>(alignment), sizeof(void*)),
+          size) != 0) {
+    return nullptr;
+  }
+
+  return pointer;
+#endif // __WINDOWS__
+}
+
+
+static void deallocate(void* pointer, std::align_val_t)
+{
+#ifdef __WINDOWS__
+  ::_aligned_free(pointer);
+#else
+  std::free(pointer);
+#endif // __WINDOWS__
+}
+
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+  void* pointer = allocate(size, alignment);
+  if (pointer == nullptr) {
+    throw std::bad_alloc();
+  }
+
+  return pointer;
+}
+
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+  return operator new(size, alignment);
+}
+
+
+void* operator new(
+    size_t size,
+    std::align_val_t alignment,
+    const std::nothrow_t&) noexcept
+{
+  return allocate(size, alignment);
+}
+
+
+void* operator new[](
+    size_t size,
+    std::align_val_t alignment,
+    const std::nothrow_t&) noexcept
+{
+  return allocate(size, alignment);
+}
+
+
+void operator delete(void* pointer, std::align_val_t alignment) noexcept
+{
+  deallocate(pointer, alignment);
+}
+
+
+void operator delete[](void* pointer, std::align_val_t alignment) noexcept
+{
+  deallocate(pointer, alignment);
+}
+
+
+void operator delete(
+    void* pointer,
+    size_t,
+    std::align_val_t alignment) noexcept
+{
+  deallocate(pointer, alignment);
+}
+
+
+void operator delete[](
+    void* pointer,
+    size_t,
+    std::align_val_t alignment) noexcept
+{
+  deallocate(pointer, alignment);
+}
+
+
+void operator delete(
+    void* pointer,
+    std::align_val_t alignment,
+    const std::nothrow_t&) noexcept
+{
+  deallocate(pointer, alignment);
+}
+
+
+void operator delete[](
+    void* pointer,
+    std::align_val_t alignment,
+    const std::nothrow_t&) noexcept
+{
+  deallocate(pointer, alignment);
+}
+#endif // __cpp_aligned_new
+
+
 int main(int argc, char** argv)
 {
   // Initialize Google Mock/Test.
@@ -603,6 +814,141 @@ TEST(ProcessTest, Process_BENCHMARK_DispatchDefer)
 }
 
 
+// An asynchronous "ladder" of `.then(defer(...))` continuations. Each
+// step awaits a dispatch back into the process so every step is
+// asynchronous.
+class ContinuationProcess : public Process<ContinuationProcess>
+{
+public:
+  // Each step allocates a promise for the `then` as well as the
+  // deferred continuation (and its dispatch).
+  Future<Nothing> deferred(Promise<Nothing>* promise, long remaining)
+  {
+    if (remaining == 0) {
+      promise->set(Nothing());
+      return Nothing();
+    }
+
+    dispatch(self(), &Self::step)
+      .then(defer(self(), &Self::deferred, promise, remaining - 1));
+
+    return Nothing();
+  }
+
+private:
+  Future<Nothing> step()
+  {
+    return Nothing();
+  }
+};
+
+
+TEST(ProcessTest, Process_BENCHMARK_ContinuationLadder)
+{
+  constexpr long repeats = 100000;
+
+  ContinuationProcess process;
+  spawn(process);
+
+  // NOTE: The allocations are counted across all threads, so they
+  // include any allocations of libprocess made meanwhile.
+  {
+    Promise<Nothing> promise;
+
+    Stopwatch watch;
+    watch.start();
+
+    const uint64_t allocated = allocations.load();
+
+    dispatch(process, &ContinuationProcess::deferred, &promise, repeats);
+
+    AWAIT_READY(promise.future());
+
+    const uint64_t count = allocations.load() - allocated;
+
+    cout << "then(defer(...)) ladder of " << repeats << " steps elapsed: "
+         << watch.elapsed() << " with "
+         << static_cast<double>(count) / repeats
+         << " allocations per step" << endl;
+  }
+
+  terminate(process);
+  wait(process);
+}
+
+
+// Measures the cost of building (and then satisfying) long chains of
+// `Future::then` continuations. This exercises the allocation of the
+// shared state of futures, the callback storage, and the fast path
+// taken when `then` is called on a future that is already satisfied.
+TEST(ProcessTest, Process_BENCHMARK_FutureChaining)
+{
+  constexpr long repeats = 1000000;
+
+  // Install a continuation on a pending future and then satisfy it.
+  // NOTE: We don't build a single long pending chain here since
+  // setting the head of the chain would run every continuation
+  // recursively on the stack.
+  {
+    long count = 0;
+
+    Stopwatch watch;
+    watch.start();
+
+    for (long i = 0; i < repeats; i++) {
+      Promise<int> promise;
+
+      promise.future()
+        .then([](int value) { return value + 1; })
+        .onReady([&count](int) { count++; });
+
+      promise.set(0);
+    }
+
+    EXPECT_EQ(repeats, count);
+
+    cout << "Pending continuations of " << repeats << " futures elapsed: "
+         << watch.elapsed() << endl;
+  }
+
+  // Chain continuations on a future that is already satisfied so
+  // that each continuation gets run immediately.
+  {
+    Future<int> future = 0;
+
+    Stopwatch watch;
+    watch.start();
+
+    for (long i = 0; i < repeats; i++) {
+      future = future.then([](int value) { return value + 1; });
+    }
+
+    AWAIT_EXPECT_EQ(repeats, future);
+
+    cout << "Ready chain of " << repeats << " continuations elapsed: "
+         << watch.elapsed() << endl;
+  }
+
+  // Chain continuations returning futures, i.e., the shape of most
+  // asynchronous code in Mesos.
+  {
+    Future<int> future = 0;
+
+    Stopwatch watch;
+    watch.start();
+
+    for (long i = 0; i < repeats; i++) {
+      future = future.then([](int value) -> Future<int> { return value + 1; });
+    }
+
+    AWAIT_EXPECT_EQ(repeats, future);
+
+    cout << "Ready chain of " << repeats << " future continuations elapsed: "
+         << watch.elapsed() << endl;
+  }
+}
+
+
 class ProtobufInstallHandlerBenchmarkProcess
   : public ProtobufProcess<ProtobufInstallHandlerBenchmarkProcess>
 {
@@ -1060,6 +1060,45 @@ TEST(HTTPConnectionTest, GzipRequestBody)
 }
 
 
+// This test verifies that a connection can be established with a
+// socket created by the caller.
+TEST(HTTPConnectionTest, ConnectSocket)
+{
+  Http http;
+
+  Try<network::Socket> socket = network::Socket::create(
+      network::Address::Family::INET4,
+      network::internal::SocketImpl::Kind::POLL);
+
+  ASSERT_SOME(socket);
+
+  const inet::Address address = http.process->self().address;
+
+  Future<http::Connection> connect = http::connect(socket.get(), address);
+  AWAIT_READY(connect);
+
+  http::Connection connection = connect.get();
+
+  EXPECT_CALL(*http.process, get(_))
+    .WillOnce(Return(http::OK()));
+
+  http::Request request;
+  request.method = "GET";
+  request.url = http::URL(
+      "http",
+      address.ip,
+      address.port,
+      http.process->self().id + "/get");
+  request.keepAlive = true;
+
+  AWAIT_EXPECT_RESPONSE_STATUS_EQ(http::OK().status, connection.send(request));
+
+  // Disconnect.
+  AWAIT_READY(connection.disconnect());
+  AWAIT_READY(connection.disconnected());
+}
+
+
 TEST(HTTPConnectionTest, Serial)
 {
   Http http;
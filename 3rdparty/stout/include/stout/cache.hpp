@@ -83,6 +83,21 @@ public:
     return None();
   }
 
+  // Erases the key/value pairs whose key satisfies the predicate.
+  template <typename Predicate>
+  void erase_if(const Predicate& predicate)
+  {
+    typename list::iterator i = keys.begin();
+    while (i != keys.end()) {
+      if (predicate(*i)) {
+        values.erase(*i);
+        i = keys.erase(i);
+      } else {
+        ++i;
+      }
+    }
+  }
+
   size_t size() const { return keys.size(); }
 
 private:
@@ -57,6 +57,25 @@ TEST(CacheTest, Erase)
 }
 
 
+TEST(CacheTest, EraseIf)
+{
+  Cache<int, std::string> cache(3);
+  cache.put(1, "a");
+  cache.put(2, "b");
+  cache.put(3, "c");
+
+  cache.erase_if([](int key) { return key % 2 == 1; });
+  EXPECT_EQ(1u, cache.size());
+  EXPECT_NONE(cache.get(1));
+  EXPECT_SOME_EQ("b", cache.get(2));
+  EXPECT_NONE(cache.get(3));
+
+  cache.put(4, "d");
+  EXPECT_SOME_EQ("d", cache.get(4));
+  EXPECT_EQ(2u, cache.size());
+}
+
+
 TEST(CacheTest, LRUEviction)
 {
   Cache<int, std::string> cache(2);
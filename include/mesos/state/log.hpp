@@ -52,6 +52,13 @@ public:
   process::Future<bool> expunge(const internal::state::Entry& entry) override;
   process::Future<std::set<std::string>> names() override;
 
+  // Reads the entries learned by the local replica since the last read
+  // without starting a writer, so that a non-leading master can follow
+  // the log. The entries read this way need not be read again once a
+  // writer is started.
+  process::Future<Option<internal::state::Entry>> follow(
+      const std::string& name) override;
+
 private:
   LogStorageProcess* process;
 };
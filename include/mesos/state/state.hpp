@@ -97,6 +97,11 @@ public:
   // previously did not exist (or an error if one occurs).
   process::Future<Variable> fetch(const std::string& name);
 
+  // Like `fetch`, but the variable is read without taking over the
+  // storage from its writer, so it may lag behind the latest stored
+  // variable (see `Storage::follow`). The variable can not be stored.
+  process::Future<Variable> follow(const std::string& name);
+
   // Returns the variable specified if it was successfully stored in
   // the state, otherwise returns none if the version of the variable
   // was no longer valid, or an error if one occurs.
@@ -131,6 +136,13 @@ inline process::Future<Variable> State::fetch(const std::string& name)
 }
 
 
+inline process::Future<Variable> State::follow(const std::string& name)
+{
+  return storage->follow(name)
+    .then(lambda::bind(&State::_fetch, name, lambda::_1));
+}
+
+
 inline process::Future<Variable> State::_fetch(
     const std::string& name,
     const Option<internal::state::Entry>& option)
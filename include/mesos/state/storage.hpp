@@ -42,6 +42,15 @@ public:
   // specified UUID.
   virtual process::Future<Option<internal::state::Entry>> get(
       const std::string& name) = 0;
+
+  // Gets a state entry without taking over the storage from the
+  // process which writes to it, e.g., on a non-leading master. The
+  // entry may lag behind the latest entry which has been set.
+  virtual process::Future<Option<internal::state::Entry>> follow(
+      const std::string& name)
+  {
+    return get(name);
+  }
   virtual process::Future<bool> set(
       const internal::state::Entry& entry,
       const id::UUID& uuid) = 0;
@@ -590,6 +590,7 @@ struct hash<mesos::CommandInfo::URI>
 
     boost::hash_combine(seed, uri.value());
     boost::hash_combine(seed, uri.output_file());
+    boost::hash_combine(seed, uri.digest());
     return seed;
   }
 };
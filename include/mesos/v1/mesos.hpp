@@ -510,6 +510,7 @@ struct hash<mesos::v1::CommandInfo::URI>
 
     boost::hash_combine(seed, uri.value());
     boost::hash_combine(seed, uri.output_file());
+    boost::hash_combine(seed, uri.digest());
     return seed;
   }
 };
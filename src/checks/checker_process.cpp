@@ -16,6 +16,7 @@
 
 #include "checks/checker_process.hpp"
 
+#include <algorithm>
 #include <cstdint>
 #include <map>
 #include <memory>
@@ -36,6 +37,7 @@
 #include <process/future.hpp>
 #include <process/io.hpp>
 #include <process/protobuf.hpp>
+#include <process/socket.hpp>
 #include <process/subprocess.hpp>
 #include <process/time.hpp>
 
@@ -43,6 +45,7 @@
 #include <stout/duration.hpp>
 #include <stout/error.hpp>
 #include <stout/foreach.hpp>
+#include <stout/ip.hpp>
 #include <stout/jsonify.hpp>
 #include <stout/nothing.hpp>
 #include <stout/option.hpp>
@@ -59,6 +62,7 @@
 
 #include "checks/checks_runtime.hpp"
 #include "checks/checks_types.hpp"
+#include "checks/socket_factory.hpp"
 
 #include "common/http.hpp"
 #include "common/protobuf_utils.hpp"
@@ -71,6 +75,7 @@
 #endif
 
 namespace http = process::http;
+namespace network = process::network;
 
 using process::Failure;
 using process::Future;
@@ -96,6 +101,9 @@ constexpr char HTTP_CHECK_COMMAND[] = "curl.exe";
 constexpr char TCP_CHECK_COMMAND[] = "mesos-tcp-connect.exe";
 #endif // __WINDOWS__
 
+// The maximum number of HTTP 3xx redirects followed by an HTTP check.
+constexpr size_t MAX_HTTP_CHECK_REDIRECTS = 10;
+
 
 #ifdef __linux__
 // TODO(alexr): Instead of defining this ad-hoc clone function, provide a
@@ -308,11 +316,14 @@ void CheckerProcess::performCheck()
   //
   // Explanations:
   // - A, B, C: Standard check launched directly by the library's user, i.e.,
-  //   the executor. Specifically, it launches the given command for CMD checks,
-  //   `curl` for HTTP checks, and `mesos-tcp-connect` for TCP checks.
+  //   the executor. Specifically, it launches the given command for CMD checks.
+  //   HTTP and TCP checks are performed in-process using libprocess sockets,
+  //   except for HTTPS checks which launch `curl`.
   // - A*, B*, C*: On Linux, the proper namespaces will be entered, which are
   //   the optional "mnt" for CMD and the required "net" for Docker HTTP/TCP.
   //   These checks are executed by the library's user, i.e., the executor.
+  //   The sockets of HTTP/TCP checks are created by a helper thread which has
+  //   entered the network namespace of the task, see `SocketFactory`.
   // - D: Delegate the command to Docker by wrapping the command with
   //   `docker exec` to run in the container's namespaces.
   // - E, F: On Windows, delegate the network checks to Docker by wrapping the
@@ -1020,17 +1031,187 @@ static vector<string> httpCheckCommand(
   };
 }
 
+Future<network::Socket> CheckerProcess::createSocket(
+    const Option<runtime::Plain>& plain,
+    network::Address::Family family)
+{
+  if (sockets.isNone()) {
+    Option<pid_t> taskPid;
+
+    if (plain.isSome() &&
+        plain->taskPid.isSome() &&
+        std::find(plain->namespaces.begin(),
+                  plain->namespaces.end(),
+                  "net") != plain->namespaces.end()) {
+      taskPid = plain->taskPid;
+    }
+
+    Try<Owned<SocketFactory>> factory = SocketFactory::create(taskPid);
+    if (factory.isError()) {
+      return Failure("Failed to create socket factory: " + factory.error());
+    }
+
+    sockets = factory.get();
+  }
+
+  return sockets.get()->socket(family);
+}
+
+
 Future<int> CheckerProcess::httpCheck(
     const check::Http& http,
     const Option<runtime::Plain>& plain)
 {
-  const string url =
-    http.scheme + "://" + http.domain + ":" + stringify(http.port) + http.path;
+  // HTTPS checks do not validate the certificate of the task, which
+  // libprocess sockets do not support on a per connection basis, so
+  // they are still performed by `curl`.
+  if (http.scheme != "http") {
+    const string url = http.scheme + "://" + http.domain + ":" +
+                       stringify(http.port) + http.path;
+
+    return _httpCheck(httpCheckCommand(HTTP_CHECK_COMMAND, url), plain);
+  }
+
+  const Duration timeout = checkTimeout;
+
+  return httpRequest(http, plain, http.path, MAX_HTTP_CHECK_REDIRECTS)
+    .after(timeout, defer(self(), [this, timeout](Future<int> future) {
+      future.discard();
+
+      // The connection might be stuck on the request, hence it is not
+      // reused for the next check.
+      resetHttpConnection();
+
+      return Failure("HTTP check timed out after " + stringify(timeout));
+    }));
+}
+
+
+Future<int> CheckerProcess::httpRequest(
+    const check::Http& http,
+    const Option<runtime::Plain>& plain,
+    const string& path,
+    size_t redirects)
+{
+  http::Request request;
+  request.method = "GET";
+  request.url = http::URL(
+      http.scheme, http.domain, static_cast<uint16_t>(http.port), path);
+  request.keepAlive = true;
+
+  VLOG(1) << "Sending " << name << " request to '" << request.url << "'"
+          << " for task '" << taskId << "'";
+
+  return httpConnection(http, plain)
+    .then([request](http::Connection connection) {
+      return connection.send(request);
+    })
+    .repair(defer(self(), [this](const Future<http::Response>& future) {
+      // The task might have closed the connection since the previous
+      // check, the next check will connect again.
+      resetHttpConnection();
+
+      return Failure(future.failure());
+    }))
+    .then(defer(
+        self(),
+        &Self::_httpRequest,
+        http,
+        plain,
+        redirects,
+        lambda::_1));
+}
+
+
+Future<int> CheckerProcess::_httpRequest(
+    const check::Http& http,
+    const Option<runtime::Plain>& plain,
+    size_t redirects,
+    const http::Response& response)
+{
+  if (response.code < 300 ||
+      response.code >= 400 ||
+      !response.headers.contains("Location")) {
+    return response.code;
+  }
+
+  if (redirects == 0) {
+    return Failure(
+        "Maximum (" + stringify(MAX_HTTP_CHECK_REDIRECTS) +
+        ") redirects followed");
+  }
+
+  const string& location = response.headers.at("Location");
+  const string origin =
+    http.scheme + "://" + http.domain + ":" + stringify(http.port);
+
+  VLOG(1) << name << " for task '" << taskId << "'"
+          << " is redirected to '" << location << "'";
+
+  if (strings::startsWith(location, "/")) {
+    return httpRequest(http, plain, location, redirects - 1);
+  }
+
+  if (strings::startsWith(location, origin + "/")) {
+    return httpRequest(
+        http, plain, location.substr(origin.size()), redirects - 1);
+  }
+
+  // Redirects to other hosts are rare enough that they are left to
+  // `curl` rather than opening further connections here.
+  const string url = origin + http.path;
 
   return _httpCheck(httpCheckCommand(HTTP_CHECK_COMMAND, url), plain);
 }
 
 
+Future<http::Connection> CheckerProcess::httpConnection(
+    const check::Http& http,
+    const Option<runtime::Plain>& plain)
+{
+  if (connection.isSome()) {
+    return connection.get();
+  }
+
+  Try<net::IP> ip =
+    net::IP::parse(strings::trim(http.domain, strings::ANY, "[]"));
+
+  if (ip.isError()) {
+    return Failure(
+        "Failed to parse '" + http.domain + "' as an IP: " + ip.error());
+  }
+
+  const network::Address address =
+    network::inet::Address(ip.get(), static_cast<uint16_t>(http.port));
+
+  return createSocket(plain, address.family())
+    .then([address](const network::Socket& socket) {
+      return http::connect(socket, address);
+    })
+    .then(defer(self(), [this](http::Connection _connection) {
+      connection = _connection;
+
+      _connection.disconnected()
+        .onAny(defer(self(), [this, _connection](const Future<Nothing>&) {
+          if (connection == _connection) {
+            connection = None();
+          }
+        }));
+
+      return _connection;
+    }));
+}
+
+
+void CheckerProcess::resetHttpConnection()
+{
+  if (connection.isSome()) {
+    connection->disconnect();
+    connection = None();
+  }
+}
+
+
 Future<int> CheckerProcess::_httpCheck(
     const vector<string>& cmdArgv,
     const Option<runtime::Plain>& plain)
@@ -1217,6 +1398,7 @@ Future<int> CheckerProcess::dockerHttpCheck(
 #endif // __WINDOWS__
 
 
+#ifdef __WINDOWS__
 static vector<string> tcpCommand(
   const string& command,
   const string& domain,
@@ -1228,20 +1410,54 @@ static vector<string> tcpCommand(
     "--port=" + stringify(port)
   };
 }
+#endif // __WINDOWS__
 
 
 Future<bool> CheckerProcess::tcpCheck(
     const check::Tcp& tcp,
     const Option<runtime::Plain>& plain)
 {
-  const string command = path::join(tcp.launcherDir, TCP_CHECK_COMMAND);
+  Try<net::IP> ip = net::IP::parse(tcp.domain);
+  if (ip.isError()) {
+    return Failure(
+        "Failed to parse '" + tcp.domain + "' as an IP: " + ip.error());
+  }
+
+  const network::Address address =
+    network::inet::Address(ip.get(), static_cast<uint16_t>(tcp.port));
 
-  const vector<string> argv =
-    tcpCommand(command, tcp.domain, static_cast<uint16_t>(tcp.port));
+  VLOG(1) << "Connecting " << name << " to " << address
+          << " for task '" << taskId << "'";
 
-  return _tcpCheck(argv, plain);
+  const string _name = name;
+  const Duration timeout = checkTimeout;
+  const TaskID _taskId = taskId;
+
+  return createSocket(plain, address.family())
+    .then([address, _name, _taskId](network::Socket socket) {
+      // NOTE: The socket is captured so that it is closed only once
+      // the connection attempt completes.
+      return socket.connect(address)
+        .then([socket]() {
+          return true;
+        })
+        .repair([_name, _taskId](const Future<bool>& future) {
+          // As with the `mesos-tcp-connect` helper, any failure to
+          // connect is reported as an unsuccessful check.
+          VLOG(1) << _name << " for task '" << _taskId << "'"
+                  << " failed to connect: " << future.failure();
+
+          return false;
+        });
+    })
+    .after(timeout, [timeout](Future<bool> future) {
+      future.discard();
+
+      return Failure("TCP check timed out after " + stringify(timeout));
+    });
 }
 
+
 Future<bool> CheckerProcess::_tcpCheck(
     const vector<string>& cmdArgv,
     const Option<runtime::Plain>& plain)
@@ -26,7 +26,9 @@
 
 #include <process/future.hpp>
 #include <process/http.hpp>
+#include <process/owned.hpp>
 #include <process/protobuf.hpp>
+#include <process/socket.hpp>
 
 #include <stout/duration.hpp>
 #include <stout/option.hpp>
@@ -36,6 +38,7 @@
 
 #include "checks/checks_runtime.hpp"
 #include "checks/checks_types.hpp"
+#include "checks/socket_factory.hpp"
 
 namespace mesos {
 namespace internal {
@@ -127,9 +130,29 @@ private:
       const Stopwatch& stopwatch,
       const process::Future<int>& future);
 
+  // Returns a socket in the network namespace the network checks
+  // should be performed in.
+  process::Future<process::network::Socket> createSocket(
+      const Option<runtime::Plain>& plain,
+      process::network::Address::Family family);
+
   process::Future<int> httpCheck(
       const check::Http& http,
       const Option<runtime::Plain>& plain);
+  process::Future<int> httpRequest(
+      const check::Http& http,
+      const Option<runtime::Plain>& plain,
+      const std::string& path,
+      size_t redirects);
+  process::Future<int> _httpRequest(
+      const check::Http& http,
+      const Option<runtime::Plain>& plain,
+      size_t redirects,
+      const process::http::Response& response);
+  process::Future<process::http::Connection> httpConnection(
+      const check::Http& http,
+      const Option<runtime::Plain>& plain);
+  void resetHttpConnection();
   process::Future<int> _httpCheck(
       const std::vector<std::string>& cmdArgv,
       const Option<runtime::Plain>& plain);
@@ -187,6 +210,14 @@ private:
   // Contains the ID of the most recently terminated nested container
   // that was used to perform a COMMAND check.
   Option<ContainerID> previousCheckContainerId;
+
+  // Created on the first HTTP or TCP check, so that the helper thread
+  // entering the network namespace of the task is only started once.
+  Option<process::Owned<SocketFactory>> sockets;
+
+  // The connection used by HTTP checks. It is kept open between checks
+  // and re-established if the task closes it.
+  Option<process::http::Connection> connection;
 };
 
 } // namespace checks {
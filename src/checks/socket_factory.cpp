@@ -0,0 +1,207 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "checks/socket_factory.hpp"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sched.h>
+
+#include <sys/socket.h>
+#endif // __linux__
+
+#include <glog/logging.h>
+
+#include <stout/error.hpp>
+#include <stout/foreach.hpp>
+#include <stout/os.hpp>
+#include <stout/path.hpp>
+#include <stout/stringify.hpp>
+#include <stout/unreachable.hpp>
+
+#include <stout/os/close.hpp>
+
+#ifdef __linux__
+#include "linux/ns.hpp"
+#endif // __linux__
+
+namespace network = process::network;
+
+using process::Failure;
+using process::Future;
+using process::Owned;
+
+using process::network::internal::SocketImpl;
+
+using std::deque;
+using std::shared_ptr;
+using std::string;
+
+namespace mesos {
+namespace internal {
+namespace checks {
+
+Try<Owned<SocketFactory>> SocketFactory::create(const Option<pid_t>& pid)
+{
+  if (pid.isNone()) {
+    return Owned<SocketFactory>(new SocketFactory(None()));
+  }
+
+#ifdef __linux__
+  const string path = path::join("/proc", stringify(pid.get()), "ns", "net");
+
+  // NOTE: The namespace is opened here rather than in the helper thread
+  // so that the thread enters the namespace of the task even if the
+  // task terminates in the meantime.
+  Try<int_fd> fd = os::open(path, O_RDONLY | O_CLOEXEC);
+  if (fd.isError()) {
+    return Error("Failed to open '" + path + "': " + fd.error());
+  }
+
+  return Owned<SocketFactory>(new SocketFactory(fd.get()));
+#else
+  return Error("Network namespaces are only supported on Linux");
+#endif // __linux__
+}
+
+
+SocketFactory::SocketFactory(const Option<int_fd>& namespaceFd)
+  : stopped(false)
+{
+  if (namespaceFd.isSome()) {
+    thread = std::thread(&SocketFactory::run, this, namespaceFd.get());
+  }
+}
+
+
+SocketFactory::~SocketFactory()
+{
+  if (thread.isSome()) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopped = true;
+    }
+
+    condition.notify_one();
+    thread->join();
+  }
+}
+
+
+Future<network::Socket> SocketFactory::socket(network::Address::Family family)
+{
+  if (thread.isNone()) {
+    Try<network::Socket> socket =
+      network::Socket::create(family, SocketImpl::Kind::POLL);
+
+    if (socket.isError()) {
+      return Failure(socket.error());
+    }
+
+    return socket.get();
+  }
+
+  shared_ptr<Request> request(new Request(family));
+  Future<int_fd> fd = request->promise.future();
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    requests.push_back(request);
+  }
+
+  condition.notify_one();
+
+  // NOTE: The continuation runs even if the caller discards the
+  // returned future, which ensures that the file descriptor is closed
+  // by the `Socket` if it is no longer needed.
+  return fd
+    .then([](int_fd fd) -> Future<network::Socket> {
+      Try<network::Socket> socket =
+        network::Socket::create(fd, SocketImpl::Kind::POLL);
+
+      if (socket.isError()) {
+        os::close(fd);
+        return Failure(socket.error());
+      }
+
+      return socket.get();
+    });
+}
+
+
+void SocketFactory::run(int_fd namespaceFd)
+{
+#ifdef __linux__
+  Option<Error> error;
+
+  // Only this thread enters the network namespace, the other threads
+  // of the process are not affected.
+  if (::setns(namespaceFd, CLONE_NEWNET) == -1) {
+    error = ErrnoError("Failed to enter the network namespace");
+    LOG(WARNING) << error->message;
+  }
+
+  os::close(namespaceFd);
+
+  while (true) {
+    deque<shared_ptr<Request>> pending;
+
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+
+      condition.wait(lock, [this]() {
+        return stopped || !requests.empty();
+      });
+
+      if (stopped) {
+        // The promises of pending requests are abandoned.
+        return;
+      }
+
+      std::swap(pending, requests);
+    }
+
+    foreach (const shared_ptr<Request>& request, pending) {
+      if (error.isSome()) {
+        request->promise.fail(error->message);
+        continue;
+      }
+
+      int domain = AF_INET;
+
+      switch (request->family) {
+        case network::Address::Family::INET4: domain = AF_INET; break;
+        case network::Address::Family::INET6: domain = AF_INET6; break;
+        case network::Address::Family::UNIX: domain = AF_UNIX; break;
+      }
+
+      int fd = ::socket(domain, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+      if (fd == -1) {
+        request->promise.fail(ErrnoError("Failed to create socket").message);
+        continue;
+      }
+
+      request->promise.set(fd);
+    }
+  }
+#else
+  UNREACHABLE();
+#endif // __linux__
+}
+
+} // namespace checks {
+} // namespace internal {
+} // namespace mesos {
@@ -0,0 +1,87 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __CHECKS_SOCKET_FACTORY_HPP__
+#define __CHECKS_SOCKET_FACTORY_HPP__
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <process/future.hpp>
+#include <process/owned.hpp>
+#include <process/socket.hpp>
+
+#include <stout/option.hpp>
+#include <stout/try.hpp>
+
+namespace mesos {
+namespace internal {
+namespace checks {
+
+// Creates sockets for the HTTP and TCP checks of a task. A socket
+// stays in the network namespace it was created in, so if the task has
+// its own network namespace the sockets are created by a long-lived
+// helper thread which has entered that namespace. The sockets can then
+// be used with libprocess like any other socket, which avoids forking a
+// helper process that enters the namespace for every check.
+class SocketFactory
+{
+public:
+  // Returns a factory for sockets in the network namespace of the
+  // process with the given pid, or in the network namespace of the
+  // calling process if `pid` is none.
+  static Try<process::Owned<SocketFactory>> create(const Option<pid_t>& pid);
+
+  ~SocketFactory();
+
+  // Returns an unconnected, non-blocking TCP socket.
+  process::Future<process::network::Socket> socket(
+      process::network::Address::Family family);
+
+private:
+  struct Request
+  {
+    explicit Request(process::network::Address::Family _family)
+      : family(_family) {}
+
+    const process::network::Address::Family family;
+    process::Promise<int_fd> promise;
+  };
+
+  explicit SocketFactory(const Option<int_fd>& namespaceFd);
+
+  SocketFactory(const SocketFactory&) = delete;
+  SocketFactory& operator=(const SocketFactory&) = delete;
+
+  // The body of the helper thread.
+  void run(int_fd namespaceFd);
+
+  Option<std::thread> thread;
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::deque<std::shared_ptr<Request>> requests;
+  bool stopped;
+};
+
+} // namespace checks {
+} // namespace internal {
+} // namespace mesos {
+
+#endif // __CHECKS_SOCKET_FACTORY_HPP__
@@ -683,6 +683,8 @@ protected:
         case Event::RESCIND:
         case Event::RESCIND_INVERSE_OFFER:
         case Event::UPDATE_OPERATION_STATUS:
+        case Event::UPDATES:
+        case Event::BATCH:
         case Event::MESSAGE: {
           break;
         }
@@ -45,6 +45,8 @@ namespace authorization {
 // Set of endpoint whose access is protected with the authorization
 // action `GET_ENDPOINTS_WITH_PATH`.
 hashset<string> AUTHORIZABLE_ENDPOINTS{
+    "/artifacts/blob",
+    "/artifacts/lookup",
     "/containers",
     "/files/debug",
     "/logging/toggle",
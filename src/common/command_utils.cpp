@@ -201,6 +201,36 @@ Future<string> sha512(const Path& input)
 }
 
 
+Future<string> sha256(const Path& input)
+{
+#ifdef __linux__
+  const string cmd = "sha256sum";
+  vector<string> argv = {
+    cmd,
+    input             // Input file to compute shasum.
+  };
+#else
+  const string cmd = "shasum";
+  vector<string> argv = {
+    cmd,
+    "-a", "256",      // Shasum type.
+    input             // Input file to compute shasum.
+  };
+#endif // __linux__
+
+  return launch(cmd, argv)
+    .then([cmd](const string& output) -> Future<string> {
+      vector<string> tokens = strings::tokenize(output, " ");
+      if (tokens.size() < 2) {
+        return Failure(
+            "Failed to parse '" + output + "' from '" + cmd + "' command");
+      }
+
+      return tokens[0];
+    });
+}
+
+
 Future<Nothing> gzip(const Path& input)
 {
   vector<string> argv = {
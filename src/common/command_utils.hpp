@@ -70,6 +70,14 @@ process::Future<Nothing> untar(
 process::Future<std::string> sha512(const Path& input);
 
 
+/**
+ * Computes SHA 256 checksum of a file.
+ *
+ * @param input path of the file whose SHA 256 checksum has to be computed.
+ */
+process::Future<std::string> sha256(const Path& input);
+
+
 /**
  * Compresses the given input file in GZIP format.
  *
@@ -164,6 +164,11 @@ struct StreamingHttpConnection
     return writer.write(encoder.encode(evolve(message)));
   }
 
+  bool send(const Event& event)
+  {
+    return writer.write(encoder.encode(event));
+  }
+
   bool close()
   {
     return writer.close();
@@ -562,6 +562,9 @@ struct Capabilities
         case FrameworkInfo::Capability::REGION_AWARE:
           regionAware = true;
           break;
+        case FrameworkInfo::Capability::BATCH_EVENTS:
+          batchEvents = true;
+          break;
       }
     }
   }
@@ -575,6 +578,7 @@ struct Capabilities
   bool multiRole = false;
   bool reservationRefinement = false;
   bool regionAware = false;
+  bool batchEvents = false;
 };
 
 
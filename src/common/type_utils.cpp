@@ -86,7 +86,8 @@ bool operator==(const CommandInfo::URI& left, const CommandInfo::URI& right)
   return left.value() == right.value() &&
     left.executable() == right.executable() &&
     left.extract() == right.extract() &&
-    left.output_file() == right.output_file();
+    left.output_file() == right.output_file() &&
+    left.digest() == right.digest();
 }
 
 
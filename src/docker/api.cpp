@@ -0,0 +1,596 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <list>
+#include <string>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include <process/address.hpp>
+#include <process/defer.hpp>
+#include <process/dispatch.hpp>
+#include <process/http.hpp>
+#include <process/id.hpp>
+#include <process/process.hpp>
+
+#include <stout/error.hpp>
+#include <stout/foreach.hpp>
+#include <stout/hashmap.hpp>
+#include <stout/json.hpp>
+#include <stout/lambda.hpp>
+#include <stout/stringify.hpp>
+#include <stout/strings.hpp>
+
+#include "docker/api.hpp"
+
+namespace http = process::http;
+namespace unix = process::network::unix;
+
+using process::Failure;
+using process::Future;
+using process::Owned;
+using process::Process;
+using process::Promise;
+
+using std::list;
+using std::string;
+using std::vector;
+
+namespace docker {
+namespace api {
+
+// The maximum number of idle connections we keep to the daemon. More
+// connections are opened when there are more requests in flight (some
+// of which, e.g., 'stop', may take a while), and closed once done.
+constexpr size_t MAX_IDLE_CONNECTIONS = 8;
+
+
+// Returns a request for the daemon. The daemon does not care about the
+// host, but HTTP/1.1 requires one.
+static http::Request request(
+    const string& method,
+    const string& path,
+    const hashmap<string, string>& query = hashmap<string, string>())
+{
+  http::Request request;
+  request.method = method;
+  request.url = http::URL("http", "docker", 80, path, query);
+  request.keepAlive = true;
+
+  return request;
+}
+
+
+// Returns the error for an unexpected response of the daemon, which
+// explains the error in the 'message' field of a JSON object.
+static Failure failure(const string& operation, const http::Response& response)
+{
+  string message = strings::trim(response.body);
+
+  Try<JSON::Object> json = JSON::parse<JSON::Object>(response.body);
+  if (json.isSome()) {
+    Result<JSON::String> _message = json->find<JSON::String>("message");
+    if (_message.isSome()) {
+      message = _message->value;
+    }
+  }
+
+  return Failure(
+      "Failed to " + operation + ": Unexpected response '" +
+      response.status + "'" + (message.empty() ? "" : ": " + message));
+}
+
+
+class ClientProcess : public Process<ClientProcess>
+{
+public:
+  explicit ClientProcess(const unix::Address& _address)
+    : ProcessBase(process::ID::generate("docker-api-client")),
+      address(_address) {}
+
+  ~ClientProcess() override {}
+
+  Future<http::Response> send(const http::Request& request);
+
+  Future<Nothing> subscribe();
+
+  Future<Nothing> event(const string& container, const string& action);
+
+protected:
+  void finalize() override;
+
+private:
+  struct Waiter
+  {
+    string container;
+    string action;
+    Owned<Promise<Nothing>> promise;
+  };
+
+  Future<http::Response> _send(
+      http::Connection connection,
+      const http::Request& request);
+
+  void release(
+      const http::Connection& connection,
+      const http::Response& response);
+
+  Future<Nothing> _subscribe(
+      const http::Connection& connection,
+      const http::Response& response);
+
+  void read();
+  void _read(const http::Pipe::Reader& reader, const Future<string>& data);
+
+  void handle(const string& line);
+
+  // Removes the waiter with the given promise, whose future has been
+  // discarded by the caller.
+  void discarded(const Promise<Nothing>* promise);
+
+  void unsubscribe(const string& reason);
+
+  const unix::Address address;
+
+  // The connections with no request in flight.
+  vector<http::Connection> idle;
+
+  // The subscription to the event stream. Once the daemon has accepted
+  // the subscription, 'events' is set and 'buffer' holds the part of
+  // the stream which does not end with a newline yet.
+  Option<Future<Nothing>> subscription;
+  Option<http::Connection> eventsConnection;
+  Option<http::Pipe::Reader> events;
+  string buffer;
+
+  list<Waiter> waiters;
+};
+
+
+Future<http::Response> ClientProcess::send(const http::Request& request)
+{
+  // Reuse an idle connection unless the daemon has closed it.
+  while (!idle.empty()) {
+    http::Connection connection = idle.back();
+    idle.pop_back();
+
+    if (connection.disconnected().isPending()) {
+      return _send(connection, request);
+    }
+  }
+
+  return http::connect(address, http::Scheme::HTTP)
+    .then(defer(self(), &Self::_send, lambda::_1, request));
+}
+
+
+Future<http::Response> ClientProcess::_send(
+    http::Connection connection,
+    const http::Request& request)
+{
+  return connection.send(request)
+    .onReady(defer(self(), &Self::release, connection, lambda::_1));
+}
+
+
+void ClientProcess::release(
+    const http::Connection& connection,
+    const http::Response& response)
+{
+  if (idle.size() >= MAX_IDLE_CONNECTIONS ||
+      response.headers.get("Connection") == string("close")) {
+    http::Connection(connection).disconnect();
+    return;
+  }
+
+  idle.push_back(connection);
+}
+
+
+Future<Nothing> ClientProcess::subscribe()
+{
+  if (subscription.isSome()) {
+    return subscription.get();
+  }
+
+  // We only wait for container events.
+  http::Request request = docker::api::request(
+      "GET",
+      "/events",
+      {{"filters", "{\"type\":[\"container\"]}"}});
+
+  Future<Nothing> future = http::connect(address, http::Scheme::HTTP)
+    .then(defer(self(), [=](http::Connection connection) {
+      return connection.send(request, true)
+        .then(defer(self(), &Self::_subscribe, connection, lambda::_1));
+    }));
+
+  subscription = future;
+
+  // Wake up the waiters if the subscription fails so that they can
+  // fall back to checking the state of the containers themselves.
+  future.onAny(defer(self(), [=](const Future<Nothing>& future) {
+    if (!future.isReady() && subscription == future) {
+      unsubscribe(
+          future.isFailed() ? future.failure() : "Subscription discarded");
+    }
+  }));
+
+  return future;
+}
+
+
+Future<Nothing> ClientProcess::_subscribe(
+    const http::Connection& connection,
+    const http::Response& response)
+{
+  if (response.code != http::Status::OK) {
+    http::Connection(connection).disconnect();
+    return failure("subscribe to events", response);
+  }
+
+  CHECK_EQ(http::Response::PIPE, response.type);
+  CHECK_SOME(response.reader);
+
+  eventsConnection = connection;
+  events = response.reader.get();
+
+  read();
+
+  return Nothing();
+}
+
+
+void ClientProcess::read()
+{
+  CHECK_SOME(events);
+
+  http::Pipe::Reader reader = events.get();
+
+  reader.read()
+    .onAny(defer(self(), &Self::_read, reader, lambda::_1));
+}
+
+
+void ClientProcess::_read(
+    const http::Pipe::Reader& reader,
+    const Future<string>& data)
+{
+  // The stream might have been closed (and another one opened) by
+  // `unsubscribe` in the meantime.
+  if (events != reader) {
+    return;
+  }
+
+  if (!data.isReady()) {
+    unsubscribe(data.isFailed() ? data.failure() : "Read discarded");
+    return;
+  } else if (data->empty()) {
+    unsubscribe("Stream closed by the daemon");
+    return;
+  }
+
+  // The daemon sends one JSON object per line.
+  buffer += data.get();
+
+  size_t index;
+  while ((index = buffer.find('\n')) != string::npos) {
+    const string line = buffer.substr(0, index);
+    buffer.erase(0, index + 1);
+
+    if (!strings::trim(line).empty()) {
+      handle(line);
+    }
+  }
+
+  read();
+}
+
+
+void ClientProcess::handle(const string& line)
+{
+  Try<JSON::Object> event = JSON::parse<JSON::Object>(line);
+  if (event.isError()) {
+    LOG(WARNING) << "Failed to parse Docker event '" << line << "': "
+                 << event.error();
+    return;
+  }
+
+  Result<JSON::String> action = event->find<JSON::String>("Action");
+  Result<JSON::String> id = event->find<JSON::String>("Actor.ID");
+  Result<JSON::String> name =
+    event->find<JSON::String>("Actor.Attributes.name");
+
+  if (!action.isSome() || !id.isSome()) {
+    VLOG(1) << "Ignoring Docker event '" << line << "'";
+    return;
+  }
+
+  auto it = waiters.begin();
+  while (it != waiters.end()) {
+    const bool matches =
+      it->action == action->value &&
+      (strings::startsWith(id->value, it->container) ||
+       (name.isSome() && name->value == it->container));
+
+    if (it->promise->future().hasDiscard()) {
+      it->promise->discard();
+      it = waiters.erase(it);
+    } else if (matches) {
+      it->promise->set(Nothing());
+      it = waiters.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+
+void ClientProcess::unsubscribe(const string& reason)
+{
+  if (!waiters.empty()) {
+    LOG(WARNING) << "Lost the subscription to the Docker events: " << reason;
+  }
+
+  if (events.isSome()) {
+    events->close();
+  }
+
+  if (eventsConnection.isSome()) {
+    eventsConnection->disconnect();
+  }
+
+  subscription = None();
+  eventsConnection = None();
+  events = None();
+  buffer.clear();
+
+  foreach (Waiter& waiter, waiters) {
+    waiter.promise->set(Nothing());
+  }
+
+  waiters.clear();
+}
+
+
+Future<Nothing> ClientProcess::event(
+    const string& container,
+    const string& action)
+{
+  Waiter waiter{
+      container, action, Owned<Promise<Nothing>>(new Promise<Nothing>())};
+  waiters.push_back(waiter);
+
+  // The waiter is removed as soon as the caller is not interested in
+  // the event anymore (e.g., because the container has started before
+  // the caller subscribed), rather than on the next event.
+  Future<Nothing> future = waiter.promise->future();
+  future.onDiscard(
+      defer(self(), &Self::discarded, waiter.promise.get()));
+
+  return future;
+}
+
+
+void ClientProcess::discarded(const Promise<Nothing>* promise)
+{
+  auto it = waiters.begin();
+  while (it != waiters.end()) {
+    if (it->promise.get() == promise) {
+      it->promise->discard();
+      waiters.erase(it);
+      return;
+    }
+
+    ++it;
+  }
+}
+
+
+void ClientProcess::finalize()
+{
+  if (events.isSome()) {
+    events->close();
+  }
+
+  if (eventsConnection.isSome()) {
+    eventsConnection->disconnect();
+  }
+
+  foreach (http::Connection& connection, idle) {
+    connection.disconnect();
+  }
+
+  foreach (Waiter& waiter, waiters) {
+    waiter.promise->discard();
+  }
+}
+
+
+Try<Owned<Client>> Client::create(const string& socket)
+{
+  Try<unix::Address> address = unix::Address::create(socket);
+  if (address.isError()) {
+    return Error(
+        "Invalid Docker socket path '" + socket + "': " + address.error());
+  }
+
+  Owned<ClientProcess> process(new ClientProcess(address.get()));
+  spawn(process.get());
+
+  return Owned<Client>(new Client(process));
+}
+
+
+Client::Client(Owned<ClientProcess> _process)
+  : process(_process) {}
+
+
+Client::~Client()
+{
+  terminate(process.get());
+  wait(process.get());
+}
+
+
+Future<Option<string>> Client::inspect(const string& container) const
+{
+  return dispatch(
+      process.get(),
+      &ClientProcess::send,
+      request("GET", "/containers/" + container + "/json"))
+    .then([=](const http::Response& response) -> Future<Option<string>> {
+      if (response.code == http::Status::NOT_FOUND) {
+        return None();
+      } else if (response.code != http::Status::OK) {
+        return failure("inspect container '" + container + "'", response);
+      }
+
+      return response.body;
+    });
+}
+
+
+Future<vector<string>> Client::ps(bool all) const
+{
+  hashmap<string, string> query;
+  if (all) {
+    query["all"] = "1";
+  }
+
+  return dispatch(
+      process.get(),
+      &ClientProcess::send,
+      request("GET", "/containers/json", query))
+    .then([](const http::Response& response) -> Future<vector<string>> {
+      if (response.code != http::Status::OK) {
+        return failure("list containers", response);
+      }
+
+      Try<JSON::Array> array = JSON::parse<JSON::Array>(response.body);
+      if (array.isError()) {
+        return Failure("Failed to parse containers: " + array.error());
+      }
+
+      vector<string> names;
+
+      foreach (const JSON::Value& value, array->values) {
+        if (!value.is<JSON::Object>()) {
+          return Failure("Failed to parse containers: Expecting objects");
+        }
+
+        Result<JSON::Array> _names =
+          value.as<JSON::Object>().find<JSON::Array>("Names");
+
+        if (!_names.isSome() || _names->values.empty() ||
+            !_names->values.front().is<JSON::String>()) {
+          return Failure("Failed to parse containers: Missing 'Names'");
+        }
+
+        // The names start with a '/'.
+        names.push_back(strings::remove(
+            _names->values.front().as<JSON::String>().value,
+            "/",
+            strings::PREFIX));
+      }
+
+      return names;
+    });
+}
+
+
+Future<Nothing> Client::stop(
+    const string& container,
+    const Duration& timeout) const
+{
+  return dispatch(
+      process.get(),
+      &ClientProcess::send,
+      request(
+          "POST",
+          "/containers/" + container + "/stop",
+          {{"t", stringify((int64_t) timeout.secs())}}))
+    .then([=](const http::Response& response) -> Future<Nothing> {
+      // The daemon responds with '304 Not Modified' if the container
+      // has already stopped.
+      if (response.code != http::Status::NO_CONTENT &&
+          response.code != http::Status::NOT_MODIFIED) {
+        return failure("stop container '" + container + "'", response);
+      }
+
+      return Nothing();
+    });
+}
+
+
+Future<Nothing> Client::kill(const string& container, int signal) const
+{
+  return dispatch(
+      process.get(),
+      &ClientProcess::send,
+      request(
+          "POST",
+          "/containers/" + container + "/kill",
+          {{"signal", stringify(signal)}}))
+    .then([=](const http::Response& response) -> Future<Nothing> {
+      if (response.code != http::Status::NO_CONTENT) {
+        return failure("kill container '" + container + "'", response);
+      }
+
+      return Nothing();
+    });
+}
+
+
+Future<Nothing> Client::rm(const string& container, bool force) const
+{
+  hashmap<string, string> query;
+  query["v"] = "1";
+
+  if (force) {
+    query["force"] = "1";
+  }
+
+  return dispatch(
+      process.get(),
+      &ClientProcess::send,
+      request("DELETE", "/containers/" + container, query))
+    .then([=](const http::Response& response) -> Future<Nothing> {
+      if (response.code != http::Status::NO_CONTENT) {
+        return failure("remove container '" + container + "'", response);
+      }
+
+      return Nothing();
+    });
+}
+
+
+Future<Nothing> Client::subscribe() const
+{
+  return dispatch(process.get(), &ClientProcess::subscribe);
+}
+
+
+Future<Nothing> Client::event(
+    const string& container,
+    const string& action) const
+{
+  return dispatch(process.get(), &ClientProcess::event, container, action);
+}
+
+} // namespace api {
+} // namespace docker {
@@ -0,0 +1,117 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __DOCKER_API_HPP__
+#define __DOCKER_API_HPP__
+
+#include <string>
+#include <vector>
+
+#include <process/future.hpp>
+#include <process/owned.hpp>
+
+#include <stout/duration.hpp>
+#include <stout/nothing.hpp>
+#include <stout/option.hpp>
+#include <stout/try.hpp>
+
+namespace docker {
+namespace api {
+
+// Forward declaration.
+class ClientProcess;
+
+
+// A client for the Docker Engine API, which the Docker daemon serves
+// over HTTP on its unix domain socket. Unlike the docker CLI, the
+// client does not fork a process for every operation: it reuses
+// persistent connections to the daemon, and it subscribes to the event
+// stream of the daemon rather than polling for state changes.
+//
+// See https://docs.docker.com/engine/api/ for the API reference.
+class Client
+{
+public:
+  // Creates a client for the daemon listening on the unix domain
+  // socket at the given path. The daemon does not need to be running
+  // yet; connections are established on demand.
+  static Try<process::Owned<Client>> create(const std::string& socket);
+
+  ~Client();
+
+  // Performs 'GET /containers/{container}/json'. Returns the JSON
+  // object describing the container (i.e., the element of the array
+  // 'docker inspect' prints), or None if there is no such container.
+  process::Future<Option<std::string>> inspect(
+      const std::string& container) const;
+
+  // Performs 'GET /containers/json'. Returns the names of the running
+  // (or all if 'all' is set) containers.
+  process::Future<std::vector<std::string>> ps(bool all) const;
+
+  // Performs 'POST /containers/{container}/stop'. Stopping a container
+  // which has already stopped succeeds.
+  process::Future<Nothing> stop(
+      const std::string& container,
+      const Duration& timeout) const;
+
+  // Performs 'POST /containers/{container}/kill'.
+  process::Future<Nothing> kill(
+      const std::string& container,
+      int signal) const;
+
+  // Performs 'DELETE /containers/{container}', removing the volumes of
+  // the container as well.
+  process::Future<Nothing> rm(
+      const std::string& container,
+      bool force) const;
+
+  // Subscribes to the container events of the daemon ('GET /events')
+  // unless already subscribed. The future is satisfied once the daemon
+  // has accepted the subscription, i.e., all the events from then on
+  // are delivered to the waiters registered with `event`.
+  process::Future<Nothing> subscribe() const;
+
+  // Returns a future which is satisfied by the next event with the
+  // given action (e.g., 'start' or 'die') for the container with the
+  // given name or (possibly abbreviated) ID. The waiter is registered
+  // before any call made after this one is processed, so that
+  //
+  //   Future<Nothing> started = client->event(name, "start");
+  //   client->subscribe().then([=]() { return client->inspect(name); });
+  //
+  // does not miss the start of the container between the two calls.
+  //
+  // NOTE: The future is also satisfied when the subscription is lost
+  // or cannot be established. Callers need to check the state of the
+  // container (e.g., with `inspect`) once it is satisfied.
+  process::Future<Nothing> event(
+      const std::string& container,
+      const std::string& action) const;
+
+private:
+  explicit Client(process::Owned<ClientProcess> process);
+
+  Client(const Client&) = delete;
+  Client& operator=(const Client&) = delete;
+
+  process::Owned<ClientProcess> process;
+};
+
+} // namespace api {
+} // namespace docker {
+
+#endif // __DOCKER_API_HPP__
@@ -38,9 +38,11 @@
 #include <stout/os/windows/jobobject.hpp>
 #endif // __WINDOWS__
 
+#include <process/after.hpp>
 #include <process/check.hpp>
 #include <process/collect.hpp>
 #include <process/io.hpp>
+#include <process/loop.hpp>
 
 #ifdef __WINDOWS__
 #include <process/windows/jobobject.hpp>
@@ -64,6 +66,10 @@ using namespace mesos::internal::slave;
 
 using namespace process;
 
+#ifndef __WINDOWS__
+using docker::api::Client;
+#endif // __WINDOWS__
+
 using std::map;
 using std::mutex;
 using std::pair;
@@ -113,6 +119,35 @@ static Future<Nothing> checkError(const string& cmd, const Subprocess& s)
 }
 
 
+#ifndef __WINDOWS__
+// Returns the Engine API client for the daemon listening on the given
+// socket, or None if the client is not available.
+static Option<Shared<Client>> createClient(const string& socket)
+{
+  Try<Owned<Client>> client = Client::create(socket);
+  if (client.isError()) {
+    LOG(WARNING) << "Falling back to the docker CLI: " << client.error();
+    return None();
+  }
+
+  return client->share();
+}
+#endif // __WINDOWS__
+
+
+Docker::Docker(
+    const string& _path,
+    const string& _socket,
+    const Option<JSON::Object>& _config)
+  : path(_path),
+    socket(DEFAULT_DOCKER_HOST_PREFIX + _socket),
+    config(_config)
+#ifndef __WINDOWS__
+    , client(createClient(_socket))
+#endif // __WINDOWS__
+{}
+
+
 Try<Owned<Docker>> Docker::create(
     const string& path,
     const string& socket,
@@ -1204,6 +1239,24 @@ Future<Nothing> Docker::stop(
                    stringify(timeoutSecs));
   }
 
+#ifndef __WINDOWS__
+  if (client.isSome()) {
+    VLOG(1) << "Stopping Docker container '" << containerName << "'";
+
+    Future<Nothing> stop = client.get()->stop(containerName, timeout);
+    if (!remove) {
+      return stop;
+    }
+
+    // Same as below, we force the removal if the container could not
+    // be stopped.
+    return stop
+      .then([]() { return false; })
+      .repair([](const Future<bool>&) { return true; })
+      .then(lambda::bind(&Docker::__stop, *this, containerName, lambda::_1));
+  }
+#endif // __WINDOWS__
+
   vector<string> argv;
   argv.push_back(path);
   argv.push_back("-H");
@@ -1255,22 +1308,40 @@ Future<Nothing> Docker::_stop(
 
   if (remove) {
     bool force = !status.isSome() || status.get() != 0;
-    return docker.rm(containerName, force)
-      .repair([=](const Future<Nothing>& future) {
-        LOG(ERROR) << "Unable to remove Docker container '"
-                   << containerName + "': " << future.failure();
-        return Nothing();
-      });
+    return __stop(docker, containerName, force);
   }
 
   return checkError(cmd, s);
 }
 
 
+Future<Nothing> Docker::__stop(
+    const Docker& docker,
+    const string& containerName,
+    bool force)
+{
+  return docker.rm(containerName, force)
+    .repair([=](const Future<Nothing>& future) {
+      LOG(ERROR) << "Unable to remove Docker container '"
+                 << containerName + "': " << future.failure();
+      return Nothing();
+    });
+}
+
+
 Future<Nothing> Docker::kill(
     const string& containerName,
     int signal) const
 {
+#ifndef __WINDOWS__
+  if (client.isSome()) {
+    VLOG(1) << "Sending signal " << signal << " to Docker container '"
+            << containerName << "'";
+
+    return client.get()->kill(containerName, signal);
+  }
+#endif // __WINDOWS__
+
   vector<string> argv;
   argv.push_back(path);
   argv.push_back("-H");
@@ -1306,6 +1377,14 @@ Future<Nothing> Docker::rm(
     const string& containerName,
     bool force) const
 {
+#ifndef __WINDOWS__
+  if (client.isSome()) {
+    VLOG(1) << "Removing Docker container '" << containerName << "'";
+
+    return client.get()->rm(containerName, force);
+  }
+#endif // __WINDOWS__
+
   // The `-v` flag removes Docker volumes that may be present.
   vector<string> argv;
   argv.push_back(path);
@@ -1347,6 +1426,12 @@ Future<Docker::Container> Docker::inspect(
     const string& containerName,
     const Option<Duration>& retryInterval) const
 {
+#ifndef __WINDOWS__
+  if (client.isSome()) {
+    return _inspect(client.get(), containerName, retryInterval);
+  }
+#endif // __WINDOWS__
+
   Owned<Promise<Docker::Container>> promise(new Promise<Docker::Container>());
 
   // Holds a callback used for cleanup in case this call to 'docker inspect' is
@@ -1372,6 +1457,94 @@ Future<Docker::Container> Docker::inspect(
 }
 
 
+#ifndef __WINDOWS__
+Future<Docker::Container> Docker::_inspect(
+    const Shared<Client>& client,
+    const string& containerName,
+    const Option<Duration>& retryInterval)
+{
+  VLOG(1) << "Inspecting Docker container '" << containerName << "'";
+
+  // Parses the output of the daemon, which is the element of the array
+  // 'docker inspect' prints.
+  auto parse = [=](const Option<string>& output) -> Try<Docker::Container> {
+    if (output.isNone()) {
+      return Error("No such container: " + containerName);
+    }
+
+    Try<Docker::Container> container =
+      Docker::Container::create("[" + output.get() + "]");
+
+    if (container.isError()) {
+      return Error("Unable to create container: " + container.error());
+    }
+
+    return container;
+  };
+
+  if (retryInterval.isNone()) {
+    return client->inspect(containerName)
+      .then([=](const Option<string>& output) -> Future<Docker::Container> {
+        Try<Docker::Container> container = parse(output);
+        if (container.isError()) {
+          return Failure(container.error());
+        }
+
+        return container.get();
+      });
+  }
+
+  // Instead of polling until the container has started, we wait for
+  // the daemon to report that the container has started whenever it
+  // has not yet (or does not even exist yet). We register for the
+  // event before inspecting the container so that we cannot miss it.
+  // If we cannot subscribe to the events, we fall back to polling.
+  return loop(
+      [=]() -> Future<Option<Docker::Container>> {
+        Future<Nothing> started = client->event(containerName, "start");
+
+        return client->subscribe()
+          .repair([=](const Future<Nothing>& future) -> Future<Nothing> {
+            LOG(WARNING) << "Failed to subscribe to Docker events: "
+                         << (future.isFailed() ? future.failure()
+                                               : "discarded")
+                         << "; retrying inspect in " << retryInterval.get();
+
+            return after(retryInterval.get());
+          })
+          .then([=]() { return client->inspect(containerName); })
+          .then([=](const Option<string>& output)
+                  -> Future<Option<Docker::Container>> {
+            Try<Docker::Container> container = parse(output);
+            if (container.isSome() && container->started) {
+              // Unregister from the start event, which has already
+              // happened (the common case).
+              Future<Nothing>(started).discard();
+              return container.get();
+            } else if (container.isError() && output.isSome()) {
+              Future<Nothing>(started).discard();
+              return Failure(container.error());
+            }
+
+            VLOG(1) << "Waiting for Docker container '" << containerName
+                    << "' to start";
+
+            return started
+              .then([]() -> Option<Docker::Container> { return None(); });
+          });
+      },
+      [](const Option<Docker::Container>& container)
+          -> ControlFlow<Docker::Container> {
+        if (container.isSome()) {
+          return Break(container.get());
+        }
+
+        return Continue();
+      });
+}
+#endif // __WINDOWS__
+
+
 void Docker::_inspect(
     const vector<string>& argv,
     const Owned<Promise<Docker::Container>>& promise,
@@ -1528,6 +1701,15 @@ Future<vector<Docker::Container>> Docker::ps(
     bool all,
     const Option<string>& prefix) const
 {
+#ifndef __WINDOWS__
+  if (client.isSome()) {
+    VLOG(1) << "Listing Docker containers";
+
+    return client.get()->ps(all)
+      .then(lambda::bind(&Docker::___ps, *this, prefix, lambda::_1));
+  }
+#endif // __WINDOWS__
+
   vector<string> argv;
   argv.push_back(path);
   argv.push_back("-H");
@@ -1598,12 +1780,36 @@ Future<vector<Docker::Container>> Docker::__ps(
     const Option<string>& prefix,
     const string& output)
 {
-  Owned<vector<string>> lines(new vector<string>());
-  *lines = strings::tokenize(output, "\n");
+  vector<string> lines = strings::tokenize(output, "\n");
 
   // Skip the header.
-  CHECK(!lines->empty());
-  lines->erase(lines->begin());
+  CHECK(!lines.empty());
+  lines.erase(lines.begin());
+
+  vector<string> names;
+  foreach (const string& line, lines) {
+    // We expect the name column to be the last column from ps.
+    vector<string> columns = strings::split(strings::trim(line), " ");
+    names.push_back(columns[columns.size() - 1]);
+  }
+
+  return ___ps(docker, prefix, names);
+}
+
+
+Future<vector<Docker::Container>> Docker::___ps(
+    const Docker& docker,
+    const Option<string>& prefix,
+    const vector<string>& names)
+{
+  // Inspect the containers that we are interested in depending on
+  // whether or not a 'prefix' was specified.
+  Owned<vector<string>> _names(new vector<string>());
+  foreach (const string& name, names) {
+    if (prefix.isNone() || strings::startsWith(name, prefix.get())) {
+      _names->push_back(name);
+    }
+  }
 
   Owned<vector<Docker::Container>> containers(new vector<Docker::Container>());
 
@@ -1612,7 +1818,7 @@ Future<vector<Docker::Container>> Docker::__ps(
 
   // Limit number of parallel calls to docker inspect at once to prevent
   // reaching system's open file descriptor limit.
-  inspectBatches(containers, lines, promise, docker, prefix);
+  inspectBatches(containers, _names, promise, docker);
 
   return promise->future();
 }
@@ -1622,24 +1828,22 @@ Future<vector<Docker::Container>> Docker::__ps(
 // within libprocess.
 void Docker::inspectBatches(
     Owned<vector<Docker::Container>> containers,
-    Owned<vector<string>> lines,
+    Owned<vector<string>> names,
     Owned<Promise<vector<Docker::Container>>> promise,
-    const Docker& docker,
-    const Option<string>& prefix)
+    const Docker& docker)
 {
-  vector<Future<Docker::Container>> batch =
-    createInspectBatch(lines, docker, prefix);
+  vector<Future<Docker::Container>> batch = createInspectBatch(names, docker);
 
   collect(batch).onAny([=](const Future<vector<Docker::Container>>& c) {
     if (c.isReady()) {
       foreach (const Docker::Container& container, c.get()) {
         containers->push_back(container);
       }
-      if (lines->empty()) {
+      if (names->empty()) {
         promise->set(*containers);
       }
       else {
-        inspectBatches(containers, lines, promise, docker, prefix);
+        inspectBatches(containers, names, promise, docker);
       }
     } else {
       if (c.isFailed()) {
@@ -1654,25 +1858,14 @@ void Docker::inspectBatches(
 
 
 vector<Future<Docker::Container>> Docker::createInspectBatch(
-    Owned<vector<string>> lines,
-    const Docker& docker,
-    const Option<string>& prefix)
+    Owned<vector<string>> names,
+    const Docker& docker)
 {
   vector<Future<Docker::Container>> batch;
 
-  while (!lines->empty() && batch.size() < DOCKER_PS_MAX_INSPECT_CALLS) {
-    string line = lines->back();
-    lines->pop_back();
-
-    // Inspect the containers that we are interested in depending on
-    // whether or not a 'prefix' was specified.
-    vector<string> columns = strings::split(strings::trim(line), " ");
-
-    // We expect the name column to be the last column from ps.
-    string name = columns[columns.size() - 1];
-    if (prefix.isNone() || strings::startsWith(name, prefix.get())) {
-      batch.push_back(docker.inspect(name));
-    }
+  while (!names->empty() && batch.size() < DOCKER_PS_MAX_INSPECT_CALLS) {
+    batch.push_back(docker.inspect(names->back()));
+    names->pop_back();
   }
 
   return batch;
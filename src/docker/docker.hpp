@@ -25,6 +25,7 @@
 
 #include <process/future.hpp>
 #include <process/owned.hpp>
+#include <process/shared.hpp>
 #include <process/subprocess.hpp>
 
 #include <stout/duration.hpp>
@@ -37,6 +38,10 @@
 
 #include <stout/os/rm.hpp>
 
+#ifndef __WINDOWS__
+#include "docker/api.hpp"
+#endif // __WINDOWS__
+
 #include "mesos/resources.hpp"
 
 #include "messages/flags.hpp"
@@ -53,6 +58,11 @@ constexpr char DEFAULT_DOCKER_HOST_PREFIX[] = "unix://";
 
 // Abstraction for working with Docker (modeled on CLI).
 //
+// NOTE: Except for 'run', 'pull' and 'version', the operations talk to
+// the daemon through the Engine API (see 'docker/api.hpp') rather than
+// running the docker CLI, unless the Engine API is not available (i.e.,
+// on Windows).
+//
 // TODO(benh): Make futures returned by functions be discardable.
 class Docker
 {
@@ -324,10 +334,7 @@ protected:
   // Uses the specified path to the Docker CLI tool.
   Docker(const std::string& _path,
          const std::string& _socket,
-         const Option<JSON::Object>& _config)
-       : path(_path),
-         socket(DEFAULT_DOCKER_HOST_PREFIX + _socket),
-         config(_config) {}
+         const Option<JSON::Object>& _config);
 
 private:
   static process::Future<Version> _version(
@@ -344,6 +351,18 @@ private:
       const process::Subprocess& s,
       bool remove);
 
+  static process::Future<Nothing> __stop(
+      const Docker& docker,
+      const std::string& containerName,
+      bool force);
+
+#ifndef __WINDOWS__
+  static process::Future<Container> _inspect(
+      const process::Shared<docker::api::Client>& client,
+      const std::string& containerName,
+      const Option<Duration>& retryInterval);
+#endif // __WINDOWS__
+
   static void _inspect(
       const std::vector<std::string>& argv,
       const process::Owned<process::Promise<Container>>& promise,
@@ -380,17 +399,20 @@ private:
       const Option<std::string>& prefix,
       const std::string& output);
 
+  static process::Future<std::vector<Container>> ___ps(
+      const Docker& docker,
+      const Option<std::string>& prefix,
+      const std::vector<std::string>& names);
+
   static void inspectBatches(
       process::Owned<std::vector<Docker::Container>> containers,
-      process::Owned<std::vector<std::string>> lines,
+      process::Owned<std::vector<std::string>> names,
       process::Owned<process::Promise<std::vector<Docker::Container>>> promise,
-      const Docker& docker,
-      const Option<std::string>& prefix);
+      const Docker& docker);
 
   static std::vector<process::Future<Docker::Container>> createInspectBatch(
-      process::Owned<std::vector<std::string>> lines,
-      const Docker& docker,
-      const Option<std::string>& prefix);
+      process::Owned<std::vector<std::string>> names,
+      const Docker& docker);
 
   static process::Future<Image> _pull(
       const Docker& docker,
@@ -427,6 +449,11 @@ private:
   const std::string path;
   const std::string socket;
   const Option<JSON::Object> config;
+
+#ifndef __WINDOWS__
+  // The Engine API client, shared by the copies of this object.
+  const Option<process::Shared<docker::api::Client>> client;
+#endif // __WINDOWS__
 };
 
 #endif // __DOCKER_HPP__
@@ -222,6 +222,15 @@ protected:
         case Event::UPDATE_OPERATION_STATUS:
           break;
 
+        // Only sent for reconciliation with 'batch_size' set, which this
+        // framework does not use.
+        case Event::UPDATES:
+          break;
+
+        // 'BATCH' events are unpacked by the scheduler library.
+        case Event::BATCH:
+          break;
+
         case Event::FAILURE: {
           const Event::Failure& failure = event.failure();
 
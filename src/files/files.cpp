@@ -22,21 +22,27 @@
 
 #include <algorithm>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
-#include <boost/shared_array.hpp>
-
+#include <process/async.hpp>
+#include <process/clock.hpp>
 #include <process/defer.hpp>
 #include <process/deferred.hpp> // TODO(benh): This is required by Clang.
+#include <process/delay.hpp>
 #include <process/dispatch.hpp>
 #include <process/future.hpp>
 #include <process/help.hpp>
 #include <process/http.hpp>
-#include <process/io.hpp>
 #include <process/mime.hpp>
+#include <process/owned.hpp>
 #include <process/process.hpp>
+#include <process/time.hpp>
 
+#include <stout/bytes.hpp>
+#include <stout/cache.hpp>
+#include <stout/duration.hpp>
 #include <stout/error.hpp>
 #include <stout/hashmap.hpp>
 #include <stout/json.hpp>
@@ -62,7 +68,6 @@
 #include "logging/logging.hpp"
 
 namespace http = process::http;
-namespace io = process::io;
 namespace mime = process::mime;
 
 using http::BadRequest;
@@ -75,12 +80,16 @@ using mesos::Authorizer;
 
 using process::AUTHENTICATION;
 using process::AUTHORIZATION;
+using process::Clock;
 using process::defer;
 using process::DESCRIPTION;
 using process::Failure;
 using process::Future;
 using process::HELP;
+using process::Owned;
 using process::Process;
+using process::Promise;
+using process::Time;
 using process::TLDR;
 using process::wait; // Necessary on some OS's to disambiguate.
 
@@ -88,6 +97,7 @@ using process::http::authentication::Principal;
 
 using std::list;
 using std::map;
+using std::shared_ptr;
 using std::string;
 using std::tuple;
 using std::vector;
@@ -95,6 +105,18 @@ using std::vector;
 namespace mesos {
 namespace internal {
 
+// The number of files kept open for `/files/read`.
+constexpr size_t MAX_CACHED_FILES = 256;
+
+// How long a `/files/read` request waits for a followed file to grow
+// if no timeout is given, and the longest timeout allowed.
+constexpr Duration DEFAULT_FOLLOW_TIMEOUT = Seconds(10);
+constexpr Duration MAX_FOLLOW_TIMEOUT = Minutes(1);
+
+// How often the followed files are checked for new data.
+constexpr Duration FOLLOW_INTERVAL = Milliseconds(100);
+
+
 class FilesProcess : public Process<FilesProcess>
 {
 public:
@@ -114,11 +136,14 @@ public:
       const string& path,
       const Option<Principal>& principal);
 
+  // If `follow` is set and the file is not larger than `offset`, waits
+  // up to the given duration for the file to grow before reading.
   Future<Try<tuple<size_t, string>, FilesError>> read(
       const size_t offset,
       const Option<size_t>& length,
       const string& path,
-      const Option<Principal>& principal);
+      const Option<Principal>& principal,
+      const Option<Duration>& follow);
 
 protected:
   void initialize() override;
@@ -135,6 +160,61 @@ private:
       string requestedPath,
       const Option<Principal>& principal);
 
+  // A file opened for reading. Descriptors are cached so that clients
+  // which repeatedly read a file (e.g., to tail a log) do not reopen it
+  // on every request. The descriptor is closed once the file has been
+  // evicted from the cache and all reads using it have completed.
+  struct File
+  {
+    File(const string& _path, int_fd _fd) : path(_path), fd(_fd) {}
+
+    File(const File&) = delete;
+    File& operator=(const File&) = delete;
+
+    ~File() { os::close(fd); }
+
+    // The resolved path of the file.
+    const string path;
+    const int_fd fd;
+
+#ifndef __WINDOWS__
+    // Identifies the file, so that the descriptor is not reused once
+    // the path refers to a different file, e.g., after log rotation.
+    dev_t device;
+    ino_t inode;
+#endif // __WINDOWS__
+  };
+
+  // Opens the file at the virtual path, reusing a cached descriptor
+  // if the path still refers to the same file.
+  Try<shared_ptr<File>, FilesError> open(const string& path);
+
+  // A request waiting for a file to grow, see `follow()`.
+  struct Follower
+  {
+    Follower(
+        const shared_ptr<File>& _file,
+        size_t _offset,
+        const Time& _deadline)
+      : file(_file), offset(_offset), deadline(_deadline) {}
+
+    const shared_ptr<File> file;
+    const size_t offset;
+    const Time deadline;
+    Promise<Nothing> promise;
+  };
+
+  // Returns once the file is larger than `offset`, or once the
+  // timeout has elapsed.
+  Future<Nothing> follow(
+      const shared_ptr<File>& file,
+      size_t offset,
+      const Duration& timeout);
+
+  // Checks the followed files every `FOLLOW_INTERVAL`, so that the
+  // cost of following does not grow with the number of requests.
+  void poll();
+
   // HTTP endpoints.
 
   // Returns a file listing for a directory.
@@ -150,7 +230,8 @@ private:
   Future<Try<tuple<size_t, string>, FilesError>> _read(
       size_t offset,
       Option<size_t> length,
-      const string& path);
+      const string& path,
+      const Option<Duration>& follow);
 
   // Reads data from a file at a given offset and for a given length.
   // See the jquery pailer for the expected behavior.
@@ -158,6 +239,15 @@ private:
       const http::Request& request,
       const Option<Principal>& principal);
 
+  // Returns the requested part of a file as the raw body of the
+  // response, which is streamed from the cached descriptor.
+  Future<http::Response> readRaw(
+      size_t offset,
+      Option<size_t> length,
+      const string& path,
+      const Option<Principal>& principal,
+      const Option<Duration>& follow);
+
   // Returns the raw file contents for a given path.
   // Requests have the following parameters:
   //   path: The directory to browse. Required.
@@ -196,6 +286,13 @@ private:
 
   hashmap<string, string> paths;
 
+  // Open files keyed by their resolved path.
+  Cache<string, shared_ptr<File>> files;
+
+  // Requests waiting for a file to grow. While there are any, `poll()`
+  // is scheduled every `FOLLOW_INTERVAL`.
+  list<Owned<Follower>> followers;
+
   // Set of authorization functions. They will be called whenever
   // access to the path used as key is requested, and will pass
   // as parameter the principal returned by the HTTP authenticator.
@@ -216,6 +313,7 @@ FilesProcess::FilesProcess(
     const Option<string>& _authenticationRealm,
     const Option<Authorizer*>& _authorizer)
   : ProcessBase("files"),
+    files(MAX_CACHED_FILES),
     authenticationRealm(_authenticationRealm),
     authorizer(_authorizer) {}
 
@@ -322,11 +420,46 @@ Future<Nothing> FilesProcess::attach(
 void FilesProcess::detach(const string& virtualPath)
 {
   const string convertedVirtualPath = path::from_uri(virtualPath);
+
+  if (paths.contains(convertedVirtualPath)) {
+    // Paths are detached when they are about to be removed (e.g., when
+    // a sandbox is garbage collected), so the cached descriptors of the
+    // files under it are closed in order not to hold on to the space of
+    // the removed files.
+    const string path = paths[convertedVirtualPath];
+
+    files.erase_if([&path](const string& file) {
+      return file == path ||
+        strings::startsWith(file, path + stringify(os::PATH_SEPARATOR));
+    });
+  }
+
   paths.erase(convertedVirtualPath);
   authorizations.erase(convertedVirtualPath);
 }
 
 
+// Returns the HTTP response for an error of a files operation.
+static http::Response toResponse(const FilesError& error)
+{
+  switch (error.type) {
+    case FilesError::Type::INVALID:
+      return BadRequest(error.message);
+
+    case FilesError::Type::NOT_FOUND:
+      return NotFound(error.message);
+
+    case FilesError::Type::UNAUTHORIZED:
+      return Forbidden(error.message);
+
+    case FilesError::Type::UNKNOWN:
+      return InternalServerError(error.message);
+  }
+
+  UNREACHABLE();
+}
+
+
 const string FilesProcess::BROWSE_HELP = HELP(
     TLDR(
         "Returns a file listing for a directory."),
@@ -394,23 +527,7 @@ Future<http::Response> FilesProcess::_browse(
     .then([jsonp](const Try<list<FileInfo>, FilesError>& result)
       -> Future<http::Response> {
       if (result.isError()) {
-        const FilesError& error = result.error();
-
-        switch (error.type) {
-          case FilesError::Type::INVALID:
-            return BadRequest(error.message);
-
-          case FilesError::Type::NOT_FOUND:
-            return NotFound(error.message);
-
-          case FilesError::Type::UNAUTHORIZED:
-            return Forbidden(error.message);
-
-          case FilesError::Type::UNKNOWN:
-            return InternalServerError(error.message);
-        }
-
-        UNREACHABLE();
+        return toResponse(result.error());
       }
 
       JSON::Array listing;
@@ -481,12 +598,25 @@ const string FilesProcess::READ_HELP = HELP(
         "This endpoint reads data from a file at a given offset and for",
         "a given length."
         "",
+        "By default the data is returned in a JSON object. With",
+        "`format=raw` the data is returned as the body of the response",
+        "instead, and the 'Content-Range' header contains the range",
+        "of the file that was read along with the size of the file.",
+        "",
+        "With `follow=true`, a read at or beyond the end of the file",
+        "waits for the file to grow, for up to `timeout`, and returns",
+        "as soon as there is new data.",
+        "",
         "Query parameters:",
         "",
         ">        path=VALUE          The path of directory to browse.",
         ">        offset=VALUE        Value added to base address to obtain "
         "a second address",
-        ">        length=VALUE        Length of file to read."),
+        ">        length=VALUE        Length of file to read.",
+        ">        format=(json|raw)   Format of the response (default: json).",
+        ">        follow=(true|false) Wait for the file to grow.",
+        ">        timeout=VALUE       How long to wait for the file to grow "
+        "(default: 10secs, at most 1mins)."),
     AUTHENTICATION(true),
     AUTHORIZATION(
         "Reading files requires that the request principal is",
@@ -561,29 +691,41 @@ Future<http::Response> FilesProcess::__read(
     length = 0;
   }
 
-  Option<string> jsonp = request.url.query.get("jsonp");
+  Option<Duration> follow;
+
+  if (request.url.query.get("follow").getOrElse("") == "true" &&
+      offset != -1) {
+    Duration timeout = DEFAULT_FOLLOW_TIMEOUT;
+
+    if (request.url.query.get("timeout").isSome()) {
+      Try<Duration> result =
+        Duration::parse(request.url.query.get("timeout").get());
 
-  return read(offset_, length, path.get(), principal)
-    .then([offset, jsonp](const Try<tuple<size_t, string>, FilesError>& result)
-        -> Future<http::Response> {
       if (result.isError()) {
-        const FilesError& error = result.error();
+        return BadRequest("Failed to parse timeout: " + result.error() + ".\n");
+      }
 
-        switch (error.type) {
-          case FilesError::Type::INVALID:
-            return BadRequest(error.message);
+      timeout = result.get();
+    }
 
-          case FilesError::Type::NOT_FOUND:
-            return NotFound(error.message);
+    follow = std::min(timeout, MAX_FOLLOW_TIMEOUT);
+  }
 
-          case FilesError::Type::UNAUTHORIZED:
-            return Forbidden(error.message);
+  const string format = request.url.query.get("format").getOrElse("json");
 
-          case FilesError::Type::UNKNOWN:
-            return InternalServerError(error.message);
-        }
+  if (format == "raw") {
+    return readRaw(offset_, length, path.get(), principal, follow);
+  } else if (format != "json") {
+    return BadRequest("Unsupported format '" + format + "'.\n");
+  }
 
-        UNREACHABLE();
+  Option<string> jsonp = request.url.query.get("jsonp");
+
+  return read(offset_, length, path.get(), principal, follow)
+    .then([offset, jsonp](const Try<tuple<size_t, string>, FilesError>& result)
+        -> Future<http::Response> {
+      if (result.isError()) {
+        return toResponse(result.error());
       }
 
       const tuple<size_t, string>& contents = result.get();
@@ -601,25 +743,227 @@ Future<Try<tuple<size_t, string>, FilesError>> FilesProcess::read(
     const size_t offset,
     const Option<size_t>& length,
     const string& path,
-    const Option<Principal>& principal)
+    const Option<Principal>& principal,
+    const Option<Duration>& follow)
 {
   const string convertedPath = path::from_uri(path);
   return authorize(convertedPath, principal)
     .then(defer(self(),
-        [this, offset, length, convertedPath](bool authorized)
+        [this, offset, length, convertedPath, follow](bool authorized)
           -> Future<Try<tuple<size_t, string>, FilesError>> {
       if (!authorized) {
         return FilesError(FilesError::Type::UNAUTHORIZED);
       }
 
-      return _read(offset, length, convertedPath);
+      return _read(offset, length, convertedPath, follow);
     }));
 }
 
 
+// Reads up to `length` bytes from the file at the given offset, or up
+// to the end of the file if `length` is none. Returns the size of the
+// file and the data read.
+static Try<tuple<size_t, string>, FilesError> readFile(
+    int_fd fd,
+    const string& path,
+    size_t offset,
+    Option<size_t> length)
+{
+  Try<Bytes> size_ = os::stat::size(fd);
+  if (size_.isError()) {
+    string error = strings::format(
+        "Failed to stat file at '%s': %s",
+        path,
+        size_.error()).get();
+
+    LOG(WARNING) << error;
+    return FilesError(FilesError::Type::UNKNOWN, error + ".\n");
+  }
+
+  const size_t size = static_cast<size_t>(size_->bytes());
+
+  if (offset >= size) {
+    return std::make_tuple(size, "");
+  }
+
+  if (length.isNone()) {
+    length = size - offset;
+  }
+
+  // Return the size of file if length is 0.
+  if (length == 0) {
+    return std::make_tuple(size, "");
+  }
+
+  // Cap the read length at 16 pages.
+  length = std::min(length.get(), os::pagesize() * 16);
+
+#ifdef __WINDOWS__
+  // Seek to the offset we want to read from. Descriptors are not
+  // shared between reads on Windows, see `FilesProcess::open()`.
+  Try<off_t> lseek = os::lseek(fd, static_cast<off_t>(offset), SEEK_SET);
+  if (lseek.isError()) {
+    string error = strings::format(
+        "Failed to seek file at '%s': %s",
+        path,
+        lseek.error()).get();
+
+    LOG(WARNING) << error;
+    return FilesError(FilesError::Type::UNKNOWN, error);
+  }
+#endif // __WINDOWS__
+
+  // NOTE: Positional reads are used so that concurrent reads can share
+  // a cached descriptor.
+  string data(length.get(), '\0');
+  size_t total = 0;
+
+  while (total < length.get()) {
+#ifdef __WINDOWS__
+    ssize_t n = os::read(fd, &data[total], length.get() - total);
+#else
+    ssize_t n = ::pread(
+        fd,
+        &data[total],
+        length.get() - total,
+        static_cast<off_t>(offset + total));
+#endif // __WINDOWS__
+
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+
+      string error = strings::format(
+          "Failed to read file at '%s': %s",
+          path,
+          os::strerror(errno)).get();
+
+      LOG(WARNING) << error;
+      return FilesError(FilesError::Type::UNKNOWN, error);
+    }
+
+    if (n == 0) {
+      break;
+    }
+
+    total += static_cast<size_t>(n);
+  }
+
+  data.resize(total);
+
+  return std::make_tuple(size, data);
+}
+
+
 Future<Try<tuple<size_t, string>, FilesError>> FilesProcess::_read(
     size_t offset,
     Option<size_t> length,
+    const string& path,
+    const Option<Duration>& follow)
+{
+  Try<shared_ptr<File>, FilesError> file = open(path);
+  if (file.isError()) {
+    return file.error();
+  }
+
+  Future<Nothing> ready = Nothing();
+
+  if (follow.isSome()) {
+    ready = this->follow(file.get(), offset, follow.get());
+  }
+
+  const shared_ptr<File> file_ = file.get();
+
+  // The data is read on another thread since reading from a regular
+  // file blocks (e.g., on a cold page cache) even though its descriptor
+  // always polls as readable.
+  return ready
+    .then([file_, offset, length]() {
+      return process::async([file_, offset, length]() {
+        return readFile(file_->fd, file_->path, offset, length);
+      });
+    });
+}
+
+
+Future<http::Response> FilesProcess::readRaw(
+    size_t offset,
+    Option<size_t> length,
+    const string& path,
+    const Option<Principal>& principal,
+    const Option<Duration>& follow)
+{
+  const string convertedPath = path::from_uri(path);
+
+  return authorize(convertedPath, principal)
+    .then(defer(self(),
+        [this, offset, length, convertedPath, follow](bool authorized)
+          -> Future<http::Response> {
+      if (!authorized) {
+        return Forbidden();
+      }
+
+      Try<shared_ptr<File>, FilesError> file = open(convertedPath);
+      if (file.isError()) {
+        return toResponse(file.error());
+      }
+
+      Future<Nothing> ready = Nothing();
+
+      if (follow.isSome()) {
+        ready = this->follow(file.get(), offset, follow.get());
+      }
+
+      const shared_ptr<File> file_ = file.get();
+
+      return ready
+        .then([file_, offset, length]() -> Future<http::Response> {
+          Try<Bytes> size_ = os::stat::size(file_->fd);
+          if (size_.isError()) {
+            return InternalServerError(
+                "Failed to stat file at '" + file_->path + "': " +
+                size_.error() + ".\n");
+          }
+
+          const size_t size = static_cast<size_t>(size_->bytes());
+
+          OK response;
+          response.headers["Content-Type"] = "application/octet-stream";
+
+          if (offset >= size || length == 0) {
+            // Like the JSON format, this allows for determining the
+            // size of the file.
+            response.headers["Content-Range"] = "bytes */" + stringify(size);
+            return response;
+          }
+
+          // Unlike the JSON format the read is not capped, since the
+          // data is sent straight from the file with `sendfile` without
+          // copying it through the process.
+          const size_t end = length.isSome()
+            ? offset + std::min(length.get(), size - offset)
+            : size;
+
+          // NOTE: The file is sent by its path since the response is
+          // sent after the descriptor might have been closed. The range
+          // is truncated to the size of the file at the time it is sent,
+          // so if the file is truncated (or rotated) in the meantime,
+          // less data is sent.
+          response.type = response.PATH;
+          response.path = file_->path;
+          response.range = http::Response::Range{offset, end - offset};
+          response.headers["Content-Range"] =
+            "bytes " + stringify(offset) + "-" + stringify(end - 1) + "/" +
+            stringify(size);
+
+          return response;
+        });
+    }));
+}
+
+
+Try<shared_ptr<FilesProcess::File>, FilesError> FilesProcess::open(
     const string& path)
 {
   Result<string> resolvedPath = resolve(path);
@@ -635,8 +979,21 @@ Future<Try<tuple<size_t, string>, FilesError>> FilesProcess::_read(
     return FilesError(FilesError::Type::INVALID, "Cannot read a directory.\n");
   }
 
-  // TODO(benh): Cache file descriptors so we aren't constantly
-  // opening them and paging the data in from disk.
+#ifndef __WINDOWS__
+  Option<shared_ptr<File>> cached = files.get(resolvedPath.get());
+
+  if (cached.isSome()) {
+    struct stat s;
+    if (::stat(resolvedPath->c_str(), &s) == 0 &&
+        s.st_dev == cached.get()->device &&
+        s.st_ino == cached.get()->inode) {
+      return cached.get();
+    }
+
+    files.erase(resolvedPath.get());
+  }
+#endif // __WINDOWS__
+
   Try<int_fd> fd = os::open(resolvedPath.get(), O_RDONLY | O_CLOEXEC);
   if (fd.isError()) {
     string error = strings::format(
@@ -647,69 +1004,95 @@ Future<Try<tuple<size_t, string>, FilesError>> FilesProcess::_read(
     return FilesError(FilesError::Type::UNKNOWN, error + ".\n");
   }
 
-  Try<off_t> lseek = os::lseek(fd.get(), 0, SEEK_END);
-  if (lseek.isError()) {
+  shared_ptr<File> file(new File(resolvedPath.get(), fd.get()));
+
+#ifndef __WINDOWS__
+  struct stat s;
+  if (::fstat(file->fd, &s) < 0) {
     string error = strings::format(
-        "Failed to open file at '%s': %s",
+        "Failed to stat file at '%s': %s",
         resolvedPath.get(),
         os::strerror(errno)).get();
-
     LOG(WARNING) << error;
-    os::close(fd.get());
     return FilesError(FilesError::Type::UNKNOWN, error + ".\n");
   }
 
-  const off_t size = lseek.get();
+  file->device = s.st_dev;
+  file->inode = s.st_ino;
 
-  if (offset >= static_cast<size_t>(size)) {
-    os::close(fd.get());
-    return std::make_tuple(size, "");
-  }
+  files.put(resolvedPath.get(), file);
+#endif // __WINDOWS__
 
-  if (length.isNone()) {
-    length = size - offset;
-  }
+  return file;
+}
 
-  // Return the size of file if length is 0.
-  if (length == 0) {
-    os::close(fd.get());
-    return std::make_tuple(size, "");
+
+Future<Nothing> FilesProcess::follow(
+    const shared_ptr<File>& file,
+    size_t offset,
+    const Duration& timeout)
+{
+  // A failure to stat the file is reported by the read.
+  Try<Bytes> size = os::stat::size(file->fd);
+  if (size.isError() || size->bytes() > offset) {
+    return Nothing();
   }
 
-  // Cap the read length at 16 pages.
-  length = std::min(length.get(), os::pagesize() * 16);
+  Owned<Follower> follower(
+      new Follower(file, offset, Clock::now() + timeout));
 
-  // Seek to the offset we want to read from.
-  lseek = os::lseek(fd.get(), static_cast<off_t>(offset), SEEK_SET);
-  if (lseek.isError()) {
-    string error = strings::format(
-        "Failed to seek file at '%s': %s",
-        resolvedPath.get(),
-        os::strerror(errno)).get();
+  followers.push_back(follower);
 
-    LOG(WARNING) << error;
-    os::close(fd.get());
-    return FilesError(FilesError::Type::UNKNOWN, error);
+  if (followers.size() == 1) {
+    delay(FOLLOW_INTERVAL, self(), &FilesProcess::poll);
   }
 
-  Try<Nothing> async = io::prepare_async(fd.get());
-  if (async.isError()) {
-    string error =
-        "Failed to make file descriptor asynchronous: " + async.error();
-    LOG(WARNING) << error;
-    os::close(fd.get());
-    return FilesError(FilesError::Type::UNKNOWN, error);
-  }
+  return follower->promise.future();
+}
+
+
+void FilesProcess::poll()
+{
+  const Time now = Clock::now();
+
+  // The size of each followed file, which is checked once no matter
+  // how many requests follow it. None if the file could not be stat'ed.
+  hashmap<const File*, Option<Bytes>> sizes;
 
-  // Read 'length' bytes (or to EOF).
-  boost::shared_array<char> data(new char[length.get()]);
+  auto it = followers.begin();
+  while (it != followers.end()) {
+    Follower* follower = it->get();
 
-  return io::read(fd.get(), data.get(), length.get())
-    .then([size, data](const size_t dataLength)
-        -> Try<tuple<size_t, string>, FilesError> {
-      return std::make_tuple(size, string(data.get(), dataLength));
-    })
-    .onAny([fd]() { os::close(fd.get()); });
+    if (follower->promise.future().hasDiscard()) {
+      follower->promise.discard();
+      it = followers.erase(it);
+      continue;
+    }
+
+    const File* file = follower->file.get();
+
+    if (!sizes.contains(file)) {
+      Try<Bytes> size = os::stat::size(file->fd);
+      sizes[file] = size.isSome() ? Option<Bytes>(size.get()) : None();
+    }
+
+    // A failure to stat the file is reported by the read.
+    const Option<Bytes>& size = sizes.at(file);
+
+    if (size.isNone() ||
+        size->bytes() > follower->offset ||
+        now >= follower->deadline) {
+      follower->promise.set(Nothing());
+      it = followers.erase(it);
+      continue;
+    }
+
+    ++it;
+  }
+
+  if (!followers.empty()) {
+    delay(FOLLOW_INTERVAL, self(), &FilesProcess::poll);
+  }
 }
 
 
@@ -957,7 +1340,8 @@ Future<Try<tuple<size_t, string>, FilesError>> Files::read(
                   offset,
                   length,
                   path,
-                  principal);
+                  principal,
+                  None());
 }
 
 } // namespace internal {
@@ -684,6 +684,14 @@ void V0ToV1AdapterProcess::send(SchedulerDriver* driver, const Call& _call)
       break;
     }
 
+    // The driver has no batched calls, so the calls are sent one by one.
+    case scheduler::Call::BATCH: {
+      foreach (const Call& __call, _call.batch().calls()) {
+        send(driver, __call);
+      }
+      break;
+    }
+
     case scheduler::Call::UNKNOWN: {
       EXIT(EXIT_FAILURE) << "Received an unexpected " << call.type()
                          << " call";
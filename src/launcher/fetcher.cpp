@@ -14,13 +14,20 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include <process/owned.hpp>
 #include <process/subprocess.hpp>
 
 #include <stout/archiver.hpp>
+#include <stout/hashmap.hpp>
+#include <stout/hashset.hpp>
 #include <stout/json.hpp>
 #include <stout/net.hpp>
 #include <stout/option.hpp>
@@ -52,6 +59,7 @@ using namespace process;
 using namespace mesos;
 using namespace mesos::internal;
 
+using std::pair;
 using std::string;
 using std::vector;
 
@@ -260,6 +268,64 @@ static Try<string> download(
 }
 
 
+// Downloads each URI to its destination path using up to `parallelism`
+// threads. Returns the first error, after all started downloads have
+// finished.
+static Try<Nothing> download(
+    const vector<pair<string, string>>& downloads,
+    size_t parallelism,
+    const Option<string>& frameworksHome,
+    const Option<Duration>& stallTimeout)
+{
+  std::atomic<size_t> next(0);
+  std::mutex mutex;
+  Option<Error> error;
+
+  auto worker = [&]() {
+    for (size_t i = next++; i < downloads.size(); i = next++) {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (error.isSome()) {
+          return;
+        }
+      }
+
+      Try<string> downloaded = download(
+          downloads[i].first,
+          downloads[i].second,
+          frameworksHome,
+          stallTimeout);
+
+      if (downloaded.isError()) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (error.isNone()) {
+          error = Error(
+              "Failed to fetch '" + downloads[i].first + "': " +
+              downloaded.error());
+        }
+      }
+    }
+  };
+
+  vector<std::thread> threads;
+  for (size_t i = 1; i < std::min(parallelism, downloads.size()); i++) {
+    threads.emplace_back(worker);
+  }
+
+  worker();
+
+  foreach (std::thread& thread, threads) {
+    thread.join();
+  }
+
+  if (error.isSome()) {
+    return error.get();
+  }
+
+  return Nothing();
+}
+
+
 // TODO(bernd-mesos): Refactor this into stout so that we can more easily
 // chmod an executable. For example, we could define some static flags
 // so that someone can do: os::chmod(path, EXECUTABLE_CHMOD_FLAGS).
@@ -285,7 +351,8 @@ static Try<string> fetchBypassingCache(
     const CommandInfo::URI& uri,
     const string& sandboxDirectory,
     const Option<string>& frameworksHome,
-    const Option<Duration>& stallTimeout)
+    const Option<Duration>& stallTimeout,
+    const Option<string>& downloadedPath)
 {
   LOG(INFO) << "Fetching '" << uri.value()
             << "' directly into the sandbox directory";
@@ -316,10 +383,22 @@ static Try<string> fetchBypassingCache(
 
   string path = path::join(sandboxDirectory, outputFile.get());
 
-  Try<string> downloaded =
-    download(uri.value(), path, frameworksHome, stallTimeout);
-  if (downloaded.isError()) {
-    return Error(downloaded.error());
+  Try<string> downloaded = path;
+
+  // The URI might have already been downloaded concurrently with the
+  // other URIs, see `main()`.
+  if (downloadedPath.isSome()) {
+    Try<Nothing> rename = os::rename(downloadedPath.get(), path);
+    if (rename.isError()) {
+      return Error(
+          "Failed to move '" + downloadedPath.get() + "' to '" + path +
+          "': " + rename.error());
+    }
+  } else {
+    downloaded = download(uri.value(), path, frameworksHome, stallTimeout);
+    if (downloaded.isError()) {
+      return Error(downloaded.error());
+    }
   }
 
   if (uri.executable()) {
@@ -344,7 +423,8 @@ static Try<string> fetchBypassingCache(
 static Try<string> fetchFromCache(
     const FetcherInfo::Item& item,
     const string& cacheDirectory,
-    const string& sandboxDirectory)
+    const string& sandboxDirectory,
+    bool linkCacheFiles)
 {
   LOG(INFO) << "Fetching URI '" << item.uri().value() << "' from cache";
 
@@ -397,6 +477,33 @@ static Try<string> fetchFromCache(
     }
   }
 
+#ifndef __WINDOWS__
+  // Executables are always copied, as changing the mode of a hard link
+  // would change the mode of the cache file.
+  if (linkCacheFiles) {
+    // The cache file is made read-only, so that a task can not modify
+    // the cache file (and the files of other tasks) by accident.
+    Try<Nothing> chmod =
+      os::chmod(sourcePath, S_IRUSR | S_IRGRP | S_IROTH);
+
+    if (chmod.isError()) {
+      LOG(WARNING) << "Failed to chmod cache file '" << sourcePath
+                   << "': " << chmod.error();
+    } else {
+      if (os::exists(destinationPath)) {
+        os::rm(destinationPath);
+      }
+
+      if (::link(sourcePath.c_str(), destinationPath.c_str()) == 0) {
+        return destinationPath;
+      }
+
+      LOG(WARNING) << "Copying instead of linking cache file '" << sourcePath
+                   << "': " << os::strerror(errno);
+    }
+  }
+#endif // __WINDOWS__
+
   return copyFile(sourcePath, destinationPath);
 }
 
@@ -408,7 +515,8 @@ static Try<string> fetchThroughCache(
     const Option<string>& cacheDirectory,
     const string& sandboxDirectory,
     const Option<string>& frameworksHome,
-    const Option<Duration>& stallTimeout)
+    const Option<Duration>& stallTimeout,
+    bool linkCacheFiles)
 {
   if (cacheDirectory.isNone() || cacheDirectory->empty()) {
     return Error("Cache directory not specified");
@@ -443,7 +551,8 @@ static Try<string> fetchThroughCache(
     }
   }
 
-  return fetchFromCache(item, cacheDirectory.get(), sandboxDirectory);
+  return fetchFromCache(
+      item, cacheDirectory.get(), sandboxDirectory, linkCacheFiles);
 }
 
 
@@ -454,7 +563,9 @@ static Try<string> fetch(
     const Option<string>& cacheDirectory,
     const string& sandboxDirectory,
     const Option<string>& frameworksHome,
-    const Option<Duration>& stallTimeout)
+    const Option<Duration>& stallTimeout,
+    bool linkCacheFiles,
+    const Option<string>& downloadedPath)
 {
   LOG(INFO) << "Fetching URI '" << item.uri().value() << "'";
 
@@ -463,7 +574,8 @@ static Try<string> fetch(
         item.uri(),
         sandboxDirectory,
         frameworksHome,
-        stallTimeout);
+        stallTimeout,
+        downloadedPath);
   }
 
   return fetchThroughCache(
@@ -471,7 +583,8 @@ static Try<string> fetch(
       cacheDirectory,
       sandboxDirectory,
       frameworksHome,
-      stallTimeout);
+      stallTimeout,
+      linkCacheFiles);
 }
 
 
@@ -607,11 +720,95 @@ int main(int argc, char* argv[])
       ? Nanoseconds(fetcherInfo->stall_timeout().nanoseconds())
       : Option<Duration>::none();
 
+  const size_t parallelism =
+    std::max(fetcherInfo->parallelism(), static_cast<uint32_t>(1));
+
+  // The URIs which need to be downloaded are downloaded concurrently
+  // first. Downloads which bypass the cache go to a staging directory
+  // in the sandbox and are only moved into place below, so that the
+  // items are copied, extracted or overwrite each other in the same
+  // order as if they had been fetched one by one.
+  Option<string> stagingDirectory;
+  hashmap<int, string> downloaded;
+
+  // NOTE: The staging directory is also removed before exiting on a
+  // failure, since it is not removed along with the sandbox until the
+  // container is garbage collected.
+  auto removeStagingDirectory = [&stagingDirectory]() {
+    if (stagingDirectory.isSome()) {
+      Try<Nothing> rmdir = os::rmdir(stagingDirectory.get());
+      if (rmdir.isError()) {
+        LOG(WARNING) << "Failed to remove staging directory '"
+                     << stagingDirectory.get() << "': " << rmdir.error();
+      }
+    }
+  };
+
+  if (parallelism > 1) {
+    vector<pair<string, string>> downloads;
+
+    // The paths which are downloaded to. Items with the same URI may
+    // share a cache file (see `FetcherProcess::fetch()`), which must
+    // only be downloaded once.
+    hashset<string> paths;
+
+    for (int i = 0; i < fetcherInfo->items_size(); i++) {
+      const FetcherInfo::Item& item = fetcherInfo->items(i);
+
+      if (item.action() == FetcherInfo::Item::DOWNLOAD_AND_CACHE &&
+          cacheDirectory.isSome() &&
+          !item.cache_filename().empty()) {
+        const string path =
+          path::join(cacheDirectory.get(), item.cache_filename());
+
+        if (!os::exists(path) && !paths.contains(path)) {
+          downloads.emplace_back(item.uri().value(), path);
+          paths.insert(path);
+        }
+      } else if (item.action() == FetcherInfo::Item::BYPASS_CACHE) {
+        if (stagingDirectory.isNone()) {
+          Try<string> mkdtemp =
+            os::mkdtemp(path::join(sandboxDirectory, ".fetcher.XXXXXX"));
+
+          if (mkdtemp.isError()) {
+            EXIT(EXIT_FAILURE)
+              << "Failed to create staging directory: " << mkdtemp.error();
+          }
+
+          stagingDirectory = mkdtemp.get();
+        }
+
+        const string path = path::join(stagingDirectory.get(), stringify(i));
+
+        downloads.emplace_back(item.uri().value(), path);
+        downloaded[i] = path;
+      }
+    }
+
+    Try<Nothing> download =
+      ::download(downloads, parallelism, frameworksHome, stallTimeout);
+
+    if (download.isError()) {
+      removeStagingDirectory();
+      EXIT(EXIT_FAILURE) << download.error();
+    }
+  }
+
   // Fetch each URI to a local file and chmod if necessary.
-  foreach (const FetcherInfo::Item& item, fetcherInfo->items()) {
+  for (int i = 0; i < fetcherInfo->items_size(); i++) {
+    const FetcherInfo::Item& item = fetcherInfo->items(i);
+
     Try<string> fetched = fetch(
-        item, cacheDirectory, sandboxDirectory, frameworksHome, stallTimeout);
+        item,
+        cacheDirectory,
+        sandboxDirectory,
+        frameworksHome,
+        stallTimeout,
+        fetcherInfo->link_cache_files(),
+        downloaded.get(i));
+
     if (fetched.isError()) {
+      removeStagingDirectory();
       EXIT(EXIT_FAILURE)
         << "Failed to fetch '" << item.uri().value() << "': " + fetched.error();
     } else {
@@ -620,6 +817,8 @@ int main(int argc, char* argv[])
     }
   }
 
+  removeStagingDirectory();
+
   LOG(INFO) << "Successfully fetched all URIs into "
             << "'" << sandboxDirectory << "'";
 
@@ -0,0 +1,534 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "linux/cgroups2.hpp"
+
+#include <signal.h>
+
+#include <vector>
+
+#include <stout/error.hpp>
+#include <stout/foreach.hpp>
+#include <stout/numify.hpp>
+#include <stout/os.hpp>
+#include <stout/path.hpp>
+#include <stout/stringify.hpp>
+#include <stout/strings.hpp>
+
+#include "linux/fs.hpp"
+
+using namespace mesos::internal;
+
+using std::set;
+using std::string;
+using std::vector;
+
+namespace cgroups2 {
+
+bool enabled()
+{
+  Try<string> filesystems = os::read("/proc/filesystems");
+  if (filesystems.isError()) {
+    return false;
+  }
+
+  foreach (const string& line, strings::tokenize(filesystems.get(), "\n")) {
+    vector<string> tokens = strings::tokenize(line, " \t");
+    if (!tokens.empty() && tokens.back() == FILE_SYSTEM) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+
+Try<bool> mounted(const string& root)
+{
+  Try<fs::MountInfoTable> table = fs::MountInfoTable::read();
+  if (table.isError()) {
+    return Error("Failed to read mount table: " + table.error());
+  }
+
+  foreach (const fs::MountInfoTable::Entry& entry, table->entries) {
+    if (entry.type == FILE_SYSTEM && entry.target == root) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+
+Try<set<string>> controllers(const string& root, const string& cgroup)
+{
+  Try<string> content = read(root, cgroup, "cgroup.controllers");
+  if (content.isError()) {
+    return Error(content.error());
+  }
+
+  set<string> result;
+  foreach (const string& controller,
+           strings::tokenize(content.get(), " \n")) {
+    result.insert(controller);
+  }
+
+  return result;
+}
+
+
+Try<Nothing> enable(
+    const string& root,
+    const string& cgroup,
+    const set<string>& controllers)
+{
+  vector<string> values;
+  foreach (const string& controller, controllers) {
+    values.push_back("+" + controller);
+  }
+
+  return write(
+      root,
+      cgroup,
+      "cgroup.subtree_control",
+      strings::join(" ", values));
+}
+
+
+Try<Nothing> create(const string& root, const string& cgroup)
+{
+  return os::mkdir(path::join(root, cgroup));
+}
+
+
+Try<Nothing> remove(const string& root, const string& cgroup)
+{
+  // NOTE: A cgroup directory only contains (virtual) control files
+  // which can not be removed, so we must not remove it recursively.
+  return os::rmdir(path::join(root, cgroup), false);
+}
+
+
+bool exists(const string& root, const string& cgroup)
+{
+  return os::exists(path::join(root, cgroup));
+}
+
+
+Try<Nothing> assign(const string& root, const string& cgroup, pid_t pid)
+{
+  return write(root, cgroup, "cgroup.procs", stringify(pid));
+}
+
+
+Try<set<pid_t>> processes(const string& root, const string& cgroup)
+{
+  Try<string> content = read(root, cgroup, "cgroup.procs");
+  if (content.isError()) {
+    return Error(content.error());
+  }
+
+  set<pid_t> pids;
+  foreach (const string& line, strings::tokenize(content.get(), "\n")) {
+    Try<pid_t> pid = numify<pid_t>(strings::trim(line));
+    if (pid.isError()) {
+      return Error("Failed to parse '" + line + "': " + pid.error());
+    }
+
+    pids.insert(pid.get());
+  }
+
+  return pids;
+}
+
+
+Try<Nothing> kill(const string& root, const string& cgroup)
+{
+  if (os::exists(path::join(root, cgroup, "cgroup.kill"))) {
+    return write(root, cgroup, "cgroup.kill", "1");
+  }
+
+  Try<set<pid_t>> pids = processes(root, cgroup);
+  if (pids.isError()) {
+    return Error(pids.error());
+  }
+
+  foreach (pid_t pid, pids.get()) {
+    if (::kill(pid, SIGKILL) == -1 && errno != ESRCH) {
+      return ErrnoError("Failed to kill process " + stringify(pid));
+    }
+  }
+
+  return Nothing();
+}
+
+
+Try<string> read(
+    const string& root,
+    const string& cgroup,
+    const string& control)
+{
+  return os::read(path::join(root, cgroup, control));
+}
+
+
+Try<Nothing> write(
+    const string& root,
+    const string& cgroup,
+    const string& control,
+    const string& value)
+{
+  return os::write(path::join(root, cgroup, control), value);
+}
+
+
+Try<hashmap<string, uint64_t>> parseFlatKeyed(const string& content)
+{
+  hashmap<string, uint64_t> result;
+
+  foreach (const string& line, strings::tokenize(content, "\n")) {
+    vector<string> tokens = strings::tokenize(line, " ");
+    if (tokens.size() != 2) {
+      return Error("Invalid line '" + line + "'");
+    }
+
+    Try<uint64_t> value = numify<uint64_t>(tokens[1]);
+    if (value.isError()) {
+      return Error(
+          "Failed to parse value of '" + tokens[0] + "': " + value.error());
+    }
+
+    result.put(tokens[0], value.get());
+  }
+
+  return result;
+}
+
+
+namespace cpu {
+
+Try<Nothing> weight(const string& root, const string& cgroup, uint64_t weight)
+{
+  return write(root, cgroup, "cpu.weight", stringify(weight));
+}
+
+
+Try<Nothing> max(
+    const string& root,
+    const string& cgroup,
+    const Option<Duration>& quota,
+    const Duration& period)
+{
+  const string max = quota.isSome()
+    ? stringify(static_cast<uint64_t>(quota->us()))
+    : "max";
+
+  return write(
+      root,
+      cgroup,
+      "cpu.max",
+      max + " " + stringify(static_cast<uint64_t>(period.us())));
+}
+
+
+Try<Stats> stat(const string& root, const string& cgroup)
+{
+  Try<string> content = read(root, cgroup, "cpu.stat");
+  if (content.isError()) {
+    return Error(content.error());
+  }
+
+  Try<hashmap<string, uint64_t>> values = parseFlatKeyed(content.get());
+  if (values.isError()) {
+    return Error("Failed to parse 'cpu.stat': " + values.error());
+  }
+
+  Stats stats;
+  stats.usage = Microseconds(values->get("usage_usec").getOrElse(0));
+  stats.user = Microseconds(values->get("user_usec").getOrElse(0));
+  stats.system = Microseconds(values->get("system_usec").getOrElse(0));
+
+  stats.periods = values->get("nr_periods");
+  stats.throttled = values->get("nr_throttled");
+
+  if (values->contains("throttled_usec")) {
+    stats.throttledTime = Microseconds(values->at("throttled_usec"));
+  }
+
+  return stats;
+}
+
+} // namespace cpu {
+
+
+namespace memory {
+
+static Try<Nothing> limit(
+    const string& root,
+    const string& cgroup,
+    const string& control,
+    const Option<Bytes>& limit)
+{
+  return write(
+      root,
+      cgroup,
+      control,
+      limit.isSome() ? stringify(limit->bytes()) : "max");
+}
+
+
+Try<Nothing> max(
+    const string& root,
+    const string& cgroup,
+    const Option<Bytes>& limit)
+{
+  return memory::limit(root, cgroup, "memory.max", limit);
+}
+
+
+Try<Nothing> high(
+    const string& root,
+    const string& cgroup,
+    const Option<Bytes>& limit)
+{
+  return memory::limit(root, cgroup, "memory.high", limit);
+}
+
+
+Try<Bytes> current(const string& root, const string& cgroup)
+{
+  Try<string> content = read(root, cgroup, "memory.current");
+  if (content.isError()) {
+    return Error(content.error());
+  }
+
+  Try<uint64_t> value = numify<uint64_t>(strings::trim(content.get()));
+  if (value.isError()) {
+    return Error("Failed to parse 'memory.current': " + value.error());
+  }
+
+  return Bytes(value.get());
+}
+
+
+Try<Option<Bytes>> max(const string& root, const string& cgroup)
+{
+  Try<string> content = read(root, cgroup, "memory.max");
+  if (content.isError()) {
+    return Error(content.error());
+  }
+
+  const string value = strings::trim(content.get());
+  if (value == "max") {
+    return None();
+  }
+
+  Try<uint64_t> bytes = numify<uint64_t>(value);
+  if (bytes.isError()) {
+    return Error("Failed to parse 'memory.max': " + bytes.error());
+  }
+
+  return Bytes(bytes.get());
+}
+
+
+Try<hashmap<string, uint64_t>> stat(const string& root, const string& cgroup)
+{
+  Try<string> content = read(root, cgroup, "memory.stat");
+  if (content.isError()) {
+    return Error(content.error());
+  }
+
+  Try<hashmap<string, uint64_t>> values = parseFlatKeyed(content.get());
+  if (values.isError()) {
+    return Error("Failed to parse 'memory.stat': " + values.error());
+  }
+
+  return values.get();
+}
+
+} // namespace memory {
+
+
+namespace io {
+
+Try<hashmap<string, Stats>> parseStat(const string& content)
+{
+  hashmap<string, Stats> result;
+
+  foreach (const string& line, strings::tokenize(content, "\n")) {
+    vector<string> tokens = strings::tokenize(line, " ");
+    if (tokens.empty()) {
+      continue;
+    }
+
+    Stats stats;
+
+    for (size_t i = 1; i < tokens.size(); i++) {
+      vector<string> pair = strings::split(tokens[i], "=");
+      if (pair.size() != 2) {
+        return Error("Invalid entry '" + tokens[i] + "' in '" + line + "'");
+      }
+
+      // Newer kernels append keys with non-integer values for some
+      // IO controllers (e.g., "cost.vrate=100.00" for `io.cost`),
+      // hence only the keys we know about are parsed.
+      const string& key = pair[0];
+      if (key != "rbytes" && key != "wbytes" && key != "rios" &&
+          key != "wios" && key != "dbytes" && key != "dios") {
+        continue;
+      }
+
+      Try<uint64_t> value = numify<uint64_t>(pair[1]);
+      if (value.isError()) {
+        return Error(
+            "Failed to parse value of '" + key + "': " + value.error());
+      }
+
+      if (key == "rbytes") {
+        stats.rbytes = value.get();
+      } else if (key == "wbytes") {
+        stats.wbytes = value.get();
+      } else if (key == "rios") {
+        stats.rios = value.get();
+      } else if (key == "wios") {
+        stats.wios = value.get();
+      } else if (key == "dbytes") {
+        stats.dbytes = value.get();
+      } else if (key == "dios") {
+        stats.dios = value.get();
+      }
+    }
+
+    result.put(tokens[0], stats);
+  }
+
+  return result;
+}
+
+
+Try<hashmap<string, Stats>> stat(const string& root, const string& cgroup)
+{
+  Try<string> content = read(root, cgroup, "io.stat");
+  if (content.isError()) {
+    return Error(content.error());
+  }
+
+  Try<hashmap<string, Stats>> stats = parseStat(content.get());
+  if (stats.isError()) {
+    return Error("Failed to parse 'io.stat': " + stats.error());
+  }
+
+  return stats.get();
+}
+
+} // namespace io {
+
+
+namespace pressure {
+
+static Try<Stall> parseStall(const vector<string>& tokens)
+{
+  Stall stall;
+
+  for (size_t i = 1; i < tokens.size(); i++) {
+    vector<string> pair = strings::split(tokens[i], "=");
+    if (pair.size() != 2) {
+      return Error("Invalid entry '" + tokens[i] + "'");
+    }
+
+    if (pair[0] == "total") {
+      Try<uint64_t> total = numify<uint64_t>(pair[1]);
+      if (total.isError()) {
+        return Error("Failed to parse 'total': " + total.error());
+      }
+
+      stall.total = Microseconds(total.get());
+      continue;
+    }
+
+    Try<double> average = numify<double>(pair[1]);
+    if (average.isError()) {
+      return Error(
+          "Failed to parse '" + pair[0] + "': " + average.error());
+    }
+
+    if (pair[0] == "avg10") {
+      stall.avg10 = average.get();
+    } else if (pair[0] == "avg60") {
+      stall.avg60 = average.get();
+    } else if (pair[0] == "avg300") {
+      stall.avg300 = average.get();
+    }
+  }
+
+  return stall;
+}
+
+
+Try<Pressure> parse(const string& content)
+{
+  Option<Stall> some;
+  Option<Stall> full;
+
+  foreach (const string& line, strings::tokenize(content, "\n")) {
+    vector<string> tokens = strings::tokenize(line, " ");
+    if (tokens.empty()) {
+      continue;
+    }
+
+    Try<Stall> stall = parseStall(tokens);
+    if (stall.isError()) {
+      return Error("Failed to parse '" + line + "': " + stall.error());
+    }
+
+    if (tokens[0] == "some") {
+      some = stall.get();
+    } else if (tokens[0] == "full") {
+      full = stall.get();
+    } else {
+      return Error("Unknown stall type '" + tokens[0] + "'");
+    }
+  }
+
+  if (some.isNone()) {
+    return Error("Missing 'some' stall information");
+  }
+
+  Pressure pressure;
+  pressure.some = some.get();
+  pressure.full = full;
+
+  return pressure;
+}
+
+
+Try<Pressure> read(
+    const string& root,
+    const string& cgroup,
+    const string& controller)
+{
+  Try<string> content = cgroups2::read(root, cgroup, controller + ".pressure");
+  if (content.isError()) {
+    return Error(content.error());
+  }
+
+  return parse(content.get());
+}
+
+} // namespace pressure {
+
+} // namespace cgroups2 {
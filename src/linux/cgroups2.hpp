@@ -0,0 +1,269 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __CGROUPS2_HPP__
+#define __CGROUPS2_HPP__
+
+#include <stdint.h>
+
+#include <set>
+#include <string>
+
+#include <sys/types.h>
+
+#include <stout/bytes.hpp>
+#include <stout/duration.hpp>
+#include <stout/hashmap.hpp>
+#include <stout/nothing.hpp>
+#include <stout/option.hpp>
+#include <stout/try.hpp>
+
+// Utilities for the cgroups v2 "unified" hierarchy, see
+// <kernel-source>/Documentation/admin-guide/cgroup-v2.rst.
+//
+// Unlike cgroups v1 (see linux/cgroups.hpp) there is a single
+// hierarchy in which every cgroup can enable any of the controllers
+// enabled in its parent's `cgroup.subtree_control`. Each controller
+// exposes a single flat-keyed or nested-keyed statistics file (e.g.,
+// `cpu.stat`, `memory.stat` and `io.stat`) and, on kernels built with
+// CONFIG_PSI, a pressure stall information file (`<controller>.pressure`).
+namespace cgroups2 {
+
+// The default mount point of the unified hierarchy.
+const std::string ROOT = "/sys/fs/cgroup";
+
+// The file system type of the unified hierarchy.
+const std::string FILE_SYSTEM = "cgroup2";
+
+
+// Returns true if the kernel supports the unified hierarchy.
+bool enabled();
+
+
+// Returns true if the unified hierarchy is mounted at `root`.
+Try<bool> mounted(const std::string& root = ROOT);
+
+
+// Returns the controllers available to the cgroup (i.e., the contents
+// of `cgroup.controllers`).
+Try<std::set<std::string>> controllers(
+    const std::string& root,
+    const std::string& cgroup);
+
+
+// Enables the controllers for the children of the cgroup by writing
+// them into its `cgroup.subtree_control`.
+Try<Nothing> enable(
+    const std::string& root,
+    const std::string& cgroup,
+    const std::set<std::string>& controllers);
+
+
+// Creates the cgroup (and any missing parents).
+Try<Nothing> create(const std::string& root, const std::string& cgroup);
+
+
+// Removes the (empty) cgroup.
+Try<Nothing> remove(const std::string& root, const std::string& cgroup);
+
+
+// Returns true if the cgroup exists.
+bool exists(const std::string& root, const std::string& cgroup);
+
+
+// Moves the process into the cgroup.
+Try<Nothing> assign(
+    const std::string& root,
+    const std::string& cgroup,
+    pid_t pid);
+
+
+// Returns the processes in the cgroup (excluding its descendants).
+Try<std::set<pid_t>> processes(
+    const std::string& root,
+    const std::string& cgroup);
+
+
+// Kills all processes in the cgroup with SIGKILL. Uses `cgroup.kill`
+// when supported by the kernel (5.14+), otherwise signals each
+// process listed in `cgroup.procs`.
+Try<Nothing> kill(const std::string& root, const std::string& cgroup);
+
+
+Try<std::string> read(
+    const std::string& root,
+    const std::string& cgroup,
+    const std::string& control);
+
+
+Try<Nothing> write(
+    const std::string& root,
+    const std::string& cgroup,
+    const std::string& control,
+    const std::string& value);
+
+
+// Parses a flat keyed file such as `cpu.stat` or `memory.stat`, i.e.,
+// lines of the form "<key> <value>".
+Try<hashmap<std::string, uint64_t>> parseFlatKeyed(const std::string& content);
+
+
+namespace cpu {
+
+// Sets `cpu.weight` (1 - 10000).
+Try<Nothing> weight(
+    const std::string& root,
+    const std::string& cgroup,
+    uint64_t weight);
+
+
+// Sets `cpu.max` to limit the cgroup to `quota` every `period`. If
+// `quota` is none the cgroup is not limited.
+Try<Nothing> max(
+    const std::string& root,
+    const std::string& cgroup,
+    const Option<Duration>& quota,
+    const Duration& period);
+
+
+// The statistics reported in `cpu.stat`.
+struct Stats
+{
+  Duration usage;
+  Duration user;
+  Duration system;
+
+  // Only reported if the cpu controller is enabled.
+  Option<uint64_t> periods;
+  Option<uint64_t> throttled;
+  Option<Duration> throttledTime;
+};
+
+
+Try<Stats> stat(const std::string& root, const std::string& cgroup);
+
+} // namespace cpu {
+
+
+namespace memory {
+
+// Sets `memory.max`, the hard limit at which the OOM killer is
+// invoked. If `limit` is none the cgroup is not limited.
+Try<Nothing> max(
+    const std::string& root,
+    const std::string& cgroup,
+    const Option<Bytes>& limit);
+
+
+// Sets `memory.high`, the limit above which the cgroup is throttled
+// and put under heavy reclaim pressure. If `limit` is none the cgroup
+// is not throttled.
+Try<Nothing> high(
+    const std::string& root,
+    const std::string& cgroup,
+    const Option<Bytes>& limit);
+
+
+// Returns `memory.current`, the memory currently used by the cgroup
+// and its descendants.
+Try<Bytes> current(const std::string& root, const std::string& cgroup);
+
+
+// Returns the hard limit (`memory.max`), none if unlimited.
+Try<Option<Bytes>> max(const std::string& root, const std::string& cgroup);
+
+
+// Returns the contents of `memory.stat`.
+Try<hashmap<std::string, uint64_t>> stat(
+    const std::string& root,
+    const std::string& cgroup);
+
+} // namespace memory {
+
+
+namespace io {
+
+// The statistics reported in `io.stat` for a single device.
+struct Stats
+{
+  uint64_t rbytes = 0;
+  uint64_t wbytes = 0;
+  uint64_t rios = 0;
+  uint64_t wios = 0;
+  uint64_t dbytes = 0;
+  uint64_t dios = 0;
+};
+
+
+// Parses the content of `io.stat`, i.e., lines of the form
+// "<major>:<minor> rbytes=<n> wbytes=<n> ...", keyed by device.
+Try<hashmap<std::string, Stats>> parseStat(const std::string& content);
+
+
+Try<hashmap<std::string, Stats>> stat(
+    const std::string& root,
+    const std::string& cgroup);
+
+} // namespace io {
+
+
+namespace pressure {
+
+// Pressure stall information, see
+// <kernel-source>/Documentation/accounting/psi.rst.
+struct Stall
+{
+  // The share of time (in percent) in which tasks were stalled over
+  // the last 10, 60 and 300 seconds.
+  double avg10 = 0;
+  double avg60 = 0;
+  double avg300 = 0;
+
+  // The total stall time.
+  Duration total;
+};
+
+
+struct Pressure
+{
+  // Some (i.e., at least one) tasks were stalled.
+  Stall some;
+
+  // All non-idle tasks were stalled simultaneously. Not reported for
+  // the cpu controller on kernels older than 5.13.
+  Option<Stall> full;
+};
+
+
+// Parses the content of a `<controller>.pressure` file, i.e.:
+//
+//   some avg10=0.00 avg60=0.00 avg300=0.00 total=0
+//   full avg10=0.00 avg60=0.00 avg300=0.00 total=0
+Try<Pressure> parse(const std::string& content);
+
+
+// Reads the pressure stall information of the controller ("cpu",
+// "memory" or "io") for the cgroup.
+Try<Pressure> read(
+    const std::string& root,
+    const std::string& cgroup,
+    const std::string& controller);
+
+} // namespace pressure {
+
+} // namespace cgroups2 {
+
+#endif // __CGROUPS2_HPP__
@@ -0,0 +1,266 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <sys/syscall.h>
+
+#include <stout/error.hpp>
+#include <stout/foreach.hpp>
+#include <stout/none.hpp>
+#include <stout/stringify.hpp>
+
+#include "linux/ebpf.hpp"
+
+using std::pair;
+using std::string;
+using std::vector;
+
+namespace ebpf {
+
+// The size of the buffer for the log of the verifier.
+constexpr size_t VERIFIER_LOG_SIZE = 64 * 1024;
+
+
+static int bpf(int cmd, bpf_attr* attr)
+{
+  return ::syscall(__NR_bpf, cmd, attr, sizeof(*attr));
+}
+
+
+Try<int> createMap(
+    bpf_map_type type,
+    uint32_t keySize,
+    uint32_t valueSize,
+    uint32_t maxEntries,
+    uint32_t flags)
+{
+  bpf_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.map_type = type;
+  attr.key_size = keySize;
+  attr.value_size = valueSize;
+  attr.max_entries = maxEntries;
+  attr.map_flags = flags;
+
+  int fd = bpf(BPF_MAP_CREATE, &attr);
+  if (fd < 0) {
+    return ErrnoError("Failed to create BPF map");
+  }
+
+  return fd;
+}
+
+
+Try<bool> lookupElement(int fd, const void* key, void* value)
+{
+  bpf_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.map_fd = fd;
+  attr.key = reinterpret_cast<uint64_t>(key);
+  attr.value = reinterpret_cast<uint64_t>(value);
+
+  if (bpf(BPF_MAP_LOOKUP_ELEM, &attr) < 0) {
+    if (errno == ENOENT) {
+      return false;
+    }
+
+    return ErrnoError("Failed to look up BPF map element");
+  }
+
+  return true;
+}
+
+
+Try<Nothing> updateElement(
+    int fd,
+    const void* key,
+    const void* value,
+    uint64_t flags)
+{
+  bpf_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.map_fd = fd;
+  attr.key = reinterpret_cast<uint64_t>(key);
+  attr.value = reinterpret_cast<uint64_t>(value);
+  attr.flags = flags;
+
+  if (bpf(BPF_MAP_UPDATE_ELEM, &attr) < 0) {
+    return ErrnoError("Failed to update BPF map element");
+  }
+
+  return Nothing();
+}
+
+
+Try<bool> deleteElement(int fd, const void* key)
+{
+  bpf_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.map_fd = fd;
+  attr.key = reinterpret_cast<uint64_t>(key);
+
+  if (bpf(BPF_MAP_DELETE_ELEM, &attr) < 0) {
+    if (errno == ENOENT) {
+      return false;
+    }
+
+    return ErrnoError("Failed to delete BPF map element");
+  }
+
+  return true;
+}
+
+
+Try<int> load(
+    bpf_prog_type type,
+    const vector<bpf_insn>& instructions,
+    const string& license)
+{
+  bpf_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.prog_type = type;
+  attr.insns = reinterpret_cast<uint64_t>(instructions.data());
+  attr.insn_cnt = instructions.size();
+  attr.license = reinterpret_cast<uint64_t>(license.c_str());
+
+  int fd = bpf(BPF_PROG_LOAD, &attr);
+  if (fd >= 0) {
+    return fd;
+  }
+
+  // The program is loaded again with the verifier log enabled to
+  // explain why it is rejected. We do not enable the log in the first
+  // place because it slows down the verification.
+  ErrnoError error("Failed to load BPF program");
+
+  vector<char> log(VERIFIER_LOG_SIZE, '\0');
+  attr.log_level = 1;
+  attr.log_buf = reinterpret_cast<uint64_t>(log.data());
+  attr.log_size = log.size();
+
+  fd = bpf(BPF_PROG_LOAD, &attr);
+  if (fd >= 0) {
+    return fd;
+  }
+
+  return Error(error.message + ":\n" + string(log.data()));
+}
+
+
+Try<Nothing> pin(int fd, const string& path)
+{
+  bpf_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.pathname = reinterpret_cast<uint64_t>(path.c_str());
+  attr.bpf_fd = fd;
+
+  if (bpf(BPF_OBJ_PIN, &attr) < 0) {
+    return ErrnoError("Failed to pin BPF object to '" + path + "'");
+  }
+
+  return Nothing();
+}
+
+
+Result<int> get(const string& path)
+{
+  bpf_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.pathname = reinterpret_cast<uint64_t>(path.c_str());
+
+  int fd = bpf(BPF_OBJ_GET, &attr);
+  if (fd < 0) {
+    if (errno == ENOENT) {
+      return None();
+    }
+
+    return ErrnoError("Failed to get BPF object pinned to '" + path + "'");
+  }
+
+  return fd;
+}
+
+
+Assembler& Assembler::emit(const bpf_insn& insn)
+{
+  instructions.push_back(insn);
+  return *this;
+}
+
+
+Assembler& Assembler::emit(const pair<bpf_insn, bpf_insn>& insns)
+{
+  instructions.push_back(insns.first);
+  instructions.push_back(insns.second);
+  return *this;
+}
+
+
+Assembler& Assembler::jumpImm(
+    uint8_t op,
+    uint8_t dst,
+    int32_t imm,
+    const string& label)
+{
+  jumps[instructions.size()] = label;
+  return emit(insn::make(BPF_JMP | op | BPF_K, dst, 0, 0, imm));
+}
+
+
+Assembler& Assembler::jump(
+    uint8_t op,
+    uint8_t dst,
+    uint8_t src,
+    const string& label)
+{
+  jumps[instructions.size()] = label;
+  return emit(insn::make(BPF_JMP | op | BPF_X, dst, src, 0, 0));
+}
+
+
+Assembler& Assembler::label(const string& label)
+{
+  labels[label] = instructions.size();
+  return *this;
+}
+
+
+Try<vector<bpf_insn>> Assembler::assemble() const
+{
+  vector<bpf_insn> result = instructions;
+
+  foreachpair (size_t index, const string& label, jumps) {
+    if (!labels.contains(label)) {
+      return Error("Undefined label '" + label + "'");
+    }
+
+    // The offset is relative to the instruction after the jump.
+    const int64_t offset = (int64_t) labels.at(label) - (int64_t) index - 1;
+
+    if (offset < INT16_MIN || offset > INT16_MAX) {
+      return Error("Jump to label '" + label + "' is out of range");
+    }
+
+    result[index].off = (int16_t) offset;
+  }
+
+  return result;
+}
+
+} // namespace ebpf {
@@ -0,0 +1,228 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __LINUX_EBPF_HPP__
+#define __LINUX_EBPF_HPP__
+
+#include <linux/bpf.h>
+
+#include <stdint.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <stout/hashmap.hpp>
+#include <stout/nothing.hpp>
+#include <stout/result.hpp>
+#include <stout/try.hpp>
+
+// Wrappers for the bpf(2) system call. The BPF maps and programs are
+// referred to by file descriptors, which the caller has to close. A
+// map or program stays in the kernel as long as a file descriptor, a
+// pin in the BPF file system or an attached program refers to it.
+namespace ebpf {
+
+// The mount point of the BPF file system.
+constexpr char BPF_FS[] = "/sys/fs/bpf";
+
+
+// Creates a BPF map and returns its file descriptor.
+Try<int> createMap(
+    bpf_map_type type,
+    uint32_t keySize,
+    uint32_t valueSize,
+    uint32_t maxEntries,
+    uint32_t flags = 0);
+
+
+// Copies the value of the element with the given key into `value`.
+// Returns false if there is no such element.
+Try<bool> lookupElement(int fd, const void* key, void* value);
+
+
+// Creates or updates the element with the given key, depending on
+// `flags` (i.e., `BPF_ANY`, `BPF_NOEXIST` or `BPF_EXIST`).
+Try<Nothing> updateElement(
+    int fd,
+    const void* key,
+    const void* value,
+    uint64_t flags = BPF_ANY);
+
+
+// Deletes the element with the given key. Returns false if there is
+// no such element.
+Try<bool> deleteElement(int fd, const void* key);
+
+
+// Loads the program into the kernel and returns its file descriptor.
+// The error includes the log of the verifier if the kernel rejects the
+// program.
+Try<int> load(
+    bpf_prog_type type,
+    const std::vector<bpf_insn>& instructions,
+    const std::string& license);
+
+
+// Pins the map or program to the given path in the BPF file system so
+// that it outlives the file descriptor.
+Try<Nothing> pin(int fd, const std::string& path);
+
+
+// Returns a file descriptor of the map or program pinned to the given
+// path, or None if nothing is pinned to the path.
+Result<int> get(const std::string& path);
+
+
+// Helpers to assemble BPF instructions, see 'Documentation/networking/
+// filter.txt' in the kernel source tree for the instruction set.
+namespace insn {
+
+inline bpf_insn make(
+    uint8_t code,
+    uint8_t dst,
+    uint8_t src,
+    int16_t off,
+    int32_t imm)
+{
+  bpf_insn insn;
+  insn.code = code;
+  insn.dst_reg = dst;
+  insn.src_reg = src;
+  insn.off = off;
+  insn.imm = imm;
+  return insn;
+}
+
+
+// dst = src (64-bit).
+inline bpf_insn mov(uint8_t dst, uint8_t src)
+{
+  return make(BPF_ALU64 | BPF_MOV | BPF_X, dst, src, 0, 0);
+}
+
+
+// dst = imm, sign extended to 64 bits.
+inline bpf_insn movImm(uint8_t dst, int32_t imm)
+{
+  return make(BPF_ALU64 | BPF_MOV | BPF_K, dst, 0, 0, imm);
+}
+
+
+// dst = imm, zero extended to 64 bits.
+inline bpf_insn movImm32(uint8_t dst, uint32_t imm)
+{
+  return make(BPF_ALU | BPF_MOV | BPF_K, dst, 0, 0, (int32_t) imm);
+}
+
+
+// dst = dst <op> imm (64-bit), e.g., `BPF_ADD`, `BPF_AND` or `BPF_LSH`.
+inline bpf_insn aluImm(uint8_t op, uint8_t dst, int32_t imm)
+{
+  return make(BPF_ALU64 | op | BPF_K, dst, 0, 0, imm);
+}
+
+
+// dst = *(size *) (src + off), where size is `BPF_B`, `BPF_H`,
+// `BPF_W` or `BPF_DW`.
+inline bpf_insn load(uint8_t size, uint8_t dst, uint8_t src, int16_t off)
+{
+  return make(BPF_LDX | size | BPF_MEM, dst, src, off, 0);
+}
+
+
+// *(size *) (dst + off) = imm.
+inline bpf_insn storeImm(uint8_t size, uint8_t dst, int16_t off, int32_t imm)
+{
+  return make(BPF_ST | size | BPF_MEM, dst, 0, off, imm);
+}
+
+
+// Atomically *(size *) (dst + off) += src, where size is `BPF_W` or
+// `BPF_DW`.
+inline bpf_insn atomicAdd(uint8_t size, uint8_t dst, int16_t off, uint8_t src)
+{
+  return make(BPF_STX | size | BPF_XADD, dst, src, off, 0);
+}
+
+
+// dst = the map with the given file descriptor. This takes two
+// instructions.
+inline std::pair<bpf_insn, bpf_insn> loadMap(uint8_t dst, int fd)
+{
+  return std::make_pair(
+      make(BPF_LD | BPF_DW | BPF_IMM, dst, BPF_PSEUDO_MAP_FD, 0, fd),
+      make(0, 0, 0, 0, 0));
+}
+
+
+// r0 = helper(r1, ..., r5), see `bpf_func_id`.
+inline bpf_insn call(int32_t helper)
+{
+  return make(BPF_JMP | BPF_CALL, 0, 0, 0, helper);
+}
+
+
+// return r0.
+inline bpf_insn exit()
+{
+  return make(BPF_JMP | BPF_EXIT, 0, 0, 0, 0);
+}
+
+} // namespace insn {
+
+
+// Assembles a BPF program. Jumps refer to labels rather than to
+// instruction offsets, which may be defined after the jump.
+class Assembler
+{
+public:
+  Assembler& emit(const bpf_insn& insn);
+  Assembler& emit(const std::pair<bpf_insn, bpf_insn>& insns);
+
+  // Jumps to the label if `dst <op> imm`, where op is, e.g., `BPF_JEQ`
+  // or `BPF_JNE`. The immediate is sign extended to 64 bits.
+  Assembler& jumpImm(
+      uint8_t op,
+      uint8_t dst,
+      int32_t imm,
+      const std::string& label);
+
+  // Jumps to the label if `dst <op> src`.
+  Assembler& jump(
+      uint8_t op,
+      uint8_t dst,
+      uint8_t src,
+      const std::string& label);
+
+  // Defines the label at the next instruction.
+  Assembler& label(const std::string& label);
+
+  // Returns the instructions with the jump offsets resolved.
+  Try<std::vector<bpf_insn>> assemble() const;
+
+private:
+  std::vector<bpf_insn> instructions;
+
+  // The jumps, keyed by instruction index.
+  hashmap<size_t, std::string> jumps;
+
+  hashmap<std::string, size_t> labels;
+};
+
+} // namespace ebpf {
+
+#endif // __LINUX_EBPF_HPP__
@@ -14,14 +14,20 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <fcntl.h>
 #include <signal.h>
 #include <stdlib.h>
 #include <unistd.h>
 
+#include <linux/perf_event.h>
+
 #include <sys/prctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 
+#include <algorithm>
 #include <list>
 #include <sstream>
 #include <string>
@@ -36,6 +42,7 @@
 #include <process/process.hpp>
 #include <process/subprocess.hpp>
 
+#include <stout/numify.hpp>
 #include <stout/os.hpp>
 #include <stout/strings.hpp>
 
@@ -48,6 +55,7 @@
 using namespace process;
 
 using process::await;
+using process::Owned;
 
 using std::list;
 using std::ostringstream;
@@ -476,4 +484,451 @@ Try<hashmap<string, mesos::PerfStatistics>> parse(
   return statistics;
 }
 
+
+namespace internal {
+
+// The perf_event_open(2) type and config of an event.
+struct Event
+{
+  uint32_t type;
+  uint64_t config;
+};
+
+
+// Returns the events which can be counted with perf_event_open(2),
+// keyed by their (normalized) PerfStatistics field.
+static const hashmap<string, Event>& events()
+{
+  static const hashmap<string, Event>* events = []() {
+    hashmap<string, Event>* events = new hashmap<string, Event>({
+      {"cycles", {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES}},
+      {"instructions", {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS}},
+      {"cache_references",
+       {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES}},
+      {"cache_misses", {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES}},
+      {"branches", {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS}},
+      {"branch_misses", {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}},
+      {"bus_cycles", {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BUS_CYCLES}},
+      {"stalled_cycles_frontend",
+       {PERF_TYPE_HARDWARE, PERF_COUNT_HW_STALLED_CYCLES_FRONTEND}},
+      {"stalled_cycles_backend",
+       {PERF_TYPE_HARDWARE, PERF_COUNT_HW_STALLED_CYCLES_BACKEND}},
+      {"ref_cycles", {PERF_TYPE_HARDWARE, PERF_COUNT_HW_REF_CPU_CYCLES}},
+
+      {"cpu_clock", {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_CLOCK}},
+      {"task_clock", {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK}},
+      {"page_faults", {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS}},
+      {"minor_faults", {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS_MIN}},
+      {"major_faults", {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS_MAJ}},
+      {"context_switches",
+       {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES}},
+      {"cpu_migrations", {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS}},
+      {"alignment_faults",
+       {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_ALIGNMENT_FAULTS}},
+      {"emulation_faults",
+       {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_EMULATION_FAULTS}},
+    });
+
+    // Hardware cache events are named `<cache>_<op>s` for accesses
+    // and `<cache>_<op>_misses` for misses, e.g., `llc_loads` and
+    // `llc_load_misses`, see perf_event_open(2) for the encoding.
+    const vector<tuple<string, uint64_t>> caches = {
+      std::make_tuple("l1_dcache", PERF_COUNT_HW_CACHE_L1D),
+      std::make_tuple("l1_icache", PERF_COUNT_HW_CACHE_L1I),
+      std::make_tuple("llc", PERF_COUNT_HW_CACHE_LL),
+      std::make_tuple("dtlb", PERF_COUNT_HW_CACHE_DTLB),
+      std::make_tuple("itlb", PERF_COUNT_HW_CACHE_ITLB),
+      std::make_tuple("branch", PERF_COUNT_HW_CACHE_BPU),
+      std::make_tuple("node", PERF_COUNT_HW_CACHE_NODE),
+    };
+
+    const vector<tuple<string, uint64_t>> ops = {
+      std::make_tuple("load", PERF_COUNT_HW_CACHE_OP_READ),
+      std::make_tuple("store", PERF_COUNT_HW_CACHE_OP_WRITE),
+      std::make_tuple("prefetch", PERF_COUNT_HW_CACHE_OP_PREFETCH),
+    };
+
+    const google::protobuf::Descriptor* descriptor =
+      mesos::PerfStatistics::descriptor();
+
+    foreach (const auto& cache, caches) {
+      foreach (const auto& op, ops) {
+        const string prefix = std::get<0>(cache) + "_" + std::get<0>(op);
+        const uint64_t config = std::get<1>(cache) | (std::get<1>(op) << 8);
+
+        // Not all combinations have a field in PerfStatistics.
+        if (descriptor->FindFieldByName(prefix + "s") != nullptr) {
+          (*events)[prefix + "s"] = {
+            PERF_TYPE_HW_CACHE,
+            config | (PERF_COUNT_HW_CACHE_RESULT_ACCESS << 16)};
+        }
+
+        if (descriptor->FindFieldByName(prefix + "_misses") != nullptr) {
+          (*events)[prefix + "_misses"] = {
+            PERF_TYPE_HW_CACHE,
+            config | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)};
+        }
+      }
+    }
+
+    return events;
+  }();
+
+  return *events;
+}
+
+
+// Returns the online CPUs, see
+// <kernel-source>/Documentation/ABI/testing/sysfs-devices-system-cpu.
+static Try<vector<int>> cpus()
+{
+  Try<string> online = os::read("/sys/devices/system/cpu/online");
+  if (online.isError()) {
+    return Error("Failed to read the online CPUs: " + online.error());
+  }
+
+  vector<int> result;
+
+  foreach (const string& range,
+           strings::tokenize(strings::trim(online.get()), ",")) {
+    vector<string> bounds = strings::split(range, "-");
+
+    Try<int> first = numify<int>(bounds[0]);
+    Try<int> last = numify<int>(bounds.back());
+
+    if (bounds.size() > 2 || first.isError() || last.isError()) {
+      return Error("Failed to parse the online CPUs '" + online.get() + "'");
+    }
+
+    for (int cpu = first.get(); cpu <= last.get(); cpu++) {
+      result.push_back(cpu);
+    }
+  }
+
+  return result;
+}
+
+
+// Returns the number of file descriptors which this process can still
+// open within its RLIMIT_NOFILE.
+static Try<size_t> available()
+{
+  struct rlimit limit;
+  if (::getrlimit(RLIMIT_NOFILE, &limit) == -1) {
+    return ErrnoError("Failed to get RLIMIT_NOFILE");
+  }
+
+  Try<list<string>> fds = os::ls("/proc/self/fd");
+  if (fds.isError()) {
+    return Error("Failed to list the open file descriptors: " + fds.error());
+  }
+
+  if (limit.rlim_cur <= fds->size()) {
+    return 0;
+  }
+
+  return limit.rlim_cur - fds->size();
+}
+
+
+// Opens a group of counters for the events on the CPU, led by the
+// counter of the first event, so that the counts of all the events
+// can be read at once from the leader. Returns the file descriptors
+// of the counters in the order of the events.
+static Try<vector<int>> open(
+    int_fd cgroup,
+    const vector<string>& fields,
+    int cpu)
+{
+  vector<int> fds;
+
+  auto close = [&fds]() {
+    foreach (int fd, fds) {
+      os::close(fd);
+    }
+  };
+
+  foreach (const string& field, fields) {
+    const Event& event = events().at(field);
+
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+
+    attr.size = sizeof(attr);
+    attr.type = event.type;
+    attr.config = event.config;
+    attr.read_format =
+      PERF_FORMAT_GROUP |
+      PERF_FORMAT_TOTAL_TIME_ENABLED |
+      PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    int fd = ::syscall(
+        __NR_perf_event_open,
+        &attr,
+        cgroup,
+        cpu,
+        fds.empty() ? -1 : fds.front(),
+        PERF_FLAG_PID_CGROUP);
+
+    if (fd < 0) {
+      ErrnoError error(
+          "Failed to open perf event '" + field + "' on CPU " +
+          stringify(cpu));
+
+      close();
+      return error;
+    }
+
+    fds.push_back(fd);
+
+    Try<Nothing> cloexec = os::cloexec(fd);
+    if (cloexec.isError()) {
+      close();
+      return Error(
+          "Failed to set FD_CLOEXEC on perf event '" + field + "': " +
+          cloexec.error());
+    }
+  }
+
+  return fds;
+}
+
+} // namespace internal {
+
+
+bool Counters::valid(const set<string>& events)
+{
+  foreach (const string& event, events) {
+    if (!internal::events().contains(internal::normalize(event))) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+
+Try<Owned<Counters>> Counters::open(
+    const set<string>& events,
+    const string& cgroup)
+{
+  vector<string> fields;
+
+  foreach (const string& event, events) {
+    const string field = internal::normalize(event);
+
+    if (!internal::events().contains(field)) {
+      return Error("Unsupported perf event '" + event + "'");
+    }
+
+    // Different names of the same event are counted once.
+    if (std::find(fields.begin(), fields.end(), field) == fields.end()) {
+      fields.push_back(field);
+    }
+  }
+
+  Try<vector<int>> cpus = internal::cpus();
+  if (cpus.isError()) {
+    return Error(cpus.error());
+  }
+
+  Owned<Counters> counters(new Counters(Clock::now(), cgroup, fields));
+
+  Try<Nothing> open = counters->open(cpus.get());
+  if (open.isError()) {
+    return Error(open.error());
+  }
+
+  return counters;
+}
+
+
+Counters::Counters(
+    const Time& _start,
+    const string& _cgroup,
+    const vector<string>& _fields)
+  : start(_start),
+    cgroup(_cgroup),
+    fields(_fields),
+    unscheduled(false) {}
+
+
+Counters::~Counters()
+{
+  foreachvalue (const vector<int>& fds, groups) {
+    foreach (int fd, fds) {
+      os::close(fd);
+    }
+  }
+}
+
+
+Try<Nothing> Counters::open(const vector<int>& cpus)
+{
+  vector<int> added;
+  foreach (int cpu, cpus) {
+    if (!groups.contains(cpu)) {
+      added.push_back(cpu);
+    }
+  }
+
+  if (added.empty() || fields.empty()) {
+    return Nothing();
+  }
+
+  // Each counter takes a file descriptor, so check up front that all
+  // of them can be opened rather than failing (or starving the rest of
+  // the agent of file descriptors) halfway through.
+  Try<size_t> available = internal::available();
+  if (available.isError()) {
+    return Error(available.error());
+  }
+
+  const size_t needed = fields.size() * added.size();
+  if (needed > available.get()) {
+    return Error(
+        "Opening " + stringify(needed) + " perf event counters would "
+        "exceed RLIMIT_NOFILE, only " + stringify(available.get()) +
+        " file descriptors are left");
+  }
+
+  // NOTE: The cgroup only needs to be open while the counters are
+  // opened, the kernel keeps a reference to it for each counter.
+  Try<int_fd> cgroupFd = os::open(cgroup, O_RDONLY | O_CLOEXEC);
+  if (cgroupFd.isError()) {
+    return Error(
+        "Failed to open cgroup '" + cgroup + "': " + cgroupFd.error());
+  }
+
+  foreach (int cpu, added) {
+    Try<vector<int>> fds = internal::open(cgroupFd.get(), fields, cpu);
+    if (fds.isError()) {
+      os::close(cgroupFd.get());
+      return Error(fds.error());
+    }
+
+    groups[cpu] = fds.get();
+  }
+
+  os::close(cgroupFd.get());
+
+  return Nothing();
+}
+
+
+Try<mesos::PerfStatistics> Counters::read()
+{
+  // Count on the CPUs which came online since the counters were last
+  // opened. Their counts only start now. The counters of CPUs which
+  // went offline are kept, as the kernel retains their counts.
+  Try<vector<int>> cpus = internal::cpus();
+  if (cpus.isError()) {
+    LOG(WARNING) << "Failed to update the perf counters of cgroup '"
+                 << cgroup << "': " << cpus.error();
+  } else {
+    Try<Nothing> open = this->open(cpus.get());
+    if (open.isError()) {
+      LOG(WARNING) << "Failed to open perf counters on the new CPUs for "
+                   << "cgroup '" << cgroup << "': " << open.error();
+    }
+  }
+
+  mesos::PerfStatistics statistics;
+  statistics.set_timestamp(start.secs());
+  statistics.set_duration((Clock::now() - start).secs());
+
+  // The number of counters, the times the group was enabled and
+  // running, and the value of each counter, see perf_event_open(2).
+  vector<uint64_t> values(3 + fields.size());
+  vector<double> counts(fields.size(), 0);
+
+  // Whether the group was enabled and running on any of the CPUs.
+  bool everEnabled = false;
+  bool everRunning = false;
+
+  foreachpair (int cpu, const vector<int>& fds, groups) {
+    const ssize_t size = values.size() * sizeof(uint64_t);
+
+    ssize_t length = ::read(fds.front(), values.data(), size);
+    if (length != size) {
+      ErrnoError error("Failed to read perf events on CPU " + stringify(cpu));
+
+      // The counters of an offline CPU may no longer be readable.
+      if (cpus.isSome() &&
+          std::find(cpus->begin(), cpus->end(), cpu) == cpus->end()) {
+        continue;
+      }
+
+      return error;
+    }
+
+    if (values[0] != fields.size()) {
+      return Error(
+          "Expected " + stringify(fields.size()) + " perf events on CPU " +
+          stringify(cpu) + " but read " + stringify(values[0]));
+    }
+
+    const uint64_t enabled = values[1];
+    const uint64_t running = values[2];
+
+    if (enabled > 0) {
+      everEnabled = true;
+    }
+
+    // Scale each count by the fraction of time the group was actually
+    // running (i.e., scheduled onto the PMU) if the kernel had to
+    // multiplex counters.
+    if (running > 0) {
+      everRunning = true;
+
+      for (size_t i = 0; i < fields.size(); i++) {
+        counts[i] += static_cast<double>(values[3 + i]) * enabled / running;
+      }
+    }
+  }
+
+  // A group which was enabled but never running on any CPU could not
+  // be scheduled onto the PMU, e.g., it has more hardware events than
+  // the PMU has counters. Its events are left unset rather than being
+  // reported as zero.
+  if (everEnabled && !everRunning) {
+    if (!unscheduled) {
+      LOG(WARNING) << "The perf events of cgroup '" << cgroup << "' have "
+                   << "never been scheduled onto the PMU, there may be "
+                   << "more hardware events than the PMU has counters";
+
+      unscheduled = true;
+    }
+
+    return statistics;
+  }
+
+  const google::protobuf::Reflection* reflection =
+    statistics.GetReflection();
+
+  for (size_t i = 0; i < fields.size(); i++) {
+    const google::protobuf::FieldDescriptor* field =
+      statistics.GetDescriptor()->FindFieldByName(fields[i]);
+
+    CHECK_NOTNULL(field);
+
+    switch (field->type()) {
+      case google::protobuf::FieldDescriptor::TYPE_DOUBLE:
+        // The clocks are counted in nanoseconds but reported in
+        // milliseconds by `perf stat`.
+        reflection->SetDouble(&statistics, field, counts[i] / 1000000);
+        break;
+      case google::protobuf::FieldDescriptor::TYPE_UINT64:
+        reflection->SetUInt64(
+            &statistics, field, static_cast<uint64_t>(counts[i]));
+        break;
+      default:
+        return Error(
+            "Unsupported perf field type of event '" + fields[i] + "'");
+    }
+  }
+
+  return statistics;
+}
+
 } // namespace perf {
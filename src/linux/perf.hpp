@@ -21,11 +21,16 @@
 
 #include <set>
 #include <string>
+#include <vector>
 
 #include <process/future.hpp>
+#include <process/owned.hpp>
+#include <process/time.hpp>
 
 #include <stout/duration.hpp>
 #include <stout/hashmap.hpp>
+#include <stout/nothing.hpp>
+#include <stout/try.hpp>
 #include <stout/version.hpp>
 
 // For PerfStatistics protobuf.
@@ -65,6 +70,76 @@ Try<Version> parseVersion(const std::string& output);
 Try<hashmap<std::string, mesos::PerfStatistics>> parse(
     const std::string& output);
 
+
+// Counts perf events for the process(es) in a perf_event cgroup using
+// counters opened within this process with perf_event_open(2), i.e.,
+// without running `perf stat`. Unlike `sample()` the counters keep
+// running once opened, so the counts are cumulative and can be read at
+// any time. The counters on each CPU form a group, so reading them
+// costs a read(2) per CPU.
+class Counters
+{
+public:
+  // Returns whether all events can be counted. Only the generic
+  // hardware, software and hardware cache events which have a field in
+  // the PerfStatistics protobuf are supported (e.g., `cycles`,
+  // `instructions`, `task-clock` or `LLC-load-misses`), raw and
+  // tracepoint events must be sampled with `perf stat`.
+  static bool valid(const std::set<std::string>& events);
+
+  // Opens counters for the events on every online CPU for the cgroup,
+  // which is an absolute path in the perf_event hierarchy, e.g.,
+  // /sys/fs/cgroup/perf_event/mesos/test. Fails if the counters (one
+  // file descriptor per event and CPU) would exceed RLIMIT_NOFILE.
+  //
+  // NOTE: The events of a group are scheduled onto the PMU together,
+  // hence a group of more hardware events than the PMU can count at
+  // once is never scheduled. Its events are then not set in the
+  // statistics returned by `read()`.
+  static Try<process::Owned<Counters>> open(
+      const std::set<std::string>& events,
+      const std::string& cgroup);
+
+  ~Counters();
+
+  // Returns the counts since the counters were opened, i.e., the
+  // `timestamp` of the returned statistics is the time the counters
+  // were opened and the `duration` is the time since then. Counts
+  // are scaled if the kernel had to multiplex the counters, and the
+  // events are left unset if the counters were never scheduled.
+  //
+  // NOTE: Counters are opened on the CPUs which came online since the
+  // last read, so the counts of such CPUs only start then.
+  Try<mesos::PerfStatistics> read();
+
+private:
+  Counters(
+      const process::Time& start,
+      const std::string& cgroup,
+      const std::vector<std::string>& fields);
+
+  Counters(const Counters&) = delete;
+  Counters& operator=(const Counters&) = delete;
+
+  // Opens the groups of counters on the CPUs which have none yet.
+  Try<Nothing> open(const std::vector<int>& cpus);
+
+  const process::Time start;
+  const std::string cgroup;
+
+  // The PerfStatistics fields of the events, in the order of the
+  // counters within each group.
+  const std::vector<std::string> fields;
+
+  // The file descriptors of the group of counters on each CPU, led by
+  // the first one.
+  hashmap<int, std::vector<int>> groups;
+
+  // Whether the groups were found to be never scheduled onto the PMU,
+  // so that this is only logged once.
+  bool unscheduled;
+};
+
 } // namespace perf {
 
 #endif // __PERF_HPP__
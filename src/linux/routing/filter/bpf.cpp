@@ -0,0 +1,235 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <arpa/inet.h>
+
+#include <string.h>
+
+#include <linux/pkt_cls.h>
+#include <linux/rtnetlink.h>
+
+#include <netlink/attr.h>
+#include <netlink/errno.h>
+#include <netlink/msg.h>
+
+#include <netlink/route/link.h>
+#include <netlink/route/tc.h>
+
+#include <stout/error.hpp>
+#include <stout/none.hpp>
+
+#include "linux/routing/handle.hpp"
+#include "linux/routing/internal.hpp"
+
+#include "linux/routing/filter/bpf.hpp"
+#include "linux/routing/filter/filter.hpp"
+#include "linux/routing/filter/internal.hpp"
+#include "linux/routing/filter/priority.hpp"
+
+#include "linux/routing/link/internal.hpp"
+
+// This is a work around for old kernel headers.
+#ifndef TCA_BPF_FLAG_ACT_DIRECT
+#define TCA_BPF_FLAG_ACT_DIRECT (1 << 0)
+#endif
+
+using std::string;
+
+namespace routing {
+namespace filter {
+
+/////////////////////////////////////////////////
+// Filter specific pack/unpack functions.
+/////////////////////////////////////////////////
+
+namespace internal {
+
+// NOTE: There is no `encode` function for the BPF classifier because
+// libnl does not support the options of BPF filters. The filters are
+// created with raw netlink messages instead, see `bpf::create`.
+
+// Decodes the BPF classifier from the libnl filter 'cls'. Each type
+// of classifier needs to implement this function. Returns None if the
+// libnl filter is not a BPF packet filter.
+template <>
+Result<bpf::Classifier> decode<bpf::Classifier>(
+    const Netlink<struct rtnl_cls>& cls)
+{
+  if (rtnl_tc_get_kind(TC_CAST(cls.get())) != string("bpf")) {
+    return None();
+  }
+
+  return bpf::Classifier(rtnl_cls_get_protocol(cls.get()));
+}
+
+} // namespace internal {
+
+
+namespace bpf {
+
+// Sends a request to create or replace (depending on 'flags') a BPF
+// packet filter running the given program in direct action mode.
+static Try<bool> send(
+    const string& _link,
+    const Handle& parent,
+    uint16_t protocol,
+    uint16_t priority,
+    uint32_t handle,
+    int fd,
+    const string& name,
+    int flags)
+{
+  Result<Netlink<struct rtnl_link>> link = link::internal::get(_link);
+  if (link.isError()) {
+    return Error(link.error());
+  } else if (link.isNone()) {
+    return Error("Link '" + _link + "' is not found");
+  }
+
+  Try<Netlink<struct nl_sock>> socket = routing::socket();
+  if (socket.isError()) {
+    return Error(socket.error());
+  }
+
+  struct nl_msg* msg = nlmsg_alloc_simple(RTM_NEWTFILTER, flags);
+  if (msg == nullptr) {
+    return Error("Failed to allocate a netlink message");
+  }
+
+  struct tcmsg tcm;
+  memset(&tcm, 0, sizeof(tcm));
+  tcm.tcm_family = AF_UNSPEC;
+  tcm.tcm_ifindex = rtnl_link_get_ifindex(link->get());
+  tcm.tcm_parent = parent.get();
+  tcm.tcm_handle = handle;
+  tcm.tcm_info = TC_H_MAKE(((uint32_t) priority) << 16, htons(protocol));
+
+  struct nlattr* options = nullptr;
+
+  if (nlmsg_append(msg, &tcm, sizeof(tcm), NLMSG_ALIGNTO) < 0 ||
+      nla_put_string(msg, TCA_KIND, "bpf") < 0 ||
+      (options = nla_nest_start(msg, TCA_OPTIONS)) == nullptr ||
+      nla_put_u32(msg, TCA_BPF_FD, fd) < 0 ||
+      nla_put_string(msg, TCA_BPF_NAME, name.c_str()) < 0 ||
+      nla_put_u32(msg, TCA_BPF_FLAGS, TCA_BPF_FLAG_ACT_DIRECT) < 0) {
+    nlmsg_free(msg);
+    return Error("Failed to encode the BPF filter");
+  }
+
+  nla_nest_end(msg, options);
+
+  // NOTE: The message is freed by `nl_send_sync`.
+  int error = nl_send_sync(socket->get(), msg);
+  if (error != 0) {
+    if (error == -NLE_EXIST || error == -NLE_OBJ_NOTFOUND) {
+      return false;
+    } else {
+      return Error(string(nl_geterror(error)));
+    }
+  }
+
+  return true;
+}
+
+
+Try<bool> exists(
+    const string& link,
+    const Handle& parent,
+    uint16_t protocol)
+{
+  return internal::exists(link, parent, Classifier(protocol));
+}
+
+
+Try<bool> create(
+    const string& link,
+    const Handle& parent,
+    uint16_t protocol,
+    const Option<Priority>& priority,
+    int fd,
+    const string& name)
+{
+  // NOTE: Same as for the other filters, the existence check and the
+  // following add operation are not atomic.
+  Try<bool> _exists = exists(link, parent, protocol);
+  if (_exists.isError()) {
+    return Error("Check filter existence failed: " + _exists.error());
+  } else if (_exists.get()) {
+    // The filter already exists.
+    return false;
+  }
+
+  // If the priority or the handle is zero, the kernel assigns one.
+  return send(
+      link,
+      parent,
+      protocol,
+      priority.isSome() ? priority->get() : 0,
+      0,
+      fd,
+      name,
+      NLM_F_CREATE | NLM_F_EXCL);
+}
+
+
+Try<bool> remove(
+    const string& link,
+    const Handle& parent,
+    uint16_t protocol)
+{
+  return internal::remove(link, parent, Classifier(protocol));
+}
+
+
+Try<bool> update(
+    const string& _link,
+    const Handle& parent,
+    uint16_t protocol,
+    int fd,
+    const string& name)
+{
+  Result<Netlink<struct rtnl_link>> link = link::internal::get(_link);
+  if (link.isError()) {
+    return Error(link.error());
+  } else if (link.isNone()) {
+    return false;
+  }
+
+  Result<Netlink<struct rtnl_cls>> cls =
+    internal::getCls(link.get(), parent, Classifier(protocol));
+
+  if (cls.isError()) {
+    return Error(cls.error());
+  } else if (cls.isNone()) {
+    return false;
+  }
+
+  // The filter is replaced in place, i.e., it keeps its priority and
+  // handle, so that no packet misses the filter.
+  return send(
+      _link,
+      parent,
+      protocol,
+      rtnl_cls_get_prio(cls->get()),
+      rtnl_tc_get_handle(TC_CAST(cls->get())),
+      fd,
+      name,
+      NLM_F_REPLACE);
+}
+
+} // namespace bpf {
+} // namespace filter {
+} // namespace routing {
@@ -0,0 +1,99 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __LINUX_ROUTING_FILTER_BPF_HPP__
+#define __LINUX_ROUTING_FILTER_BPF_HPP__
+
+#include <stdint.h>
+
+#include <string>
+
+#include <stout/option.hpp>
+#include <stout/try.hpp>
+
+#include "linux/routing/handle.hpp"
+
+#include "linux/routing/filter/priority.hpp"
+
+namespace routing {
+namespace filter {
+namespace bpf {
+
+// The classifier for the BPF filter only contains a protocol. The
+// packets are classified by the BPF program of the filter.
+struct Classifier
+{
+  explicit Classifier(uint16_t _protocol)
+    : protocol(_protocol) {}
+
+  bool operator==(const Classifier& that) const
+  {
+    return protocol == that.protocol;
+  }
+
+  uint16_t protocol;
+};
+
+
+// Returns true if a BPF packet filter with given protocol attached to
+// the given parent exists on the link.
+Try<bool> exists(
+    const std::string& link,
+    const Handle& parent,
+    uint16_t protocol);
+
+
+// Creates a BPF packet filter with given protocol attached to the
+// given parent on the link which runs the loaded BPF program 'fd'
+// (see `ebpf::load`) in direct action mode, i.e., the return value of
+// the program is the action for the packet (e.g., `TC_ACT_REDIRECT`),
+// and `TC_ACT_UNSPEC` passes the packet on to the next filter. Returns
+// false if a BPF packet filter with the given protocol attached to the
+// given parent already exists on the link.
+Try<bool> create(
+    const std::string& link,
+    const Handle& parent,
+    uint16_t protocol,
+    const Option<Priority>& priority,
+    int fd,
+    const std::string& name);
+
+
+// Removes the BPF packet filter with given protocol attached to the
+// parent from the link. Returns false if no BPF packet filter with the
+// given protocol attached to the given parent is found on the link.
+Try<bool> remove(
+    const std::string& link,
+    const Handle& parent,
+    uint16_t protocol);
+
+
+// Atomically replaces the BPF program of the BPF packet filter with
+// given protocol attached to the given parent on the link. Returns
+// false if no BPF packet filter with the given protocol attached to
+// the parent is found on the link.
+Try<bool> update(
+    const std::string& link,
+    const Handle& parent,
+    uint16_t protocol,
+    int fd,
+    const std::string& name);
+
+} // namespace bpf {
+} // namespace filter {
+} // namespace routing {
+
+#endif // __LINUX_ROUTING_FILTER_BPF_HPP__
@@ -429,7 +429,11 @@ PID<Master> launch(const Flags& flags, Allocator* _allocator)
         << slaveFlags.runtime_dir << "': " << mkdir.error();
     }
 
-    garbageCollectors->push_back(new GarbageCollector(slaveFlags.work_dir));
+    garbageCollectors->push_back(new GarbageCollector(
+        slaveFlags.work_dir,
+        slaveFlags.gc_parallelism,
+        slaveFlags.gc_max_operations_per_second,
+        slaveFlags.gc_max_bytes_per_second));
     taskStatusUpdateManagers->push_back(
         new TaskStatusUpdateManager(slaveFlags));
     fetchers->push_back(new Fetcher(slaveFlags));
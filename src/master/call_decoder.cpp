@@ -0,0 +1,188 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "master/call_decoder.hpp"
+
+#include <functional>
+#include <string>
+
+#include <mesos/v1/scheduler/scheduler.hpp>
+
+#include <process/dispatch.hpp>
+#include <process/id.hpp>
+#include <process/process.hpp>
+
+#include <stout/check.hpp>
+#include <stout/foreach.hpp>
+#include <stout/json.hpp>
+#include <stout/protobuf.hpp>
+#include <stout/try.hpp>
+
+#include "internal/devolve.hpp"
+
+#include "master/validation.hpp"
+
+using process::dispatch;
+using process::spawn;
+using process::terminate;
+using process::wait; // Necessary on some OS's to disambiguate.
+
+using process::Future;
+using process::Owned;
+using process::Process;
+
+using process::http::BadRequest;
+using process::http::NotAcceptable;
+using process::http::UnsupportedMediaType;
+
+using process::http::authentication::Principal;
+
+using std::string;
+using std::vector;
+
+namespace mesos {
+namespace internal {
+namespace master {
+
+class CallDecoderProcess : public Process<CallDecoderProcess>
+{
+public:
+  CallDecoderProcess()
+    : ProcessBase(process::ID::generate("call-decoder")) {}
+
+  CallDecoder::Result decode(
+      const process::http::Request& request,
+      const Option<Principal>& principal)
+  {
+    CallDecoder::Result result;
+
+    v1::scheduler::Call v1Call;
+
+    // TODO(anand): Content type values are case-insensitive.
+    Option<string> contentType = request.headers.get("Content-Type");
+
+    if (contentType.isNone()) {
+      result.response = BadRequest("Expecting 'Content-Type' to be present");
+      return result;
+    }
+
+    if (contentType.get() == APPLICATION_PROTOBUF) {
+      if (!v1Call.ParseFromString(request.body)) {
+        result.response = BadRequest("Failed to parse body into Call protobuf");
+        return result;
+      }
+    } else if (contentType.get() == APPLICATION_JSON) {
+      Try<JSON::Value> value = JSON::parse(request.body);
+
+      if (value.isError()) {
+        result.response =
+          BadRequest("Failed to parse body into JSON: " + value.error());
+        return result;
+      }
+
+      Try<v1::scheduler::Call> parse =
+        ::protobuf::parse<v1::scheduler::Call>(value.get());
+
+      if (parse.isError()) {
+        result.response = BadRequest(
+            "Failed to convert JSON into Call protobuf: " + parse.error());
+        return result;
+      }
+
+      v1Call = parse.get();
+    } else {
+      result.response = UnsupportedMediaType(
+          string("Expecting 'Content-Type' of ") +
+          APPLICATION_JSON + " or " + APPLICATION_PROTOBUF);
+      return result;
+    }
+
+    result.call = devolve(v1Call);
+
+    Option<Error> error =
+      validation::scheduler::call::validate(result.call.get(), principal);
+
+    if (error.isSome()) {
+      result.response =
+        BadRequest("Failed to validate scheduler::Call: " + error->message);
+      return result;
+    }
+
+    // Ideally this handler would be consistent with the Operator API
+    // handler and determine the accept type regardless of the type of
+    // request. However, to maintain backwards compatibility, it
+    // determines the accept type only if the response will not be empty.
+    if (result.call->type() == scheduler::Call::SUBSCRIBE ||
+        result.call->type() == scheduler::Call::RECONCILE_OPERATIONS) {
+      if (request.acceptsMediaType(APPLICATION_JSON)) {
+        result.acceptType = ContentType::JSON;
+      } else if (request.acceptsMediaType(APPLICATION_PROTOBUF)) {
+        result.acceptType = ContentType::PROTOBUF;
+      } else {
+        result.call = None();
+        result.response = NotAcceptable(
+            string("Expecting 'Accept' to allow ") +
+            "'" + APPLICATION_PROTOBUF + "' or '" + APPLICATION_JSON + "'");
+      }
+    }
+
+    return result;
+  }
+};
+
+
+CallDecoder::CallDecoder(size_t workers)
+{
+  CHECK_GT(workers, 0u);
+
+  for (size_t i = 0; i < workers; i++) {
+    processes.push_back(Owned<CallDecoderProcess>(new CallDecoderProcess()));
+    spawn(processes.back().get());
+  }
+}
+
+
+CallDecoder::~CallDecoder()
+{
+  foreach (const Owned<CallDecoderProcess>& process, processes) {
+    terminate(process.get());
+    wait(process.get());
+  }
+}
+
+
+Future<CallDecoder::Result> CallDecoder::decode(
+    const process::http::Request& request,
+    const Option<Principal>& principal)
+{
+  // The calls of a framework other than SUBSCRIBE carry the ID of its
+  // stream, the calls without one are partitioned by their client.
+  Option<string> streamId = request.headers.get("Mesos-Stream-Id");
+
+  const string key = streamId.isSome()
+    ? streamId.get()
+    : (request.client.isSome() ? stringify(request.client.get()) : "");
+
+  const Owned<CallDecoderProcess>& process =
+    processes[std::hash<string>()(key) % processes.size()];
+
+  return dispatch(
+      process.get(), &CallDecoderProcess::decode, request, principal);
+}
+
+} // namespace master {
+} // namespace internal {
+} // namespace mesos {
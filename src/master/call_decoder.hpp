@@ -0,0 +1,84 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __MASTER_CALL_DECODER_HPP__
+#define __MASTER_CALL_DECODER_HPP__
+
+#include <vector>
+
+#include <mesos/scheduler/scheduler.hpp>
+
+#include <process/authenticator.hpp>
+#include <process/future.hpp>
+#include <process/http.hpp>
+#include <process/owned.hpp>
+
+#include <stout/option.hpp>
+
+#include "common/http.hpp"
+
+namespace mesos {
+namespace internal {
+namespace master {
+
+// Forward declaration.
+class CallDecoderProcess;
+
+
+// Decodes and validates the scheduler calls of the `/api/v1/scheduler`
+// endpoint off the master actor. The requests are partitioned over a
+// pool of processes by the stream of the framework which sent them, so
+// that the requests of a framework are decoded in order while the
+// requests of different frameworks are decoded in parallel. The master
+// actor only handles the calls which have been decoded successfully.
+class CallDecoder
+{
+public:
+  struct Result
+  {
+    // The decoded call. This is none if the request body could not be
+    // decoded.
+    Option<scheduler::Call> call;
+
+    // The response to the request if it is rejected. If the call has
+    // been decoded but failed validation, both fields are set.
+    Option<process::http::Response> response;
+
+    // The content type of the events sent in response to the call.
+    // NOTE: This is only determined for the calls which send a body.
+    ContentType acceptType = ContentType::PROTOBUF;
+  };
+
+  explicit CallDecoder(size_t workers);
+
+  ~CallDecoder();
+
+  process::Future<Result> decode(
+      const process::http::Request& request,
+      const Option<process::http::authentication::Principal>& principal);
+
+private:
+  CallDecoder(const CallDecoder&) = delete;
+  CallDecoder& operator=(const CallDecoder&) = delete;
+
+  std::vector<process::Owned<CallDecoderProcess>> processes;
+};
+
+} // namespace master {
+} // namespace internal {
+} // namespace mesos {
+
+#endif // __MASTER_CALL_DECODER_HPP__
@@ -0,0 +1,121 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "master/compact_task.hpp"
+
+#include <algorithm>
+
+#include <glog/logging.h>
+
+using std::shared_ptr;
+using std::string;
+
+namespace mesos {
+namespace internal {
+namespace master {
+
+shared_ptr<const string> TaskInterner::intern(string&& part)
+{
+  if (part.empty()) {
+    return nullptr;
+  }
+
+  // NOTE: The part is moved rather than copied into the candidate,
+  // which is dropped if an equal part is interned already.
+  shared_ptr<const string> candidate(new string(std::move(part)));
+
+  auto iterator = parts.find(candidate);
+  if (iterator != parts.end()) {
+    return *iterator;
+  }
+
+  // Drop the parts which are no longer referred to by any task, i.e.,
+  // only by the set. The threshold is doubled to keep the amortized
+  // cost constant.
+  if (parts.size() >= threshold) {
+    for (auto it = parts.begin(); it != parts.end();) {
+      if (it->use_count() == 1) {
+        it = parts.erase(it);
+      } else {
+        ++it;
+      }
+    }
+
+    threshold = std::max(threshold, parts.size() * 2);
+  }
+
+  parts.insert(candidate);
+
+  return candidate;
+}
+
+
+CompactTask::CompactTask(Task _task, TaskInterner* interner)
+  : taskId(_task.task_id()),
+    slaveId(_task.slave_id()),
+    state_(_task.state())
+{
+  CHECK_NOTNULL(interner);
+
+  Task part;
+  part.mutable_resources()->Swap(_task.mutable_resources());
+  resources = interner->intern(part.SerializePartialAsString());
+
+  part.Clear();
+  if (_task.has_labels()) {
+    part.mutable_labels()->Swap(_task.mutable_labels());
+    _task.clear_labels();
+    labels = interner->intern(part.SerializePartialAsString());
+  }
+
+  part.Clear();
+  if (_task.has_container()) {
+    part.mutable_container()->Swap(_task.mutable_container());
+    _task.clear_container();
+    container = interner->intern(part.SerializePartialAsString());
+  }
+
+  part.Clear();
+  if (_task.has_health_check()) {
+    part.mutable_health_check()->Swap(_task.mutable_health_check());
+    _task.clear_health_check();
+    healthCheck = interner->intern(part.SerializePartialAsString());
+  }
+
+  task = _task.SerializeAsString();
+}
+
+
+Task CompactTask::expand() const
+{
+  Task _task;
+  CHECK(_task.ParseFromString(task));
+
+  // Merging a serialized part is the same as parsing the concatenation
+  // of the serialized task and the part.
+  for (const shared_ptr<const string>& part :
+       {resources, labels, container, healthCheck}) {
+    if (part) {
+      CHECK(_task.MergeFromString(*part));
+    }
+  }
+
+  return _task;
+}
+
+} // namespace master {
+} // namespace internal {
+} // namespace mesos {
@@ -0,0 +1,110 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __MASTER_COMPACT_TASK_HPP__
+#define __MASTER_COMPACT_TASK_HPP__
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include <mesos/mesos.hpp>
+
+#include <stout/hashset.hpp>
+
+namespace mesos {
+namespace internal {
+namespace master {
+
+// Interns the parts of tasks which tend to be identical across the
+// tasks of a framework, e.g., the resources, labels, container and
+// health check of the tasks launched from the same template. A part
+// is kept as long as a task refers to it.
+class TaskInterner
+{
+public:
+  // Returns the shared copy of the given serialized part.
+  std::shared_ptr<const std::string> intern(std::string&& part);
+
+private:
+  // Hashes and compares the parts by their content, so that each part
+  // is stored once and shared between the set and the tasks.
+  struct Hash
+  {
+    size_t operator()(const std::shared_ptr<const std::string>& part) const
+    {
+      return std::hash<std::string>()(*part);
+    }
+  };
+
+  struct Equal
+  {
+    bool operator()(
+        const std::shared_ptr<const std::string>& left,
+        const std::shared_ptr<const std::string>& right) const
+    {
+      return *left == *right;
+    }
+  };
+
+  hashset<std::shared_ptr<const std::string>, Hash, Equal> parts;
+
+  // The number of parts after which the parts which are no longer
+  // referred to by any task are dropped.
+  size_t threshold = 1024;
+};
+
+
+// A completed or unreachable task kept in a compact form: the task is
+// serialized, and the parts which are shared with other tasks of the
+// framework are interned. The fields needed to index the task are kept
+// as is, the full task is only expanded when an endpoint or an event
+// needs it.
+//
+// TODO(bmahler): Consider storing the running tasks in this form too.
+class CompactTask
+{
+public:
+  CompactTask(Task task, TaskInterner* interner);
+
+  const TaskID& task_id() const { return taskId; }
+  const SlaveID& slave_id() const { return slaveId; }
+  TaskState state() const { return state_; }
+
+  // Returns the full task.
+  Task expand() const;
+
+private:
+  TaskID taskId;
+  SlaveID slaveId;
+  TaskState state_;
+
+  // The serialized task without the interned parts.
+  std::string task;
+
+  // The interned parts, each of which is a serialized `Task` only
+  // holding the interned field.
+  std::shared_ptr<const std::string> resources;
+  std::shared_ptr<const std::string> labels;
+  std::shared_ptr<const std::string> container;
+  std::shared_ptr<const std::string> healthCheck;
+};
+
+} // namespace master {
+} // namespace internal {
+} // namespace mesos {
+
+#endif // __MASTER_COMPACT_TASK_HPP__
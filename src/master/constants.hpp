@@ -41,6 +41,14 @@ namespace master {
 // Maximum number of slot offers to have outstanding for each framework.
 constexpr int MAX_OFFERS_PER_FRAMEWORK = 50;
 
+// Maximum number of processes which decode the calls of HTTP schedulers
+// before the master processes the calls.
+constexpr size_t MAX_CALL_DECODERS = 8;
+
+// Maximum number of processes which validate and authorize the tasks
+// in ACCEPT calls before the master processes the calls.
+constexpr size_t MAX_LAUNCH_VALIDATORS = 8;
+
 // Minimum number of cpus per offer.
 constexpr double MIN_CPUS = 0.01;
 
@@ -70,6 +78,14 @@ constexpr Duration DEFAULT_AGENT_PING_TIMEOUT = Seconds(15);
 // Maximum number of ping timeouts until slave is considered failed.
 constexpr size_t DEFAULT_MAX_AGENT_PING_TIMEOUTS = 5;
 
+// Default maximum number of agent re-registrations which the master
+// processes concurrently.
+constexpr size_t DEFAULT_MAX_AGENT_REREGISTRATIONS = 1000;
+
+// The delay after which an agent whose re-registration was throttled
+// retries it. The agent spreads its retry over up to twice this delay.
+constexpr Duration AGENT_REREGISTRATION_RETRY_INTERVAL = Seconds(5);
+
 // The minimum timeout that can be used by a newly elected leader to
 // allow re-registration of slaves. Any slaves that do not reregister
 // within this timeout will be marked unreachable; if/when the agent
@@ -114,6 +114,13 @@ mesos::internal::master::Flags::Flags()
       "after which the operation is considered a failure.",
       Seconds(20));
 
+  add(&Flags::registry_follow_interval,
+      "registry_follow_interval",
+      "If set, a non-leading master follows the registry at this interval\n"
+      "and keeps the recovered agents prebuilt, so that it can take over\n"
+      "quickly once elected. Only the `replicated_log` registry benefits\n"
+      "from following, since the log is then read incrementally.");
+
   add(&Flags::log_auto_initialize,
       "log_auto_initialize",
       "Whether to automatically initialize the replicated log used for the\n"
@@ -543,6 +550,24 @@ mesos::internal::master::Flags::Flags()
         return None();
       });
 
+  add(&Flags::max_agent_reregistrations,
+      "max_agent_reregistrations",
+      "Maximum number of agent re-registrations which the master processes\n"
+      "concurrently. Agents which attempt to reregister while the limit is\n"
+      "reached, e.g., right after a master failover, are asked to retry\n"
+      "their re-registration later. This bounds the backlog of the master\n"
+      "during a re-registration storm.\n"
+      "NOTE: The agents still have to reregister within\n"
+      "`--agent_reregister_timeout`.",
+      DEFAULT_MAX_AGENT_REREGISTRATIONS,
+      [](size_t value) -> Option<Error> {
+        if (value < 1) {
+          return Error(
+              "Expected `--max_agent_reregistrations` to be at least 1");
+        }
+        return None();
+      });
+
   add(&Flags::authorizers,
       "authorizers",
       "Authorizer implementation to use when authorizing actions that\n"
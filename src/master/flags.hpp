@@ -54,6 +54,7 @@ public:
   bool registry_strict;
   Duration registry_fetch_timeout;
   Duration registry_store_timeout;
+  Option<Duration> registry_follow_interval;
   bool log_auto_initialize;
   Duration agent_reregister_timeout;
   std::string recovery_agent_removal_limit;
@@ -87,6 +88,7 @@ public:
   Option<std::string> hooks;
   Duration agent_ping_timeout;
   size_t max_agent_ping_timeouts;
+  size_t max_agent_reregistrations;
   std::string authorizers;
   std::string http_authenticators;
   Option<std::string> http_framework_authenticators;
@@ -16,6 +16,8 @@
 
 #include "master/master.hpp"
 
+#include <process/clock.hpp>
+
 #include "common/heartbeater.hpp"
 #include "common/protobuf_utils.hpp"
 
@@ -118,6 +120,7 @@ void Framework::addTask(Task* task)
   }
 
   tasks[task->task_id()] = task;
+  taskUpdateTimes[task->task_id()] = process::Clock::now();
 
   // Unreachable tasks should be added via `addUnreachableTask`.
   CHECK(task->state() != TASK_UNREACHABLE)
@@ -203,14 +206,17 @@ void Framework::addCompletedTask(Task&& task)
   // means that there might be multiple completed tasks with the
   // same task ID. We should consider rejecting attempts to reuse
   // task IDs (MESOS-6779).
-  completedTasks.push_back(process::Owned<Task>(new Task(std::move(task))));
+  completedTasks.push_back(process::Owned<CompactTask>(
+      new CompactTask(std::move(task), &taskInterner)));
 }
 
 
 void Framework::addUnreachableTask(const Task& task)
 {
   // TODO(adam-mesos): Check if unreachable task already exists.
-  unreachableTasks.set(task.task_id(), process::Owned<Task>(new Task(task)));
+  unreachableTasks.set(
+      task.task_id(),
+      process::Owned<CompactTask>(new CompactTask(task, &taskInterner)));
 }
 
 
@@ -238,6 +244,7 @@ void Framework::removeTask(Task* task, bool unreachable)
   }
 
   tasks.erase(task->task_id());
+  taskUpdateTimes.erase(task->task_id());
 }
 
 
@@ -653,12 +660,17 @@ void Framework::closeHttpConnection()
 {
   CHECK_SOME(http);
 
-  if (connected() && !http->close()) {
-    LOG(WARNING) << "Failed to close HTTP pipe for " << *this;
+  if (connected()) {
+    flushEvents();
+
+    if (!http->close()) {
+      LOG(WARNING) << "Failed to close HTTP pipe for " << *this;
+    }
   }
 
   http = None();
   heartbeater.reset();
+  batchedEvents = None();
 }
 
 
@@ -684,6 +696,64 @@ void Framework::heartbeat()
 }
 
 
+void Framework::flushEvents()
+{
+  if (batchedEvents.isNone()) {
+    return;
+  }
+
+  v1::scheduler::Event event = std::move(batchedEvents.get());
+  batchedEvents = None();
+
+  // A single event is sent as is rather than in a 'BATCH' event.
+  if (event.batch().events_size() == 1) {
+    v1::scheduler::Event single =
+      std::move(*event.mutable_batch()->mutable_events(0));
+
+    event = std::move(single);
+  }
+
+  if (http.isNone() || !http->send(event)) {
+    LOG(WARNING) << "Unable to send batched events to framework " << *this
+                 << ": connection closed";
+  }
+}
+
+
+bool Framework::batch(const StatusUpdateMessage& message)
+{
+  return _batch(evolve(message));
+}
+
+
+bool Framework::batch(const ResourceOffersMessage& message)
+{
+  return _batch(evolve(message));
+}
+
+
+bool Framework::_batch(v1::scheduler::Event&& event)
+{
+  if (!capabilities.batchEvents) {
+    return false;
+  }
+
+  if (batchedEvents.isNone()) {
+    batchedEvents = v1::scheduler::Event();
+    batchedEvents->set_type(v1::scheduler::Event::BATCH);
+
+    // The batched events are sent once the master has processed the
+    // messages which are already queued, so that the events generated
+    // while processing them end up in the same 'BATCH' event.
+    process::dispatch(master->self(), &Master::flushFrameworkEvents, id());
+  }
+
+  *batchedEvents->mutable_batch()->add_events() = std::move(event);
+
+  return true;
+}
+
+
 bool Framework::isTrackedUnderRole(const std::string& role) const
 {
   CHECK(master->isWhitelistedRole(role))
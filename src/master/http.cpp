@@ -496,68 +496,39 @@ Future<Response> Master::Http::scheduler(
     return MethodNotAllowed({"POST"}, request.method);
   }
 
-  v1::scheduler::Call v1Call;
+  // The call is decoded and validated off the master actor.
+  return master->callDecoder->decode(request, principal)
+    .then(defer(
+        master->self(),
+        [this, request, principal](const CallDecoder::Result& result) {
+          return _scheduler(request, principal, result);
+        }));
+}
 
-  // TODO(anand): Content type values are case-insensitive.
-  Option<string> contentType = request.headers.get("Content-Type");
 
-  if (contentType.isNone()) {
-    return BadRequest("Expecting 'Content-Type' to be present");
+Future<Response> Master::Http::_scheduler(
+    const Request& request,
+    const Option<Principal>& principal,
+    CallDecoder::Result result) const
+{
+  // The master might have lost its leadership while the call was being
+  // decoded.
+  if (!master->elected()) {
+    return redirect(request);
   }
 
-  if (contentType.get() == APPLICATION_PROTOBUF) {
-    if (!v1Call.ParseFromString(request.body)) {
-      return BadRequest("Failed to parse body into Call protobuf");
-    }
-  } else if (contentType.get() == APPLICATION_JSON) {
-    Try<JSON::Value> value = JSON::parse(request.body);
-
-    if (value.isError()) {
-      return BadRequest("Failed to parse body into JSON: " + value.error());
-    }
-
-    Try<v1::scheduler::Call> parse =
-      ::protobuf::parse<v1::scheduler::Call>(value.get());
-
-    if (parse.isError()) {
-      return BadRequest("Failed to convert JSON into Call protobuf: " +
-                        parse.error());
+  if (result.response.isSome()) {
+    if (result.call.isSome()) {
+      master->metrics->incrementInvalidSchedulerCalls(result.call.get());
     }
 
-    v1Call = parse.get();
-  } else {
-    return UnsupportedMediaType(
-        string("Expecting 'Content-Type' of ") +
-        APPLICATION_JSON + " or " + APPLICATION_PROTOBUF);
-  }
-
-  scheduler::Call call = devolve(v1Call);
-
-  Option<Error> error = validation::scheduler::call::validate(call, principal);
-
-  if (error.isSome()) {
-    master->metrics->incrementInvalidSchedulerCalls(call);
-    return BadRequest("Failed to validate scheduler::Call: " + error->message);
+    return result.response.get();
   }
 
-  ContentType acceptType;
+  CHECK_SOME(result.call);
 
-  // Ideally this handler would be consistent with the Operator API handler
-  // and determine the accept type regardless of the type of request.
-  // However, to maintain backwards compatibility, it determines the accept
-  // type only if the response will not be empty.
-  if (call.type() == scheduler::Call::SUBSCRIBE ||
-      call.type() == scheduler::Call::RECONCILE_OPERATIONS) {
-    if (request.acceptsMediaType(APPLICATION_JSON)) {
-      acceptType = ContentType::JSON;
-    } else if (request.acceptsMediaType(APPLICATION_PROTOBUF)) {
-      acceptType = ContentType::PROTOBUF;
-    } else {
-      return NotAcceptable(
-          string("Expecting 'Accept' to allow ") +
-          "'" + APPLICATION_PROTOBUF + "' or '" + APPLICATION_JSON + "'");
-    }
-  }
+  scheduler::Call& call = result.call.get();
+  const ContentType acceptType = result.acceptType;
 
   if (call.type() == scheduler::Call::SUBSCRIBE) {
     // Make sure that a stream ID was not included in the request headers.
@@ -648,6 +619,14 @@ Future<Response> Master::Http::scheduler(
         + framework->id().value());
   }
 
+  return __scheduler(framework, std::move(call));
+}
+
+
+Response Master::Http::__scheduler(
+    Framework* framework,
+    scheduler::Call&& call) const
+{
   switch (call.type()) {
     case scheduler::Call::SUBSCRIBE:
       // SUBSCRIBE call should have been handled above.
@@ -715,6 +694,26 @@ Future<Response> Master::Http::scheduler(
       master->request(framework, call.request());
       return Accepted();
 
+    case scheduler::Call::BATCH:
+      // The calls are processed in this dispatch, so no other event can
+      // interleave with them. The validation guarantees that none of the
+      // calls removes the framework.
+      foreach (scheduler::Call& _call, *call.mutable_batch()->mutable_calls()) {
+        const scheduler::Call::Type type = _call.type();
+
+        framework->metrics.incrementCall(type);
+
+        Response response = __scheduler(framework, std::move(_call));
+
+        if (response.code != process::http::Status::ACCEPTED) {
+          LOG(WARNING) << "Failed to process '"
+                       << scheduler::Call::Type_Name(type) << "' call in"
+                       << " 'BATCH' call of framework " << *framework
+                       << ": " << response.status;
+        }
+      }
+      return Accepted();
+
     case scheduler::Call::UNKNOWN:
       LOG(WARNING) << "Received 'UNKNOWN' call";
       return NotImplemented();
@@ -3059,23 +3058,28 @@ mesos::master::Response::GetTasks Master::Http::_getTasks(
     }
 
     // Unreachable tasks.
-    foreachvalue (const Owned<Task>& task, framework->unreachableTasks) {
+    foreachvalue (const Owned<CompactTask>& compact,
+                  framework->unreachableTasks) {
+      Task task = compact->expand();
+
       // Skip unauthorized tasks.
-      if (!approvers->approved<VIEW_TASK>(*task, framework->info)) {
+      if (!approvers->approved<VIEW_TASK>(task, framework->info)) {
         continue;
       }
 
-      getTasks.add_unreachable_tasks()->CopyFrom(*task);
+      getTasks.add_unreachable_tasks()->Swap(&task);
     }
 
     // Completed tasks.
-    foreach (const Owned<Task>& task, framework->completedTasks) {
+    foreach (const Owned<CompactTask>& compact, framework->completedTasks) {
+      Task task = compact->expand();
+
       // Skip unauthorized tasks.
-      if (!approvers->approved<VIEW_TASK>(*task, framework->info)) {
+      if (!approvers->approved<VIEW_TASK>(task, framework->info)) {
         continue;
       }
 
-      getTasks.add_completed_tasks()->CopyFrom(*task);
+      getTasks.add_completed_tasks()->Swap(&task);
     }
   }
 
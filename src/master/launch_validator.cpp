@@ -0,0 +1,185 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "master/launch_validator.hpp"
+
+#include <functional>
+#include <memory>
+
+#include <glog/logging.h>
+
+#include <mesos/type_utils.hpp>
+
+#include <process/collect.hpp>
+#include <process/defer.hpp>
+#include <process/dispatch.hpp>
+#include <process/id.hpp>
+#include <process/process.hpp>
+
+#include <stout/check.hpp>
+#include <stout/foreach.hpp>
+#include <stout/lambda.hpp>
+
+#include "master/validation.hpp"
+
+using process::defer;
+using process::dispatch;
+using process::spawn;
+using process::terminate;
+using process::wait; // Necessary on some OS's to disambiguate.
+
+using process::Future;
+using process::Owned;
+using process::Process;
+
+using std::vector;
+
+namespace mesos {
+namespace internal {
+namespace master {
+
+class LaunchValidatorProcess : public Process<LaunchValidatorProcess>
+{
+public:
+  explicit LaunchValidatorProcess(const Option<Authorizer*>& _authorizer)
+    : ProcessBase(process::ID::generate("launch-validator")),
+      authorizer(_authorizer) {}
+
+  Future<vector<LaunchValidator::Result>> validate(
+      const std::shared_ptr<const vector<LaunchValidator::Task>>& tasks,
+      const FrameworkInfo& frameworkInfo)
+  {
+    vector<Future<bool>> authorizations;
+    vector<Option<Error>> errors;
+
+    foreach (const LaunchValidator::Task& task, *tasks) {
+      authorizations.push_back(authorize(task.info, frameworkInfo));
+
+      // Task groups are validated as a whole by the master.
+      errors.push_back(
+          task.grouped
+            ? Option<Error>::none()
+            : validation::task::validateStateless(task.info));
+    }
+
+    return process::await(authorizations)
+      .then(defer(self(), &Self::_validate, errors, lambda::_1));
+  }
+
+private:
+  Future<bool> authorize(
+      const TaskInfo& task,
+      const FrameworkInfo& frameworkInfo)
+  {
+    if (authorizer.isNone()) {
+      return true; // Authorization is disabled.
+    }
+
+    authorization::Request request;
+
+    if (frameworkInfo.has_principal()) {
+      request.mutable_subject()->set_value(frameworkInfo.principal());
+    }
+
+    request.set_action(authorization::RUN_TASK);
+
+    authorization::Object* object = request.mutable_object();
+
+    *object->mutable_task_info() = task;
+    *object->mutable_framework_info() = frameworkInfo;
+
+    LOG(INFO)
+      << "Authorizing framework principal '"
+      << (frameworkInfo.has_principal() ? frameworkInfo.principal() : "ANY")
+      << "' to launch task " << task.task_id();
+
+    return authorizer.get()->authorized(request);
+  }
+
+  vector<LaunchValidator::Result> _validate(
+      const vector<Option<Error>>& errors,
+      const vector<Future<bool>>& authorizations)
+  {
+    CHECK_EQ(errors.size(), authorizations.size());
+
+    vector<LaunchValidator::Result> results;
+
+    for (size_t i = 0; i < errors.size(); i++) {
+      const Future<bool>& authorization = authorizations[i];
+
+      CHECK(!authorization.isPending());
+
+      if (authorization.isReady()) {
+        results.push_back({authorization.get(), errors[i]});
+      } else {
+        results.push_back({
+            Error(authorization.isFailed()
+                    ? authorization.failure()
+                    : "Authorization was discarded"),
+            errors[i]});
+      }
+    }
+
+    return results;
+  }
+
+  const Option<Authorizer*> authorizer;
+};
+
+
+LaunchValidator::LaunchValidator(
+    const Option<Authorizer*>& authorizer,
+    size_t workers)
+{
+  CHECK_GT(workers, 0u);
+
+  for (size_t i = 0; i < workers; i++) {
+    processes.push_back(Owned<LaunchValidatorProcess>(
+        new LaunchValidatorProcess(authorizer)));
+
+    spawn(processes.back().get());
+  }
+}
+
+
+LaunchValidator::~LaunchValidator()
+{
+  foreach (const Owned<LaunchValidatorProcess>& process, processes) {
+    terminate(process.get());
+    wait(process.get());
+  }
+}
+
+
+Future<vector<LaunchValidator::Result>> LaunchValidator::validate(
+    const std::shared_ptr<const vector<Task>>& tasks,
+    const FrameworkInfo& frameworkInfo)
+{
+  // The calls of a framework are pre-processed by the same process, so
+  // that they reach the master in the order in which they were made.
+  const Owned<LaunchValidatorProcess>& process =
+    processes[std::hash<FrameworkID>()(frameworkInfo.id()) % processes.size()];
+
+  return dispatch(
+      process.get(),
+      &LaunchValidatorProcess::validate,
+      tasks,
+      frameworkInfo);
+}
+
+} // namespace master {
+} // namespace internal {
+} // namespace mesos {
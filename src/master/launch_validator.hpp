@@ -0,0 +1,98 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __MASTER_LAUNCH_VALIDATOR_HPP__
+#define __MASTER_LAUNCH_VALIDATOR_HPP__
+
+#include <memory>
+#include <vector>
+
+#include <mesos/mesos.hpp>
+
+#include <mesos/authorizer/authorizer.hpp>
+
+#include <process/future.hpp>
+#include <process/owned.hpp>
+
+#include <stout/error.hpp>
+#include <stout/option.hpp>
+#include <stout/try.hpp>
+
+namespace mesos {
+namespace internal {
+namespace master {
+
+// Forward declaration.
+class LaunchValidatorProcess;
+
+
+// Pre-processes the tasks of the LAUNCH and LAUNCH_GROUP operations in
+// ACCEPT calls off the master actor: the authorization requests for the
+// tasks are built and sent, and the parts of the tasks which do not
+// depend on the state of the master are validated. The work is spread
+// over a pool of processes, so that the ACCEPT calls of different
+// frameworks are pre-processed in parallel, while the calls of a
+// framework are pre-processed in order. The master only performs the
+// remaining checks, see `validation::task::validateStateful`.
+class LaunchValidator
+{
+public:
+  // A task of a LAUNCH or LAUNCH_GROUP operation.
+  struct Task
+  {
+    TaskInfo info;
+
+    // Whether the task is part of a LAUNCH_GROUP operation.
+    bool grouped;
+  };
+
+  // The outcome of pre-processing a task.
+  struct Result
+  {
+    // Whether the task is authorized, or an error if the
+    // authorization failed.
+    Try<bool> authorized;
+
+    // The first error found by `validation::task::validateStateless`.
+    // NOTE: Task groups are validated as a whole by the master, so
+    // this is always none for the tasks of LAUNCH_GROUP operations.
+    Option<Error> error;
+  };
+
+  // Authorization is disabled if `authorizer` is none.
+  LaunchValidator(const Option<Authorizer*>& authorizer, size_t workers);
+
+  ~LaunchValidator();
+
+  // Returns the outcomes for the given tasks, in the same order. The
+  // tasks are shared rather than copied; they are only read before the
+  // returned future is completed and must not be modified until then.
+  process::Future<std::vector<Result>> validate(
+      const std::shared_ptr<const std::vector<Task>>& tasks,
+      const FrameworkInfo& frameworkInfo);
+
+private:
+  LaunchValidator(const LaunchValidator&) = delete;
+  LaunchValidator& operator=(const LaunchValidator&) = delete;
+
+  std::vector<process::Owned<LaunchValidatorProcess>> processes;
+};
+
+} // namespace master {
+} // namespace internal {
+} // namespace mesos {
+
+#endif // __MASTER_LAUNCH_VALIDATOR_HPP__
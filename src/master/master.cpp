@@ -43,6 +43,7 @@
 
 #include <mesos/scheduler/scheduler.hpp>
 
+#include <process/async.hpp>
 #include <process/check.hpp>
 #include <process/collect.hpp>
 #include <process/defer.hpp>
@@ -67,6 +68,7 @@
 #include <stout/nothing.hpp>
 #include <stout/numify.hpp>
 #include <stout/option.hpp>
+#include <stout/os.hpp>
 #include <stout/path.hpp>
 #include <stout/stringify.hpp>
 #include <stout/unreachable.hpp>
@@ -791,6 +793,19 @@ void Master::initialize()
       defer(self(), &Master::offer, lambda::_1, lambda::_2),
       defer(self(), &Master::inverseOffer, lambda::_1, lambda::_2));
 
+  // The calls of HTTP schedulers are decoded, and the tasks in ACCEPT
+  // calls are validated and authorized, by pools of processes before
+  // the master processes the calls.
+  Try<long> cpus = os::cpus();
+  const size_t workers = cpus.isSome() ? static_cast<size_t>(cpus.get()) : 1;
+
+  callDecoder.reset(
+      new CallDecoder(std::min(workers, MAX_CALL_DECODERS)));
+
+  launchValidator.reset(new LaunchValidator(
+      authorizer,
+      std::min(workers, MAX_LAUNCH_VALIDATORS)));
+
   // Parse the whitelist. Passing Allocator::updateWhitelist()
   // callback is safe because we shut down the whitelistWatcher in
   // Master::finalize(), while allocator lifetime is greater than
@@ -1127,6 +1142,12 @@ void Master::initialize()
     .onAny(defer(self(), &Master::contended, lambda::_1));
   detector->detect()
     .onAny(defer(self(), &Master::detected, lambda::_1));
+
+  if (flags.registry_follow_interval.isSome()) {
+    delay(flags.registry_follow_interval.get(),
+          self(),
+          &Self::followRegistry);
+  }
 }
 
 
@@ -1686,6 +1707,16 @@ Future<Nothing> Master::_recover(const Registry& registry)
   }
 
   foreach (const Registry::Slave& slave, registry.slaves().slaves()) {
+    const SlaveID& slaveId = slave.info().id();
+
+    // Reuse the agent prebuilt while following the registry, unless it
+    // has changed since.
+    if (standby.stored.contains(slaveId) &&
+        standby.stored.at(slaveId) == slave.info()) {
+      slaves.recovered.put(slaveId, standby.recovered.at(slaveId));
+      continue;
+    }
+
     SlaveInfo slaveInfo = slave.info();
 
     // We store the `SlaveInfo`'s resources in the `pre-reservation-refinement`
@@ -1697,6 +1728,9 @@ Future<Nothing> Master::_recover(const Registry& registry)
     slaves.recovered.put(slaveInfo.id(), slaveInfo);
   }
 
+  standby.stored.clear();
+  standby.recovered.clear();
+
   foreach (const Registry::UnreachableSlave& unreachable,
            registry.unreachable().slaves()) {
     CHECK(!slaves.unreachable.contains(unreachable.id()));
@@ -1796,6 +1830,63 @@ Future<Nothing> Master::_recover(const Registry& registry)
 }
 
 
+void Master::followRegistry()
+{
+  // Once elected, the registry is recovered rather than followed.
+  if (elected()) {
+    return;
+  }
+
+  registrar->follow()
+    .onAny(defer(self(), &Self::_followRegistry, lambda::_1));
+}
+
+
+void Master::_followRegistry(const Future<Registry>& registry)
+{
+  if (elected()) {
+    return;
+  }
+
+  if (!registry.isReady()) {
+    LOG(WARNING) << "Failed to follow the registry: "
+                 << (registry.isFailed() ? registry.failure() : "discarded");
+  } else {
+    hashset<SlaveID> slaveIds;
+
+    foreach (const Registry::Slave& slave, registry->slaves().slaves()) {
+      const SlaveInfo& stored = slave.info();
+      slaveIds.insert(stored.id());
+
+      if (standby.stored.contains(stored.id()) &&
+          standby.stored.at(stored.id()) == stored) {
+        continue;
+      }
+
+      SlaveInfo slaveInfo = stored;
+      upgradeResources(&slaveInfo);
+
+      standby.stored[stored.id()] = stored;
+      standby.recovered[stored.id()] = std::move(slaveInfo);
+    }
+
+    foreach (const SlaveID& slaveId, standby.stored.keys()) {
+      if (!slaveIds.contains(slaveId)) {
+        standby.stored.erase(slaveId);
+        standby.recovered.erase(slaveId);
+      }
+    }
+
+    VLOG(1) << "Followed the registry with "
+            << standby.recovered.size() << " agents";
+  }
+
+  delay(flags.registry_follow_interval.get(),
+        self(),
+        &Self::followRegistry);
+}
+
+
 void Master::scheduleRegistryGc()
 {
   registryGcTimer = delay(flags.registry_gc_interval,
@@ -2488,6 +2579,10 @@ void Master::receive(
       suppress(framework, call.suppress());
       break;
 
+    case scheduler::Call::BATCH:
+      drop(from, call, "'BATCH' is not supported by the v0 API");
+      break;
+
     case scheduler::Call::UNKNOWN:
       LOG(WARNING) << "'UNKNOWN' call";
       break;
@@ -3559,39 +3654,6 @@ void Master::launchTasks(
 }
 
 
-Future<bool> Master::authorizeTask(
-    const TaskInfo& task,
-    Framework* framework)
-{
-  CHECK_NOTNULL(framework);
-
-  if (authorizer.isNone()) {
-    return true; // Authorization is disabled.
-  }
-
-  // Authorize the task.
-  authorization::Request request;
-
-  if (framework->info.has_principal()) {
-    request.mutable_subject()->set_value(framework->info.principal());
-  }
-
-  request.set_action(authorization::RUN_TASK);
-
-  authorization::Object* object = request.mutable_object();
-
-  object->mutable_task_info()->CopyFrom(task);
-  object->mutable_framework_info()->CopyFrom(framework->info);
-
-  LOG(INFO)
-    << "Authorizing framework principal '"
-    << (framework->info.has_principal() ? framework->info.principal() : "ANY")
-    << "' to launch task " << task.task_id();
-
-  return authorizer.get()->authorized(request);
-}
-
-
 Future<bool> Master::authorizeReserveResources(
     const Offer::Operation::Reserve& reserve,
     const Option<Principal>& principal)
@@ -4569,24 +4631,70 @@ void Master::accept(
   LOG(INFO) << "Processing ACCEPT call for offers: " << accept.offer_ids()
             << " on agent " << *slave << " for framework " << *framework;
 
+  // Authorize and validate the tasks off the master actor. The tasks
+  // are moved out of the operations and shared with the launch
+  // validator rather than copied; they are moved back in `_accept`.
+  std::shared_ptr<vector<LaunchValidator::Task>> launchTasks(
+      new vector<LaunchValidator::Task>());
+
+  foreach (Offer::Operation& operation, *accept.mutable_operations()) {
+    if (operation.type() == Offer::Operation::LAUNCH) {
+      foreach (
+          TaskInfo& task,
+          *operation.mutable_launch()->mutable_task_infos()) {
+        launchTasks->push_back({std::move(task), false});
+      }
+    } else if (operation.type() == Offer::Operation::LAUNCH_GROUP) {
+      foreach (
+          TaskInfo& task,
+          *operation.mutable_launch_group()->mutable_task_group()
+            ->mutable_tasks()) {
+        launchTasks->push_back({std::move(task), true});
+      }
+    }
+  }
+
+  // NOTE: The launch validator is only used if there are tasks, which
+  // ensures that the outcomes are ready once the authorizations of the
+  // tasks below are.
+  Future<vector<LaunchValidator::Result>> launches =
+    vector<LaunchValidator::Result>();
+
+  if (!launchTasks->empty()) {
+    launches = launchValidator->validate(launchTasks, framework->info);
+  }
+
+  // The index of the next task in the outcomes of the launch validator.
+  size_t index = 0;
+
   vector<Future<bool>> futures;
   foreach (const Offer::Operation& operation, accept.operations()) {
     switch (operation.type()) {
       case Offer::Operation::LAUNCH:
       case Offer::Operation::LAUNCH_GROUP: {
-        const RepeatedPtrField<TaskInfo>& tasks = [&]() {
-          if (operation.type() == Offer::Operation::LAUNCH) {
-            return operation.launch().task_infos();
-          } else if (operation.type() == Offer::Operation::LAUNCH_GROUP) {
-            return operation.launch_group().task_group().tasks();
-          }
-          UNREACHABLE();
-        }();
-
-        // Authorize the tasks. A task is in 'framework->pendingTasks'
-        // and 'slave->pendingTasks' before it is authorized.
-        foreach (const TaskInfo& task, tasks) {
-          futures.push_back(authorizeTask(task, framework));
+        const int size = operation.type() == Offer::Operation::LAUNCH
+          ? operation.launch().task_infos_size()
+          : operation.launch_group().task_group().tasks_size();
+
+        // The tasks are authorized by the launch validator. A task is
+        // in 'framework->pendingTasks' and 'slave->pendingTasks' before
+        // it is authorized.
+        for (int i = 0; i < size; i++) {
+          const TaskInfo& task = launchTasks->at(index).info;
+
+          futures.push_back(
+              launches.then([index](
+                  const vector<LaunchValidator::Result>& results)
+                  -> Future<bool> {
+                const Try<bool>& authorized = results.at(index).authorized;
+                if (authorized.isError()) {
+                  return Failure(authorized.error());
+                }
+
+                return authorized.get();
+              }));
+
+          index++;
 
           // Add to the framework's list of pending tasks.
           //
@@ -4732,6 +4840,8 @@ void Master::accept(
                  slaveId.get(),
                  offeredResources,
                  std::move(accept),
+                 launchTasks,
+                 launches,
                  lambda::_1));
 }
 
@@ -4741,8 +4851,32 @@ void Master::_accept(
     const SlaveID& slaveId,
     const Resources& offeredResources,
     scheduler::Call::Accept&& accept,
+    const std::shared_ptr<vector<LaunchValidator::Task>>& launchTasks,
+    const Future<vector<LaunchValidator::Result>>& launches,
     const Future<vector<Future<bool>>>& _authorizations)
 {
+  // Move the tasks back into the operations, see `accept`.
+  size_t taskIndex = 0;
+
+  foreach (Offer::Operation& operation, *accept.mutable_operations()) {
+    if (operation.type() == Offer::Operation::LAUNCH) {
+      foreach (
+          TaskInfo& task,
+          *operation.mutable_launch()->mutable_task_infos()) {
+        task = std::move(launchTasks->at(taskIndex++).info);
+      }
+    } else if (operation.type() == Offer::Operation::LAUNCH_GROUP) {
+      foreach (
+          TaskInfo& task,
+          *operation.mutable_launch_group()->mutable_task_group()
+            ->mutable_tasks()) {
+        task = std::move(launchTasks->at(taskIndex++).info);
+      }
+    }
+  }
+
+  CHECK_EQ(taskIndex, launchTasks->size());
+
   Framework* framework = getFramework(frameworkId);
 
   // TODO(jieyu): Consider using the 'drop' overload mentioned in
@@ -4871,6 +5005,11 @@ void Master::_accept(
   std::deque<Future<bool>> authorizations(
       _authorizations->begin(), _authorizations->end());
 
+  // The outcomes of pre-processing the tasks by the launch validator,
+  // in the order of the tasks in `accept.operations()`.
+  CHECK_READY(launches);
+  size_t launchIndex = 0;
+
   foreach (const Offer::Operation& operation, accept.operations()) {
     switch (operation.type()) {
       // The RESERVE operation allows a principal to reserve resources.
@@ -5360,6 +5499,9 @@ void Master::_accept(
           Future<bool> authorization = authorizations.front();
           authorizations.pop_front();
 
+          CHECK_LT(launchIndex, launches->size());
+          const LaunchValidator::Result& launch = launches->at(launchIndex++);
+
           // The task will not be in `pendingTasks` if it has been
           // killed in the interim. No need to send TASK_KILLED in
           // this case as it has already been sent. Note however that
@@ -5426,8 +5568,10 @@ void Master::_accept(
           Resources available =
             remainingResources.nonShared() + remainingSharedResources;
 
-          Option<Error> error =
-            validation::task::validate(task, framework, slave, available);
+          // The parts of the task which do not depend on the state of
+          // the master have been validated by the launch validator.
+          Option<Error> error = validation::task::validateStateful(
+              task, framework, slave, available, launch.error);
 
           if (error.isSome()) {
             const StatusUpdate& update = protobuf::createStatusUpdate(
@@ -5610,6 +5754,8 @@ void Master::_accept(
           Future<bool> authorization = authorizations.front();
           authorizations.pop_front();
 
+          launchIndex++;
+
           CHECK(!authorization.isDiscarded());
 
           if (authorization.isFailed()) {
@@ -7173,14 +7319,22 @@ void Master::reregisterSlave(
     return;
   }
 
-  Option<Error> error =
-    validation::master::message::reregisterSlave(reregisterSlaveMessage);
+  // Admission control: during a re-registration storm, e.g., after a
+  // master failover, the agents beyond the limit are asked to retry
+  // later rather than piling up in the backlog of the master.
+  if (slaves.reregistering.size() >= flags.max_agent_reregistrations) {
+    VLOG(1) << "Throttling re-registration of agent " << slaveInfo.id()
+            << " at " << from << " (" << slaveInfo.hostname() << ") as "
+            << slaves.reregistering.size() << " re-registrations are"
+            << " already in progress";
 
-  if (error.isSome()) {
-    LOG(WARNING) << "Dropping re-registration of agent at " << from
-                 << " because it sent an invalid re-registration: "
-                 << error->message;
+    ++metrics->slave_reregistrations_throttled;
+
+    SlaveReregistrationThrottledMessage message;
+    message.mutable_retry_after()->set_nanoseconds(
+        AGENT_REREGISTRATION_RETRY_INTERVAL.ns());
 
+    send(from, message);
     return;
   }
 
@@ -7192,12 +7346,6 @@ void Master::reregisterSlave(
   // and `erase()` in its destructor, to avoid the manual bookkeeping.
   slaves.reregistering.insert(slaveInfo.id());
 
-  // Update all resources passed by the agent to `POST_RESERVATION_REFINEMENT`
-  // format. We do this as early as possible so that we only use a single
-  // format inside master, and downgrade again if necessary when they leave the
-  // master (e.g. when writing to the registry).
-  upgradeResources(&reregisterSlaveMessage);
-
   // Note that the principal may be empty if authentication is not
   // required. Also it is passed along because it may be removed from
   // `authenticated` while the authorization is pending.
@@ -7205,19 +7353,53 @@ void Master::reregisterSlave(
       ? Principal(authenticated.at(from))
       : Option<Principal>::none();
 
-  // Calling the `onAny` continuation below separately so we can move
-  // `reregisterSlaveMessage` without it being evaluated before it's used
-  // by `authorizeSlave`.
-  Future<bool> authorization =
-    authorizeSlave(reregisterSlaveMessage.slave(), principal);
+  // The message carries all tasks, executors and frameworks of the
+  // agent, so it is validated and upgraded off the master actor.
+  //
+  // Update all resources passed by the agent to `POST_RESERVATION_REFINEMENT`
+  // format. We do this as early as possible so that we only use a single
+  // format inside master, and downgrade again if necessary when they leave the
+  // master (e.g. when writing to the registry).
+  std::shared_ptr<ReregisterSlaveMessage> message(new ReregisterSlaveMessage());
+  message->Swap(&reregisterSlaveMessage);
 
-  authorization
-    .onAny(defer(self(),
-                 &Self::_reregisterSlave,
-                 from,
-                 std::move(reregisterSlaveMessage),
-                 principal,
-                 lambda::_1));
+  process::async([message]() -> Option<Error> {
+    Option<Error> error =
+      validation::master::message::reregisterSlave(*message);
+
+    if (error.isNone()) {
+      upgradeResources(message.get());
+    }
+
+    return error;
+  })
+  .onAny(defer(self(), [=](const Future<Option<Error>>& error) {
+    const SlaveInfo& info = message->slave();
+    CHECK(slaves.reregistering.contains(info.id()));
+
+    if (!error.isReady() || error->isSome()) {
+      LOG(WARNING) << "Dropping re-registration of agent at " << from
+                   << " because it sent an invalid re-registration: "
+                   << (error.isReady() ? error->get().message
+                       : error.isFailed() ? error.failure() : "discarded");
+
+      slaves.reregistering.erase(info.id());
+      return;
+    }
+
+    // Calling the `onAny` continuation below separately so we can move
+    // the message without it being evaluated before it's used by
+    // `authorizeSlave`.
+    Future<bool> authorization = authorizeSlave(info, principal);
+
+    authorization
+      .onAny(defer(self(),
+                   &Self::_reregisterSlave,
+                   from,
+                   std::move(*message),
+                   principal,
+                   lambda::_1));
+  }));
 }
 
 
@@ -9285,22 +9467,22 @@ void Master::markGone(const SlaveID& slaveId, const TimeInfo& goneTime)
         foreach (const TaskID& taskId,
                  slaves.unreachableTasks.at(slaveId).get(frameworkId)) {
           if (framework->unreachableTasks.contains(taskId)) {
-            const Owned<Task>& task = framework->unreachableTasks.at(taskId);
+            Task task = framework->unreachableTasks.at(taskId)->expand();
 
             const StatusUpdate& update = protobuf::createStatusUpdate(
-                task->framework_id(),
-                task->slave_id(),
-                task->task_id(),
+                task.framework_id(),
+                task.slave_id(),
+                task.task_id(),
                 newTaskState,
                 TaskStatus::SOURCE_MASTER,
                 None(),
                 message,
                 newTaskReason,
-                (task->has_executor_id()
-                   ? Option<ExecutorID>(task->executor_id())
+                (task.has_executor_id()
+                   ? Option<ExecutorID>(task.executor_id())
                    : None()));
 
-            updateTask(task.get(), update);
+            updateTask(&task, update);
 
             if (!framework->connected()) {
               LOG(WARNING) << "Dropping update " << update
@@ -9311,7 +9493,7 @@ void Master::markGone(const SlaveID& slaveId, const TimeInfo& goneTime)
             }
 
             // Move task from unreachable map to completed map.
-            framework->addCompletedTask(std::move(*task));
+            framework->addCompletedTask(std::move(task));
             framework->unreachableTasks.erase(taskId);
           }
         }
@@ -9456,6 +9638,65 @@ void Master::reconcile(
 
   ++metrics->messages_reconcile_tasks;
 
+  // The statuses are sent in batches if requested, which is only
+  // supported by schedulers using the HTTP API.
+  const Option<size_t> batchSize =
+    reconcile.has_batch_size() && framework->http.isSome()
+      ? Option<size_t>(reconcile.batch_size())
+      : None();
+
+  scheduler::Event batch;
+  batch.set_type(scheduler::Event::UPDATES);
+  *batch.mutable_updates()->mutable_time() = protobuf::getCurrentTime();
+
+  auto flush = [&]() {
+    if (batch.updates().statuses_size() > 0) {
+      framework->send(batch);
+      batch.mutable_updates()->clear_statuses();
+    }
+  };
+
+  auto send = [&](StatusUpdate&& update) {
+    if (batchSize.isNone()) {
+      // TODO(bmahler): Consider using forward(); might lead to too
+      // much logging.
+      StatusUpdateMessage message;
+      *message.mutable_update() = std::move(update);
+      framework->send(message);
+      return;
+    }
+
+    // The status is completed like in `evolve(StatusUpdateMessage)`.
+    TaskStatus* status = batch.mutable_updates()->add_statuses();
+    *status = std::move(*update.mutable_status());
+
+    if (update.has_executor_id()) {
+      *status->mutable_executor_id() = update.executor_id();
+    }
+
+    if (static_cast<size_t>(batch.updates().statuses_size()) >=
+          batchSize.get()) {
+      flush();
+    }
+  };
+
+  // Returns whether the master updated the task since the time
+  // requested by the scheduler, if any. The time at which the master
+  // updated the task is used rather than the timestamp of its latest
+  // status, which is set by the clock of the agent.
+  auto changed = [&](const Task& task) {
+    if (!reconcile.has_since()) {
+      return true;
+    }
+
+    Option<Time> updated = framework->taskUpdateTimes.get(task.task_id());
+    if (updated.isNone()) {
+      return true;
+    }
+
+    return updated->duration() > Nanoseconds(reconcile.since().nanoseconds());
+  };
+
   if (reconcile.tasks().empty()) {
     // Implicit reconciliation.
     LOG(INFO) << "Performing implicit task state reconciliation"
@@ -9477,14 +9718,14 @@ void Master::reconcile(
               << " for task " << update.status().task_id()
               << " of framework " << *framework;
 
-      // TODO(bmahler): Consider using forward(); might lead to too
-      // much logging.
-      StatusUpdateMessage message;
-      *message.mutable_update() = std::move(update);
-      framework->send(message);
+      send(std::move(update));
     }
 
     foreachvalue (Task* task, framework->tasks) {
+      if (!changed(*task)) {
+        continue;
+      }
+
       const TaskState& state = task->has_status_update_state()
           ? task->status_update_state()
           : task->state();
@@ -9513,13 +9754,10 @@ void Master::reconcile(
               << " for task " << update.status().task_id()
               << " of framework " << *framework;
 
-      // TODO(bmahler): Consider using forward(); might lead to too
-      // much logging.
-      StatusUpdateMessage message;
-      *message.mutable_update() = std::move(update);
-      framework->send(message);
+      send(std::move(update));
     }
 
+    flush();
     return;
   }
 
@@ -9566,7 +9804,12 @@ void Master::reconcile(
           "Reconciliation: Latest task state",
           TaskStatus::REASON_RECONCILIATION);
     } else if (task != nullptr) {
-      // (2) Task is known: send the latest status update state.
+      // (2) Task is known: send the latest status update state, unless
+      // it has not changed since the time requested by the scheduler.
+      if (!changed(*task)) {
+        continue;
+      }
+
       const TaskState& state = task->has_status_update_state()
           ? task->status_update_state()
           : task->state();
@@ -9690,13 +9933,11 @@ void Master::reconcile(
               << " for task " << update->status().task_id()
               << " of framework " << *framework;
 
-      // TODO(bmahler): Consider using forward(); might lead to too
-      // much logging.
-      StatusUpdateMessage message;
-      *message.mutable_update() = std::move(update.get());
-      framework->send(message);
+      send(std::move(update.get()));
     }
   }
+
+  flush();
 }
 
 
@@ -10973,36 +11214,36 @@ void Master::removeFramework(Framework* framework)
 
   // Mark the framework's unreachable tasks as completed.
   foreach (const TaskID& taskId, framework->unreachableTasks.keys()) {
-    const Owned<Task>& task = framework->unreachableTasks.at(taskId);
+    Task task = framework->unreachableTasks.at(taskId)->expand();
 
     // TODO(neilc): Per comment above, using TASK_KILLED here is not
     // ideal. It would be better to use TASK_UNREACHABLE here and only
     // transition it to a terminal state when the agent reregisters
     // and the task is shutdown (MESOS-6608).
     const StatusUpdate& update = protobuf::createStatusUpdate(
-        task->framework_id(),
-        task->slave_id(),
-        task->task_id(),
+        task.framework_id(),
+        task.slave_id(),
+        task.task_id(),
         TASK_KILLED,
         TaskStatus::SOURCE_MASTER,
         None(),
         "Framework " + framework->id().value() + " removed",
         TaskStatus::REASON_FRAMEWORK_REMOVED,
-        (task->has_executor_id()
-         ? Option<ExecutorID>(task->executor_id())
+        (task.has_executor_id()
+         ? Option<ExecutorID>(task.executor_id())
          : None()));
 
-    updateTask(task.get(), update);
+    updateTask(&task, update);
 
     // We don't need to remove the task from the slave, because the
     // task was removed when the agent was marked unreachable.
-    CHECK(!slaves.registered.contains(task->slave_id()))
-      << "Unreachable task " << task->task_id()
-      << " of framework " << task->framework_id()
-      << " was found on registered agent " << task->slave_id();
+    CHECK(!slaves.registered.contains(task.slave_id()))
+      << "Unreachable task " << task.task_id()
+      << " of framework " << task.framework_id()
+      << " was found on registered agent " << task.slave_id();
 
     // Move task from unreachable map to completed map.
-    framework->addCompletedTask(std::move(*task));
+    framework->addCompletedTask(std::move(task));
     framework->unreachableTasks.erase(taskId);
   }
 
@@ -11718,6 +11959,10 @@ void Master::updateTask(Task* task, const StatusUpdate& update)
   }
   task->add_statuses()->CopyFrom(status);
 
+  if (framework != nullptr && framework->tasks.contains(task->task_id())) {
+    framework->taskUpdateTimes[task->task_id()] = Clock::now();
+  }
+
   // Delete data (maybe very large since it's stored by on-top framework) we
   // are not interested in to avoid OOM.
   // For example: mesos-master is running on a machine with 4GB free memory,
@@ -12344,6 +12589,17 @@ void Master::_apply(
 }
 
 
+void Master::flushFrameworkEvents(const FrameworkID& frameworkId)
+{
+  Framework* framework = getFramework(frameworkId);
+
+  // The framework might have been removed in the meantime.
+  if (framework != nullptr) {
+    framework->flushEvents();
+  }
+}
+
+
 void Master::offerTimeout(const OfferID& offerId)
 {
   Offer* offer = getOffer(offerId);
@@ -12712,7 +12968,7 @@ double Master::_tasks_unreachable()
   double count = 0.0;
 
   foreachvalue (Framework* framework, frameworks.registered) {
-    foreachvalue (const Owned<Task>& task, framework->unreachableTasks) {
+    foreachvalue (const Owned<CompactTask>& task, framework->unreachableTasks) {
       if (task->state() == TASK_UNREACHABLE) {
         count++;
       }
@@ -49,6 +49,7 @@
 #include <process/owned.hpp>
 #include <process/process.hpp>
 #include <process/protobuf.hpp>
+#include <process/time.hpp>
 #include <process/timer.hpp>
 
 #include <process/metrics/counter.hpp>
@@ -76,8 +77,11 @@
 #include "internal/devolve.hpp"
 #include "internal/evolve.hpp"
 
+#include "master/call_decoder.hpp"
+#include "master/compact_task.hpp"
 #include "master/constants.hpp"
 #include "master/flags.hpp"
+#include "master/launch_validator.hpp"
 #include "master/machine.hpp"
 #include "master/metrics.hpp"
 #include "master/validation.hpp"
@@ -555,6 +559,11 @@ protected:
   process::Future<Nothing> recover();
   void recoveredSlavesTimeout(const Registry& registry);
 
+  // Follows the registry while this master is not elected, see
+  // `--registry_follow_interval`.
+  void followRegistry();
+  void _followRegistry(const process::Future<Registry>& registry);
+
   void _registerSlave(
       const process::UPID& pid,
       RegisterSlaveMessage&& registerSlaveMessage,
@@ -727,12 +736,6 @@ protected:
       const SlaveInfo& slaveInfo,
       const Option<process::http::authentication::Principal>& principal);
 
-  // Returns whether the task is authorized.
-  // Returns failure for transient authorization failures.
-  process::Future<bool> authorizeTask(
-      const TaskInfo& task,
-      Framework* framework);
-
   /**
    * Authorizes a `RESERVE` operation.
    *
@@ -961,6 +964,9 @@ protected:
   // Remove an offer after specified timeout
   void offerTimeout(const OfferID& offerId);
 
+  // Sends the events batched for the framework, see `Framework::send()`.
+  void flushFrameworkEvents(const FrameworkID& frameworkId);
+
   // Remove an offer and optionally rescind the offer as well.
   void removeOffer(Offer* offer, bool rescind = false);
 
@@ -1059,6 +1065,8 @@ private:
       const SlaveID& slaveId,
       const Resources& offeredResources,
       mesos::scheduler::Call::Accept&& accept,
+      const std::shared_ptr<std::vector<LaunchValidator::Task>>& launchTasks,
+      const process::Future<std::vector<LaunchValidator::Result>>& launches,
       const process::Future<
           std::vector<process::Future<bool>>>& authorizations);
 
@@ -1417,6 +1425,17 @@ private:
         const Option<process::http::authentication::Principal>&
             principal) const;
 
+    // Continuation of `scheduler()` once the call has been decoded.
+    process::Future<process::http::Response> _scheduler(
+        const process::http::Request& request,
+        const Option<process::http::authentication::Principal>& principal,
+        CallDecoder::Result result) const;
+
+    // Processes a decoded and validated call of a subscribed framework.
+    process::http::Response __scheduler(
+        Framework* framework,
+        scheduler::Call&& call) const;
+
     // /master/create-volumes
     process::Future<process::http::Response> createVolumes(
         const process::http::Request& request,
@@ -1921,6 +1940,14 @@ private:
 
   const Option<Authorizer*> authorizer;
 
+  // Validates and authorizes the tasks in ACCEPT calls off the master
+  // actor, see `accept()`.
+  process::Owned<LaunchValidator> launchValidator;
+
+  // Decodes the calls of HTTP schedulers off the master actor, see
+  // `Http::scheduler()`.
+  process::Owned<CallDecoder> callDecoder;
+
   MasterInfo info_;
 
   // Holds some info which affects how a machine behaves, as well as state that
@@ -1938,6 +1965,19 @@ private:
   // master is elected as a leader.
   Option<process::Future<Nothing>> recovered;
 
+  // The agents of the registry followed by a non-leading master (see
+  // `--registry_follow_interval`), prebuilt so that they are reused by
+  // the recovery once this master is elected.
+  struct Standby
+  {
+    // The `SlaveInfo`s as stored in the registry.
+    hashmap<SlaveID, SlaveInfo> stored;
+
+    // The `SlaveInfo`s in `POST_RESERVATION_REFINEMENT` format, as kept
+    // in `Slaves::recovered`.
+    hashmap<SlaveID, SlaveInfo> recovered;
+  } standby;
+
   // If this is the leading master, we periodically check whether we
   // should GC some information from the registry.
   Option<process::Timer> registryGcTimer;
@@ -2426,6 +2466,10 @@ struct Framework
 
   void heartbeat();
 
+  // Sends the 'UPDATE' and 'OFFERS' events which have been batched
+  // for a framework with the BATCH_EVENTS capability.
+  void flushEvents();
+
   bool active() const;
   bool connected() const;
   bool recovered() const;
@@ -2465,18 +2509,26 @@ struct Framework
   // `removeTask()` are used, and provide a const view into the tasks.
   hashmap<TaskID, Task*> tasks;
 
+  // The time at which the master last updated each of the `tasks`,
+  // i.e., added the task or processed a status update of the task.
+  // Used to only reconcile the tasks which changed since a given time.
+  hashmap<TaskID, process::Time> taskUpdateTimes;
+
   // Tasks launched by this framework that have reached a terminal
   // state and have had all their updates acknowledged. We only keep a
   // fixed-size cache to avoid consuming too much memory. We use
   // circular_buffer rather than BoundedHashMap because there
   // can be multiple completed tasks with the same task ID.
-  circular_buffer<process::Owned<Task>> completedTasks;
+  circular_buffer<process::Owned<CompactTask>> completedTasks;
 
   // When an agent is marked unreachable, tasks running on it are stored
   // here. We only keep a fixed-size cache to avoid consuming too much memory.
   // NOTE: Non-partition-aware unreachable tasks in this map are marked
   // TASK_LOST instead of TASK_UNREACHABLE for backward compatibility.
-  BoundedHashMap<TaskID, process::Owned<Task>> unreachableTasks;
+  BoundedHashMap<TaskID, process::Owned<CompactTask>> unreachableTasks;
+
+  // Interns the parts shared by the completed and unreachable tasks.
+  TaskInterner taskInterner;
 
   hashset<Offer*> offers; // Active offers for framework.
 
@@ -2544,6 +2596,19 @@ private:
 
   Framework(const Framework&);              // No copying.
   Framework& operator=(const Framework&); // No assigning.
+
+  // Adds the event to the batched events if the framework has the
+  // BATCH_EVENTS capability. Returns false if the event is not batched
+  // and has to be sent right away.
+  template <typename Message>
+  bool batch(const Message& message) { return false; }
+  bool batch(const StatusUpdateMessage& message);
+  bool batch(const ResourceOffersMessage& message);
+  bool _batch(v1::scheduler::Event&& event);
+
+  // The 'BATCH' event which holds the events which have been batched
+  // but not yet sent, see `batch()`.
+  Option<v1::scheduler::Event> batchedEvents;
 };
 
 
@@ -2571,6 +2636,14 @@ void Framework::send(const Message& message)
   }
 
   if (http.isSome()) {
+    if (batch(message)) {
+      return;
+    }
+
+    // Events which are not batched are sent after the batched events
+    // to preserve the order in which the events were generated.
+    flushEvents();
+
     if (!http->send(message)) {
       LOG(WARNING) << "Unable to send message to framework " << *this << ":"
                    << " connection closed";
@@ -206,6 +206,8 @@ Metrics::Metrics(const Master& master)
         "master/slave_registrations"),
     slave_reregistrations(
         "master/slave_reregistrations"),
+    slave_reregistrations_throttled(
+        "master/slave_reregistrations_throttled"),
     slave_removals(
         "master/slave_removals"),
     slave_removals_reason_unhealthy(
@@ -319,6 +321,7 @@ Metrics::Metrics(const Master& master)
 
   process::metrics::add(slave_registrations);
   process::metrics::add(slave_reregistrations);
+  process::metrics::add(slave_reregistrations_throttled);
   process::metrics::add(slave_removals);
   process::metrics::add(slave_removals_reason_unhealthy);
   process::metrics::add(slave_removals_reason_unregistered);
@@ -501,6 +504,7 @@ Metrics::~Metrics()
 
   process::metrics::remove(slave_registrations);
   process::metrics::remove(slave_reregistrations);
+  process::metrics::remove(slave_reregistrations_throttled);
   process::metrics::remove(slave_removals);
   process::metrics::remove(slave_removals_reason_unhealthy);
   process::metrics::remove(slave_removals_reason_unregistered);
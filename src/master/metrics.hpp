@@ -237,6 +237,7 @@ struct Metrics
   // Successful registry operations.
   process::metrics::Counter slave_registrations;
   process::metrics::Counter slave_reregistrations;
+  process::metrics::Counter slave_reregistrations_throttled;
   process::metrics::Counter slave_removals;
   process::metrics::Counter slave_removals_reason_unhealthy;
   process::metrics::Counter slave_removals_reason_unregistered;
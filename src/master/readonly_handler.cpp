@@ -225,24 +225,29 @@ void FullFrameworkWriter::operator()(JSON::ObjectWriter* writer) const
   });
 
   writer->field("unreachable_tasks", [this](JSON::ArrayWriter* writer) {
-    foreachvalue (const Owned<Task>& task, framework_->unreachableTasks) {
+    foreachvalue (const Owned<CompactTask>& compact,
+                  framework_->unreachableTasks) {
+      const Task task = compact->expand();
+
       // Skip unauthorized tasks.
-      if (!approvers_->approved<VIEW_TASK>(*task, framework_->info)) {
+      if (!approvers_->approved<VIEW_TASK>(task, framework_->info)) {
         continue;
       }
 
-      writer->element(*task);
+      writer->element(task);
     }
   });
 
   writer->field("completed_tasks", [this](JSON::ArrayWriter* writer) {
-    foreach (const Owned<Task>& task, framework_->completedTasks) {
+    foreach (const Owned<CompactTask>& compact, framework_->completedTasks) {
+      const Task task = compact->expand();
+
       // Skip unauthorized tasks.
-      if (!approvers_->approved<VIEW_TASK>(*task, framework_->info)) {
+      if (!approvers_->approved<VIEW_TASK>(task, framework_->info)) {
         continue;
       }
 
-      writer->element(*task);
+      writer->element(task);
     }
   });
 
@@ -483,12 +488,13 @@ public:
         slavesToFrameworks[task->slave_id()].insert(frameworkId);
       }
 
-      foreachvalue (const Owned<Task>& task, framework->unreachableTasks) {
+      foreachvalue (const Owned<CompactTask>& task,
+                    framework->unreachableTasks) {
         frameworksToSlaves[frameworkId].insert(task->slave_id());
         slavesToFrameworks[task->slave_id()].insert(frameworkId);
       }
 
-      foreach (const Owned<Task>& task, framework->completedTasks) {
+      foreach (const Owned<CompactTask>& task, framework->completedTasks) {
         frameworksToSlaves[frameworkId].insert(task->slave_id());
         slavesToFrameworks[task->slave_id()].insert(frameworkId);
       }
@@ -540,9 +546,9 @@ struct TaskStateSummary
       unknown(0) {}
 
   // Account for the state of the given task.
-  void count(const Task& task)
+  void count(TaskState state)
   {
-    switch (task.state()) {
+    switch (state) {
       case TASK_STAGING: { ++staging; break; }
       case TASK_STARTING: { ++starting; break; }
       case TASK_RUNNING: { ++running; break; }
@@ -600,18 +606,19 @@ public:
       }
 
       foreachvalue (const Task* task, framework->tasks) {
-        frameworkTaskSummaries[frameworkId].count(*task);
-        slaveTaskSummaries[task->slave_id()].count(*task);
+        frameworkTaskSummaries[frameworkId].count(task->state());
+        slaveTaskSummaries[task->slave_id()].count(task->state());
       }
 
-      foreachvalue (const Owned<Task>& task, framework->unreachableTasks) {
-        frameworkTaskSummaries[frameworkId].count(*task);
-        slaveTaskSummaries[task->slave_id()].count(*task);
+      foreachvalue (const Owned<CompactTask>& task,
+                    framework->unreachableTasks) {
+        frameworkTaskSummaries[frameworkId].count(task->state());
+        slaveTaskSummaries[task->slave_id()].count(task->state());
       }
 
-      foreach (const Owned<Task>& task, framework->completedTasks) {
-        frameworkTaskSummaries[frameworkId].count(*task);
-        slaveTaskSummaries[task->slave_id()].count(*task);
+      foreach (const Owned<CompactTask>& task, framework->completedTasks) {
+        frameworkTaskSummaries[frameworkId].count(task->state());
+        slaveTaskSummaries[task->slave_id()].count(task->state());
       }
     }
   }
@@ -1166,6 +1173,9 @@ process::http::Response Master::ReadOnlyHandler::tasks(
   // Construct task list with both running,
   // completed and unreachable tasks.
   vector<const Task*> tasks;
+
+  // Holds the expanded completed and unreachable tasks.
+  vector<Owned<Task>> expanded;
   foreach (const Framework* framework, frameworks) {
     foreachvalue (Task* task, framework->tasks) {
       CHECK_NOTNULL(task);
@@ -1179,25 +1189,39 @@ process::http::Response Master::ReadOnlyHandler::tasks(
     }
 
     foreachvalue (
-        const Owned<Task>& task,
+        const Owned<CompactTask>& compact,
         framework->unreachableTasks) {
-      // Skip unauthorized tasks or tasks without matching task ID.
-      if (!selectTaskId.accept(task->task_id()) ||
-          !approvers->approved<VIEW_TASK>(*task, framework->info)) {
+      // Skip tasks without matching task ID before expanding them.
+      if (!selectTaskId.accept(compact->task_id())) {
+        continue;
+      }
+
+      Owned<Task> task(new Task(compact->expand()));
+
+      // Skip unauthorized tasks.
+      if (!approvers->approved<VIEW_TASK>(*task, framework->info)) {
         continue;
       }
 
       tasks.push_back(task.get());
+      expanded.push_back(task);
     }
 
-    foreach (const Owned<Task>& task, framework->completedTasks) {
-      // Skip unauthorized tasks or tasks without matching task ID.
-      if (!selectTaskId.accept(task->task_id()) ||
-          !approvers->approved<VIEW_TASK>(*task, framework->info)) {
+    foreach (const Owned<CompactTask>& compact, framework->completedTasks) {
+      // Skip tasks without matching task ID before expanding them.
+      if (!selectTaskId.accept(compact->task_id())) {
+        continue;
+      }
+
+      Owned<Task> task(new Task(compact->expand()));
+
+      // Skip unauthorized tasks.
+      if (!approvers->approved<VIEW_TASK>(*task, framework->info)) {
         continue;
       }
 
       tasks.push_back(task.get());
+      expanded.push_back(task);
     }
   }
 
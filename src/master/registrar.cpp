@@ -100,6 +100,7 @@ public:
 
   // Registrar implementation.
   Future<Registry> recover(const MasterInfo& info);
+  Future<Registry> follow();
   Future<bool> apply(Owned<RegistryOperation> operation);
 
 protected:
@@ -425,6 +426,28 @@ void RegistrarProcess::__recover(const Future<bool>& recover)
 }
 
 
+Future<Registry> RegistrarProcess::follow()
+{
+  if (recovered.isSome()) {
+    return Failure("Attempted to follow the registry after recovering");
+  }
+
+  // NOTE: The registry is deserialized outside of this process.
+  return state->follow("registry")
+    .then([](const Variable& variable) -> Future<Registry> {
+      Try<Registry> registry =
+        ::protobuf::deserialize<Registry>(variable.value());
+
+      if (registry.isError()) {
+        return Failure(
+            "Failed to deserialize the registry: " + registry.error());
+      }
+
+      return registry.get();
+    });
+}
+
+
 Future<bool> RegistrarProcess::apply(Owned<RegistryOperation> operation)
 {
   if (recovered.isNone()) {
@@ -594,6 +617,12 @@ Future<Registry> Registrar::recover(const MasterInfo& info)
 }
 
 
+Future<Registry> Registrar::follow()
+{
+  return dispatch(process, &RegistrarProcess::follow);
+}
+
+
 Future<bool> Registrar::apply(Owned<RegistryOperation> operation)
 {
   return dispatch(process, &RegistrarProcess::apply, operation);
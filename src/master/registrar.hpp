@@ -102,6 +102,12 @@ public:
   // and therefore MasterInfo is unknown during construction.
   process::Future<Registry> recover(const MasterInfo& info);
 
+  // Reads the Registry without recovering, i.e., without taking over
+  // the storage from the leading master. Used by a non-leading master
+  // to follow the Registry, see `--registry_follow_interval`. Fails
+  // once the Registrar is recovering.
+  process::Future<Registry> follow();
+
   // Applies an operation on the Registry.
   // Returns:
   //   true if the operation is permitted.
@@ -705,6 +705,11 @@ Option<Error> validate(
       if (!call.has_reconcile()) {
         return Error("Expecting 'reconcile' to be present");
       }
+
+      if (call.reconcile().has_batch_size() &&
+          call.reconcile().batch_size() == 0) {
+        return Error("Expecting 'reconcile.batch_size' to be positive");
+      }
       return None();
 
     case mesos::scheduler::Call::RECONCILE_OPERATIONS:
@@ -725,6 +730,32 @@ Option<Error> validate(
       }
       return None();
 
+    case mesos::scheduler::Call::BATCH:
+      if (!call.has_batch()) {
+        return Error("Expecting 'batch' to be present");
+      }
+
+      foreach (const mesos::scheduler::Call& _call, call.batch().calls()) {
+        if (_call.type() == mesos::scheduler::Call::SUBSCRIBE ||
+            _call.type() == mesos::scheduler::Call::TEARDOWN ||
+            _call.type() == mesos::scheduler::Call::BATCH) {
+          return Error(
+              "'" + mesos::scheduler::Call::Type_Name(_call.type()) +
+              "' calls are not allowed in a 'BATCH' call");
+        }
+
+        if (_call.framework_id() != call.framework_id()) {
+          return Error("'framework_id' of a call in 'batch' differs from"
+                       " 'framework_id' of the 'BATCH' call");
+        }
+
+        Option<Error> error = validate(_call, principal);
+        if (error.isSome()) {
+          return Error("Invalid call in 'batch': " + error->message);
+        }
+      }
+      return None();
+
     case mesos::scheduler::Call::UNKNOWN:
       return None();
   }
@@ -1439,6 +1470,33 @@ Option<Error> validateContainerInfo(const TaskInfo& task)
 }
 
 
+// Validates task specific fields which do not depend on the state of
+// the master, except its task ID and executor (if it exists).
+Option<Error> validateTaskFields(const TaskInfo& task)
+{
+  // NOTE: The order in which the following validate functions are
+  // executed does matter!
+  vector<lambda::function<Option<Error>()>> validators = {
+    lambda::bind(internal::validateKillPolicy, task),
+    lambda::bind(internal::validateMaxCompletionTime, task),
+    lambda::bind(internal::validateCheck, task),
+    lambda::bind(internal::validateHealthCheck, task),
+    lambda::bind(internal::validateResources, task),
+    lambda::bind(internal::validateCommandInfo, task),
+    lambda::bind(internal::validateContainerInfo, task)
+  };
+
+  foreach (const lambda::function<Option<Error>()>& validator, validators) {
+    Option<Error> error = validator();
+    if (error.isSome()) {
+      return error;
+    }
+  }
+
+  return None();
+}
+
+
 // Validates task specific fields except its executor (if it exists).
 Option<Error> validateTask(
     const TaskInfo& task,
@@ -1454,13 +1512,7 @@ Option<Error> validateTask(
     lambda::bind(internal::validateTaskID, task),
     lambda::bind(internal::validateUniqueTaskID, task, framework),
     lambda::bind(internal::validateSlaveID, task, slave),
-    lambda::bind(internal::validateKillPolicy, task),
-    lambda::bind(internal::validateMaxCompletionTime, task),
-    lambda::bind(internal::validateCheck, task),
-    lambda::bind(internal::validateHealthCheck, task),
-    lambda::bind(internal::validateResources, task),
-    lambda::bind(internal::validateCommandInfo, task),
-    lambda::bind(internal::validateContainerInfo, task)
+    lambda::bind(internal::validateTaskFields, task)
   };
 
   foreach (const lambda::function<Option<Error>()>& validator, validators) {
@@ -1473,16 +1525,36 @@ Option<Error> validateTask(
   return None();
 }
 
+} // namespace internal {
+
 
-// Validates `Task.executor` if it exists.
-Option<Error> validateExecutor(
+// Validate task and its executor (if it exists).
+Option<Error> validate(
     const TaskInfo& task,
     Framework* framework,
     Slave* slave,
     const Resources& offered)
 {
-  CHECK_NOTNULL(framework);
-  CHECK_NOTNULL(slave);
+  return validateStateful(
+      task, framework, slave, offered, validateStateless(task));
+}
+
+
+Option<Error> validateStateless(const TaskInfo& task)
+{
+  // NOTE: The order in which the following validate functions are
+  // executed does matter!
+  vector<lambda::function<Option<Error>()>> validators = {
+    lambda::bind(internal::validateTaskID, task),
+    lambda::bind(internal::validateTaskFields, task)
+  };
+
+  foreach (const lambda::function<Option<Error>()>& validator, validators) {
+    Option<Error> error = validator();
+    if (error.isSome()) {
+      return error;
+    }
+  }
 
   if (task.has_executor() == task.has_command()) {
     return Error(
@@ -1490,15 +1562,16 @@ Option<Error> validateExecutor(
         "ExecutorInfo present");
   }
 
-  Resources total = task.resources();
-
-  Option<Error> error = None();
-
   if (task.has_executor()) {
     const ExecutorInfo& executor = task.executor();
 
     // Do the general validation first.
-    error = executor::internal::validate(executor, framework, slave);
+    Option<Error> error = executor::validate(executor);
+    if (error.isSome()) {
+      return error;
+    }
+
+    error = executor::internal::validateResources(executor);
     if (error.isSome()) {
       return error;
     }
@@ -1537,7 +1610,7 @@ Option<Error> validateExecutor(
     Option<double> cpus = executorResources.cpus();
     if (cpus.isNone() || cpus.get() < MIN_CPUS) {
       LOG(WARNING)
-        << "Executor '" << task.executor().executor_id()
+        << "Executor '" << executor.executor_id()
         << "' for task '" << task.task_id()
         << "' uses less CPUs ("
         << (cpus.isSome() ? stringify(cpus.get()) : "None")
@@ -1549,7 +1622,7 @@ Option<Error> validateExecutor(
     Option<Bytes> mem = executorResources.mem();
     if (mem.isNone() || mem.get() < MIN_MEM) {
       LOG(WARNING)
-        << "Executor '" << task.executor().executor_id()
+        << "Executor '" << executor.executor_id()
         << "' for task '" << task.task_id()
         << "' uses less memory ("
         << (mem.isSome() ? stringify(mem.get()) : "None")
@@ -1557,47 +1630,36 @@ Option<Error> validateExecutor(
         << "). Please update your executor, as this will be mandatory "
         << "in future releases.";
     }
-
-    if (!slave->hasExecutor(framework->id(), task.executor().executor_id())) {
-      total += executorResources;
-    }
   }
 
   // Now validate combined resources of task and executor.
 
   // NOTE: This is refactored into a separate function
   // so that it can be easily unit tested.
-  error = task::internal::validateTaskAndExecutorResources(task);
-
-  if (error.isSome()) {
-    return error;
-  }
-
-  if (!offered.contains(total)) {
-    return Error(
-        "Total resources " + stringify(total) + " required by task and its"
-        " executor is more than available " + stringify(offered));
-  }
-
-  return None();
+  return internal::validateTaskAndExecutorResources(task);
 }
 
-} // namespace internal {
-
 
-// Validate task and its executor (if it exists).
-Option<Error> validate(
+Option<Error> validateStateful(
     const TaskInfo& task,
     Framework* framework,
     Slave* slave,
-    const Resources& offered)
+    const Resources& offered,
+    const Option<Error>& stateless)
 {
   CHECK_NOTNULL(framework);
   CHECK_NOTNULL(slave);
 
+  // NOTE: The order in which the following validate functions are
+  // executed does matter! A duplicate task ID or a wrong agent ID is
+  // reported before the error found by `validateStateless` (if any).
+  // The task ID is validated again (which is cheap) so that an invalid
+  // task ID is reported before a duplicate one.
   vector<lambda::function<Option<Error>()>> validators = {
-    lambda::bind(internal::validateTask, task, framework, slave),
-    lambda::bind(internal::validateExecutor, task, framework, slave, offered)
+    lambda::bind(internal::validateTaskID, task),
+    lambda::bind(internal::validateUniqueTaskID, task, framework),
+    lambda::bind(internal::validateSlaveID, task, slave),
+    [&stateless]() { return stateless; }
   };
 
   foreach (const lambda::function<Option<Error>()>& validator, validators) {
@@ -1607,6 +1669,34 @@ Option<Error> validate(
     }
   }
 
+  Resources total = task.resources();
+
+  if (task.has_executor()) {
+    const ExecutorInfo& executor = task.executor();
+
+    Option<Error> error =
+      executor::internal::validateFrameworkID(executor, framework);
+    if (error.isSome()) {
+      return error;
+    }
+
+    error = executor::internal::validateCompatibleExecutorInfo(
+        executor, framework, slave);
+    if (error.isSome()) {
+      return error;
+    }
+
+    if (!slave->hasExecutor(framework->id(), executor.executor_id())) {
+      total += executor.resources();
+    }
+  }
+
+  if (!offered.contains(total)) {
+    return Error(
+        "Total resources " + stringify(total) + " required by task and its"
+        " executor is more than available " + stringify(offered));
+  }
+
   return None();
 }
 
@@ -187,6 +187,29 @@ Option<Error> validate(
     const Resources& offered);
 
 
+// Validates the parts of a task and its executor (if it exists) which
+// do not depend on the state of the master, e.g., the task ID, the
+// checks and the resources of the task. Unlike `validate` this can be
+// called off the master actor, see `LaunchValidator`.
+Option<Error> validateStateless(const TaskInfo& task);
+
+
+// Validates the parts of a task and its executor (if it exists) which
+// depend on the state of the master, e.g., that the task ID is unique
+// and that the task fits into the offered resources. `stateless` is the
+// result of `validateStateless` for the same task; it is returned after
+// the task ID and agent ID checks, so that `validate` is equivalent to
+// `validateStateful(..., validateStateless(task))`.
+//
+// NOTE: Like `validate` this must be called sequentially for each task.
+Option<Error> validateStateful(
+    const TaskInfo& task,
+    Framework* framework,
+    Slave* slave,
+    const Resources& offered,
+    const Option<Error>& stateless);
+
+
 // Functions in this namespace are only exposed for testing.
 namespace internal {
 
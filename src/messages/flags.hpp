@@ -46,6 +46,20 @@ inline Try<mesos::internal::ImageGcConfig> parse(const std::string& value)
 }
 
 
+template <>
+inline Try<mesos::internal::ContainerPoolConfig> parse(
+    const std::string& value)
+{
+  // Convert from string or file to JSON.
+  Try<JSON::Object> json = parse<JSON::Object>(value);
+  if (json.isError()) {
+    return Error(json.error());
+  }
+
+  return protobuf::parse<mesos::internal::ContainerPoolConfig>(json.get());
+}
+
+
 template <>
 inline Try<mesos::internal::Firewall> parse(const std::string& value)
 {
@@ -97,6 +111,14 @@ inline std::ostream& operator<<(
 }
 
 
+inline std::ostream& operator<<(
+    std::ostream& stream,
+    const ContainerPoolConfig& containerPoolConfig)
+{
+  return stream << containerPoolConfig.DebugString();
+}
+
+
 inline std::ostream& operator<<(
     std::ostream& stream,
     const Firewall& rules)
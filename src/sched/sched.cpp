@@ -527,6 +527,32 @@ protected:
     LOG(WARNING) << "Dropping " << event.type() << ": " << message;
   }
 
+  // Handles a status received in an 'UPDATE' or 'UPDATES' event.
+  void update(const UPID& from, const TaskStatus& status)
+  {
+    // Create a StatusUpdate based on the TaskStatus.
+    StatusUpdate update;
+    update.mutable_framework_id()->CopyFrom(framework.id());
+    update.mutable_status()->CopyFrom(status);
+    update.set_timestamp(status.timestamp());
+
+    if (status.has_executor_id()) {
+      update.mutable_executor_id()->CopyFrom(status.executor_id());
+    }
+
+    if (status.has_slave_id()) {
+      update.mutable_slave_id()->CopyFrom(status.slave_id());
+    }
+
+    if (status.has_uuid()) {
+      update.set_uuid(status.uuid());
+    }
+
+    // Note that we do not need to set the 'pid' now that
+    // the driver uses 'uuid' absence to skip acknowledgement.
+    statusUpdate(from, update, UPID());
+  }
+
   void receive(const UPID& from, const Event& event)
   {
     switch (event.type()) {
@@ -618,33 +644,19 @@ protected:
           break;
         }
 
-        const TaskStatus& status = event.update().status();
-
-        // Create a StatusUpdate based on the TaskStatus.
-        StatusUpdate update;
-        update.mutable_framework_id()->CopyFrom(framework.id());
-        update.mutable_status()->CopyFrom(status);
-        update.set_timestamp(status.timestamp());
-
-        if (status.has_executor_id()) {
-          update.mutable_executor_id()->CopyFrom(status.executor_id());
-        }
+        update(from, event.update().status());
+        break;
+      }
 
-        if (status.has_slave_id()) {
-          update.mutable_slave_id()->CopyFrom(status.slave_id());
+      case Event::UPDATES: {
+        if (!event.has_updates()) {
+          drop(event, "Expecting 'updates' to be present");
+          break;
         }
 
-        if (status.has_uuid()) {
-          update.set_uuid(status.uuid());
+        foreach (const TaskStatus& status, event.updates().statuses()) {
+          update(from, status);
         }
-
-        // Note that we do not need to set the 'pid' now that
-        // the driver uses 'uuid' absence to skip acknowledgement.
-        //
-        // TODO(bmahler): Implement an 'update' method to match
-        // the Event naming scheme, and have 'statusUpdate' call
-        // into it.
-        statusUpdate(from, update, UPID());
         break;
       }
 
@@ -709,6 +721,18 @@ protected:
         break;
       }
 
+      case Event::BATCH: {
+        if (!event.has_batch()) {
+          drop(event, "Expecting 'batch' to be present");
+          break;
+        }
+
+        foreach (const Event& _event, event.batch().events()) {
+          receive(from, _event);
+        }
+        break;
+      }
+
       case Event::UNKNOWN: {
         drop(event, "Unknown event");
         break;
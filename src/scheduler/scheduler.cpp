@@ -841,6 +841,15 @@ protected:
       return;
     }
 
+    // The events in a 'BATCH' event are delivered one by one, in the
+    // same queue of events if the 'received' callback is not running.
+    if (event.type() == Event::BATCH) {
+      foreach (const Event& _event, event.batch().events()) {
+        receive(_event, isLocallyInjected);
+      }
+      return;
+    }
+
     if (isLocallyInjected) {
       VLOG(1) << "Enqueuing locally injected event " << stringify(event.type());
     } else {
@@ -0,0 +1,944 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "slave/artifacts.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <list>
+#include <memory>
+#include <random>
+
+#include <glog/logging.h>
+
+#include <process/async.hpp>
+#include <process/collect.hpp>
+#include <process/defer.hpp>
+#include <process/dispatch.hpp>
+#include <process/help.hpp>
+#include <process/http.hpp>
+#include <process/process.hpp>
+
+#include <stout/base64.hpp>
+#include <stout/foreach.hpp>
+#include <stout/hashmap.hpp>
+#include <stout/json.hpp>
+#include <stout/net.hpp>
+#include <stout/numify.hpp>
+#include <stout/os.hpp>
+#include <stout/path.hpp>
+#include <stout/strings.hpp>
+
+#include <stout/os/close.hpp>
+#include <stout/os/lseek.hpp>
+#include <stout/os/open.hpp>
+#include <stout/os/write.hpp>
+
+#include "common/command_utils.hpp"
+#include "common/http.hpp"
+
+#include "credentials/credentials.hpp"
+
+#include "messages/messages.hpp"
+
+#include "slave/constants.hpp"
+#include "slave/state.hpp"
+
+#include "slave/containerizer/fetcher.hpp"
+
+#include "slave/containerizer/mesos/provisioner/docker/paths.hpp"
+
+namespace http = process::http;
+
+using std::deque;
+using std::list;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+using mesos::Authorizer;
+
+using process::AUTHENTICATION;
+using process::AUTHORIZATION;
+using process::Clock;
+using process::DESCRIPTION;
+using process::Failure;
+using process::Future;
+using process::HELP;
+using process::Owned;
+using process::Process;
+using process::Promise;
+using process::TLDR;
+using process::Time;
+using process::UPID;
+
+using process::async;
+using process::defer;
+using process::dispatch;
+using process::spawn;
+using process::terminate;
+using process::wait;
+
+using process::http::authentication::Principal;
+
+namespace mesos {
+namespace internal {
+namespace slave {
+
+// Timeout for looking up an artifact on a peer.
+static const Duration LOOKUP_TIMEOUT = Seconds(5);
+
+// Timeout for downloading a single chunk from a peer.
+static const Duration CHUNK_TIMEOUT = Minutes(1);
+
+// Minimum interval between rescans of the artifacts held by an agent.
+static const Duration REFRESH_INTERVAL = Seconds(1);
+
+static const string FILE_PREFIX = "file://";
+
+// The SHA-512 digests of the fetcher cache files are kept in the
+// `FetcherCacheIndex`, see `FetcherProcess::deduplicate()`.
+static const string SHA512_PREFIX = "sha512:";
+static const string SHA256_PREFIX = "sha256:";
+
+
+static Try<vector<UPID>> parsePeers(const string& value)
+{
+  vector<UPID> peers;
+
+  foreach (const string& token, strings::tokenize(value, ", \n")) {
+    // NOTE: A full PID is used by tests, which run several agents in
+    // the same process.
+    if (strings::contains(token, "@")) {
+      UPID pid(token);
+      if (!pid) {
+        return Error("Failed to parse peer '" + token + "'");
+      }
+
+      peers.push_back(pid);
+      continue;
+    }
+
+    const vector<string> tokens = strings::split(token, ":");
+    if (tokens.size() != 2) {
+      return Error("Expected `host:port` but got '" + token + "'");
+    }
+
+    Try<net::IP> ip = net::getIP(tokens[0], AF_INET);
+    if (ip.isError()) {
+      return Error(
+          "Failed to resolve peer '" + tokens[0] + "': " + ip.error());
+    }
+
+    Try<uint16_t> port = numify<uint16_t>(tokens[1]);
+    if (port.isError()) {
+      return Error(
+          "Failed to parse the port of peer '" + token + "': " +
+          port.error());
+    }
+
+    peers.push_back(UPID(
+        ARTIFACT_SERVER_ID,
+        process::network::inet::Address(ip.get(), port.get())));
+  }
+
+  return peers;
+}
+
+
+// A tracker for a fixed list of peers, which is possibly maintained in
+// a file. Since any of the peers might hold an artifact, a random
+// subset of them is returned for each lookup, which spreads the load
+// of concurrently launched tasks across the peers.
+class StaticPeerTracker : public PeerTracker
+{
+public:
+  explicit StaticPeerTracker(const string& _value) : value(_value) {}
+
+  Future<vector<UPID>> peers(const string& artifact) override
+  {
+    string list = value;
+
+    if (strings::startsWith(value, FILE_PREFIX)) {
+      Try<string> read = os::read(value.substr(FILE_PREFIX.size()));
+      if (read.isError()) {
+        return Failure("Failed to read the list of peers: " + read.error());
+      }
+
+      list = read.get();
+    }
+
+    Try<vector<UPID>> peers = parsePeers(list);
+    if (peers.isError()) {
+      return Failure(peers.error());
+    }
+
+    std::shuffle(peers->begin(), peers->end(), generator);
+
+    if (peers->size() > MAX_ARTIFACT_PEERS) {
+      peers->resize(MAX_ARTIFACT_PEERS);
+    }
+
+    return peers.get();
+  }
+
+private:
+  const string value;
+  std::mt19937 generator{std::random_device()()};
+};
+
+
+Try<Owned<PeerTracker>> PeerTracker::create(const string& peers)
+{
+  if (!strings::startsWith(peers, FILE_PREFIX)) {
+    Try<vector<UPID>> parse = parsePeers(peers);
+    if (parse.isError()) {
+      return Error(parse.error());
+    }
+  }
+
+  return Owned<PeerTracker>(new StaticPeerTracker(peers));
+}
+
+
+class ArtifactServerProcess : public Process<ArtifactServerProcess>
+{
+public:
+  ArtifactServerProcess(
+      const Flags& _flags,
+      const Option<string>& _authenticationRealm,
+      const Option<Authorizer*>& _authorizer,
+      const string& id)
+    : ProcessBase(id),
+      flags(_flags),
+      authenticationRealm(_authenticationRealm),
+      authorizer(_authorizer) {}
+
+protected:
+  void initialize() override
+  {
+    route("/lookup",
+          authenticationRealm,
+          LOOKUP_HELP(),
+          &ArtifactServerProcess::lookup);
+
+    route("/blob",
+          authenticationRealm,
+          BLOB_HELP(),
+          &ArtifactServerProcess::blob);
+  }
+
+private:
+  static string LOOKUP_HELP()
+  {
+    return HELP(
+        TLDR("Looks up an artifact held by this agent."),
+        DESCRIPTION(
+            "Returns the digest and size of the artifact with the given",
+            "`digest`, or `404 Not Found` if this agent does not hold it."),
+        AUTHENTICATION(true),
+        AUTHORIZATION(
+            "This endpoint might be disabled by the `get_endpoints` ACL."));
+  }
+
+  static string BLOB_HELP()
+  {
+    return HELP(
+        TLDR("Reads a chunk of an artifact held by this agent."),
+        DESCRIPTION(
+            "Returns `length` bytes of the artifact with the given `digest`",
+            "starting at `offset`."),
+        AUTHENTICATION(true),
+        AUTHORIZATION(
+            "This endpoint might be disabled by the `get_endpoints` ACL."));
+  }
+
+  Future<http::Response> lookup(
+      const http::Request& request,
+      const Option<Principal>& principal)
+  {
+    return authorize("lookup", request, principal)
+      .then(defer(self(), [=](bool authorized) -> Future<http::Response> {
+        if (!authorized) {
+          return http::Forbidden();
+        }
+
+        Option<string> digest = request.url.query.get("digest");
+        if (digest.isNone()) {
+          return http::BadRequest("Missing 'digest'.\n");
+        }
+
+        return find(digest.get())
+          .then([=](const Option<string>& path) -> http::Response {
+            if (path.isNone()) {
+              return http::NotFound();
+            }
+
+            Try<Bytes> size = os::stat::size(path.get());
+            if (size.isError()) {
+              return http::NotFound();
+            }
+
+            JSON::Object object;
+            object.values["digest"] = digest.get();
+            object.values["size"] = size->bytes();
+
+            return http::OK(object);
+          });
+      }));
+  }
+
+  Future<http::Response> blob(
+      const http::Request& request,
+      const Option<Principal>& principal)
+  {
+    return authorize("blob", request, principal)
+      .then(defer(self(), [=](bool authorized) -> Future<http::Response> {
+        if (!authorized) {
+          return http::Forbidden();
+        }
+
+        return _blob(request);
+      }));
+  }
+
+  Future<http::Response> _blob(const http::Request& request)
+  {
+    Option<string> digest = request.url.query.get("digest");
+    if (digest.isNone()) {
+      return http::BadRequest("Missing 'digest'.\n");
+    }
+
+    Try<size_t> offset = numify<size_t>(
+        request.url.query.get("offset").getOrElse("0"));
+
+    if (offset.isError()) {
+      return http::BadRequest("Failed to parse 'offset': " + offset.error());
+    }
+
+    Option<size_t> length;
+    if (request.url.query.contains("length")) {
+      Try<size_t> _length = numify<size_t>(request.url.query.at("length"));
+      if (_length.isError()) {
+        return http::BadRequest(
+            "Failed to parse 'length': " + _length.error());
+      }
+
+      length = _length.get();
+    }
+
+    return find(digest.get())
+      .then([=](const Option<string>& path) -> http::Response {
+        if (path.isNone()) {
+          return http::NotFound();
+        }
+
+        Try<Bytes> size_ = os::stat::size(path.get());
+        if (size_.isError()) {
+          return http::NotFound();
+        }
+
+        const size_t size = static_cast<size_t>(size_->bytes());
+        if (offset.get() > size) {
+          return http::BadRequest(
+              "'offset' is beyond the end of the artifact.\n");
+        }
+
+        const size_t end = length.isSome()
+          ? std::min(size, offset.get() + length.get())
+          : size;
+
+        http::OK response;
+        response.type = response.PATH;
+        response.path = path.get();
+        response.range =
+          http::Response::Range{offset.get(), end - offset.get()};
+        response.headers["Content-Type"] = "application/octet-stream";
+
+        return response;
+      });
+  }
+
+  // Authorizes the principal to access the given endpoint with the
+  // `get_endpoints` ACL.
+  //
+  // NOTE: The endpoint is named by `ARTIFACT_SERVER_ID` rather than
+  // the ID of this process, which differs when several agents are run
+  // in the same process (e.g., in tests).
+  Future<bool> authorize(
+      const string& endpoint,
+      const http::Request& request,
+      const Option<Principal>& principal)
+  {
+    if (request.method != "GET") {
+      return Failure("Unexpected request method '" + request.method + "'");
+    }
+
+    return authorizeEndpoint(
+        "/" + string(ARTIFACT_SERVER_ID) + "/" + endpoint,
+        request.method,
+        authorizer,
+        principal);
+  }
+
+  Future<Option<string>> find(const string& digest)
+  {
+    if (blobs.contains(digest) && os::exists(blobs.at(digest))) {
+      return blobs.at(digest);
+    }
+
+    return refresh()
+      .then(defer(self(), [=]() { return blobs.get(digest); }));
+  }
+
+  // Rescans the fetcher cache and the Docker store for artifacts. The
+  // scan is done off this actor, and concurrent rescans are coalesced.
+  Future<Nothing> refresh()
+  {
+    if (refreshing.isSome()) {
+      return refreshing.get();
+    }
+
+    if (refreshed.isSome() &&
+        Clock::now() - refreshed.get() < REFRESH_INTERVAL) {
+      return Nothing();
+    }
+
+    const string fetcherCacheDir = flags.fetcher_cache_dir;
+    const string dockerStoreDir = flags.docker_store_dir;
+
+    refreshing =
+      async([=]() { return scan(fetcherCacheDir, dockerStoreDir); })
+      .then(defer(self(), [=](const hashmap<string, string>& _blobs) {
+        blobs = _blobs;
+        return Nothing();
+      }))
+      .onAny(defer(self(), [=](const Future<Nothing>&) {
+        refreshing = None();
+        refreshed = Clock::now();
+      }));
+
+    return refreshing.get();
+  }
+
+  // Returns the paths of the artifacts held by this agent, by their
+  // digest.
+  static hashmap<string, string> scan(
+      const string& fetcherCacheDir,
+      const string& dockerStoreDir)
+  {
+    hashmap<string, string> blobs;
+
+    // Only the fetcher cache files of which the digest has already
+    // been computed can be served.
+    const string indexPath = Fetcher::getCacheIndexPath(fetcherCacheDir);
+
+    if (os::exists(indexPath)) {
+      Result<FetcherCacheIndex> index =
+        state::read<FetcherCacheIndex>(indexPath);
+
+      if (index.isError()) {
+        LOG(WARNING) << "Failed to read the fetcher cache index '"
+                     << indexPath << "': " << index.error();
+      } else if (index.isSome()) {
+        foreach (const FetcherCacheIndex::Entry& entry, index->entries()) {
+          if (entry.has_digest()) {
+            blobs[SHA512_PREFIX + entry.digest()] =
+              path::join(entry.directory(), entry.filename());
+          }
+        }
+      }
+    }
+
+    // The Docker image layer tar balls are kept by the registry puller
+    // if artifacts are distributed between agents.
+    if (os::exists(dockerStoreDir)) {
+      Try<list<string>> layers = docker::paths::listLayers(dockerStoreDir);
+
+      if (layers.isError()) {
+        LOG(WARNING) << "Failed to list the Docker image layers: "
+                     << layers.error();
+        return blobs;
+      }
+
+      foreach (const string& layerId, layers.get()) {
+        const string layerPath =
+          docker::paths::getImageLayerPath(dockerStoreDir, layerId);
+
+        Try<list<string>> files = os::ls(layerPath);
+        if (files.isError()) {
+          continue;
+        }
+
+        foreach (const string& file, files.get()) {
+          if (strings::startsWith(file, SHA256_PREFIX)) {
+            blobs[file] = docker::paths::getImageLayerBlobPath(layerPath, file);
+          }
+        }
+      }
+    }
+
+    return blobs;
+  }
+
+  const Flags flags;
+  const Option<string> authenticationRealm;
+  const Option<Authorizer*> authorizer;
+
+  // Paths of the artifacts held by this agent, by their digest.
+  hashmap<string, string> blobs;
+
+  Option<Future<Nothing>> refreshing;
+  Option<Time> refreshed;
+};
+
+
+ArtifactServer::ArtifactServer(
+    const Flags& flags,
+    const Option<string>& authenticationRealm,
+    const Option<Authorizer*>& authorizer,
+    const string& id)
+  : process(new ArtifactServerProcess(
+        flags,
+        authenticationRealm,
+        authorizer,
+        id))
+{
+  spawn(process.get());
+}
+
+
+ArtifactServer::~ArtifactServer()
+{
+  terminate(process.get());
+  wait(process.get());
+}
+
+
+UPID ArtifactServer::pid() const
+{
+  return process->self();
+}
+
+
+class PeerFetcherProcess : public Process<PeerFetcherProcess>
+{
+public:
+  PeerFetcherProcess(
+      Owned<PeerTracker> _tracker,
+      const Bytes& _chunkSize,
+      const Option<Credential>& credential)
+    : ProcessBase(process::ID::generate("peer-fetcher")),
+      tracker(_tracker),
+      chunkSize(_chunkSize.bytes())
+  {
+    // The artifact servers of the peers authenticate this agent with
+    // the credential it uses to authenticate with the master.
+    if (credential.isSome()) {
+      headers["Authorization"] =
+        "Basic " +
+        base64::encode(credential->principal() + ":" + credential->secret());
+    }
+  }
+
+  Future<Nothing> fetch(const string& digest, const string& path)
+  {
+    return tracker->peers(digest)
+      .then(defer(self(), [=](const vector<UPID>& peers) {
+        return lookup(digest, peers);
+      }))
+      .then(defer(self(), [=](const vector<Holder>& holders) {
+        return download(digest, holders, path);
+      }));
+  }
+
+  Future<Bytes> size(const string& digest)
+  {
+    return tracker->peers(digest)
+      .then(defer(self(), [=](const vector<UPID>& peers) {
+        return lookup(digest, peers);
+      }))
+      .then([](const vector<Holder>& holders) {
+        return Bytes(holders.front().size);
+      });
+  }
+
+private:
+  struct Holder
+  {
+    UPID peer;
+    size_t size;
+  };
+
+  struct Download
+  {
+    string digest;
+    string path;
+    size_t size;
+    int_fd fd;
+
+    // The chunks which remain to be downloaded.
+    deque<size_t> chunks;
+    size_t remaining;
+
+    // The peers which have not failed yet, and those of them which
+    // are currently downloading a chunk.
+    vector<UPID> peers;
+    vector<UPID> active;
+
+    Promise<Nothing> promise;
+  };
+
+  // Returns the peers which hold the artifact with the given digest.
+  // If they do not agree on its size, only the peers reporting the
+  // most common one are returned. Since the downloaded artifact is
+  // verified against the digest, a peer reporting a wrong size can
+  // only make the download fail.
+  Future<vector<Holder>> lookup(
+      const string& digest,
+      const vector<UPID>& peers)
+  {
+    vector<Future<http::Response>> responses;
+
+    foreach (const UPID& peer, peers) {
+      responses.push_back(
+          http::get(
+              peer,
+              "lookup",
+              http::query::encode({{"digest", digest}}),
+              headers)
+            .after(LOOKUP_TIMEOUT,
+                   [](Future<http::Response> response)
+                       -> Future<http::Response> {
+              response.discard();
+              return Failure("Timed out");
+            }));
+    }
+
+    return await(responses)
+      .then([=](const vector<Future<http::Response>>& responses)
+          -> Future<vector<Holder>> {
+        hashmap<size_t, vector<Holder>> holders;
+        Option<size_t> size;
+
+        for (size_t i = 0; i < responses.size(); i++) {
+          if (!responses[i].isReady() ||
+              responses[i]->code != http::Status::OK) {
+            continue;
+          }
+
+          Try<JSON::Object> object =
+            JSON::parse<JSON::Object>(responses[i]->body);
+
+          if (object.isError()) {
+            continue;
+          }
+
+          Result<JSON::String> _digest = object->at<JSON::String>("digest");
+          Result<JSON::Number> _size = object->at<JSON::Number>("size");
+
+          if (!_digest.isSome() || _digest->value != digest ||
+              !_size.isSome()) {
+            continue;
+          }
+
+          vector<Holder>& group = holders[_size->as<size_t>()];
+          group.push_back({peers[i], _size->as<size_t>()});
+
+          if (size.isNone() || group.size() > holders[size.get()].size()) {
+            size = _size->as<size_t>();
+          }
+        }
+
+        if (size.isNone()) {
+          return Failure("No peer holds '" + digest + "'");
+        }
+
+        return holders.at(size.get());
+      });
+  }
+
+  Future<Nothing> download(
+      const string& digest,
+      const vector<Holder>& holders,
+      const string& path)
+  {
+    CHECK(!holders.empty());
+
+    Try<int_fd> fd = os::open(
+        path,
+        O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+        S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+
+    if (fd.isError()) {
+      return Failure("Failed to open '" + path + "': " + fd.error());
+    }
+
+    shared_ptr<Download> download(new Download());
+    download->digest = digest;
+    download->path = path;
+    download->size = holders.front().size;
+    download->fd = fd.get();
+
+    for (size_t offset = 0; offset < download->size; offset += chunkSize) {
+      download->chunks.push_back(offset);
+    }
+
+    download->remaining = download->chunks.size();
+
+    foreach (const Holder& holder, holders) {
+      download->peers.push_back(holder.peer);
+    }
+
+    VLOG(1) << "Downloading '" << download->digest << "' in "
+            << download->chunks.size() << " chunks from "
+            << download->peers.size() << " peers to '" << path << "'";
+
+    if (download->remaining == 0) {
+      finish(download);
+    } else {
+      download->active = download->peers;
+
+      foreach (const UPID& peer, download->peers) {
+        pull(download, peer);
+      }
+    }
+
+    return download->promise.future();
+  }
+
+  // Downloads the next chunk of the artifact from the given peer.
+  void pull(const shared_ptr<Download>& download, const UPID& peer)
+  {
+    if (!download->promise.future().isPending()) {
+      return;
+    }
+
+    if (download->chunks.empty()) {
+      download->active.erase(
+          std::remove(download->active.begin(), download->active.end(), peer),
+          download->active.end());
+      return;
+    }
+
+    const size_t offset = download->chunks.front();
+    const size_t length = std::min(chunkSize, download->size - offset);
+
+    download->chunks.pop_front();
+
+    http::get(
+        peer,
+        "blob",
+        http::query::encode({
+            {"digest", download->digest},
+            {"offset", stringify(offset)},
+            {"length", stringify(length)}}),
+        headers)
+      .after(CHUNK_TIMEOUT,
+             [](Future<http::Response> response) -> Future<http::Response> {
+        response.discard();
+        return Failure("Timed out");
+      })
+      .onAny(defer(self(), [=](const Future<http::Response>& response) {
+        Option<string> error;
+
+        if (!response.isReady()) {
+          error = response.isFailed() ? response.failure() : "discarded";
+        } else if (response->code != http::Status::OK) {
+          error = response->status;
+        } else if (response->body.size() != length) {
+          error = "Received " + stringify(response->body.size()) +
+                  " instead of " + stringify(length) + " bytes";
+        }
+
+        if (error.isSome()) {
+          LOG(WARNING) << "Failed to download chunk at offset " << offset
+                       << " of '" << download->digest << "' from " << peer
+                       << ": " << error.get();
+
+          retry(download, peer, offset);
+          return;
+        }
+
+        Try<off_t> seek = os::lseek(download->fd, offset, SEEK_SET);
+        Try<Nothing> write = seek.isSome()
+          ? os::write(download->fd, response->body)
+          : Error(seek.error());
+
+        if (write.isError()) {
+          fail(download, "Failed to write '" + download->path + "': " +
+               write.error());
+          return;
+        }
+
+        if (--download->remaining == 0) {
+          finish(download);
+          return;
+        }
+
+        pull(download, peer);
+      }));
+  }
+
+  // Gives up on the given peer and downloads the chunk at `offset`
+  // from one of the other peers.
+  void retry(
+      const shared_ptr<Download>& download,
+      const UPID& peer,
+      size_t offset)
+  {
+    download->chunks.push_back(offset);
+
+    download->peers.erase(
+        std::remove(download->peers.begin(), download->peers.end(), peer),
+        download->peers.end());
+
+    download->active.erase(
+        std::remove(download->active.begin(), download->active.end(), peer),
+        download->active.end());
+
+    if (download->peers.empty()) {
+      fail(download, "No peer could serve '" + download->digest + "'");
+      return;
+    }
+
+    // Peers which have run out of chunks are restarted.
+    foreach (const UPID& peer, download->peers) {
+      if (std::find(download->active.begin(), download->active.end(), peer) ==
+          download->active.end()) {
+        download->active.push_back(peer);
+        pull(download, peer);
+      }
+    }
+  }
+
+  void finish(const shared_ptr<Download>& download)
+  {
+    os::close(download->fd);
+
+    Future<string> digest = Failure("Unsupported digest");
+
+    if (strings::startsWith(download->digest, SHA512_PREFIX)) {
+      digest = command::sha512(Path(download->path))
+        .then([](const string& hex) { return SHA512_PREFIX + hex; });
+    } else if (strings::startsWith(download->digest, SHA256_PREFIX)) {
+      digest = command::sha256(Path(download->path))
+        .then([](const string& hex) { return SHA256_PREFIX + hex; });
+    }
+
+    digest
+      .onAny(defer(self(), [=](const Future<string>& digest) {
+        if (!digest.isReady()) {
+          os::rm(download->path);
+          download->promise.fail(
+              "Failed to verify '" + download->path + "': " +
+              (digest.isFailed() ? digest.failure() : "discarded"));
+        } else if (digest.get() != download->digest) {
+          os::rm(download->path);
+          download->promise.fail(
+              "Downloaded '" + download->path + "' has digest '" +
+              digest.get() + "' instead of '" + download->digest + "'");
+        } else {
+          download->promise.set(Nothing());
+        }
+      }));
+  }
+
+  void fail(const shared_ptr<Download>& download, const string& message)
+  {
+    if (!download->promise.future().isPending()) {
+      return;
+    }
+
+    os::close(download->fd);
+    os::rm(download->path);
+
+    download->promise.fail(message);
+  }
+
+  Owned<PeerTracker> tracker;
+  const size_t chunkSize;
+
+  // Headers of the requests to the artifact servers of the peers.
+  http::Headers headers;
+};
+
+
+Try<Owned<PeerFetcher>> PeerFetcher::create(const Flags& flags)
+{
+  if (flags.artifact_peers.isNone()) {
+    return Error("No peers specified with `--artifact_peers`");
+  }
+
+  Try<Owned<PeerTracker>> tracker =
+    PeerTracker::create(flags.artifact_peers.get());
+
+  if (tracker.isError()) {
+    return Error("Failed to create peer tracker: " + tracker.error());
+  }
+
+  Option<Credential> credential;
+  if (flags.credential.isSome()) {
+    Result<Credential> _credential =
+      credentials::readCredential(flags.credential.get());
+
+    if (_credential.isError()) {
+      return Error(
+          "Failed to read the credential of the agent: " +
+          _credential.error());
+    }
+
+    if (_credential.isSome()) {
+      credential = _credential.get();
+    }
+  }
+
+  return Owned<PeerFetcher>(new PeerFetcher(Owned<PeerFetcherProcess>(
+      new PeerFetcherProcess(
+          tracker.get(),
+          flags.artifact_chunk_size,
+          credential))));
+}
+
+
+PeerFetcher::PeerFetcher(Owned<PeerFetcherProcess> _process)
+  : process(_process)
+{
+  spawn(process.get());
+}
+
+
+PeerFetcher::~PeerFetcher()
+{
+  terminate(process.get());
+  wait(process.get());
+}
+
+
+Future<Bytes> PeerFetcher::size(const string& digest)
+{
+  return dispatch(process.get(), &PeerFetcherProcess::size, digest);
+}
+
+
+Future<Nothing> PeerFetcher::fetch(const string& digest, const string& path)
+{
+  return dispatch(process.get(), &PeerFetcherProcess::fetch, digest, path);
+}
+
+} // namespace slave {
+} // namespace internal {
+} // namespace mesos {
@@ -0,0 +1,130 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __SLAVE_ARTIFACTS_HPP__
+#define __SLAVE_ARTIFACTS_HPP__
+
+#include <string>
+#include <vector>
+
+#include <mesos/authorizer/authorizer.hpp>
+
+#include <process/future.hpp>
+#include <process/owned.hpp>
+#include <process/pid.hpp>
+
+#include <stout/bytes.hpp>
+#include <stout/nothing.hpp>
+#include <stout/option.hpp>
+#include <stout/try.hpp>
+
+#include "slave/flags.hpp"
+
+namespace mesos {
+namespace internal {
+namespace slave {
+
+// Forward declarations.
+class ArtifactServerProcess;
+class PeerFetcherProcess;
+
+
+// The ID of the artifact server process of an agent.
+constexpr char ARTIFACT_SERVER_ID[] = "artifacts";
+
+
+// Locates the agents which might hold an artifact. An artifact is
+// either named by its digest (e.g., `sha256:<hex>`), or by its fetcher
+// cache key (see `FetcherProcess::Cache`).
+class PeerTracker
+{
+public:
+  // Returns the tracker for the peers specified by `--artifact_peers`.
+  static Try<process::Owned<PeerTracker>> create(const std::string& peers);
+
+  virtual ~PeerTracker() {}
+
+  // Returns the artifact servers of the peers which might hold the
+  // given artifact, see `ArtifactServer`.
+  virtual process::Future<std::vector<process::UPID>> peers(
+      const std::string& artifact) = 0;
+};
+
+
+// Serves the fetcher cache files and the Docker image layers of this
+// agent to its peers. Artifacts are looked up by their digest with
+// `/artifacts/lookup?digest=...`, and downloaded in chunks with
+// `/artifacts/blob?digest=...&offset=...`. The endpoints are
+// authenticated in the given realm and authorized with the
+// `get_endpoints` ACL, like the other endpoints of the agent.
+class ArtifactServer
+{
+public:
+  ArtifactServer(
+      const Flags& flags,
+      const Option<std::string>& authenticationRealm,
+      const Option<Authorizer*>& authorizer,
+      const std::string& id = ARTIFACT_SERVER_ID);
+
+  ~ArtifactServer();
+
+  process::UPID pid() const;
+
+private:
+  ArtifactServer(const ArtifactServer&) = delete;
+  ArtifactServer& operator=(const ArtifactServer&) = delete;
+
+  process::Owned<ArtifactServerProcess> process;
+};
+
+
+// Downloads artifacts from the peers which hold them. The chunks of an
+// artifact are downloaded from up to `MAX_ARTIFACT_PEERS` peers
+// concurrently, and a chunk which fails to download from one peer is
+// downloaded from another one. The downloaded file is verified against
+// the digest of the artifact, which must therefore not be taken from
+// the peers. If the agent has a credential (see `--credential`), the
+// peers are authenticated with it.
+class PeerFetcher
+{
+public:
+  static Try<process::Owned<PeerFetcher>> create(const Flags& flags);
+
+  ~PeerFetcher();
+
+  // Returns the size of the artifact with the given digest as reported
+  // by the peers which hold it, e.g., to reserve space for it.
+  process::Future<Bytes> size(const std::string& digest);
+
+  // Downloads the artifact with the given digest to `path`.
+  process::Future<Nothing> fetch(
+      const std::string& digest,
+      const std::string& path);
+
+private:
+  explicit PeerFetcher(process::Owned<PeerFetcherProcess> process);
+
+  PeerFetcher(const PeerFetcher&) = delete;
+  PeerFetcher& operator=(const PeerFetcher&) = delete;
+
+  process::Owned<PeerFetcherProcess> process;
+};
+
+} // namespace slave {
+} // namespace internal {
+} // namespace mesos {
+
+#endif // __SLAVE_ARTIFACTS_HPP__
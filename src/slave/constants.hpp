@@ -51,6 +51,9 @@ constexpr Duration DEFAULT_EXECUTOR_SHUTDOWN_GRACE_PERIOD = Seconds(5);
 // The default amount of time between heartbeats sent to HTTP executors.
 constexpr Duration DEFAULT_EXECUTOR_HEARTBEAT_INTERVAL = Minutes(30);
 
+// The default amount of time for which task launches are batched.
+constexpr Duration DEFAULT_TASK_LAUNCH_BATCH_INTERVAL = Duration::zero();
+
 constexpr Duration RECOVERY_TIMEOUT = Minutes(15);
 
 // TODO(gkleiman): Move this to a different file once `TaskStatusUpdateManager`
@@ -86,6 +89,9 @@ constexpr Duration DISK_WATCH_INTERVAL = Minutes(1);
 // Minimum free disk capacity enforced by the garbage collector.
 constexpr double GC_DISK_HEADROOM = 0.1;
 
+// Default number of paths the garbage collector removes concurrently.
+constexpr size_t GC_PARALLELISM = 2;
+
 // Maximum number of completed frameworks to store in memory.
 constexpr size_t MAX_COMPLETED_FRAMEWORKS = 50;
 
@@ -189,6 +195,15 @@ constexpr Bytes DEFAULT_FETCHER_CACHE_SIZE = Gigabytes(2);
 // Default timeout for the fetcher to wait when a net download stalls.
 constexpr Duration DEFAULT_FETCHER_STALL_TIMEOUT = Minutes(1);
 
+// Default maximum number of URIs downloaded concurrently by a fetch.
+constexpr size_t DEFAULT_FETCHER_PARALLELISM = 4;
+
+// Size of the chunks in which artifacts are downloaded from peers.
+constexpr Bytes DEFAULT_ARTIFACT_CHUNK_SIZE = Megabytes(4);
+
+// Maximum number of peers an artifact is downloaded from.
+constexpr size_t MAX_ARTIFACT_PEERS = 16;
+
 // If no pings received within this timeout, then the slave will
 // trigger a re-detection of the master to cause a re-registration.
 Duration DEFAULT_MASTER_PING_TIMEOUT();
@@ -14,36 +14,69 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <fcntl.h>
 #include <unistd.h>
 
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <zlib.h>
+
+#include <list>
 #include <map>
+#include <memory>
 #include <string>
+#include <thread>
 
 #include <mesos/mesos.hpp>
+#include <mesos/type_utils.hpp>
 
 #include <mesos/module/container_logger.hpp>
 
 #include <mesos/slave/container_logger.hpp>
 #include <mesos/slave/containerizer.hpp>
 
+#include <process/collect.hpp>
+#include <process/defer.hpp>
+#include <process/delay.hpp>
 #include <process/dispatch.hpp>
 #include <process/future.hpp>
+#include <process/id.hpp>
+#include <process/io.hpp>
+#include <process/owned.hpp>
 #include <process/process.hpp>
 #include <process/subprocess.hpp>
 
 #include <stout/bytes.hpp>
 #include <stout/error.hpp>
+#include <stout/hashmap.hpp>
+#include <stout/json.hpp>
+#include <stout/lambda.hpp>
+#include <stout/numify.hpp>
 #include <stout/try.hpp>
 #include <stout/none.hpp>
 #include <stout/nothing.hpp>
 #include <stout/path.hpp>
+#include <stout/stringify.hpp>
 #include <stout/strings.hpp>
 
+#include <stout/os/close.hpp>
 #include <stout/os/constants.hpp>
 #include <stout/os/environment.hpp>
+#include <stout/os/exists.hpp>
 #include <stout/os/fcntl.hpp>
 #include <stout/os/killtree.hpp>
+#include <stout/os/ls.hpp>
+#include <stout/os/mkdir.hpp>
+#include <stout/os/open.hpp>
 #include <stout/os/pipe.hpp>
+#include <stout/os/posix/chown.hpp>
+#include <stout/os/read.hpp>
+#include <stout/os/rename.hpp>
+#include <stout/os/rm.hpp>
+#include <stout/os/rmdir.hpp>
+#include <stout/os/stat.hpp>
+#include <stout/os/write.hpp>
 
 #ifdef __linux__
 #include "linux/systemd.hpp"
@@ -57,8 +90,10 @@ using namespace mesos;
 using namespace process;
 
 using std::array;
+using std::list;
 using std::map;
 using std::string;
+using std::vector;
 
 using mesos::slave::ContainerConfig;
 using mesos::slave::ContainerLogger;
@@ -68,15 +103,352 @@ namespace mesos {
 namespace internal {
 namespace logger {
 
+// In the multiplexed mode, the output of a container is written to its
+// log file once this much is buffered, or after `FLUSH_INTERVAL`.
+const Bytes BATCH_SIZE = Kilobytes(64);
+constexpr Duration FLUSH_INTERVAL = Milliseconds(100);
+
+// The capacity requested for the named pipes in the multiplexed mode.
+const Bytes PIPE_SIZE = Megabytes(1);
+
+// The most output of a stream which is kept while its leading log
+// file can not be opened, in the multiplexed mode.
+const Bytes MAX_PENDING_SIZE = Megabytes(4);
+
+// The suffix of the files which keep the settings of each stream in
+// the multiplexed mode.
+const string STATE_SUFFIX = ".state";
+
+// The streams of each container in the multiplexed mode.
+const vector<string> NAMES = {"stdout", "stderr"};
+
+
+// The subset of `logrotate` options which are supported when the logs
+// are rotated in-process. As with `logrotate`, rotated files are
+// removed rather than kept unless `rotate` is given.
+struct Rotation
+{
+  size_t count = 0;
+  bool compress = false;
+};
+
+
+static Try<Rotation> parseRotation(const Option<string>& options)
+{
+  Rotation rotation;
+
+  if (options.isNone()) {
+    return rotation;
+  }
+
+  foreach (const string& line, strings::tokenize(options.get(), "\n")) {
+    const vector<string> tokens = strings::tokenize(line, " \t");
+    if (tokens.empty()) {
+      continue;
+    }
+
+    if (tokens[0] == "rotate" && tokens.size() == 2) {
+      Try<size_t> count = numify<size_t>(tokens[1]);
+      if (count.isError()) {
+        return Error("Invalid 'rotate' option '" + line + "'");
+      }
+
+      rotation.count = count.get();
+    } else if (tokens[0] == "compress") {
+      rotation.compress = true;
+    } else if (tokens[0] == "nocompress") {
+      rotation.compress = false;
+    } else {
+      LOG(WARNING) << "Ignoring unsupported logrotate option '" << line
+                   << "' in multiplexed mode";
+    }
+  }
+
+  return rotation;
+}
+
+
+// Compresses a rotated log file into a gzip file next to it. The file
+// is compressed in chunks rather than read into memory as a whole.
+static void compressFile(const string& path, const Option<string>& user)
+{
+  Try<int_fd> in = os::open(path, O_RDONLY | O_CLOEXEC);
+  if (in.isError()) {
+    LOG(WARNING) << "Failed to open '" << path << "': " << in.error();
+    return;
+  }
+
+  const string temporary = path + ".gz.tmp";
+
+  gzFile out = gzopen(temporary.c_str(), "wb");
+  if (out == nullptr) {
+    LOG(WARNING) << "Failed to open '" << temporary << "'";
+    os::close(in.get());
+    return;
+  }
+
+  std::unique_ptr<char[]> data(new char[BATCH_SIZE.bytes()]);
+
+  Option<string> error;
+
+  while (error.isNone()) {
+    ssize_t length = os::read(in.get(), data.get(), BATCH_SIZE.bytes());
+    if (length < 0) {
+      error = ErrnoError("Failed to read '" + path + "'").message;
+    } else if (length == 0) {
+      break;
+    } else if (gzwrite(out, data.get(), length) != length) {
+      int errnum = Z_OK;
+      error = "Failed to compress '" + path + "': " + gzerror(out, &errnum);
+    }
+  }
+
+  os::close(in.get());
+
+  if (gzclose(out) != Z_OK && error.isNone()) {
+    error = "Failed to write '" + temporary + "'";
+  }
+
+  if (error.isSome()) {
+    LOG(WARNING) << error.get();
+    os::rm(temporary);
+    return;
+  }
+
+  if (user.isSome()) {
+    Try<Nothing> chown = os::chown(user.get(), temporary, false);
+    if (chown.isError()) {
+      LOG(WARNING) << "Failed to chown '" << temporary << "': "
+                   << chown.error();
+    }
+  }
+
+  Try<Nothing> rename = os::rename(temporary, path + ".gz");
+  if (rename.isError()) {
+    LOG(WARNING) << "Failed to rename '" << temporary << "': "
+                 << rename.error();
+    os::rm(temporary);
+    return;
+  }
+
+  os::rm(path);
+}
+
+
+// Writes the output of a stream to its leading log file and rotates
+// the log files, in the multiplexed mode. Each stream has a process of
+// its own, so that writing and rotating the log files of a stream
+// neither holds up the reading of the named pipes nor other streams.
+class LogFileProcess : public Process<LogFileProcess>
+{
+public:
+  LogFileProcess(
+      const string& _filename,
+      const Bytes& _maxSize,
+      const Rotation& _rotation,
+      const Option<string>& _user)
+    : ProcessBase(process::ID::generate("logrotate-log-file")),
+      filename(_filename),
+      maxSize(_maxSize),
+      rotation(_rotation),
+      user(_user),
+      bytesWritten(0),
+      compressing(Nothing()) {}
+
+  // Appends the output to the leading log file, rotating the log files
+  // so that each of them stays within the maximum size.
+  //
+  // NOTE: Errors are logged rather than returned since draining the
+  // named pipe (which would otherwise potentially block the container
+  // on write) is prioritized over log fidelity. Output which could not
+  // be written because the leading log file could not be opened is kept
+  // and written along with the next output, up to `MAX_PENDING_SIZE`.
+  Nothing write(const string& output)
+  {
+    pending.append(output);
+
+    size_t offset = 0;
+
+    while (offset < pending.size()) {
+      size_t length = pending.size() - offset;
+
+      if (bytesWritten + length > maxSize.bytes()) {
+        // NOTE: If the leading log file can not be rotated yet, it
+        // temporarily grows beyond the maximum size.
+        if (bytesWritten < maxSize.bytes()) {
+          length = maxSize.bytes() - bytesWritten;
+        } else if (rotate()) {
+          continue;
+        }
+      }
+
+      if (leading.isNone()) {
+        // NOTE: We open the file in append-mode as the leading log file
+        // already exists after the agent restarts.
+        Try<int_fd> open = os::open(
+            filename,
+            O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC,
+            S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+
+        if (open.isError()) {
+          LOG(WARNING) << "Failed to open '" << filename << "': "
+                       << open.error();
+          break;
+        }
+
+        if (user.isSome()) {
+          Try<Nothing> chown = os::chown(user.get(), filename, false);
+          if (chown.isError()) {
+            LOG(WARNING) << "Failed to chown '" << filename << "': "
+                         << chown.error();
+          }
+        }
+
+        Try<Bytes> size = os::stat::size(filename);
+        bytesWritten = size.isSome() ? size->bytes() : 0;
+        leading = open.get();
+
+        continue;
+      }
+
+      Try<Nothing> write =
+        os::write(leading.get(), pending.substr(offset, length));
+
+      if (write.isError()) {
+        LOG(WARNING) << "Failed to write to '" << filename << "': "
+                     << write.error();
+      }
+
+      bytesWritten += length;
+      offset += length;
+    }
+
+    pending.erase(0, offset);
+
+    if (pending.size() > MAX_PENDING_SIZE.bytes()) {
+      const size_t dropped = pending.size() - MAX_PENDING_SIZE.bytes();
+
+      LOG(WARNING) << "Dropping " << Bytes(dropped) << " of output for '"
+                   << filename << "'";
+
+      pending.erase(0, dropped);
+    }
+
+    return Nothing();
+  }
+
+protected:
+  void finalize() override
+  {
+    if (leading.isSome()) {
+      os::close(leading.get());
+    }
+  }
+
+private:
+  // Moves the leading log file to `<filename>.1` (after moving the
+  // older ones to `<filename>.<N+1>`), and removes the oldest log file
+  // beyond the rotation count. Returns false if the leading log file
+  // could not be rotated, e.g., because the previous rotated log file
+  // is still being compressed.
+  bool rotate()
+  {
+    if (compressing.isPending()) {
+      return false;
+    }
+
+    const size_t count = rotation.count;
+
+    if (count == 0) {
+      Try<Nothing> rm = os::rm(filename);
+      if (rm.isError()) {
+        LOG(WARNING) << "Failed to remove '" << filename << "': "
+                     << rm.error();
+        return false;
+      }
+    } else {
+      const string suffix = rotation.compress ? ".gz" : "";
+
+      auto rotated = [this, &suffix](size_t index) {
+        return filename + "." + stringify(index) + suffix;
+      };
+
+      if (os::exists(rotated(count))) {
+        os::rm(rotated(count));
+      }
+
+      for (size_t index = count - 1; index > 0; index--) {
+        if (os::exists(rotated(index))) {
+          os::rename(rotated(index), rotated(index + 1));
+        }
+      }
+
+      const string first = filename + ".1";
+
+      Try<Nothing> rename = os::rename(filename, first);
+      if (rename.isError()) {
+        LOG(WARNING) << "Failed to rotate '" << filename << "': "
+                     << rename.error();
+        return false;
+      }
+
+      if (rotation.compress) {
+        std::shared_ptr<Promise<Nothing>> promise(new Promise<Nothing>());
+        compressing = promise->future();
+
+        // NOTE: The log file is compressed on a thread of its own rather
+        // than on a libprocess worker thread, as compressing a large log
+        // file blocks for a while. The thread is detached since it only
+        // holds copies and shared state.
+        const Option<string> _user = user;
+        std::thread([first, _user, promise]() {
+          compressFile(first, _user);
+          promise->set(Nothing());
+        }).detach();
+      }
+    }
+
+    // NOTE: The leading log file is closed only after it has been
+    // moved, as the output keeps being appended to it otherwise.
+    if (leading.isSome()) {
+      os::close(leading.get());
+      leading = None();
+    }
+
+    bytesWritten = 0;
+
+    return true;
+  }
+
+  const string filename;
+  const Bytes maxSize;
+  const Rotation rotation;
+  const Option<string> user;
+
+  // The output which could not be written yet.
+  string pending;
+
+  Option<int_fd> leading;
+  size_t bytesWritten;
+
+  // The compression of the most recently rotated log file.
+  Future<Nothing> compressing;
+};
+
+
 class LogrotateContainerLoggerProcess :
   public Process<LogrotateContainerLoggerProcess>
 {
 public:
-  LogrotateContainerLoggerProcess(const Flags& _flags) : flags(_flags) {}
+  LogrotateContainerLoggerProcess(const Flags& _flags)
+    : flags(_flags),
+      stopping(false) {}
 
   // Spawns two subprocesses that read from their stdin and write to
   // "stdout" and "stderr" files in the sandbox.  The subprocesses will rotate
   // the files according to the configured maximum size and number of files.
+  // In the multiplexed mode, the process itself reads from named pipes
+  // instead (see `attach`).
   Future<ContainerIO> prepare(
       const ContainerID& containerId,
       const ContainerConfig& containerConfig)
@@ -146,6 +518,10 @@ public:
       }
     }
 
+    if (flags.multiplexed) {
+      return attach(containerId, containerConfig, overriddenFlags);
+    }
+
     // NOTE: We manually construct a pipe here instead of using
     // `Subprocess::PIPE` so that the ownership of the FDs is properly
     // represented.  The `Subprocess` spawned below owns the read-end
@@ -246,8 +622,532 @@ public:
     return io;
   }
 
-protected:
+  // Recovers the streams of the containers which were running when
+  // the agent restarted, in the multiplexed mode.
+  void recover()
+  {
+    if (!os::exists(flags.state_dir)) {
+      return;
+    }
+
+    Try<list<string>> containers = os::ls(flags.state_dir);
+    if (containers.isError()) {
+      LOG(ERROR) << "Failed to list '" << flags.state_dir << "': "
+                 << containers.error();
+      return;
+    }
+
+    foreach (const string& container, containers.get()) {
+      const string directory = path::join(flags.state_dir, container);
+
+      foreach (const string& name, NAMES) {
+        const string state = path::join(directory, name + STATE_SUFFIX);
+        if (!os::exists(state)) {
+          continue;
+        }
+
+        Try<Owned<Stream>> stream = Stream::recover(directory, name);
+        if (stream.isError()) {
+          LOG(WARNING) << "Failed to recover the " << name << " of container "
+                       << container << ": " << stream.error();
+
+          os::rm(state);
+          os::rm(path::join(directory, name));
+          continue;
+        }
+
+        // NOTE: If the container has terminated while the agent was
+        // down, the named pipe has no writers left and the first read
+        // returns EOF after the remaining output has been drained.
+        start(stream.get());
+      }
+
+      // Remove the directories of containers with no streams left.
+      Try<list<string>> entries = os::ls(directory);
+      if (entries.isSome() && entries->empty()) {
+        os::rmdir(directory, false);
+      }
+    }
+  }
+
+  // Creates the named pipes for the stdout and stderr of a container
+  // in the multiplexed mode, and starts reading from them.
+  Future<ContainerIO> attach(
+      const ContainerID& containerId,
+      const ContainerConfig& containerConfig,
+      const LoggerFlags& loggerFlags)
+  {
+    const string directory =
+      path::join(flags.state_dir, stringify(containerId));
+
+    Try<Nothing> mkdir = os::mkdir(directory);
+    if (mkdir.isError()) {
+      return Failure(
+          "Failed to create directory '" + directory + "': " + mkdir.error());
+    }
+
+    const Option<string> user = containerConfig.has_user()
+      ? Option<string>(containerConfig.user())
+      : Option<string>::none();
+
+    Try<int_fd> out = create(
+        directory,
+        "stdout",
+        path::join(containerConfig.directory(), "stdout"),
+        loggerFlags.max_stdout_size,
+        loggerFlags.logrotate_stdout_options,
+        user);
+
+    if (out.isError()) {
+      return Failure("Failed to attach to stdout: " + out.error());
+    }
+
+    Try<int_fd> err = create(
+        directory,
+        "stderr",
+        path::join(containerConfig.directory(), "stderr"),
+        loggerFlags.max_stderr_size,
+        loggerFlags.logrotate_stderr_options,
+        user);
+
+    if (err.isError()) {
+      os::close(out.get());
+      return Failure("Failed to attach to stderr: " + err.error());
+    }
+
+    // NOTE: The ownership of these FDs is given to the caller of this function.
+    ContainerIO io;
+    io.out = ContainerIO::IO::FD(out.get());
+    io.err = ContainerIO::IO::FD(err.get());
+    return io;
+  }
+
+private:
+  // A stdout or stderr of a container in the multiplexed mode.
+  struct Stream
+  {
+    // Reads the settings of the stream from its state file and opens
+    // the read end of its named pipe.
+    static Try<Owned<Stream>> recover(
+        const string& directory,
+        const string& name)
+    {
+      const string state = path::join(directory, name + STATE_SUFFIX);
+
+      Try<string> read = os::read(state);
+      if (read.isError()) {
+        return Error("Failed to read '" + state + "': " + read.error());
+      }
+
+      Try<JSON::Object> object = JSON::parse<JSON::Object>(read.get());
+      if (object.isError()) {
+        return Error("Failed to parse '" + state + "': " + object.error());
+      }
+
+      Result<JSON::String> filename = object->at<JSON::String>("filename");
+      Result<JSON::Number> maxSize = object->at<JSON::Number>("max_size");
+      Result<JSON::Number> count = object->at<JSON::Number>("rotate");
+      Result<JSON::Boolean> compress = object->at<JSON::Boolean>("compress");
+      Result<JSON::String> user = object->at<JSON::String>("user");
+
+      if (!filename.isSome() || !maxSize.isSome() || !count.isSome() ||
+          !compress.isSome() || user.isError()) {
+        return Error("Invalid state in '" + state + "'");
+      }
+
+      Rotation rotation;
+      rotation.count = count->as<size_t>();
+      rotation.compress = compress->value;
+
+      Owned<Stream> stream(new Stream(
+          directory,
+          name,
+          filename->value,
+          Bytes(maxSize->as<uint64_t>()),
+          rotation,
+          user.isSome() ? Option<string>(user->value) : None()));
+
+      Try<Nothing> open = stream->open();
+      if (open.isError()) {
+        return Error(open.error());
+      }
+
+      return stream;
+    }
+
+    Stream(
+        const string& directory,
+        const string& name,
+        const string& _filename,
+        const Bytes& _maxSize,
+        const Rotation& _rotation,
+        const Option<string>& _user)
+      : fifo(path::join(directory, name)),
+        state(path::join(directory, name + STATE_SUFFIX)),
+        filename(_filename),
+        maxSize(_maxSize),
+        rotation(_rotation),
+        user(_user),
+        data(new char[BATCH_SIZE.bytes()]),
+        flushing(false),
+        terminated(false),
+        writing(Nothing())
+    {
+      writer = spawn(
+          new LogFileProcess(filename, maxSize, rotation, user),
+          true);
+    }
+
+    ~Stream()
+    {
+      if (fd.isSome()) {
+        os::close(fd.get());
+      }
+
+      // NOTE: The output which was already handed to the writer is
+      // still written, as the termination is queued after it.
+      terminate(writer, false);
+    }
+
+    // Persists the settings of the stream so that it can be recovered
+    // after the agent restarts.
+    Try<Nothing> checkpoint() const
+    {
+      JSON::Object object;
+      object.values["filename"] = filename;
+      object.values["max_size"] = maxSize.bytes();
+      object.values["rotate"] = rotation.count;
+      object.values["compress"] = rotation.compress;
+
+      if (user.isSome()) {
+        object.values["user"] = user.get();
+      }
+
+      return os::write(state, stringify(object));
+    }
+
+    // Opens the read end of the named pipe.
+    Try<Nothing> open()
+    {
+      // NOTE: Opening the read end of a named pipe does not block with
+      // `O_NONBLOCK`, even if there is no writer yet.
+      Try<int_fd> open = os::open(fifo, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+      if (open.isError()) {
+        return Error("Failed to open '" + fifo + "': " + open.error());
+      }
+
+      fd = open.get();
+      return Nothing();
+    }
+
+    // The named pipe, which also identifies the stream.
+    const string fifo;
+    const string state;
+
+    // The leading log file.
+    const string filename;
+
+    const Bytes maxSize;
+    const Rotation rotation;
+    const Option<string> user;
+
+    // The read end of the named pipe.
+    Option<int_fd> fd;
+
+    // For reading from the named pipe. The read is none while its
+    // result is being handled, or while reading is paused.
+    std::unique_ptr<char[]> data;
+    Option<Future<size_t>> reading;
+
+    // The output read from the named pipe, but not yet handed to the
+    // writer.
+    string buffer;
+
+    // Whether a flush of the buffer is scheduled.
+    bool flushing;
+
+    // Whether EOF has been read, i.e., the container has terminated.
+    bool terminated;
+
+    // Writes and rotates the log files.
+    PID<LogFileProcess> writer;
+
+    // The most recent write of the buffer.
+    Future<Nothing> writing;
+  };
+
+  // Creates the named pipe of a stream and starts reading from it.
+  // Returns the write end of the named pipe for the container.
+  Try<int_fd> create(
+      const string& directory,
+      const string& name,
+      const string& filename,
+      const Bytes& maxSize,
+      const Option<string>& options,
+      const Option<string>& user)
+  {
+    Try<Rotation> rotation = parseRotation(options);
+    if (rotation.isError()) {
+      return Error(rotation.error());
+    }
+
+    Owned<Stream> stream(
+        new Stream(directory, name, filename, maxSize, rotation.get(), user));
+
+    if (::mkfifo(stream->fifo.c_str(), S_IRUSR | S_IWUSR) == -1) {
+      return ErrnoError("Failed to create named pipe '" + stream->fifo + "'");
+    }
+
+    Try<Nothing> checkpoint = stream->checkpoint();
+    if (checkpoint.isError()) {
+      os::rm(stream->fifo);
+      return Error(
+          "Failed to checkpoint '" + stream->state + "': " +
+          checkpoint.error());
+    }
+
+    Try<Nothing> open = stream->open();
+    if (open.isError()) {
+      os::rm(stream->fifo);
+      os::rm(stream->state);
+      return Error(open.error());
+    }
+
+    // NOTE: The write end is opened for reading as well, so that the
+    // named pipe always has a reader. This way the container does not
+    // get `SIGPIPE` while the agent is down, it only blocks once the
+    // pipe is full until the agent has restarted and resumed reading.
+    // Since the agent does not hold a write end, it still reads EOF
+    // once the container has terminated.
+    Try<int_fd> writer = os::open(stream->fifo, O_RDWR | O_CLOEXEC);
+    if (writer.isError()) {
+      os::rm(stream->fifo);
+      os::rm(stream->state);
+      return Error(
+          "Failed to open '" + stream->fifo + "': " + writer.error());
+    }
+
+#ifdef __linux__
+    // Allow more output to be buffered while the agent is down.
+    // This is best-effort as the size is capped for unprivileged users.
+    ::fcntl(writer.get(), F_SETPIPE_SZ, PIPE_SIZE.bytes());
+#endif // __linux__
+
+    start(stream);
+
+    return writer.get();
+  }
+
+  void start(const Owned<Stream>& stream)
+  {
+    streams[stream->fifo] = stream;
+    read(stream->fifo);
+  }
+
+  void read(const string& id)
+  {
+    if (!streams.contains(id) || stopping) {
+      return;
+    }
+
+    const Owned<Stream>& stream = streams.at(id);
+
+    stream->reading =
+      io::read(stream->fd.get(), stream->data.get(), BATCH_SIZE.bytes());
+
+    stream->reading->onAny(defer(self(), &Self::_read, id, lambda::_1));
+  }
+
+  void _read(const string& id, const Future<size_t>& length)
+  {
+    if (!streams.contains(id)) {
+      return;
+    }
+
+    const Owned<Stream>& stream = streams.at(id);
+    stream->reading = None();
+
+    // The read has been discarded by `stop()`, or completed before it
+    // could be discarded in which case its output is kept.
+    if (stopping) {
+      if (length.isReady()) {
+        if (length.get() == 0) {
+          stream->terminated = true;
+        } else {
+          stream->buffer.append(stream->data.get(), length.get());
+        }
+      }
+
+      return;
+    }
+
+    // EOF indicates that the container has terminated.
+    if (!length.isReady() || length.get() == 0) {
+      if (!length.isReady()) {
+        LOG(WARNING) << "Failed to read from '" << stream->fifo << "': "
+                     << (length.isFailed() ? length.failure() : "discarded");
+      }
+
+      flush(stream.get());
+      remove(id);
+      return;
+    }
+
+    stream->buffer.append(stream->data.get(), length.get());
+
+    if (stream->buffer.size() >= BATCH_SIZE.bytes()) {
+      const bool behind = stream->writing.isPending();
+
+      flush(stream.get());
+
+      // If the previous batch is still being written, the container
+      // produces output faster than it can be written. Reading is
+      // paused until the writer has caught up, so that the container
+      // blocks on the named pipe rather than its output piling up.
+      if (behind) {
+        stream->writing.onAny(defer(self(), &Self::read, id));
+        return;
+      }
+    } else if (!stream->flushing) {
+      stream->flushing = true;
+      delay(FLUSH_INTERVAL, self(), &Self::_flush, id);
+    }
+
+    read(id);
+  }
+
+  void _flush(const string& id)
+  {
+    if (streams.contains(id)) {
+      const Owned<Stream>& stream = streams.at(id);
+      stream->flushing = false;
+      flush(stream.get());
+    }
+  }
+
+  // Hands the buffered output to the writer of the stream.
+  void flush(Stream* stream)
+  {
+    if (!stream->buffer.empty()) {
+      stream->writing = dispatch(
+          stream->writer,
+          &LogFileProcess::write,
+          std::move(stream->buffer));
+
+      stream->buffer.clear();
+    }
+  }
+
+  // Reads the output left in the named pipe without blocking. Returns
+  // true if the container has terminated, i.e., the named pipe has no
+  // writers left.
+  bool drain(Stream* stream)
+  {
+    if (stream->terminated) {
+      return true;
+    }
+
+    // NOTE: A terminated container left at most `PIPE_SIZE` in the
+    // named pipe, more can only be read from a running container.
+    size_t drained = 0;
+
+    while (drained <= PIPE_SIZE.bytes()) {
+      ssize_t length =
+        os::read(stream->fd.get(), stream->data.get(), BATCH_SIZE.bytes());
+
+      if (length == 0) {
+        return true;
+      } else if (length < 0) {
+        return false; // E.g., `EAGAIN` while the container is running.
+      }
+
+      stream->buffer.append(stream->data.get(), length);
+      drained += length;
+    }
+
+    return false;
+  }
+
+  // Stops reading from the stream and removes its named pipe and state.
+  void remove(const string& id)
+  {
+    const Owned<Stream> stream = streams.at(id);
+    streams.erase(id);
+
+    os::rm(stream->fifo);
+    os::rm(stream->state);
+
+    const string directory = Path(stream->fifo).dirname();
+
+    Try<list<string>> entries = os::ls(directory);
+    if (entries.isSome() && entries->empty()) {
+      os::rmdir(directory, false);
+    }
+  }
+
+public:
+  // Stops reading from the named pipes and writes out the output which
+  // was already written to them, so that it is not lost when the agent
+  // stops, and removes the streams of the containers which have
+  // terminated. The output of running containers is read by the next
+  // agent after recovery.
+  Future<Nothing> stop()
+  {
+    stopping = true;
+
+    // NOTE: Rather than waiting for the pending reads here, they are
+    // discarded and `_stop()` is dispatched once they are done, after
+    // their output has been kept by `_read()`.
+    vector<Future<size_t>> readings;
+
+    foreachvalue (const Owned<Stream>& stream, streams) {
+      if (stream->reading.isSome()) {
+        Future<size_t> reading = stream->reading.get();
+        reading.discard();
+        readings.push_back(reading);
+      }
+    }
+
+    return await(readings)
+      .then(defer(self(), &Self::_stop));
+  }
+
+private:
+  Future<Nothing> _stop()
+  {
+    vector<string> terminated;
+    vector<Future<Nothing>> writes;
+
+    foreachpair (const string& id, const Owned<Stream>& stream, streams) {
+      if (drain(stream.get())) {
+        terminated.push_back(id);
+      }
+
+      flush(stream.get());
+
+      // NOTE: The output is written in order, so the most recent write
+      // completes after all the others.
+      writes.push_back(stream->writing);
+    }
+
+    return await(writes)
+      .then(defer(self(), [=]() {
+        foreach (const string& id, terminated) {
+          remove(id);
+        }
+
+        return Nothing();
+      }));
+  }
+
   Flags flags;
+
+  // The streams of all containers in the multiplexed mode, keyed by
+  // the path of their named pipes.
+  hashmap<string, Owned<Stream>> streams;
+
+  // Whether the streams are being stopped, see `stop()`.
+  bool stopping;
 };
 
 
@@ -262,6 +1162,10 @@ LogrotateContainerLogger::LogrotateContainerLogger(const Flags& _flags)
 
 LogrotateContainerLogger::~LogrotateContainerLogger()
 {
+  // NOTE: The stop is queued after the pending work (e.g., the
+  // recovery) so that the output read so far is written out.
+  dispatch(process.get(), &LogrotateContainerLoggerProcess::stop).await();
+
   terminate(process.get());
   wait(process.get());
 }
@@ -269,6 +1173,19 @@ LogrotateContainerLogger::~LogrotateContainerLogger()
 
 Try<Nothing> LogrotateContainerLogger::initialize()
 {
+  if (flags.multiplexed) {
+    Try<Nothing> mkdir = os::mkdir(flags.state_dir);
+    if (mkdir.isError()) {
+      return Error(
+          "Failed to create directory '" + flags.state_dir + "': " +
+          mkdir.error());
+    }
+
+    // NOTE: Containers are only prepared after the recovery, as the
+    // dispatches to the process are handled in order.
+    dispatch(process.get(), &LogrotateContainerLoggerProcess::recover);
+  }
+
   return Nothing();
 }
 
@@ -159,6 +159,24 @@ struct Flags : public virtual LoggerFlags
           return None();
         });
 
+    add(&Flags::multiplexed,
+        "multiplexed",
+        "If true, the agent reads the stdout and stderr of all containers\n"
+        "itself and writes, rotates and compresses the log files in-process,\n"
+        "instead of launching two '" + mesos::internal::logger::rotate::NAME +
+        "'\nsubprocesses per container. Of the 'logrotate' options, only\n"
+        "'rotate <count>', 'compress' and 'nocompress' are supported in\n"
+        "this mode.",
+        false);
+
+    add(&Flags::state_dir,
+        "state_dir",
+        "Directory where the agent keeps the named pipes of the containers\n"
+        "and their rotation settings when '--multiplexed' is set, so that\n"
+        "the logs of running containers are picked up again after the agent\n"
+        "restarts.",
+        "/var/run/mesos/logrotate");
+
     add(&Flags::libprocess_num_worker_threads,
         "libprocess_num_worker_threads",
         "Number of Libprocess worker threads.\n"
@@ -179,6 +197,9 @@ struct Flags : public virtual LoggerFlags
   std::string launcher_dir;
   std::string logrotate_path;
 
+  bool multiplexed;
+  std::string state_dir;
+
   size_t libprocess_num_worker_threads;
 };
 
@@ -187,6 +208,12 @@ struct Flags : public virtual LoggerFlags
 // `logrotate` utility to strictly constrain total size of a container's
 // stdout and stderr log files.  All `logrotate` configuration options
 // (besides `size`, which this module uses) are supported.  See `Flags` above.
+//
+// In the multiplexed mode (see `--multiplexed`), a container writes its
+// stdout and stderr into named pipes which are read by the module within
+// the agent, so no companion processes are launched. The module batches
+// the writes to the log files and rotates them itself. The named pipes
+// outlive the agent, so the module resumes reading them on restart.
 class LogrotateContainerLogger : public mesos::slave::ContainerLogger
 {
 public:
@@ -194,7 +221,7 @@ public:
 
   ~LogrotateContainerLogger() override;
 
-  // This is a noop. The logrotate container logger has nothing to initialize.
+  // Recovers the logs of running containers in the multiplexed mode.
   Try<Nothing> initialize() override;
 
   process::Future<mesos::slave::ContainerIO> prepare(
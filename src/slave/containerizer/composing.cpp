@@ -79,6 +79,9 @@ public:
   Future<ResourceStatistics> usage(
       const ContainerID& containerId);
 
+  Future<hashmap<ContainerID, ResourceStatistics>> usages(
+      const hashset<ContainerID>& containerIds);
+
   Future<ContainerStatus> status(
       const ContainerID& containerId);
 
@@ -212,6 +215,16 @@ Future<ResourceStatistics> ComposingContainerizer::usage(
 }
 
 
+Future<hashmap<ContainerID, ResourceStatistics>> ComposingContainerizer::usages(
+    const hashset<ContainerID>& containerIds)
+{
+  return dispatch(
+      process,
+      &ComposingContainerizerProcess::usages,
+      containerIds);
+}
+
+
 Future<ContainerStatus> ComposingContainerizer::status(
     const ContainerID& containerId)
 {
@@ -569,6 +582,46 @@ Future<ResourceStatistics> ComposingContainerizerProcess::usage(
 }
 
 
+Future<hashmap<ContainerID, ResourceStatistics>>
+ComposingContainerizerProcess::usages(const hashset<ContainerID>& containerIds)
+{
+  typedef hashmap<ContainerID, ResourceStatistics> Statistics;
+
+  // Batch the containers of each containerizer into a single call.
+  hashmap<Containerizer*, hashset<ContainerID>> batches;
+
+  foreach (const ContainerID& containerId, containerIds) {
+    if (containers_.contains(containerId)) {
+      batches[containers_.at(containerId)->containerizer].insert(containerId);
+    }
+  }
+
+  vector<Future<Statistics>> futures;
+
+  foreachpair (Containerizer* containerizer,
+               const hashset<ContainerID>& batch,
+               batches) {
+    futures.push_back(containerizer->usages(batch));
+  }
+
+  return await(futures)
+    .then([](const vector<Future<Statistics>>& statistics) {
+      Statistics result;
+
+      foreach (const Future<Statistics>& future, statistics) {
+        if (future.isReady()) {
+          result.insert(future->begin(), future->end());
+        } else {
+          LOG(WARNING) << "Failed to get resource statistics of containers: "
+                       << (future.isFailed() ? future.failure() : "discarded");
+        }
+      }
+
+      return result;
+    });
+}
+
+
 Future<ContainerStatus> ComposingContainerizerProcess::status(
     const ContainerID& containerId)
 {
@@ -70,6 +70,9 @@ public:
   process::Future<ResourceStatistics> usage(
       const ContainerID& containerId) override;
 
+  process::Future<hashmap<ContainerID, ResourceStatistics>> usages(
+      const hashset<ContainerID>& containerIds) override;
+
   process::Future<ContainerStatus> status(
       const ContainerID& containerId) override;
 
@@ -20,6 +20,7 @@
 
 #include <mesos/secret/resolver.hpp>
 
+#include <process/collect.hpp>
 #include <process/dispatch.hpp>
 #include <process/owned.hpp>
 
@@ -213,6 +214,39 @@ Try<Resources> Containerizer::resources(const Flags& flags)
 }
 
 
+Future<hashmap<ContainerID, ResourceStatistics>> Containerizer::usages(
+    const hashset<ContainerID>& containerIds)
+{
+  vector<ContainerID> containers;
+  vector<Future<ResourceStatistics>> futures;
+
+  foreach (const ContainerID& containerId, containerIds) {
+    containers.push_back(containerId);
+    futures.push_back(usage(containerId));
+  }
+
+  return await(futures)
+    .then([=](const vector<Future<ResourceStatistics>>& statistics) {
+      CHECK_EQ(containers.size(), statistics.size());
+
+      hashmap<ContainerID, ResourceStatistics> result;
+
+      for (size_t i = 0; i < containers.size(); i++) {
+        if (statistics[i].isReady()) {
+          result.put(containers[i], statistics[i].get());
+        } else {
+          VLOG(1) << "Failed to get resource statistics for container "
+                  << containers[i] << ": "
+                  << (statistics[i].isFailed() ? statistics[i].failure()
+                                               : "discarded");
+        }
+      }
+
+      return result;
+    });
+}
+
+
 Try<Containerizer*> Containerizer::create(
     const Flags& flags,
     bool local,
@@ -32,6 +32,7 @@
 #include <process/process.hpp>
 
 #include <stout/duration.hpp>
+#include <stout/hashmap.hpp>
 #include <stout/hashset.hpp>
 #include <stout/option.hpp>
 #include <stout/try.hpp>
@@ -122,6 +123,13 @@ public:
   virtual process::Future<ResourceStatistics> usage(
       const ContainerID& containerId) = 0;
 
+  // Get resource usage statistics on multiple containers at once.
+  // Containers whose statistics cannot be retrieved are left out of
+  // the result. The default implementation calls `usage()` for each
+  // container, containerizers can override it to batch the calls.
+  virtual process::Future<hashmap<ContainerID, ResourceStatistics>> usages(
+      const hashset<ContainerID>& containerIds);
+
   // Retrieve the run-time state of various isolator properties
   // associated with the container. Unlike other methods in this class
   // we are not making this pure virtual, since a `Containerizer`
@@ -29,6 +29,7 @@
 #include <stout/hashmap.hpp>
 #include <stout/hashset.hpp>
 #include <stout/net.hpp>
+#include <stout/numify.hpp>
 #include <stout/path.hpp>
 #include <stout/strings.hpp>
 #include <stout/uri.hpp>
@@ -45,8 +46,11 @@
 
 #include "hdfs/hdfs.hpp"
 
+#include "common/command_utils.hpp"
 #include "common/status_utils.hpp"
 
+#include "slave/state.hpp"
+
 #include "slave/containerizer/fetcher_process.hpp"
 
 using std::list;
@@ -73,16 +77,12 @@ namespace slave {
 
 static const string CACHE_FILE_NAME_PREFIX = "c";
 
+// NOTE: This must not contain `CACHE_FILE_NAME_PREFIX`.
+static const string CACHE_INDEX_FILE_NAME = "index";
+
 
 Fetcher::Fetcher(const Flags& flags) : process(new FetcherProcess(flags))
 {
-  if (os::exists(flags.fetcher_cache_dir)) {
-    Try<Nothing> rmdir = os::rmdir(flags.fetcher_cache_dir, true);
-    CHECK_SOME(rmdir)
-      << "Could not delete fetcher cache directory '"
-      << flags.fetcher_cache_dir << "': " + rmdir.error();
-  }
-
   spawn(process.get());
 }
 
@@ -94,6 +94,12 @@ Fetcher::Fetcher(const process::Owned<FetcherProcess>& process)
 }
 
 
+string Fetcher::getCacheIndexPath(const string& cacheDirectory)
+{
+  return path::join(cacheDirectory, CACHE_INDEX_FILE_NAME);
+}
+
+
 Fetcher::~Fetcher()
 {
   terminate(process.get());
@@ -293,6 +299,15 @@ FetcherProcess::FetcherProcess(const Flags& _flags)
       flags(_flags),
       cache(_flags.fetcher_cache_size)
 {
+  if (flags.artifact_peers.isSome()) {
+    Try<Owned<PeerFetcher>> peerFetcher = PeerFetcher::create(flags);
+    if (peerFetcher.isError()) {
+      LOG(ERROR) << "Not fetching cache files from peers: "
+                 << peerFetcher.error();
+    } else {
+      peers = peerFetcher.get();
+    }
+  }
 }
 
 
@@ -304,6 +319,63 @@ FetcherProcess::~FetcherProcess()
 }
 
 
+void FetcherProcess::initialize()
+{
+  if (!os::exists(flags.fetcher_cache_dir)) {
+    return;
+  }
+
+  const string indexPath = Fetcher::getCacheIndexPath(flags.fetcher_cache_dir);
+
+  hashset<string> recovered;
+
+  Result<FetcherCacheIndex> index = state::read<FetcherCacheIndex>(indexPath);
+  if (index.isError()) {
+    LOG(WARNING) << "Failed to read the fetcher cache index from '"
+                 << indexPath << "', clearing the cache: " << index.error();
+  } else if (index.isSome()) {
+    recovered = cache.recover(index.get());
+
+    LOG(INFO) << "Recovered " << cache.size() << " fetcher cache entries"
+              << " using " << cache.usedSpace();
+  }
+
+  // Remove all other files, e.g., partial downloads and cache files
+  // which were not checkpointed before the agent stopped.
+  Try<list<string>> files = os::find(flags.fetcher_cache_dir, "");
+  if (files.isError()) {
+    LOG(WARNING) << "Failed to list the fetcher cache directory '"
+                 << flags.fetcher_cache_dir << "': " << files.error();
+  } else {
+    foreach (const string& file, files.get()) {
+      if (file == indexPath || recovered.contains(file)) {
+        continue;
+      }
+
+      Try<Nothing> rm = os::rm(file);
+      if (rm.isError()) {
+        LOG(WARNING) << "Failed to remove '" << file << "' from the fetcher"
+                     << " cache directory: " << rm.error();
+      }
+    }
+  }
+
+  // The cache might have been configured to be smaller than before.
+  if (cache.usedSpace() > cache.totalSpace()) {
+    Try<list<shared_ptr<Cache::Entry>>> victims =
+      cache.selectVictims(cache.usedSpace() - cache.totalSpace());
+
+    CHECK_SOME(victims); // No entry is referenced yet.
+
+    foreach (const shared_ptr<Cache::Entry>& entry, victims.get()) {
+      cache.remove(entry);
+    }
+  }
+
+  checkpoint();
+}
+
+
 // Find out how large a potential download from the given URI is.
 static Try<Bytes> fetchSize(
     const string& uri,
@@ -445,12 +517,12 @@ Future<Nothing> FetcherProcess::fetch(
       newEntries.put(uri.value(), newEntry);
       newEntry->reference();
 
-      entries[uri] =
-        async([=]() {
-          return fetchSize(uri.value(), flags.frameworks_home);
-        })
+      entries[uri] = probe(uri)
         .then(defer(self(), [=](const Try<Bytes>& requestedSpace) {
           return reserveCacheSpace(requestedSpace, newEntry);
+        }))
+        .then(defer(self(), [=](const shared_ptr<Cache::Entry>& entry) {
+          return prefill(uri, entry, commandUser);
         }));
     }
   }
@@ -578,6 +650,9 @@ Future<Nothing> FetcherProcess::__fetch(
   info.mutable_stall_timeout()
     ->set_nanoseconds(flags.fetcher_stall_timeout.ns());
 
+  info.set_parallelism(flags.fetcher_parallelism);
+  info.set_link_cache_files(flags.fetcher_cache_hardlinks);
+
   return run(containerId, sandboxDirectory, user, info)
     .repair(defer(self(), [=](const Future<Nothing>& future) {
       ++metrics.task_fetches_failed;
@@ -605,6 +680,8 @@ Future<Nothing> FetcherProcess::__fetch(
     .then(defer(self(), [=]() {
       ++metrics.task_fetches_succeeded;
 
+      bool completed = false;
+
       foreachvalue (const Option<shared_ptr<Cache::Entry>>& entry, entries) {
         if (entry.isSome()) {
           entry.get()->unreference();
@@ -615,6 +692,9 @@ Future<Nothing> FetcherProcess::__fetch(
             Try<Nothing> adjust = cache.adjust(entry.get());
             if (adjust.isSome()) {
               entry.get()->complete();
+              deduplicate(entry.get());
+
+              completed = true;
             } else {
               LOG(WARNING) << "Failed to adjust the cache size for entry '"
                            << entry.get()->key << "' with error: "
@@ -629,11 +709,135 @@ Future<Nothing> FetcherProcess::__fetch(
         }
       }
 
+      if (completed) {
+        checkpoint();
+      }
+
       return Nothing();
     }));
 }
 
 
+void FetcherProcess::deduplicate(const shared_ptr<Cache::Entry>& entry)
+{
+  command::sha512(entry->path())
+    .onAny(defer(self(), &Self::_deduplicate, entry, lambda::_1));
+}
+
+
+void FetcherProcess::_deduplicate(
+    const shared_ptr<Cache::Entry>& entry,
+    const Future<string>& digest)
+{
+  // The entry might have been evicted in the meantime.
+  if (!cache.contains(entry)) {
+    return;
+  }
+
+  if (!digest.isReady()) {
+    LOG(WARNING) << "Failed to compute the digest of fetcher cache file '"
+                 << entry->path() << "': "
+                 << (digest.isFailed() ? digest.failure() : "discarded");
+    return;
+  }
+
+  Try<Nothing> deduplicate = cache.deduplicate(entry, digest.get());
+  if (deduplicate.isError()) {
+    LOG(WARNING) << "Failed to deduplicate fetcher cache entry '"
+                 << entry->key << "': " << deduplicate.error();
+  }
+
+  checkpoint();
+}
+
+
+Future<Try<Bytes>> FetcherProcess::probe(const CommandInfo::URI& uri)
+{
+  const string frameworksHome = flags.frameworks_home;
+
+  auto origin = [=]() {
+    return async([=]() { return fetchSize(uri.value(), frameworksHome); });
+  };
+
+  // The content held by peers can only be trusted if it can be
+  // verified against a digest which the task specifies.
+  if (peers.isNone() || !uri.has_digest()) {
+    return origin();
+  }
+
+  return peers.get()->size(uri.digest())
+    .then([](const Bytes& size) -> Try<Bytes> { return size; })
+    .repair(defer(self(), [=](const Future<Try<Bytes>>& future) {
+      VLOG(1) << "Fetching '" << uri.value() << "' from its origin: "
+              << (future.isFailed() ? future.failure() : "discarded");
+
+      return origin();
+    }));
+}
+
+
+Future<shared_ptr<FetcherProcess::Cache::Entry>> FetcherProcess::prefill(
+    const CommandInfo::URI& uri,
+    const shared_ptr<Cache::Entry>& entry,
+    const Option<string>& user)
+{
+  if (peers.isNone() || !uri.has_digest()) {
+    return entry;
+  }
+
+  const string path = entry->path().string();
+
+  Try<Nothing> mkdir = os::mkdir(entry->directory);
+  if (mkdir.isError()) {
+    LOG(WARNING) << "Failed to create cache directory '" << entry->directory
+                 << "': " << mkdir.error();
+    return entry;
+  }
+
+  // NOTE: The downloaded file is verified against the digest and
+  // removed if it does not match, in which case mesos-fetcher
+  // downloads the resource from its origin instead.
+  return peers.get()->fetch(uri.digest(), path)
+    .then(defer(self(), [=]() -> Future<shared_ptr<Cache::Entry>> {
+      // TODO(coffler): Fix Windows chown handling, see MESOS-8063.
+#ifndef __WINDOWS__
+      if (user.isSome()) {
+        Try<Nothing> chown = os::chown(user.get(), path, false);
+        if (chown.isError()) {
+          os::rm(path);
+          return Failure(
+              "Failed to chown '" + path + "': " + chown.error());
+        }
+      }
+#endif // __WINDOWS__
+
+      VLOG(1) << "Fetched '" << entry->key << "' from peers";
+
+      return entry;
+    }))
+    .repair(defer(
+        self(),
+        [=](const Future<shared_ptr<Cache::Entry>>& future) {
+          VLOG(1) << "Fetching '" << entry->key << "' from its origin: "
+                  << (future.isFailed() ? future.failure() : "discarded");
+
+          return entry;
+        }));
+}
+
+
+void FetcherProcess::checkpoint()
+{
+  const string path = Fetcher::getCacheIndexPath(flags.fetcher_cache_dir);
+
+  Try<Nothing> checkpoint = state::checkpoint(path, cache.index());
+  if (checkpoint.isError()) {
+    LOG(WARNING) << "Failed to checkpoint the fetcher cache index to '"
+                 << path << "': " << checkpoint.error();
+  }
+}
+
+
 static off_t delta(
     const Bytes& actualSize,
     const shared_ptr<FetcherProcess::Cache::Entry>& entry)
@@ -737,6 +941,9 @@ FetcherProcess::reserveCacheSpace(
   // Cache::remove()).
   entry->size = requestedSpace.get();
 
+  // Other entries might have been evicted.
+  checkpoint();
+
   return entry;
 }
 
@@ -998,6 +1205,14 @@ static string cacheKey(const Option<string>& user, const string& uri)
 }
 
 
+static string contentKey(const shared_ptr<FetcherProcess::Cache::Entry>& entry)
+{
+  CHECK_SOME(entry->digest);
+
+  return path::join(entry->directory, entry->digest.get());
+}
+
+
 shared_ptr<FetcherProcess::Cache::Entry> FetcherProcess::Cache::create(
     const string& cacheDirectory,
     const Option<string>& user,
@@ -1120,6 +1335,20 @@ Try<Nothing> FetcherProcess::Cache::remove(
   table.erase(entry->key);
   lruSortedEntries.remove(entry);
 
+  if (entry->digest.isSome() && contents.contains(contentKey(entry))) {
+    list<shared_ptr<Entry>>& sharers = contents.at(contentKey(entry));
+    sharers.remove(entry);
+
+    if (sharers.empty()) {
+      contents.erase(contentKey(entry));
+    } else if (entry->size > 0) {
+      // The content stays on disk as long as other entries link to it,
+      // so its space is now accounted to one of them.
+      sharers.front()->size = entry->size;
+      entry->size = 0;
+    }
+  }
+
   // We may or may not have started downloading. The download may or may
   // not have been partial. In any case, clean up whatever is there.
   if (os::exists(entry->path().string())) {
@@ -1244,6 +1473,147 @@ Try<Nothing> FetcherProcess::Cache::adjust(
 }
 
 
+Try<Nothing> FetcherProcess::Cache::deduplicate(
+    const shared_ptr<Cache::Entry>& entry,
+    const string& digest)
+{
+  CHECK(contains(entry));
+  CHECK(entry->completion().isReady());
+
+  entry->digest = digest;
+
+  list<shared_ptr<Entry>>& sharers = contents[contentKey(entry)];
+  sharers.push_back(entry);
+
+  if (sharers.size() == 1) {
+    return Nothing();
+  }
+
+#ifdef __WINDOWS__
+  // TODO(bernd-mesos): Support hard links on Windows.
+  sharers.pop_back();
+  return Nothing();
+#else
+  const string source = sharers.front()->path().string();
+  const string target = entry->path().string();
+  const string temp = target + ".link";
+
+  // The cache file is replaced atomically, so that concurrent fetches
+  // which are copying it from the cache are not affected.
+  if (::link(source.c_str(), temp.c_str()) < 0) {
+    sharers.pop_back();
+    return ErrnoError("Failed to link '" + source + "' to '" + temp + "'");
+  }
+
+  Try<Nothing> rename = os::rename(temp, target);
+  if (rename.isError()) {
+    os::rm(temp);
+    sharers.pop_back();
+    return Error(
+        "Failed to rename '" + temp + "' to '" + target + "': " +
+        rename.error());
+  }
+
+  VLOG(1) << "Deduplicated cache entry '" << entry->key
+          << "' with cache entry '" << sharers.front()->key << "'";
+
+  releaseSpace(entry->size);
+  entry->size = 0;
+
+  return Nothing();
+#endif // __WINDOWS__
+}
+
+
+hashset<string> FetcherProcess::Cache::recover(const FetcherCacheIndex& index)
+{
+  hashset<string> paths;
+
+  foreach (const FetcherCacheIndex::Entry& checkpointed, index.entries()) {
+    auto entry = shared_ptr<Cache::Entry>(new Cache::Entry(
+        checkpointed.key(),
+        checkpointed.directory(),
+        checkpointed.filename()));
+
+    const string path = entry->path().string();
+
+    Try<Bytes> size = os::stat::size(
+        path, os::stat::FollowSymlink::DO_NOT_FOLLOW_SYMLINK);
+
+    // NOTE: The checkpointed size of an entry sharing its cache file
+    // with other entries is zero.
+    if (size.isError() ||
+        (checkpointed.size() > 0 && size->bytes() != checkpointed.size())) {
+      LOG(WARNING) << "Skipping cache entry '" << entry->key
+                   << "' with missing or modified file: " << path;
+      continue;
+    }
+
+    if (table.contains(entry->key)) {
+      continue;
+    }
+
+    entry->size = size.get();
+    entry->complete();
+
+    if (checkpointed.has_digest()) {
+      entry->digest = checkpointed.digest();
+
+      // Only the first of the entries sharing a cache file holds its
+      // space, regardless of which one held it before.
+      list<shared_ptr<Entry>>& sharers = contents[contentKey(entry)];
+      if (!sharers.empty()) {
+        entry->size = 0;
+      }
+
+      sharers.push_back(entry);
+    }
+
+    claimSpace(entry->size);
+
+    table.put(entry->key, entry);
+    lruSortedEntries.push_back(entry);
+    paths.insert(path);
+
+    // New cache files must not reuse the names of recovered ones.
+    const string& filename = entry->filename;
+    Try<unsigned long> serial = numify<unsigned long>(filename.substr(
+        CACHE_FILE_NAME_PREFIX.size(),
+        filename.find('-') - CACHE_FILE_NAME_PREFIX.size()));
+
+    if (serial.isSome() && serial.get() > filenameSerial) {
+      filenameSerial = serial.get();
+    }
+  }
+
+  return paths;
+}
+
+
+FetcherCacheIndex FetcherProcess::Cache::index() const
+{
+  FetcherCacheIndex index;
+
+  foreach (const shared_ptr<Cache::Entry>& entry, lruSortedEntries) {
+    if (!entry->completion().isReady()) {
+      continue;
+    }
+
+    FetcherCacheIndex::Entry* checkpointed = index.add_entries();
+    checkpointed->set_key(entry->key);
+    checkpointed->set_directory(entry->directory);
+    checkpointed->set_filename(entry->filename);
+    checkpointed->set_size(entry->size.bytes());
+
+    if (entry->digest.isSome()) {
+      checkpointed->set_digest(entry->digest.get());
+    }
+  }
+
+  return index;
+}
+
+
 size_t FetcherProcess::Cache::size() const
 {
   return table.size();
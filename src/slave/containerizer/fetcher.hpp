@@ -73,6 +73,10 @@ public:
 
   static bool isNetUri(const std::string& uri);
 
+  // Returns the path of the index of the completed cache files in the
+  // given cache directory, see `FetcherCacheIndex`.
+  static std::string getCacheIndexPath(const std::string& cacheDirectory);
+
   Fetcher(const Flags& flags);
 
   // This is only public for tests.
@@ -25,13 +25,18 @@
 #include <mesos/type_utils.hpp>
 
 #include <process/future.hpp>
+#include <process/owned.hpp>
 #include <process/process.hpp>
 
 #include <process/metrics/counter.hpp>
 #include <process/metrics/pull_gauge.hpp>
 
 #include <stout/hashmap.hpp>
+#include <stout/hashset.hpp>
 
+#include "messages/messages.hpp"
+
+#include "slave/artifacts.hpp"
 #include "slave/flags.hpp"
 
 namespace mesos {
@@ -44,6 +49,10 @@ public:
   explicit FetcherProcess(const Flags& _flags);
   ~FetcherProcess() override;
 
+  // Recovers the cache entries from the cache index, if any, and
+  // removes all other files from the cache directory.
+  void initialize() override;
+
   process::Future<Nothing> fetch(
       const ContainerID& containerId,
       const CommandInfo& commandInfo,
@@ -122,8 +131,15 @@ public:
       // The expected size of the cache file. This field is set before
       // downloading. If the actual size of the downloaded file is
       // different a warning is logged and the field's value adjusted.
+      // If the cache file is a hard link to the file of another entry
+      // with the same content, the size is accounted to only one of
+      // them and is zero for the others.
       Bytes size;
 
+      // The SHA-512 digest of the cache file, once it is downloaded
+      // and the digest has been computed.
+      Option<std::string> digest;
+
     private:
       // Concurrent fetch attempts can reference the same entry multiple
       // times.
@@ -186,6 +202,22 @@ public:
     // sizes and adjusts the cache's total amount of space in use.
     Try<Nothing> adjust(const std::shared_ptr<Cache::Entry>& entry);
 
+    // Replaces the cache file of the entry with a hard link to the
+    // file of another entry with the same content in the same cache
+    // directory, if there is one, and releases the entry's space.
+    Try<Nothing> deduplicate(
+        const std::shared_ptr<Cache::Entry>& entry,
+        const std::string& digest);
+
+    // Adds the completed entries of a checkpointed index to the cache,
+    // skipping the ones whose cache file is missing. Returns the paths
+    // of the recovered cache files.
+    hashset<std::string> recover(const FetcherCacheIndex& index);
+
+    // Returns the index of the completed entries, sorted from LRU to
+    // MRU, for checkpointing.
+    FetcherCacheIndex index() const;
+
     // Number of entries.
     size_t size() const;
 
@@ -208,6 +240,11 @@ public:
 
     // Stores cache file entries sorted from LRU to MRU.
     std::list<std::shared_ptr<Entry>> lruSortedEntries;
+
+    // Maps the content (cache directory / digest combinations) of
+    // cache files to the entries sharing it. The first entry of each
+    // list is the one the space is accounted to.
+    hashmap<std::string, std::list<std::shared_ptr<Entry>>> contents;
   };
 
   // Public and virtual for mock testing.
@@ -221,6 +258,12 @@ public:
       const std::string& cacheDirectory,
       const Option<std::string>& user);
 
+  // Deduplicates a newly downloaded cache file once its digest has
+  // been computed. Public for testing.
+  void _deduplicate(
+      const std::shared_ptr<Cache::Entry>& entry,
+      const process::Future<std::string>& digest);
+
   // Returns a list of cache files on disk for the given slave
   // (for all users combined). For testing.
   Try<std::list<Path>> cacheFiles() const;
@@ -242,6 +285,30 @@ private:
       const std::string& cacheDirectory,
       const Option<std::string>& user);
 
+  // Computes the digest of a newly downloaded cache file and
+  // deduplicates it with the files of other entries.
+  void deduplicate(const std::shared_ptr<Cache::Entry>& entry);
+
+  // Checkpoints the index of the cache. Warns on failure.
+  void checkpoint();
+
+  // Returns the size of the resource at the given URI. If artifacts
+  // are distributed between agents and the URI specifies the digest of
+  // the resource, the size is looked up on the peers first.
+  process::Future<Try<Bytes>> probe(const CommandInfo::URI& uri);
+
+  // If artifacts are distributed between agents and the URI specifies
+  // the digest of the resource, downloads the resource from peers into
+  // the cache file of the entry, for which space has been reserved
+  // already. mesos-fetcher then only copies the cache file into the
+  // sandbox. Otherwise, or if no peer could serve the resource, the
+  // entry is returned as is and mesos-fetcher downloads the resource
+  // from its origin.
+  process::Future<std::shared_ptr<Cache::Entry>> prefill(
+      const CommandInfo::URI& uri,
+      const std::shared_ptr<Cache::Entry>& entry,
+      const Option<std::string>& user);
+
   // Calls Cache::reserve() and returns a ready entry future if successful,
   // else Failure. Claims the space and assigns the entry's size to this
   // amount if and only if successful.
@@ -269,6 +336,9 @@ private:
 
   Cache cache;
 
+  // Set if artifacts are distributed between agents.
+  Option<process::Owned<PeerFetcher>> peers;
+
   hashmap<ContainerID, pid_t> subprocessPids;
 };
 
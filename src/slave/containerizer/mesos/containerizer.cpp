@@ -99,6 +99,7 @@
 
 #include "slave/containerizer/mesos/isolators/appc/runtime.hpp"
 #include "slave/containerizer/mesos/isolators/cgroups/cgroups.hpp"
+#include "slave/containerizer/mesos/isolators/cgroups2/cgroups2.hpp"
 #include "slave/containerizer/mesos/isolators/docker/runtime.hpp"
 #include "slave/containerizer/mesos/isolators/docker/volume/isolator.hpp"
 #include "slave/containerizer/mesos/isolators/filesystem/linux.hpp"
@@ -424,6 +425,7 @@ Try<MesosContainerizer*> MesosContainerizer::create(
     {"cgroups/net_prio", &CgroupsIsolatorProcess::create},
     {"cgroups/perf_event", &CgroupsIsolatorProcess::create},
     {"cgroups/pids", &CgroupsIsolatorProcess::create},
+    {"cgroups2", &Cgroups2IsolatorProcess::create},
 
     {"appc/runtime", &AppcRuntimeIsolatorProcess::create},
     {"docker/runtime", &DockerRuntimeIsolatorProcess::create},
@@ -729,6 +731,15 @@ Future<ResourceStatistics> MesosContainerizer::usage(
 }
 
 
+Future<hashmap<ContainerID, ResourceStatistics>> MesosContainerizer::usages(
+    const hashset<ContainerID>& containerIds)
+{
+  return dispatch(process.get(),
+                  &MesosContainerizerProcess::usages,
+                  containerIds);
+}
+
+
 Future<ContainerStatus> MesosContainerizer::status(
     const ContainerID& containerId)
 {
@@ -2489,6 +2500,39 @@ Future<ResourceStatistics> MesosContainerizerProcess::usage(
 }
 
 
+Future<hashmap<ContainerID, ResourceStatistics>>
+MesosContainerizerProcess::usages(const hashset<ContainerID>& containerIds)
+{
+  vector<ContainerID> containers;
+  vector<Future<ResourceStatistics>> futures;
+
+  foreach (const ContainerID& containerId, containerIds) {
+    containers.push_back(containerId);
+    futures.push_back(usage(containerId));
+  }
+
+  return await(futures)
+    .then([=](const vector<Future<ResourceStatistics>>& statistics) {
+      CHECK_EQ(containers.size(), statistics.size());
+
+      hashmap<ContainerID, ResourceStatistics> result;
+
+      for (size_t i = 0; i < containers.size(); i++) {
+        if (statistics[i].isReady()) {
+          result.put(containers[i], statistics[i].get());
+        } else {
+          VLOG(1) << "Failed to get resource statistics for container "
+                  << containers[i] << ": "
+                  << (statistics[i].isFailed() ? statistics[i].failure()
+                                               : "discarded");
+        }
+      }
+
+      return result;
+    });
+}
+
+
 Future<ContainerStatus> MesosContainerizerProcess::status(
     const ContainerID& containerId)
 {
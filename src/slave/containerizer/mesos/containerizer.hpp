@@ -105,6 +105,9 @@ public:
   process::Future<ResourceStatistics> usage(
       const ContainerID& containerId) override;
 
+  process::Future<hashmap<ContainerID, ResourceStatistics>> usages(
+      const hashset<ContainerID>& containerIds) override;
+
   process::Future<ContainerStatus> status(
       const ContainerID& containerId) override;
 
@@ -199,6 +202,11 @@ public:
   virtual process::Future<ResourceStatistics> usage(
       const ContainerID& containerId);
 
+  // Gets the statistics of all the containers within a single dispatch
+  // to this process, rather than one dispatch per container.
+  virtual process::Future<hashmap<ContainerID, ResourceStatistics>> usages(
+      const hashset<ContainerID>& containerIds);
+
   virtual process::Future<ContainerStatus> status(
       const ContainerID& containerId);
 
@@ -14,11 +14,15 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <sys/stat.h>
+
 #include <list>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -515,6 +519,8 @@ Future<Option<ContainerLaunchInfo>> IOSwitchboard::_prepare(
   switchboardFlags.stdout_to_fd = STDOUT_FILENO;
   switchboardFlags.stderr_to_fd = STDERR_FILENO;
   switchboardFlags.heartbeat_interval = flags.http_heartbeat_interval;
+  switchboardFlags.statistics_path =
+    getContainerIOSwitchboardStatisticsPath(flags.runtime_dir, containerId);
 
   if (containerConfig.container_class() == ContainerClass::DEBUG) {
     switchboardFlags.wait_for_connection = true;
@@ -763,6 +769,39 @@ Future<ContainerLimitation> IOSwitchboard::watch(
 }
 
 
+Future<ResourceStatistics> IOSwitchboard::usage(
+    const ContainerID& containerId)
+{
+  ResourceStatistics result;
+
+#ifndef __WINDOWS__
+  if (local || !infos.contains(containerId)) {
+    return result;
+  }
+
+  const string path =
+    getContainerIOSwitchboardStatisticsPath(flags.runtime_dir, containerId);
+
+  // NOTE: The statistics are missing until the server has checkpointed
+  // them for the first time, and for servers launched by older agents.
+  Result<IOSwitchboardStatistics> statistics =
+    slave::state::read<IOSwitchboardStatistics>(path);
+
+  if (statistics.isError()) {
+    return Failure(
+        "Failed to read the io switchboard statistics from '" + path + "': " +
+        statistics.error());
+  }
+
+  if (statistics.isSome()) {
+    result.mutable_io_switchboard_statistics()->CopyFrom(statistics.get());
+  }
+#endif // __WINDOWS__
+
+  return result;
+}
+
+
 Future<Nothing> IOSwitchboard::cleanup(
     const ContainerID& containerId)
 {
@@ -956,6 +995,20 @@ void IOSwitchboard::reaped(
 const char IOSwitchboardServer::NAME[] = "mesos-io-switchboard";
 
 
+// The maximum number of bytes moved at once from the stdout or stderr
+// of a container.
+constexpr size_t TRANSFER_SIZE = 64 * 1024;
+
+
+// Data is sent to the output connections once this many bytes are
+// buffered, or after `OUTPUT_BATCH_INTERVAL` at the latest.
+constexpr size_t OUTPUT_BATCH_SIZE = 64 * 1024;
+constexpr Duration OUTPUT_BATCH_INTERVAL = Milliseconds(10);
+
+
+constexpr Duration STATISTICS_CHECKPOINT_INTERVAL = Seconds(1);
+
+
 class IOSwitchboardServerProcess : public Process<IOSwitchboardServerProcess>
 {
 public:
@@ -968,7 +1021,8 @@ public:
       int _stderrToFd,
       const unix::Socket& _socket,
       bool waitForConnection,
-      Option<Duration> heartbeatInterval);
+      Option<Duration> heartbeatInterval,
+      const Option<string>& statisticsPath);
 
   void finalize() override;
 
@@ -991,6 +1045,17 @@ private:
       return writer.write(encoder.encode(message));
     }
 
+    // Sends the messages with a single write to the pipe.
+    bool send(const vector<agent::ProcessIO>& messages)
+    {
+      string records;
+      foreach (const agent::ProcessIO& message, messages) {
+        records += encoder.encode(message);
+      }
+
+      return writer.write(std::move(records));
+    }
+
     bool close()
     {
       return writer.close();
@@ -1038,12 +1103,39 @@ private:
       ContentType acceptType,
       Option<ContentType> messageAcceptType);
 
+  // Moves the data read from `from` to `to` until `from` reaches EOF,
+  // and passes a copy of it to `outputHook` while there are output
+  // connections. On Linux, the data is moved with `splice` (or `tee`
+  // if there are output connections) without copying it through user
+  // space, if the file descriptors support it.
+  Future<Nothing> transfer(
+      int_fd from,
+      int_fd to,
+      const agent::ProcessIO::Data::Type& type);
+
   // Asynchronously receive data as we read it from our
-  // `stdoutFromFd` and `stderrFromFd` file descriptors.
+  // `stdoutFromFd` and `stderrFromFd` file descriptors. The data is
+  // buffered for a short while so that it is sent to the output
+  // connections in batches.
   void outputHook(
       const string& data,
       const agent::ProcessIO::Data::Type& type);
 
+  // Sends the buffered data to all output connections.
+  void flushOutput();
+
+  // Accounts `bytes` of data moved from the container's stdout or
+  // stderr in `statistics`.
+  void account(
+      const agent::ProcessIO::Data::Type& type,
+      size_t bytes,
+      bool zeroCopy);
+
+  // Periodically checkpoints `statistics` to `statisticsPath`.
+  void statisticsLoop();
+
+  void checkpointStatistics();
+
   bool tty;
   int stdinToFd;
   int stdoutFromFd;
@@ -1053,6 +1145,7 @@ private:
   unix::Socket socket;
   bool waitForConnection;
   Option<Duration> heartbeatInterval;
+  Option<string> statisticsPath;
   bool inputConnected;
   // Each time the agent receives a response for `ATTACH_CONTAINER_INPUT`
   // request it sends an acknowledgment. This counter is used to delay
@@ -1066,6 +1159,13 @@ private:
   // The following must be a `std::list`
   // for proper erase semantics later on.
   list<HttpConnection> outputConnections;
+  // Data which has not been sent to the output connections yet,
+  // with consecutive data of the same type coalesced into a record.
+  vector<agent::ProcessIO> pendingOutput;
+  size_t pendingOutputBytes;
+  bool flushScheduled;
+  IOSwitchboardStatistics statistics;
+  bool statisticsChanged;
   Option<Failure> failure;
 };
 
@@ -1079,7 +1179,8 @@ Try<Owned<IOSwitchboardServer>> IOSwitchboardServer::create(
     int stderrToFd,
     const string& socketPath,
     bool waitForConnection,
-    Option<Duration> heartbeatInterval)
+    Option<Duration> heartbeatInterval,
+    const Option<string>& statisticsPath)
 {
   Try<unix::Socket> socket = unix::Socket::create(SocketImpl::Kind::POLL);
   if (socket.isError()) {
@@ -1126,7 +1227,8 @@ Try<Owned<IOSwitchboardServer>> IOSwitchboardServer::create(
       stderrToFd,
       socket.get(),
       waitForConnection,
-      heartbeatInterval);
+      heartbeatInterval,
+      statisticsPath);
 }
 
 
@@ -1139,7 +1241,8 @@ IOSwitchboardServer::IOSwitchboardServer(
     int stderrToFd,
     const unix::Socket& socket,
     bool waitForConnection,
-    Option<Duration> heartbeatInterval)
+    Option<Duration> heartbeatInterval,
+    const Option<string>& statisticsPath)
   : process(new IOSwitchboardServerProcess(
         tty,
         stdinToFd,
@@ -1149,7 +1252,8 @@ IOSwitchboardServer::IOSwitchboardServer(
         stderrToFd,
         socket,
         waitForConnection,
-        heartbeatInterval))
+        heartbeatInterval,
+        statisticsPath))
 {
   spawn(process.get());
 }
@@ -1183,7 +1287,8 @@ IOSwitchboardServerProcess::IOSwitchboardServerProcess(
     int _stderrToFd,
     const unix::Socket& _socket,
     bool _waitForConnection,
-    Option<Duration> _heartbeatInterval)
+    Option<Duration> _heartbeatInterval,
+    const Option<string>& _statisticsPath)
   : tty(_tty),
     stdinToFd(_stdinToFd),
     stdoutFromFd(_stdoutFromFd),
@@ -1193,8 +1298,12 @@ IOSwitchboardServerProcess::IOSwitchboardServerProcess(
     socket(_socket),
     waitForConnection(_waitForConnection),
     heartbeatInterval(_heartbeatInterval),
+    statisticsPath(_statisticsPath),
     inputConnected(false),
-    numPendingAcknowledgments(0) {}
+    numPendingAcknowledgments(0),
+    pendingOutputBytes(0),
+    flushScheduled(false),
+    statisticsChanged(false) {}
 
 
 Future<Nothing> IOSwitchboardServerProcess::run()
@@ -1205,14 +1314,8 @@ Future<Nothing> IOSwitchboardServerProcess::run()
 
   startRedirect.future()
     .then(defer(self(), [this]() {
-      Future<Nothing> stdoutRedirect = process::io::redirect(
-          stdoutFromFd,
-          stdoutToFd,
-          process::io::BUFFERED_READ_SIZE,
-          {defer(self(),
-                 &Self::outputHook,
-                 lambda::_1,
-                 agent::ProcessIO::Data::STDOUT)});
+      Future<Nothing> stdoutRedirect =
+        transfer(stdoutFromFd, stdoutToFd, agent::ProcessIO::Data::STDOUT);
 
       // NOTE: We don't need to redirect stderr if TTY is enabled. If
       // TTY is enabled for the container, stdout and stderr for the
@@ -1223,14 +1326,8 @@ Future<Nothing> IOSwitchboardServerProcess::run()
       if (tty) {
         stderrRedirect = Nothing();
       } else {
-        stderrRedirect = process::io::redirect(
-            stderrFromFd,
-            stderrToFd,
-            process::io::BUFFERED_READ_SIZE,
-            {defer(self(),
-                   &Self::outputHook,
-                   lambda::_1,
-                   agent::ProcessIO::Data::STDERR)});
+        stderrRedirect =
+          transfer(stderrFromFd, stderrToFd, agent::ProcessIO::Data::STDERR);
       }
 
       // Set the future once our IO redirects finish. On failure,
@@ -1304,6 +1401,10 @@ Future<Nothing> IOSwitchboardServerProcess::run()
     heartbeatLoop();
   }
 
+  if (statisticsPath.isSome()) {
+    statisticsLoop();
+  }
+
   acceptLoop();
 
   return promise.future();
@@ -1323,6 +1424,12 @@ void IOSwitchboardServerProcess::finalize()
   // maintain a reference to the socket, which would cause a leak.
   accept.discard();
 
+  flushOutput();
+
+  if (statisticsPath.isSome()) {
+    checkpointStatistics();
+  }
+
   foreach (HttpConnection& connection, outputConnections) {
     connection.close();
 
@@ -1823,6 +1930,10 @@ Future<http::Response> IOSwitchboardServerProcess::attachContainerOutput(
   // calls to `receiveOutput()` to actually push data out over the
   // connection. If we ever detect a connection has been closed,
   // we remove it from this list.
+  // Send the buffered data to the existing connections first, so that
+  // the new connection only receives data read after it attached.
+  flushOutput();
+
   HttpConnection connection(pipe.writer(), messageContentType);
   auto iterator = outputConnections.insert(outputConnections.end(), connection);
 
@@ -1847,6 +1958,185 @@ Future<http::Response> IOSwitchboardServerProcess::attachContainerOutput(
 }
 
 
+Future<Nothing> IOSwitchboardServerProcess::transfer(
+    int_fd from,
+    int_fd to,
+    const agent::ProcessIO::Data::Type& type)
+{
+  // Duplicate the file descriptors so that we're in control of their
+  // lifetime, as `process::io::redirect` does.
+  Try<int_fd> dup = os::dup(from);
+  if (dup.isError()) {
+    return Failure("Failed to duplicate 'from': " + dup.error());
+  }
+
+  from = dup.get();
+
+  dup = os::dup(to);
+  if (dup.isError()) {
+    os::close(from);
+    return Failure("Failed to duplicate 'to': " + dup.error());
+  }
+
+  to = dup.get();
+
+  Try<Nothing> prepare = os::cloexec(from);
+
+  if (prepare.isSome()) {
+    prepare = os::cloexec(to);
+  }
+
+  if (prepare.isSome()) {
+    prepare = os::nonblock(from);
+  }
+
+  if (prepare.isSome()) {
+    prepare = os::nonblock(to);
+  }
+
+  if (prepare.isError()) {
+    os::close(from);
+    os::close(to);
+    return Failure("Failed to prepare file descriptors: " + prepare.error());
+  }
+
+  struct State
+  {
+    // Whether `splice` and `tee` can be used for the file descriptors.
+    // This is determined by the first attempt to use them.
+    bool zeroCopy = false;
+
+    // `tee` can only be used if `to` is a pipe.
+    bool pipe = false;
+
+    // Whether `to` can be full, i.e., it is a pipe or a socket. Other
+    // files, e.g., regular files, are never waited for.
+    bool pollTo = false;
+
+    // Whether to wait for `to` to become writable, rather than for
+    // `from` to become readable.
+    bool blocked = false;
+
+    std::unique_ptr<char[]> data;
+  };
+
+  std::shared_ptr<State> state(new State());
+  state->data.reset(new char[TRANSFER_SIZE]);
+
+  struct stat s;
+  if (::fstat(to, &s) == 0) {
+    state->pipe = S_ISFIFO(s.st_mode);
+    state->pollTo = S_ISFIFO(s.st_mode) || S_ISSOCK(s.st_mode);
+  }
+
+#ifdef __linux__
+  state->zeroCopy = true;
+#endif // __linux__
+
+  return loop(
+      self(),
+      [=]() {
+        return state->blocked
+          ? process::io::poll(to, process::io::WRITE)
+          : process::io::poll(from, process::io::READ);
+      },
+      [=](short) -> Future<ControlFlow<Nothing>> {
+#ifdef __linux__
+        // The data only needs to be copied through user space if it
+        // is sent to output connections. Even then `tee` avoids the
+        // copy for `to` if it is a pipe.
+        if (state->zeroCopy && (outputConnections.empty() || state->pipe)) {
+          const bool tee = !outputConnections.empty();
+
+          ssize_t length = tee
+            ? ::tee(from, to, TRANSFER_SIZE, SPLICE_F_NONBLOCK)
+            : ::splice(
+                  from,
+                  nullptr,
+                  to,
+                  nullptr,
+                  TRANSFER_SIZE,
+                  SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+
+          if (length < 0) {
+            if (errno == EINTR) {
+              return Continue();
+            } else if (errno == EAGAIN) {
+              // Either `from` is empty or `to` is full, so we
+              // alternate between waiting for either of them. Only
+              // pipes and sockets can be full.
+              state->blocked = state->pollTo && !state->blocked;
+              return Continue();
+            } else if (errno == EINVAL) {
+              // The file descriptors can not be spliced, e.g., `from`
+              // is a pseudo terminal or `to` is in append mode.
+              VLOG(1) << "Falling back to copying the "
+                      << agent::ProcessIO::Data::Type_Name(type)
+                      << " of the container";
+
+              state->zeroCopy = false;
+              return Continue();
+            }
+
+            return Failure(ErrnoError(tee ? "tee" : "splice").message);
+          }
+
+          state->blocked = false;
+
+          if (length == 0) { // EOF.
+            return Break();
+          }
+
+          if (tee) {
+            // `tee` does not consume the data from `from`, so we read
+            // the same data once more for the output connections.
+            ssize_t read = ::read(from, state->data.get(), length);
+            if (read != length) {
+              return Failure(
+                  read < 0 ? ErrnoError("read").message
+                           : "Short read of duplicated data");
+            }
+
+            outputHook(string(state->data.get(), length), type);
+          }
+
+          account(type, length, true);
+          return Continue();
+        }
+#endif // __linux__
+
+        state->blocked = false;
+
+        ssize_t length = ::read(from, state->data.get(), TRANSFER_SIZE);
+        if (length < 0) {
+          if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK) {
+            return Continue();
+          }
+
+          return Failure(ErrnoError("read").message);
+        }
+
+        if (length == 0) { // EOF.
+          return Break();
+        }
+
+        const string data(state->data.get(), length);
+
+        outputHook(data, type);
+        account(type, length, false);
+
+        return process::io::write(to, data)
+          .then([]() -> Future<ControlFlow<Nothing>> {
+            return Continue();
+          });
+      })
+    .onAny([from, to]() {
+      os::close(from);
+      os::close(to);
+    });
+}
+
+
 void IOSwitchboardServerProcess::outputHook(
     const string& data,
     const agent::ProcessIO::Data::Type& type)
@@ -1856,13 +2146,40 @@ void IOSwitchboardServerProcess::outputHook(
     return;
   }
 
-  // Build a `ProcessIO` message from the data.
-  agent::ProcessIO message;
-  message.set_type(agent::ProcessIO::DATA);
-  message.mutable_data()->set_type(type);
-  message.mutable_data()->set_data(data);
+  // Append the data to the last buffered `ProcessIO` message if it is
+  // of the same type, so that fewer records are sent.
+  if (!pendingOutput.empty() &&
+      pendingOutput.back().data().type() == type) {
+    pendingOutput.back().mutable_data()->mutable_data()->append(data);
+  } else {
+    agent::ProcessIO message;
+    message.set_type(agent::ProcessIO::DATA);
+    message.mutable_data()->set_type(type);
+    message.mutable_data()->set_data(data);
 
-  // Walk through our list of connections and write the message to
+    pendingOutput.push_back(std::move(message));
+  }
+
+  pendingOutputBytes += data.size();
+
+  if (pendingOutputBytes >= OUTPUT_BATCH_SIZE) {
+    flushOutput();
+  } else if (!flushScheduled) {
+    flushScheduled = true;
+    delay(OUTPUT_BATCH_INTERVAL, self(), &Self::flushOutput);
+  }
+}
+
+
+void IOSwitchboardServerProcess::flushOutput()
+{
+  flushScheduled = false;
+
+  if (pendingOutput.empty()) {
+    return;
+  }
+
+  // Walk through our list of connections and write the messages to
   // them. It's possible that a write might fail if the writer has
   // been closed. That's OK because we already take care of removing
   // closed connections from our list via the future returned by
@@ -1870,8 +2187,66 @@ void IOSwitchboardServerProcess::outputHook(
   // unnecessary writes if we have a bunch of messages queued up,
   // but that shouldn't be a problem.
   foreach (HttpConnection& connection, outputConnections) {
-    connection.send(message);
+    connection.send(pendingOutput);
   }
+
+  statistics.set_output_records(
+      statistics.output_records() + pendingOutput.size());
+  statistics.set_output_batches(statistics.output_batches() + 1);
+  statisticsChanged = true;
+
+  pendingOutput.clear();
+  pendingOutputBytes = 0;
+}
+
+
+void IOSwitchboardServerProcess::account(
+    const agent::ProcessIO::Data::Type& type,
+    size_t bytes,
+    bool zeroCopy)
+{
+  if (type == agent::ProcessIO::Data::STDERR) {
+    statistics.set_stderr_bytes(statistics.stderr_bytes() + bytes);
+  } else {
+    statistics.set_stdout_bytes(statistics.stdout_bytes() + bytes);
+  }
+
+  if (zeroCopy) {
+    statistics.set_zero_copy_bytes(statistics.zero_copy_bytes() + bytes);
+  }
+
+  statisticsChanged = true;
+}
+
+
+void IOSwitchboardServerProcess::statisticsLoop()
+{
+  checkpointStatistics();
+
+  delay(STATISTICS_CHECKPOINT_INTERVAL,
+        self(),
+        &IOSwitchboardServerProcess::statisticsLoop);
+}
+
+
+void IOSwitchboardServerProcess::checkpointStatistics()
+{
+  CHECK_SOME(statisticsPath);
+
+  if (!statisticsChanged && os::exists(statisticsPath.get())) {
+    return;
+  }
+
+  Try<Nothing> checkpoint = slave::state::checkpoint(
+      statisticsPath.get(), statistics, false, false);
+
+  if (checkpoint.isError()) {
+    LOG(WARNING) << "Failed to checkpoint statistics to '"
+                 << statisticsPath.get() << "': " << checkpoint.error();
+    return;
+  }
+
+  statisticsChanged = false;
 }
 #endif // __WINDOWS__
 
@@ -73,6 +73,11 @@ public:
   process::Future<mesos::slave::ContainerLimitation> watch(
     const ContainerID& containerId) override;
 
+  // Returns the statistics of the container's io switchboard server,
+  // as last checkpointed by the server.
+  process::Future<ResourceStatistics> usage(
+      const ContainerID& containerId) override;
+
   process::Future<Nothing> cleanup(
       const ContainerID& containerId) override;
 
@@ -220,6 +225,11 @@ public:
           "heartbeat_interval",
           "A heartbeat interval (e.g. '5secs', '10mins') for messages to\n"
           "be sent to any open 'ATTACH_CONTAINER_OUTPUT' connections.");
+
+      add(&Flags::statistics_path,
+          "statistics_path",
+          "If set, the path of the file where the server periodically\n"
+          "checkpoints the statistics of the data it has redirected.");
     }
 
     bool tty;
@@ -231,6 +241,7 @@ public:
     Option<std::string> socket_path;
     bool wait_for_connection;
     Option<Duration> heartbeat_interval;
+    Option<std::string> statistics_path;
   };
 
   static const char NAME[];
@@ -244,7 +255,8 @@ public:
       int stderrToFd,
       const std::string& socketPath,
       bool waitForConnection = false,
-      Option<Duration> heartbeatInterval = None());
+      Option<Duration> heartbeatInterval = None(),
+      const Option<std::string>& statisticsPath = None());
 
   ~IOSwitchboardServer();
 
@@ -265,7 +277,8 @@ private:
       int stderrToFd,
       const process::network::unix::Socket& socket,
       bool waitForConnection,
-      Option<Duration> heartbeatInterval);
+      Option<Duration> heartbeatInterval,
+      const Option<std::string>& statisticsPath);
 
   process::Owned<IOSwitchboardServerProcess> process;
 };
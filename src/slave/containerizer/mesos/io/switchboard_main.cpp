@@ -125,7 +125,8 @@ int main(int argc, char** argv)
       flags.stderr_to_fd.get(),
       flags.socket_path.get(),
       flags.wait_for_connection,
-      flags.heartbeat_interval);
+      flags.heartbeat_interval,
+      flags.statistics_path);
 
   if (server.isError()) {
     EXIT(EXIT_FAILURE) << "Failed to create the io switchboard server:"
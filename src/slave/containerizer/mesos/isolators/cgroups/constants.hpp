@@ -33,6 +33,14 @@ const uint64_t MIN_CPU_SHARES = 2; // Linux constant.
 const Duration CPU_CFS_PERIOD = Milliseconds(100); // Linux default.
 const Duration MIN_CPU_CFS_QUOTA = Milliseconds(1);
 
+// The cgroups v2 `cpu.weight` range is [1, 10000] with a default of
+// 100, i.e., the default `cpu.weight` of a cgroup corresponds to the
+// default `cpu.shares` (1024) of cgroups v1.
+const uint64_t CPU_WEIGHT_PER_CPU = 100;
+const uint64_t CPU_WEIGHT_PER_CPU_REVOCABLE = 1;
+const uint64_t MIN_CPU_WEIGHT = 1; // Linux constant.
+const uint64_t MAX_CPU_WEIGHT = 10000; // Linux constant.
+
 
 // Memory subsystem constants.
 const Bytes MIN_MEMORY = Megabytes(32);
@@ -21,6 +21,7 @@
 
 #include <stout/duration.hpp>
 #include <stout/error.hpp>
+#include <stout/path.hpp>
 
 #include "linux/perf.hpp"
 
@@ -51,6 +52,26 @@ Try<Owned<SubsystemProcess>> PerfEventSubsystemProcess::create(
         new PerfEventSubsystemProcess(flags, hierarchy, set<string>{}));
   }
 
+  set<string> events;
+  foreach (const string& event,
+           strings::tokenize(flags.perf_events.get(), ",")) {
+    events.insert(event);
+  }
+
+  // The counters are opened by the agent itself, hence neither the
+  // `perf` binary nor the sampling duration and interval are needed.
+  if (flags.perf_counters) {
+    if (!perf::Counters::valid(events)) {
+      return Error("Invalid perf events for counting: " + stringify(events));
+    }
+
+    LOG(INFO) << "perf_event subsystem will count events: "
+              << stringify(events);
+
+    return Owned<SubsystemProcess>(
+        new PerfEventSubsystemProcess(flags, hierarchy, events));
+  }
+
   if (!perf::supported()) {
     return Error("Perf is not supported");
   }
@@ -61,12 +82,6 @@ Try<Owned<SubsystemProcess>> PerfEventSubsystemProcess::create(
         "interval (" + stringify(flags.perf_interval) + ") is not supported.");
   }
 
-  set<string> events;
-  foreach (const string& event,
-           strings::tokenize(flags.perf_events.get(), ",")) {
-    events.insert(event);
-  }
-
   if (!perf::valid(events)) {
     return Error("Invalid perf events: " + stringify(events));
   }
@@ -93,7 +108,7 @@ PerfEventSubsystemProcess::PerfEventSubsystemProcess(
 void PerfEventSubsystemProcess::initialize()
 {
   // Start sampling.
-  if (!events.empty()) {
+  if (!events.empty() && !flags.perf_counters) {
     sample();
   }
 }
@@ -109,6 +124,14 @@ Future<Nothing> PerfEventSubsystemProcess::recover(
 
   infos.put(containerId, Owned<Info>(new Info(cgroup)));
 
+  // The counts restart from zero after the agent restarts, which is
+  // reflected in the `timestamp` of the statistics.
+  Try<Nothing> open = this->open(containerId);
+  if (open.isError()) {
+    LOG(WARNING) << "Failed to open perf counters for container "
+                 << containerId << ": " << open.error();
+  }
+
   return Nothing();
 }
 
@@ -123,6 +146,13 @@ Future<Nothing> PerfEventSubsystemProcess::prepare(
 
   infos.put(containerId, Owned<Info>(new Info(cgroup)));
 
+  Try<Nothing> open = this->open(containerId);
+  if (open.isError()) {
+    infos.erase(containerId);
+
+    return Failure("Failed to open perf counters: " + open.error());
+  }
+
   return Nothing();
 }
 
@@ -137,8 +167,19 @@ Future<ResourceStatistics> PerfEventSubsystemProcess::usage(
         ": Unknown container");
   }
 
+  const Owned<Info>& info = infos[containerId];
+
+  if (info->counters.isSome()) {
+    Try<PerfStatistics> counts = info->counters.get()->read();
+    if (counts.isError()) {
+      return Failure("Failed to read perf counters: " + counts.error());
+    }
+
+    info->statistics = counts.get();
+  }
+
   ResourceStatistics statistics;
-  statistics.mutable_perf()->CopyFrom(infos[containerId]->statistics);
+  statistics.mutable_perf()->CopyFrom(info->statistics);
 
   return statistics;
 }
@@ -161,6 +202,29 @@ Future<Nothing> PerfEventSubsystemProcess::cleanup(
 }
 
 
+Try<Nothing> PerfEventSubsystemProcess::open(const ContainerID& containerId)
+{
+  CHECK(infos.contains(containerId));
+
+  if (!flags.perf_counters || events.empty()) {
+    return Nothing();
+  }
+
+  const Owned<Info>& info = infos[containerId];
+
+  Try<Owned<perf::Counters>> counters =
+    perf::Counters::open(events, path::join(hierarchy, info->cgroup));
+
+  if (counters.isError()) {
+    return Error(counters.error());
+  }
+
+  info->counters = counters.get();
+
+  return Nothing();
+}
+
+
 void PerfEventSubsystemProcess::sample()
 {
   // Collect a perf sample for all cgroups that are not being
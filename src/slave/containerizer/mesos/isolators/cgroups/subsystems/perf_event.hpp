@@ -28,6 +28,9 @@
 #include <process/time.hpp>
 
 #include <stout/hashmap.hpp>
+#include <stout/option.hpp>
+
+#include "linux/perf.hpp"
 
 #include "slave/flags.hpp"
 
@@ -95,8 +98,14 @@ private:
 
     const std::string cgroup;
     PerfStatistics statistics;
+
+    // Only used with `--perf_counters`.
+    Option<process::Owned<perf::Counters>> counters;
   };
 
+  // Opens the counters for the container if `--perf_counters` is set.
+  Try<Nothing> open(const ContainerID& containerId);
+
   void sample();
 
   void _sample(
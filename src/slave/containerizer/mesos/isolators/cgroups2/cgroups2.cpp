@@ -0,0 +1,696 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "slave/containerizer/mesos/isolators/cgroups2/cgroups2.hpp"
+
+#include <algorithm>
+#include <list>
+#include <set>
+
+#include <process/after.hpp>
+#include <process/clock.hpp>
+#include <process/collect.hpp>
+#include <process/defer.hpp>
+#include <process/id.hpp>
+#include <process/loop.hpp>
+#include <process/pid.hpp>
+
+#include <stout/bytes.hpp>
+#include <stout/error.hpp>
+#include <stout/foreach.hpp>
+#include <stout/numify.hpp>
+#include <stout/os.hpp>
+#include <stout/path.hpp>
+#include <stout/stringify.hpp>
+#include <stout/strings.hpp>
+
+#include "common/protobuf_utils.hpp"
+
+#include "linux/cgroups2.hpp"
+
+#include "slave/containerizer/mesos/isolators/cgroups/constants.hpp"
+
+using mesos::slave::ContainerConfig;
+using mesos::slave::ContainerLaunchInfo;
+using mesos::slave::ContainerState;
+using mesos::slave::Isolator;
+
+using process::await;
+using process::Break;
+using process::Clock;
+using process::Continue;
+using process::ControlFlow;
+using process::Failure;
+using process::Future;
+using process::Owned;
+using process::PID;
+using process::Time;
+
+using std::set;
+using std::string;
+using std::vector;
+
+namespace mesos {
+namespace internal {
+namespace slave {
+
+// The controllers managed by this isolator.
+static const set<string> CONTROLLERS = {"cpu", "memory", "io"};
+
+// How often to check whether the processes of a killed container
+// have exited, i.e., whether its cgroup can be removed.
+static const Duration CGROUP_KILL_INTERVAL = Milliseconds(10);
+
+
+static void setPressure(
+    const cgroups2::pressure::Pressure& pressure,
+    PressureStatistics* statistics)
+{
+  auto set = [](
+      const cgroups2::pressure::Stall& stall,
+      PressureStatistics::Stall* stallStatistics) {
+    stallStatistics->set_avg10(stall.avg10);
+    stallStatistics->set_avg60(stall.avg60);
+    stallStatistics->set_avg300(stall.avg300);
+    stallStatistics->set_total_microsecs(
+        static_cast<uint64_t>(stall.total.us()));
+  };
+
+  set(pressure.some, statistics->mutable_some());
+
+  if (pressure.full.isSome()) {
+    set(pressure.full.get(), statistics->mutable_full());
+  }
+}
+
+
+Cgroups2IsolatorProcess::Cgroups2IsolatorProcess(
+    const Flags& _flags,
+    const string& _root)
+  : ProcessBase(process::ID::generate("cgroups2-isolator")),
+    flags(_flags),
+    root(_root) {}
+
+
+Cgroups2IsolatorProcess::~Cgroups2IsolatorProcess() {}
+
+
+Try<Isolator*> Cgroups2IsolatorProcess::create(const Flags& flags)
+{
+  foreach (const string& isolator, strings::tokenize(flags.isolation, ",")) {
+    if (isolator == "cgroups" ||
+        strings::startsWith(isolator, "cgroups/")) {
+      return Error(
+          "The 'cgroups2' isolator can not be used together with the "
+          "'" + isolator + "' isolator");
+    }
+  }
+
+  if (!cgroups2::enabled()) {
+    return Error("cgroups v2 is not supported by the kernel");
+  }
+
+  const string root = cgroups2::ROOT;
+
+  Try<bool> mounted = cgroups2::mounted(root);
+  if (mounted.isError()) {
+    return Error(
+        "Failed to determine whether the cgroups v2 hierarchy is mounted: " +
+        mounted.error());
+  } else if (!mounted.get()) {
+    return Error("The cgroups v2 hierarchy is not mounted at '" + root + "'");
+  }
+
+  Try<set<string>> available = cgroups2::controllers(root, "");
+  if (available.isError()) {
+    return Error(
+        "Failed to determine the available controllers: " +
+        available.error());
+  }
+
+  foreach (const string& controller, CONTROLLERS) {
+    if (available->count(controller) == 0) {
+      return Error(
+          "The '" + controller + "' controller is not available in the "
+          "cgroups v2 hierarchy at '" + root + "'");
+    }
+  }
+
+  // Containers are created as children of `flags.cgroups_root`, hence
+  // the controllers need to be enabled for the children of both the
+  // root and `flags.cgroups_root`. Note that because of the "no
+  // internal process" constraint of cgroups v2, the agent itself must
+  // not be placed into `flags.cgroups_root`.
+  Try<Nothing> enable = cgroups2::enable(root, "", CONTROLLERS);
+  if (enable.isError()) {
+    return Error(
+        "Failed to enable controllers in '" + root + "': " + enable.error());
+  }
+
+  if (!cgroups2::exists(root, flags.cgroups_root)) {
+    Try<Nothing> create = cgroups2::create(root, flags.cgroups_root);
+    if (create.isError()) {
+      return Error(
+          "Failed to create cgroup '" + flags.cgroups_root + "': " +
+          create.error());
+    }
+  }
+
+  enable = cgroups2::enable(root, flags.cgroups_root, CONTROLLERS);
+  if (enable.isError()) {
+    return Error(
+        "Failed to enable controllers in '" +
+        path::join(root, flags.cgroups_root) + "': " + enable.error());
+  }
+
+  Owned<MesosIsolatorProcess> process(
+      new Cgroups2IsolatorProcess(flags, root));
+
+  return new MesosIsolator(process);
+}
+
+
+bool Cgroups2IsolatorProcess::supportsNesting()
+{
+  return true;
+}
+
+
+bool Cgroups2IsolatorProcess::supportsStandalone()
+{
+  return true;
+}
+
+
+Future<Nothing> Cgroups2IsolatorProcess::recover(
+    const vector<ContainerState>& states,
+    const hashset<ContainerID>& orphans)
+{
+  foreach (const ContainerState& state, states) {
+    // Only top-level containers have cgroups created for them.
+    if (state.container_id().has_parent()) {
+      continue;
+    }
+
+    const ContainerID& containerId = state.container_id();
+    const string cgroup = path::join(flags.cgroups_root, containerId.value());
+
+    if (!cgroups2::exists(root, cgroup)) {
+      // This may occur if the executor has exited and the isolator
+      // has destroyed the cgroup but the agent dies before noticing
+      // this. This will be detected when the containerizer tries to
+      // monitor the executor's pid.
+      LOG(WARNING) << "Couldn't find the cgroup '" << cgroup << "' "
+                   << "in the cgroups v2 hierarchy for container "
+                   << containerId;
+      continue;
+    }
+
+    infos[containerId] = Owned<Info>(new Info(cgroup));
+  }
+
+  Try<std::list<string>> entries =
+    os::ls(path::join(root, flags.cgroups_root));
+
+  if (entries.isError()) {
+    return Failure(
+        "Failed to list cgroups under '" +
+        path::join(root, flags.cgroups_root) + "': " + entries.error());
+  }
+
+  foreach (const string& entry, entries.get()) {
+    const string cgroup = path::join(flags.cgroups_root, entry);
+
+    if (!os::stat::isdir(path::join(root, cgroup))) {
+      continue;
+    }
+
+    ContainerID containerId;
+    containerId.set_value(entry);
+
+    if (infos.contains(containerId)) {
+      continue;
+    }
+
+    infos[containerId] = Owned<Info>(new Info(cgroup));
+
+    // Known orphan cgroups will be destroyed by the containerizer
+    // using the normal cleanup path. See MESOS-2367 for details.
+    if (!orphans.contains(containerId)) {
+      LOG(INFO) << "Cleaning up unknown orphaned container " << containerId;
+      cleanup(containerId);
+    }
+  }
+
+  return Nothing();
+}
+
+
+Future<Option<ContainerLaunchInfo>> Cgroups2IsolatorProcess::prepare(
+    const ContainerID& containerId,
+    const ContainerConfig& containerConfig)
+{
+  // Nested containers share the cgroup of their root ancestor.
+  if (containerId.has_parent()) {
+    return None();
+  }
+
+  if (infos.contains(containerId)) {
+    return Failure("Container has already been prepared");
+  }
+
+  const string cgroup = path::join(flags.cgroups_root, containerId.value());
+
+  if (cgroups2::exists(root, cgroup)) {
+    return Failure("The cgroup '" + cgroup + "' already exists");
+  }
+
+  Try<Nothing> create = cgroups2::create(root, cgroup);
+  if (create.isError()) {
+    return Failure(
+        "Failed to create the cgroup '" + cgroup + "': " + create.error());
+  }
+
+  infos[containerId] = Owned<Info>(new Info(cgroup));
+
+  return update(containerId, containerConfig.resources())
+    .then([]() -> Future<Option<ContainerLaunchInfo>> {
+      return None();
+    });
+}
+
+
+Future<Nothing> Cgroups2IsolatorProcess::isolate(
+    const ContainerID& containerId,
+    pid_t pid)
+{
+  // If we are a nested container, we inherit
+  // the cgroup from our root ancestor.
+  const ContainerID rootContainerId =
+    protobuf::getRootContainerId(containerId);
+
+  if (!infos.contains(rootContainerId)) {
+    return Failure("Failed to isolate the container: Unknown root container");
+  }
+
+  const string& cgroup = infos[rootContainerId]->cgroup;
+
+  Try<Nothing> assign = cgroups2::assign(root, cgroup, pid);
+  if (assign.isError()) {
+    return Failure(
+        "Failed to assign container " + stringify(containerId) +
+        " pid " + stringify(pid) + " to cgroup '" + cgroup + "': " +
+        assign.error());
+  }
+
+  return Nothing();
+}
+
+
+Future<Nothing> Cgroups2IsolatorProcess::update(
+    const ContainerID& containerId,
+    const Resources& resources)
+{
+  if (containerId.has_parent()) {
+    return Failure("Not supported for nested containers");
+  }
+
+  if (!infos.contains(containerId)) {
+    return Failure("Unknown container");
+  }
+
+  const string& cgroup = infos[containerId]->cgroup;
+
+  Option<double> cpus = resources.cpus();
+  if (cpus.isSome()) {
+    const uint64_t weightPerCpu =
+      flags.revocable_cpu_low_priority && resources.revocable().cpus().isSome()
+        ? CPU_WEIGHT_PER_CPU_REVOCABLE
+        : CPU_WEIGHT_PER_CPU;
+
+    const uint64_t weight = std::min(
+        std::max((uint64_t) (weightPerCpu * cpus.get()), MIN_CPU_WEIGHT),
+        MAX_CPU_WEIGHT);
+
+    Try<Nothing> write = cgroups2::cpu::weight(root, cgroup, weight);
+    if (write.isError()) {
+      return Failure("Failed to update 'cpu.weight': " + write.error());
+    }
+
+    LOG(INFO) << "Updated 'cpu.weight' to " << weight
+              << " (cpus " << cpus.get() << ")"
+              << " for container " << containerId;
+
+    if (flags.cgroups_enable_cfs) {
+      const Duration quota =
+        std::max(CPU_CFS_PERIOD * cpus.get(), MIN_CPU_CFS_QUOTA);
+
+      write = cgroups2::cpu::max(root, cgroup, quota, CPU_CFS_PERIOD);
+      if (write.isError()) {
+        return Failure("Failed to update 'cpu.max': " + write.error());
+      }
+
+      LOG(INFO) << "Updated 'cpu.max' to " << quota << " every "
+                << CPU_CFS_PERIOD << " (cpus " << cpus.get() << ")"
+                << " for container " << containerId;
+    }
+  }
+
+  Option<Bytes> mem = resources.mem();
+  if (mem.isSome()) {
+    const Bytes limit = std::max(mem.get(), MIN_MEMORY);
+
+    // Always set `memory.high`: when it is lowered below the current
+    // usage the kernel throttles the container and reclaims memory
+    // from it, rather than invoking the OOM killer.
+    Try<Nothing> write = cgroups2::memory::high(root, cgroup, limit);
+    if (write.isError()) {
+      return Failure("Failed to update 'memory.high': " + write.error());
+    }
+
+    LOG(INFO) << "Updated 'memory.high' to " << limit
+              << " for container " << containerId;
+
+    Try<Option<Bytes>> currentLimit = cgroups2::memory::max(root, cgroup);
+    if (currentLimit.isError()) {
+      return Failure("Failed to read 'memory.max': " + currentLimit.error());
+    }
+
+    // Like the cgroups v1 memory subsystem, only update the hard
+    // limit if this is the first time (i.e., it is unlimited) or when
+    // it is raised. Lowering `memory.max` below the current usage
+    // would OOM kill the container, whereas the lowered `memory.high`
+    // above lets the kernel shrink it gradually.
+    if (currentLimit->isNone() || limit > currentLimit->get()) {
+      write = cgroups2::memory::max(root, cgroup, limit);
+      if (write.isError()) {
+        return Failure("Failed to update 'memory.max': " + write.error());
+      }
+
+      LOG(INFO) << "Updated 'memory.max' to " << limit
+                << " for container " << containerId;
+    }
+  }
+
+  return Nothing();
+}
+
+
+Future<ResourceStatistics> Cgroups2IsolatorProcess::usage(
+    const ContainerID& containerId)
+{
+  if (containerId.has_parent()) {
+    return Failure("Not supported for nested containers");
+  }
+
+  if (!infos.contains(containerId)) {
+    return Failure("Unknown container");
+  }
+
+  const string& cgroup = infos[containerId]->cgroup;
+
+  ResourceStatistics result;
+
+  Try<set<pid_t>> pids = cgroups2::processes(root, cgroup);
+  if (pids.isError()) {
+    return Failure("Failed to read 'cgroup.procs': " + pids.error());
+  }
+
+  result.set_processes(pids->size());
+
+  // CPU.
+  Try<cgroups2::cpu::Stats> cpu = cgroups2::cpu::stat(root, cgroup);
+  if (cpu.isError()) {
+    return Failure("Failed to read 'cpu.stat': " + cpu.error());
+  }
+
+  result.set_cpus_user_time_secs(cpu->user.secs());
+  result.set_cpus_system_time_secs(cpu->system.secs());
+
+  if (cpu->periods.isSome()) {
+    result.set_cpus_nr_periods(cpu->periods.get());
+  }
+
+  if (cpu->throttled.isSome()) {
+    result.set_cpus_nr_throttled(cpu->throttled.get());
+  }
+
+  if (cpu->throttledTime.isSome()) {
+    result.set_cpus_throttled_time_secs(cpu->throttledTime->secs());
+  }
+
+  // Memory.
+  Try<Bytes> current = cgroups2::memory::current(root, cgroup);
+  if (current.isError()) {
+    return Failure("Failed to read 'memory.current': " + current.error());
+  }
+
+  result.set_mem_total_bytes(current->bytes());
+
+  Try<Option<Bytes>> limit = cgroups2::memory::max(root, cgroup);
+  if (limit.isError()) {
+    return Failure("Failed to read 'memory.max': " + limit.error());
+  }
+
+  if (limit->isSome()) {
+    result.set_mem_limit_bytes(limit->get().bytes());
+  }
+
+  Try<hashmap<string, uint64_t>> memory =
+    cgroups2::memory::stat(root, cgroup);
+
+  if (memory.isError()) {
+    return Failure(memory.error());
+  }
+
+  if (memory->contains("anon")) {
+    result.set_mem_anon_bytes(memory->at("anon"));
+    result.set_mem_rss_bytes(memory->at("anon"));
+  }
+
+  if (memory->contains("file")) {
+    result.set_mem_file_bytes(memory->at("file"));
+    result.set_mem_cache_bytes(memory->at("file"));
+  }
+
+  if (memory->contains("file_mapped")) {
+    result.set_mem_mapped_file_bytes(memory->at("file_mapped"));
+  }
+
+  if (memory->contains("unevictable")) {
+    result.set_mem_unevictable_bytes(memory->at("unevictable"));
+  }
+
+  // IO.
+  Try<hashmap<string, cgroups2::io::Stats>> io =
+    cgroups2::io::stat(root, cgroup);
+
+  if (io.isError()) {
+    return Failure(io.error());
+  }
+
+  foreachpair (const string& device,
+               const cgroups2::io::Stats& stats,
+               io.get()) {
+    vector<string> number = strings::split(device, ":");
+    if (number.size() != 2) {
+      return Failure("Invalid device '" + device + "' in 'io.stat'");
+    }
+
+    Try<uint64_t> major = numify<uint64_t>(number[0]);
+    Try<uint64_t> minor = numify<uint64_t>(number[1]);
+
+    if (major.isError() || minor.isError()) {
+      return Failure("Invalid device '" + device + "' in 'io.stat'");
+    }
+
+    CgroupInfo::Blkio::Throttling::Statistics* throttling =
+      result.mutable_blkio_statistics()->add_throttling();
+
+    throttling->mutable_device()->set_major_number(major.get());
+    throttling->mutable_device()->set_minor_number(minor.get());
+
+    auto add = [](
+        google::protobuf::RepeatedPtrField<CgroupInfo::Blkio::Value>* values,
+        CgroupInfo::Blkio::Operation op,
+        uint64_t value) {
+      CgroupInfo::Blkio::Value* v = values->Add();
+      v->set_op(op);
+      v->set_value(value);
+    };
+
+    add(throttling->mutable_io_serviced(),
+        CgroupInfo::Blkio::READ,
+        stats.rios);
+    add(throttling->mutable_io_serviced(),
+        CgroupInfo::Blkio::WRITE,
+        stats.wios);
+    add(throttling->mutable_io_serviced(),
+        CgroupInfo::Blkio::DISCARD,
+        stats.dios);
+    add(throttling->mutable_io_serviced(),
+        CgroupInfo::Blkio::TOTAL,
+        stats.rios + stats.wios + stats.dios);
+
+    add(throttling->mutable_io_service_bytes(),
+        CgroupInfo::Blkio::READ,
+        stats.rbytes);
+    add(throttling->mutable_io_service_bytes(),
+        CgroupInfo::Blkio::WRITE,
+        stats.wbytes);
+    add(throttling->mutable_io_service_bytes(),
+        CgroupInfo::Blkio::DISCARD,
+        stats.dbytes);
+    add(throttling->mutable_io_service_bytes(),
+        CgroupInfo::Blkio::TOTAL,
+        stats.rbytes + stats.wbytes + stats.dbytes);
+  }
+
+  // Pressure stall information. This is only available on kernels
+  // built with CONFIG_PSI (and not disabled with `psi=0`), hence
+  // failing to read it is not treated as an error.
+  Try<cgroups2::pressure::Pressure> pressure =
+    cgroups2::pressure::read(root, cgroup, "cpu");
+
+  if (pressure.isSome()) {
+    setPressure(pressure.get(), result.mutable_cpu_pressure());
+  } else {
+    VLOG(1) << "Failed to read 'cpu.pressure' for container "
+            << containerId << ": " << pressure.error();
+  }
+
+  pressure = cgroups2::pressure::read(root, cgroup, "memory");
+
+  if (pressure.isSome()) {
+    setPressure(pressure.get(), result.mutable_mem_pressure());
+  } else {
+    VLOG(1) << "Failed to read 'memory.pressure' for container "
+            << containerId << ": " << pressure.error();
+  }
+
+  pressure = cgroups2::pressure::read(root, cgroup, "io");
+
+  if (pressure.isSome()) {
+    setPressure(pressure.get(), result.mutable_io_pressure());
+  } else {
+    VLOG(1) << "Failed to read 'io.pressure' for container "
+            << containerId << ": " << pressure.error();
+  }
+
+  return result;
+}
+
+
+Future<Nothing> Cgroups2IsolatorProcess::cleanup(
+    const ContainerID& containerId)
+{
+  // If we are a nested container, we do not need to clean anything up
+  // since only top-level containers should have cgroups created for
+  // them.
+  if (containerId.has_parent()) {
+    return Nothing();
+  }
+
+  if (!infos.contains(containerId)) {
+    VLOG(1) << "Ignoring cleanup request for unknown container "
+            << containerId;
+
+    return Nothing();
+  }
+
+  const string cgroup = infos[containerId]->cgroup;
+
+  if (!cgroups2::exists(root, cgroup)) {
+    infos.erase(containerId);
+    return Nothing();
+  }
+
+  Try<Nothing> kill = cgroups2::kill(root, cgroup);
+  if (kill.isError()) {
+    return Failure(
+        "Failed to kill the processes in cgroup '" + cgroup + "': " +
+        kill.error());
+  }
+
+  const Time deadline = Clock::now() + flags.cgroups_destroy_timeout;
+
+  // The cgroup can only be removed once all of its processes have
+  // exited, which happens asynchronously after they are killed.
+  Future<Nothing> killed = process::loop(
+      PID<Cgroups2IsolatorProcess>(this),
+      []() {
+        return process::after(CGROUP_KILL_INTERVAL);
+      },
+      [=](const Nothing&) -> Future<ControlFlow<Nothing>> {
+        Try<set<pid_t>> pids = cgroups2::processes(root, cgroup);
+        if (pids.isError()) {
+          return Failure(
+              "Failed to read 'cgroup.procs' of '" + cgroup + "': " +
+              pids.error());
+        }
+
+        if (pids->empty()) {
+          return Break();
+        }
+
+        if (Clock::now() > deadline) {
+          return Failure(
+              "Timed out after " + stringify(flags.cgroups_destroy_timeout) +
+              " waiting for the processes in cgroup '" + cgroup +
+              "' to exit");
+        }
+
+        return Continue();
+      });
+
+  return await(killed)
+    .then(defer(
+        PID<Cgroups2IsolatorProcess>(this),
+        &Cgroups2IsolatorProcess::_cleanup,
+        containerId,
+        lambda::_1));
+}
+
+
+Future<Nothing> Cgroups2IsolatorProcess::_cleanup(
+    const ContainerID& containerId,
+    const Future<Nothing>& future)
+{
+  if (!future.isReady()) {
+    return Failure(
+        "Failed to kill the processes of container " +
+        stringify(containerId) + ": " +
+        (future.isFailed() ? future.failure() : "discarded"));
+  }
+
+  CHECK(infos.contains(containerId));
+
+  const string& cgroup = infos[containerId]->cgroup;
+
+  Try<Nothing> remove = cgroups2::remove(root, cgroup);
+  if (remove.isError()) {
+    return Failure(
+        "Failed to remove cgroup '" + cgroup + "': " + remove.error());
+  }
+
+  infos.erase(containerId);
+
+  return Nothing();
+}
+
+} // namespace slave {
+} // namespace internal {
+} // namespace mesos {
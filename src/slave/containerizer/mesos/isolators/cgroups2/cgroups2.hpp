@@ -0,0 +1,111 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __CGROUPS2_ISOLATOR_HPP__
+#define __CGROUPS2_ISOLATOR_HPP__
+
+#include <string>
+#include <vector>
+
+#include <mesos/resources.hpp>
+
+#include <process/future.hpp>
+#include <process/owned.hpp>
+
+#include <stout/hashmap.hpp>
+#include <stout/hashset.hpp>
+#include <stout/nothing.hpp>
+#include <stout/option.hpp>
+#include <stout/try.hpp>
+
+#include "slave/flags.hpp"
+
+#include "slave/containerizer/mesos/isolator.hpp"
+
+namespace mesos {
+namespace internal {
+namespace slave {
+
+// This isolator places containers into the cgroups v2 unified
+// hierarchy and manages the cpu, memory and io controllers for them.
+// In addition to the usual statistics it reports the pressure stall
+// information (PSI) of each controller, which tells how much time the
+// tasks of a container were delayed waiting on a resource rather than
+// how much of it they used.
+//
+// Unlike the cgroups v1 isolator (i.e., `cgroups/*`), all controllers
+// share a single cgroup per container so a container's statistics are
+// collected from one directory.
+class Cgroups2IsolatorProcess : public MesosIsolatorProcess
+{
+public:
+  static Try<mesos::slave::Isolator*> create(const Flags& flags);
+
+  ~Cgroups2IsolatorProcess() override;
+
+  bool supportsNesting() override;
+  bool supportsStandalone() override;
+
+  process::Future<Nothing> recover(
+      const std::vector<mesos::slave::ContainerState>& states,
+      const hashset<ContainerID>& orphans) override;
+
+  process::Future<Option<mesos::slave::ContainerLaunchInfo>> prepare(
+      const ContainerID& containerId,
+      const mesos::slave::ContainerConfig& containerConfig) override;
+
+  process::Future<Nothing> isolate(
+      const ContainerID& containerId,
+      pid_t pid) override;
+
+  process::Future<Nothing> update(
+      const ContainerID& containerId,
+      const Resources& resources) override;
+
+  process::Future<ResourceStatistics> usage(
+      const ContainerID& containerId) override;
+
+  process::Future<Nothing> cleanup(
+      const ContainerID& containerId) override;
+
+private:
+  struct Info
+  {
+    explicit Info(const std::string& _cgroup) : cgroup(_cgroup) {}
+
+    // Relative to the root of the unified hierarchy.
+    const std::string cgroup;
+  };
+
+  Cgroups2IsolatorProcess(const Flags& _flags, const std::string& _root);
+
+  process::Future<Nothing> _cleanup(
+      const ContainerID& containerId,
+      const process::Future<Nothing>& future);
+
+  const Flags flags;
+
+  // The mount point of the unified hierarchy.
+  const std::string root;
+
+  hashmap<ContainerID, process::Owned<Info>> infos;
+};
+
+} // namespace slave {
+} // namespace internal {
+} // namespace mesos {
+
+#endif // __CGROUPS2_ISOLATOR_HPP__
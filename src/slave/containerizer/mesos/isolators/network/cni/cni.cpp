@@ -1928,6 +1928,38 @@ Try<JSON::Object> NetworkCniIsolatorProcess::getNetworkConfigJSON(
     const string& network,
     const string& path)
 {
+  struct ::stat s;
+  if (::stat(path.c_str(), &s) < 0) {
+    networkConfigJSONs.erase(network);
+
+    return ErrnoError(
+        "Failed to stat CNI network configuration file: '" + path + "'");
+  }
+
+  // The cached configuration is only used if the file is the same one
+  // (i.e., it has not been replaced, e.g., by a rename) and it has not
+  // been written to since. We check the change time in addition to
+  // the modification time since the latter can be set arbitrarily.
+  if (networkConfigJSONs.contains(network)) {
+    const NetworkConfigJSON& cached = networkConfigJSONs.at(network);
+
+    if (cached.path == path &&
+        cached.stat.st_dev == s.st_dev &&
+        cached.stat.st_ino == s.st_ino &&
+        cached.stat.st_size == s.st_size &&
+        cached.stat.st_mtim.tv_sec == s.st_mtim.tv_sec &&
+        cached.stat.st_mtim.tv_nsec == s.st_mtim.tv_nsec &&
+        cached.stat.st_ctim.tv_sec == s.st_ctim.tv_sec &&
+        cached.stat.st_ctim.tv_nsec == s.st_ctim.tv_nsec) {
+      return cached.json;
+    }
+
+    VLOG(1) << "CNI network configuration file '" << path
+            << "' of network '" << network << "' has changed";
+
+    networkConfigJSONs.erase(network);
+  }
+
   Try<string> read = os::read(path);
   if (read.isError()) {
     return Error(
@@ -1957,6 +1989,8 @@ Try<JSON::Object> NetworkCniIsolatorProcess::getNetworkConfigJSON(
         "') does not match the network name: '" + network + "'");
   }
 
+  networkConfigJSONs[network] = NetworkConfigJSON{path, s, parse.get()};
+
   return parse;
 }
 
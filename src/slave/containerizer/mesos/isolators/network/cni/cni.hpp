@@ -17,6 +17,8 @@
 #ifndef __NETWORK_CNI_ISOLATOR_HPP__
 #define __NETWORK_CNI_ISOLATOR_HPP__
 
+#include <sys/stat.h>
+
 #include <process/id.hpp>
 #include <process/subprocess.hpp>
 
@@ -199,17 +201,33 @@ private:
   // Given a network name and the path for the CNI network
   // configuration file, reads the file, parses the JSON and
   // validates the name of the network to which this configuration
-  // file belongs.
+  // file belongs. The parsed configuration is cached in
+  // `networkConfigJSONs` until the file changes.
   Try<JSON::Object> getNetworkConfigJSON(
       const std::string& network,
       const std::string& path);
 
+  // A parsed CNI network configuration file, along with the status of
+  // the file it was parsed from which is used to detect whether the
+  // file has been modified or replaced since.
+  struct NetworkConfigJSON
+  {
+    std::string path;
+    struct ::stat stat;
+    JSON::Object json;
+  };
+
   const Flags flags;
 
   // A map storing the path to CNI network configuration files keyed
   // by the network name.
   hashmap<std::string, std::string> networkConfigs;
 
+  // Parsed CNI network configurations keyed by the network name. This
+  // avoids reading and parsing the configuration file for every
+  // container joining the network.
+  hashmap<std::string, NetworkConfigJSON> networkConfigJSONs;
+
   // DNS informations of CNI networks keyed by CNI network name.
   hashmap<std::string, ContainerDNSInfo::MesosInfo> cniDNSMap;
 
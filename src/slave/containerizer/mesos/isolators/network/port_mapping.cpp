@@ -18,6 +18,12 @@
 #include <string.h>
 #include <unistd.h>
 
+#include <linux/if_ether.h>
+#include <linux/pkt_cls.h>
+
+#include <netinet/in.h>
+#include <netinet/ip.h>
+
 #include <iostream>
 #include <vector>
 
@@ -57,6 +63,7 @@
 #include "common/status_utils.hpp"
 #include "common/values.hpp"
 
+#include "linux/ebpf.hpp"
 #include "linux/fs.hpp"
 #include "linux/ns.hpp"
 
@@ -66,6 +73,7 @@
 #include "linux/routing/diagnosis/diagnosis.hpp"
 
 #include "linux/routing/filter/basic.hpp"
+#include "linux/routing/filter/bpf.hpp"
 #include "linux/routing/filter/icmp.hpp"
 #include "linux/routing/filter/ip.hpp"
 
@@ -1357,6 +1365,287 @@ PortMappingIsolatorProcess::Metrics::~Metrics()
 }
 
 
+// When the BPF data path is enabled, the IP filters from host eth0
+// and host lo to the veths of the containers (see 'addHostIPFilters')
+// are replaced by a single BPF filter on each of the two interfaces.
+// The BPF program looks up the destination port of an IP packet in a
+// longest prefix match trie which maps each port range of a container
+// to the veth of the container, and redirects the packet to the veth.
+// Unlike the u32 filters, which the kernel tries one after another,
+// the cost of the lookup does not grow with the number of containers.
+//
+// The key of the map is a 'bpf_lpm_trie_key' whose data is the first
+// port of a port range in network order. Since the port ranges are
+// power of two sized and size aligned (see 'getPortRanges'), the
+// prefix length is the number of fixed leading bits of the range.
+struct PortsMapKey
+{
+  uint32_t prefixLength;
+  uint8_t port[2];
+} __attribute__((packed));
+
+
+// The value of the map. The BPF program also counts the packets and
+// bytes it redirects to the veth, which we report in 'usage'.
+struct PortsMapValue
+{
+  uint32_t ifindex;
+  uint32_t padding;
+  uint64_t packets;
+  uint64_t bytes;
+};
+
+
+// The maximum number of port ranges in the map.
+static const uint32_t PORTS_MAP_MAX_ENTRIES = 65536;
+
+
+static PortsMapKey getPortsMapKey(const PortRange& range)
+{
+  PortsMapKey key;
+  key.prefixLength = __builtin_popcount(range.mask());
+  key.port[0] = range.begin() >> 8;
+  key.port[1] = range.begin() & 0xff;
+  return key;
+}
+
+
+// Returns the BPF program for the ingress of host eth0 or host lo
+// (if 'host' is None). The program redirects the packets that the
+// 'hostEth0ToVeth' and 'hostLoToVeth' IP filters would redirect,
+// i.e., the TCP and UDP packets whose destination port is in the
+// map, and for host eth0 whose destination MAC and IP are the ones
+// of the host. Other packets are passed on to the next filter.
+static Try<vector<bpf_insn>> getPortsProgram(
+    int map,
+    const Option<std::pair<net::MAC, net::IP>>& host)
+{
+  using namespace ebpf::insn;
+
+  // The Ethernet header and the IP header (without options) are
+  // copied to separate stack slots, so that all the loads below are
+  // aligned to their size as the verifier requires. The map key is
+  // built at KEY.
+  const int16_t ETH_HEADER = -16;
+  const int16_t IP_HEADER = -40;
+  const int16_t KEY = -48;
+
+  const int32_t IP_HEADER_SIZE = 20;
+
+  ebpf::Assembler program;
+
+  // r6 = skb; r0 = bpf_skb_load_bytes(skb, ETH_HLEN, IP_HEADER, size).
+  program
+    .emit(mov(BPF_REG_6, BPF_REG_1))
+    .emit(movImm(BPF_REG_2, ETH_HLEN))
+    .emit(mov(BPF_REG_3, BPF_REG_10))
+    .emit(aluImm(BPF_ADD, BPF_REG_3, IP_HEADER))
+    .emit(movImm(BPF_REG_4, IP_HEADER_SIZE))
+    .emit(call(BPF_FUNC_skb_load_bytes))
+    .jumpImm(BPF_JNE, BPF_REG_0, 0, "pass");
+
+  if (host.isSome()) {
+    // The destination MAC is compared in network order, i.e., as the
+    // bytes are laid out in the packet.
+    uint8_t mac[6];
+    for (size_t i = 0; i < 6; i++) {
+      mac[i] = host->first[i];
+    }
+
+    uint32_t mac0;
+    uint16_t mac1;
+    memcpy(&mac0, mac, sizeof(mac0));
+    memcpy(&mac1, mac + sizeof(mac0), sizeof(mac1));
+
+    Try<struct in_addr> ip = host->second.in();
+    if (ip.isError()) {
+      return Error("Host IP is not IPv4: " + ip.error());
+    }
+
+    // r0 = bpf_skb_load_bytes(skb, 0, ETH_HEADER, ETH_HLEN).
+    program
+      .emit(mov(BPF_REG_1, BPF_REG_6))
+      .emit(movImm(BPF_REG_2, 0))
+      .emit(mov(BPF_REG_3, BPF_REG_10))
+      .emit(aluImm(BPF_ADD, BPF_REG_3, ETH_HEADER))
+      .emit(movImm(BPF_REG_4, ETH_HLEN))
+      .emit(call(BPF_FUNC_skb_load_bytes))
+      .jumpImm(BPF_JNE, BPF_REG_0, 0, "pass");
+
+    program
+      .emit(load(BPF_W, BPF_REG_1, BPF_REG_10, ETH_HEADER))
+      .emit(movImm32(BPF_REG_2, mac0))
+      .jump(BPF_JNE, BPF_REG_1, BPF_REG_2, "pass")
+      .emit(load(BPF_H, BPF_REG_1, BPF_REG_10, ETH_HEADER + 4))
+      .emit(movImm32(BPF_REG_2, mac1))
+      .jump(BPF_JNE, BPF_REG_1, BPF_REG_2, "pass")
+      .emit(load(BPF_W, BPF_REG_1, BPF_REG_10, IP_HEADER + 16))
+      .emit(movImm32(BPF_REG_2, ip->s_addr))
+      .jump(BPF_JNE, BPF_REG_1, BPF_REG_2, "pass");
+  }
+
+  // Only TCP and UDP packets have ports. Fragments other than the
+  // first one do not have the transport header.
+  program
+    .emit(load(BPF_B, BPF_REG_1, BPF_REG_10, IP_HEADER + 9))
+    .jumpImm(BPF_JEQ, BPF_REG_1, IPPROTO_TCP, "transport")
+    .jumpImm(BPF_JNE, BPF_REG_1, IPPROTO_UDP, "pass")
+    .label("transport")
+    .emit(load(BPF_H, BPF_REG_1, BPF_REG_10, IP_HEADER + 6))
+    .emit(aluImm(BPF_AND, BPF_REG_1, htons(IP_OFFMASK)))
+    .jumpImm(BPF_JNE, BPF_REG_1, 0, "pass");
+
+  // r2 = the offset of the destination port, which follows the
+  // source port in both the TCP and the UDP header, i.e., the length
+  // of the Ethernet header + the length of the IP header (in 32-bit
+  // words) * 4 + 2.
+  program
+    .emit(load(BPF_B, BPF_REG_2, BPF_REG_10, IP_HEADER))
+    .emit(aluImm(BPF_AND, BPF_REG_2, 0x0f))
+    .emit(aluImm(BPF_LSH, BPF_REG_2, 2))
+    .emit(aluImm(BPF_ADD, BPF_REG_2, ETH_HLEN + 2));
+
+  // Build the key with the full destination port and look it up.
+  program
+    .emit(mov(BPF_REG_1, BPF_REG_6))
+    .emit(mov(BPF_REG_3, BPF_REG_10))
+    .emit(aluImm(BPF_ADD, BPF_REG_3, KEY + offsetof(PortsMapKey, port)))
+    .emit(movImm(BPF_REG_4, sizeof(PortsMapKey::port)))
+    .emit(call(BPF_FUNC_skb_load_bytes))
+    .jumpImm(BPF_JNE, BPF_REG_0, 0, "pass")
+    .emit(storeImm(BPF_W, BPF_REG_10, KEY, 16))
+    .emit(loadMap(BPF_REG_1, map))
+    .emit(mov(BPF_REG_2, BPF_REG_10))
+    .emit(aluImm(BPF_ADD, BPF_REG_2, KEY))
+    .emit(call(BPF_FUNC_map_lookup_elem))
+    .jumpImm(BPF_JEQ, BPF_REG_0, 0, "pass");
+
+  // Update the counters and redirect the packet to the veth.
+  program
+    .emit(movImm(BPF_REG_1, 1))
+    .emit(atomicAdd(
+        BPF_DW, BPF_REG_0, offsetof(PortsMapValue, packets), BPF_REG_1))
+    .emit(load(BPF_W, BPF_REG_1, BPF_REG_6, offsetof(__sk_buff, len)))
+    .emit(atomicAdd(
+        BPF_DW, BPF_REG_0, offsetof(PortsMapValue, bytes), BPF_REG_1))
+    .emit(load(BPF_W, BPF_REG_1, BPF_REG_0, offsetof(PortsMapValue, ifindex)))
+    .emit(movImm(BPF_REG_2, 0))
+    .emit(call(BPF_FUNC_redirect))
+    .emit(exit());
+
+  program
+    .label("pass")
+    .emit(movImm(BPF_REG_0, TC_ACT_UNSPEC))
+    .emit(exit());
+
+  return program.assemble();
+}
+
+
+Try<int> createPortsMap()
+{
+  return ebpf::createMap(
+      BPF_MAP_TYPE_LPM_TRIE,
+      sizeof(PortsMapKey),
+      sizeof(PortsMapValue),
+      PORTS_MAP_MAX_ENTRIES,
+      BPF_F_NO_PREALLOC);
+}
+
+
+Try<int> loadPortsProgram(
+    int map,
+    const Option<std::pair<net::MAC, net::IP>>& host)
+{
+  Try<vector<bpf_insn>> instructions = getPortsProgram(map, host);
+  if (instructions.isError()) {
+    return Error("Failed to assemble BPF program: " + instructions.error());
+  }
+
+  return ebpf::load(
+      BPF_PROG_TYPE_SCHED_CLS,
+      instructions.get(),
+      "Apache-2.0");
+}
+
+
+// Loads the BPF program (see 'getPortsProgram') and attaches it to
+// the ingress of the link. If the link already has a BPF filter,
+// e.g., from a previous run of the slave, its program is replaced.
+static Try<Nothing> attachPortsProgram(
+    const string& link,
+    int map,
+    const Option<std::pair<net::MAC, net::IP>>& host)
+{
+  Try<int> program = loadPortsProgram(map, host);
+  if (program.isError()) {
+    return Error(program.error());
+  }
+
+  const string name = "mesos-port-mapping-" + link;
+
+  Try<bool> create = filter::bpf::create(
+      link,
+      ingress::HANDLE,
+      ETH_P_IP,
+      Priority(IP_FILTER_PRIORITY, HIGH),
+      program.get(),
+      name);
+
+  if (create.isSome() && !create.get()) {
+    create = filter::bpf::update(
+        link,
+        ingress::HANDLE,
+        ETH_P_IP,
+        program.get(),
+        name);
+  }
+
+  // The filter holds a reference to the program.
+  os::close(program.get());
+
+  if (create.isError()) {
+    return Error(create.error());
+  } else if (!create.get()) {
+    return Error("The BPF filter disappeared while being updated");
+  }
+
+  return Nothing();
+}
+
+
+// Opens the pinned BPF map from the port ranges of the containers to
+// their veths, or creates and pins it if it does not exist.
+static Try<int> openPortsMap()
+{
+  Result<int> map = ebpf::get(PORT_MAPPING_BPF_MAP_PATH());
+  if (map.isError()) {
+    return Error(map.error());
+  } else if (map.isSome()) {
+    return map.get();
+  }
+
+  Try<int> create = createPortsMap();
+  if (create.isError()) {
+    return Error(create.error());
+  }
+
+  Try<Nothing> mkdir = os::mkdir(Path(PORT_MAPPING_BPF_MAP_PATH()).dirname());
+  if (mkdir.isError()) {
+    os::close(create.get());
+    return Error("Failed to create the directory: " + mkdir.error());
+  }
+
+  Try<Nothing> pin = ebpf::pin(create.get(), PORT_MAPPING_BPF_MAP_PATH());
+  if (pin.isError()) {
+    os::close(create.get());
+    return Error(pin.error());
+  }
+
+  return create.get();
+}
+
+
 Try<Isolator*> PortMappingIsolatorProcess::create(const Flags& flags)
 {
   // Check for root permission.
@@ -1786,6 +2075,85 @@ Try<Isolator*> PortMappingIsolatorProcess::create(const Flags& flags)
         ": " + createHostLoQdisc.error());
   }
 
+  // The containers of a previous run of the slave keep the data path
+  // which was enabled when they were isolated, i.e., an entry in the
+  // BPF map or IP filters on host eth0 and host lo, which the BPF
+  // filter on host eth0 tells apart. Since the host side of each
+  // container is added and removed using the data path enabled now,
+  // it cannot be switched while any of these containers is left.
+  Try<bool> bpfAttached =
+    filter::bpf::exists(eth0.get(), ingress::HANDLE, ETH_P_IP);
+
+  if (bpfAttached.isError()) {
+    return Error(
+        "Failed to check the BPF filter on " + eth0.get() +
+        ": " + bpfAttached.error());
+  }
+
+  if (bpfAttached.get() != flags.network_enable_bpf_port_mapping) {
+    Try<set<string>> links = net::links();
+    if (links.isError()) {
+      return Error("Failed to get all the links: " + links.error());
+    }
+
+    foreach (const string& link, links.get()) {
+      if (getPidFromVeth(link).isSome()) {
+        return Error(
+            string("Cannot ") +
+            (flags.network_enable_bpf_port_mapping ? "enable" : "disable") +
+            " '--network_enable_bpf_port_mapping' while there are"
+            " containers using the " +
+            (bpfAttached.get() ? "BPF" : "IP filter") +
+            " data path (e.g., with " + link + ")");
+      }
+    }
+  }
+
+  // Set up the BPF data path on host eth0 and host lo if enabled.
+  // Otherwise, we remove the BPF filters a previous run of the slave
+  // might have left so that they do not shadow the IP filters.
+  Option<int> portsMap;
+
+  if (flags.network_enable_bpf_port_mapping) {
+    Try<int> map = openPortsMap();
+    if (map.isError()) {
+      return Error("Failed to open the BPF map: " + map.error());
+    }
+
+    Try<Nothing> attach = attachPortsProgram(
+        eth0.get(),
+        map.get(),
+        std::make_pair(hostMAC.get(), hostIPNetwork->address()));
+
+    if (attach.isError()) {
+      os::close(map.get());
+      return Error(
+          "Failed to attach the BPF program to " + eth0.get() +
+          ": " + attach.error());
+    }
+
+    attach = attachPortsProgram(lo.get(), map.get(), None());
+    if (attach.isError()) {
+      os::close(map.get());
+      return Error(
+          "Failed to attach the BPF program to " + lo.get() +
+          ": " + attach.error());
+    }
+
+    portsMap = map.get();
+  } else {
+    const vector<string> links = {eth0.get(), lo.get()};
+
+    foreach (const string& link, links) {
+      Try<bool> remove = filter::bpf::remove(link, ingress::HANDLE, ETH_P_IP);
+      if (remove.isError()) {
+        return Error(
+            "Failed to remove the BPF filter on " + link +
+            ": " + remove.error());
+      }
+    }
+  }
+
   // Enable 'route_localnet' on host loopback interface (lo). This
   // enables the use of 127.0.0.1/8 for local routing purpose. This
   // feature only exists on kernel 3.6 or newer.
@@ -2034,7 +2402,16 @@ Try<Isolator*> PortMappingIsolatorProcess::create(const Flags& flags)
           egressRateLimitPerContainer,
           nonEphemeralPorts,
           ephemeralPortsAllocator,
-          freeFlowIds)));
+          freeFlowIds,
+          portsMap)));
+}
+
+
+PortMappingIsolatorProcess::~PortMappingIsolatorProcess()
+{
+  if (portsMap.isSome()) {
+    os::close(portsMap.get());
+  }
 }
 
 
@@ -3211,6 +3588,32 @@ Future<ResourceStatistics> PortMappingIsolatorProcess::usage(
     result.set_net_tx_dropped(tx_dropped.get());
   }
 
+  // Report the packets and bytes the BPF programs on host eth0 and
+  // host lo have redirected to the container.
+  if (portsMap.isSome()) {
+    hashmap<string, uint64_t> statistics;
+    statistics[PACKETS] = 0;
+    statistics[BYTES] = 0;
+
+    foreach (const PortRange& range,
+             getPortRanges(info->nonEphemeralPorts + info->ephemeralPorts)) {
+      const PortsMapKey key = getPortsMapKey(range);
+
+      PortsMapValue value;
+      Try<bool> lookup = ebpf::lookupElement(portsMap.get(), &key, &value);
+      if (lookup.isError()) {
+        return Failure(
+            "Failed to look up " + stringify(range) +
+            " in the BPF map: " + lookup.error());
+      } else if (lookup.get()) {
+        statistics[PACKETS] += value.packets;
+        statistics[BYTES] += value.bytes;
+      }
+    }
+
+    addTrafficControlStatistics(NET_ISOLATOR_INGRESS_BPF, statistics, &result);
+  }
+
   // Retrieve the socket information from inside the container.
   PortMappingStatistics statistics;
   statistics.flags.pid = info->pid.get();
@@ -3715,53 +4118,88 @@ Try<Nothing> PortMappingIsolatorProcess::addHostIPFilters(
         veth + " to host " + lo + " already exists");
   }
 
-  // Add an IP packet filter from host eth0 to veth of the container
-  // such that any incoming IP packet will be properly redirected to
-  // the corresponding container based on its destination port.
-  Try<bool> hostEth0ToVeth = filter::ip::create(
-      eth0,
-      ingress::HANDLE,
-      ip::Classifier(hostMAC, hostIPNetwork.address(), None(), range),
-      Priority(IP_FILTER_PRIORITY, NORMAL),
-      action::Redirect(veth));
+  if (portsMap.isSome()) {
+    // Add an entry to the BPF map such that any incoming or internally
+    // generated IP packet will be properly redirected to the
+    // corresponding container by the BPF programs on host eth0 and
+    // host lo based on its destination port.
+    Result<int> index = link::index(veth);
+    if (index.isError()) {
+      ++metrics.adding_eth0_ip_filters_errors;
 
-  if (hostEth0ToVeth.isError()) {
-    ++metrics.adding_eth0_ip_filters_errors;
+      return Error(
+          "Failed to get the index of " + veth + ": " + index.error());
+    } else if (index.isNone()) {
+      ++metrics.adding_eth0_ip_filters_errors;
 
-    return Error(
-        "Failed to create an IP packet filter from host " +
-        eth0 + " to " + veth + ": " + hostEth0ToVeth.error());
-  } else if (!hostEth0ToVeth.get()) {
-    ++metrics.adding_eth0_ip_filters_already_exist;
+      return Error("Failed to find " + veth);
+    }
 
-    return Error(
-        "The IP packet filter from host " + eth0 + " to " +
-        veth + " already exists");
-  }
+    const PortsMapKey key = getPortsMapKey(range);
 
-  // Add an IP packet filter from host lo to veth of the container
-  // such that any internally generated IP packet will be properly
-  // redirected to the corresponding container based on its
-  // destination port.
-  Try<bool> hostLoToVeth = filter::ip::create(
-      lo,
-      ingress::HANDLE,
-      ip::Classifier(None(), None(), None(), range),
-      Priority(IP_FILTER_PRIORITY, NORMAL),
-      action::Redirect(veth));
+    PortsMapValue value;
+    memset(&value, 0, sizeof(value));
+    value.ifindex = index.get();
 
-  if (hostLoToVeth.isError()) {
-    ++metrics.adding_lo_ip_filters_errors;
+    Try<Nothing> update =
+      ebpf::updateElement(portsMap.get(), &key, &value, BPF_NOEXIST);
 
-    return Error(
-        "Failed to create an IP packet filter from host " +
-        lo + " to " + veth + ": " + hostLoToVeth.error());
-  } else if (!hostLoToVeth.get()) {
-    ++metrics.adding_lo_ip_filters_already_exist;
+    if (update.isError()) {
+      ++metrics.adding_eth0_ip_filters_errors;
 
-    return Error(
-        "The IP packet filter from host " + lo + " to " +
-        veth + " already exists");
+      return Error(
+          "Failed to add " + stringify(range) + " to the BPF map for " +
+          veth + ": " + update.error());
+    }
+  } else {
+    // Add an IP packet filter from host eth0 to veth of the container
+    // such that any incoming IP packet will be properly redirected to
+    // the corresponding container based on its destination port.
+    Try<bool> hostEth0ToVeth = filter::ip::create(
+        eth0,
+        ingress::HANDLE,
+        ip::Classifier(hostMAC, hostIPNetwork.address(), None(), range),
+        Priority(IP_FILTER_PRIORITY, NORMAL),
+        action::Redirect(veth));
+
+    if (hostEth0ToVeth.isError()) {
+      ++metrics.adding_eth0_ip_filters_errors;
+
+      return Error(
+          "Failed to create an IP packet filter from host " +
+          eth0 + " to " + veth + ": " + hostEth0ToVeth.error());
+    } else if (!hostEth0ToVeth.get()) {
+      ++metrics.adding_eth0_ip_filters_already_exist;
+
+      return Error(
+          "The IP packet filter from host " + eth0 + " to " +
+          veth + " already exists");
+    }
+
+    // Add an IP packet filter from host lo to veth of the container
+    // such that any internally generated IP packet will be properly
+    // redirected to the corresponding container based on its
+    // destination port.
+    Try<bool> hostLoToVeth = filter::ip::create(
+        lo,
+        ingress::HANDLE,
+        ip::Classifier(None(), None(), None(), range),
+        Priority(IP_FILTER_PRIORITY, NORMAL),
+        action::Redirect(veth));
+
+    if (hostLoToVeth.isError()) {
+      ++metrics.adding_lo_ip_filters_errors;
+
+      return Error(
+          "Failed to create an IP packet filter from host " +
+          lo + " to " + veth + ": " + hostLoToVeth.error());
+    } else if (!hostLoToVeth.get()) {
+      ++metrics.adding_lo_ip_filters_already_exist;
+
+      return Error(
+          "The IP packet filter from host " + lo + " to " +
+          veth + " already exists");
+    }
   }
 
   if (flowId.isSome()) {
@@ -3806,42 +4244,61 @@ Try<Nothing> PortMappingIsolatorProcess::removeHostIPFilters(
   // removed is important. We need to remove filters on host eth0 and
   // host lo first before we remove filters on veth.
 
-  // Remove the IP packet filter from host eth0 to veth of the container.
-  Try<bool> hostEth0ToVeth = filter::ip::remove(
-      eth0,
-      ingress::HANDLE,
-      ip::Classifier(hostMAC, hostIPNetwork.address(), None(), range));
+  if (portsMap.isSome()) {
+    // Remove the entry from the BPF map.
+    const PortsMapKey key = getPortsMapKey(range);
 
-  if (hostEth0ToVeth.isError()) {
-    ++metrics.removing_eth0_ip_filters_errors;
+    Try<bool> remove = ebpf::deleteElement(portsMap.get(), &key);
+    if (remove.isError()) {
+      ++metrics.removing_eth0_ip_filters_errors;
 
-    return Error(
-        "Failed to remove the IP packet filter from host " +
-        eth0 + " to " + veth + ": " + hostEth0ToVeth.error());
-  } else if (!hostEth0ToVeth.get()) {
-    ++metrics.removing_eth0_ip_filters_do_not_exist;
+      return Error(
+          "Failed to remove " + stringify(range) + " from the BPF map for " +
+          veth + ": " + remove.error());
+    } else if (!remove.get()) {
+      ++metrics.removing_eth0_ip_filters_do_not_exist;
 
-    LOG(ERROR) << "The IP packet filter from host " << eth0
-               << " to " << veth << " does not exist";
-  }
+      LOG(ERROR) << "The entry for " << range << " in the BPF map for "
+                 << veth << " does not exist";
+    }
+  } else {
+    // Remove the IP packet filter from host eth0 to veth of the container.
+    Try<bool> hostEth0ToVeth = filter::ip::remove(
+        eth0,
+        ingress::HANDLE,
+        ip::Classifier(hostMAC, hostIPNetwork.address(), None(), range));
 
-  // Remove the IP packet filter from host lo to veth of the container.
-  Try<bool> hostLoToVeth = filter::ip::remove(
-      lo,
-      ingress::HANDLE,
-      ip::Classifier(None(), None(), None(), range));
+    if (hostEth0ToVeth.isError()) {
+      ++metrics.removing_eth0_ip_filters_errors;
 
-  if (hostLoToVeth.isError()) {
-    ++metrics.removing_lo_ip_filters_errors;
+      return Error(
+          "Failed to remove the IP packet filter from host " +
+          eth0 + " to " + veth + ": " + hostEth0ToVeth.error());
+    } else if (!hostEth0ToVeth.get()) {
+      ++metrics.removing_eth0_ip_filters_do_not_exist;
 
-    return Error(
-        "Failed to remove the IP packet filter from host " +
-        lo + " to " + veth + ": " + hostLoToVeth.error());
-  } else if (!hostLoToVeth.get()) {
-    ++metrics.removing_lo_ip_filters_do_not_exist;
+      LOG(ERROR) << "The IP packet filter from host " << eth0
+                 << " to " << veth << " does not exist";
+    }
+
+    // Remove the IP packet filter from host lo to veth of the container.
+    Try<bool> hostLoToVeth = filter::ip::remove(
+        lo,
+        ingress::HANDLE,
+        ip::Classifier(None(), None(), None(), range));
+
+    if (hostLoToVeth.isError()) {
+      ++metrics.removing_lo_ip_filters_errors;
 
-    LOG(ERROR) << "The IP packet filter from host " << lo
-               << " to " << veth << " does not exist";
+      return Error(
+          "Failed to remove the IP packet filter from host " +
+          lo + " to " + veth + ": " + hostLoToVeth.error());
+    } else if (!hostLoToVeth.get()) {
+      ++metrics.removing_lo_ip_filters_do_not_exist;
+
+      LOG(ERROR) << "The IP packet filter from host " << lo
+                 << " to " << veth << " does not exist";
+    }
   }
 
   if (flags.egress_unique_flow_per_container) {
@@ -23,6 +23,7 @@
 
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <process/id.hpp>
@@ -41,6 +42,7 @@
 #include <stout/none.hpp>
 #include <stout/option.hpp>
 #include <stout/subcommand.hpp>
+#include <stout/try.hpp>
 
 #include "linux/routing/filter/ip.hpp"
 
@@ -73,10 +75,21 @@ inline std::string PORT_MAPPING_BIND_MOUNT_SYMLINK_ROOT()
 }
 
 
+// The path in the BPF file system where we pin the BPF map from the
+// port ranges of the containers to their veths, so that the map (and
+// thus the BPF data path) survives slave restarts.
+// NOTE: This constant is exposed for testing.
+inline std::string PORT_MAPPING_BPF_MAP_PATH()
+{
+  return "/sys/fs/bpf/mesos/port_mapping";
+}
+
+
 // These names are used to identify the traffic control statistics
 // output for each of the Linux Traffic Control Qdiscs we report.
 constexpr char NET_ISOLATOR_BW_LIMIT[] = "bw_limit";
 constexpr char NET_ISOLATOR_BLOAT_REDUCTION[] = "bloat_reduction";
+constexpr char NET_ISOLATOR_INGRESS_BPF[] = "ingress_bpf";
 
 
 // Responsible for allocating ephemeral ports for the port mapping
@@ -135,6 +148,22 @@ std::vector<routing::filter::ip::PortRange> getPortRanges(
     const IntervalSet<uint16_t>& ports);
 
 
+// Creates the (unpinned) BPF map from the port ranges of the
+// containers to their veths which is used when
+// `--network_enable_bpf_port_mapping` is set. This function is
+// exposed mainly for unit testing.
+Try<int> createPortsMap();
+
+
+// Loads the BPF program for the ingress of host eth0 (with the MAC
+// and IP of the host) or host lo (if 'host' is None) which redirects
+// the packets to the veths in the map, and returns its fd. This
+// function is exposed mainly for unit testing.
+Try<int> loadPortsProgram(
+    int map,
+    const Option<std::pair<net::MAC, net::IP>>& host);
+
+
 // Provides network isolation using port mapping. Each container is
 // assigned a fixed set of ports (including ephemeral ports). The
 // isolator will set up filters on the host such that network traffic
@@ -149,7 +178,7 @@ class PortMappingIsolatorProcess : public MesosIsolatorProcess
 public:
   static Try<mesos::slave::Isolator*> create(const Flags& flags);
 
-  ~PortMappingIsolatorProcess() override {}
+  ~PortMappingIsolatorProcess() override;
 
   process::Future<Nothing> recover(
       const std::vector<mesos::slave::ContainerState>& states,
@@ -260,7 +289,8 @@ private:
       const Option<Bytes>& _egressRateLimitPerContainer,
       const IntervalSet<uint16_t>& _managedNonEphemeralPorts,
       const process::Owned<EphemeralPortsAllocator>& _ephemeralPortsAllocator,
-      const std::set<uint16_t>& _flowIDs)
+      const std::set<uint16_t>& _flowIDs,
+      const Option<int>& _portsMap)
     : ProcessBase(process::ID::generate("mesos-port-mapping-isolator")),
       flags(_flags),
       bindMountRoot(_bindMountRoot),
@@ -275,7 +305,8 @@ private:
       egressRateLimitPerContainer(_egressRateLimitPerContainer),
       managedNonEphemeralPorts(_managedNonEphemeralPorts),
       ephemeralPortsAllocator(_ephemeralPortsAllocator),
-      freeFlowIds(_flowIDs) {}
+      freeFlowIds(_flowIDs),
+      portsMap(_portsMap) {}
 
   // Continuations.
   Try<Nothing> _cleanup(Info* info, const Option<ContainerID>& containerId);
@@ -337,6 +368,13 @@ private:
   // Store a set of unused flow ID's on this slave.
   std::set<uint16_t> freeFlowIds;
 
+  // The file descriptor of the BPF map from the port ranges of the
+  // containers to their veths if the BPF data path is enabled (see
+  // 'flags.network_enable_bpf_port_mapping'). In that case, the
+  // ingress IP packets on host eth0 and host lo are redirected by BPF
+  // programs looking up this map instead of by per port range filters.
+  const Option<int> portsMap;
+
   hashmap<ContainerID, Info*> infos;
 
   // Recovered containers from a previous run that weren't managed by
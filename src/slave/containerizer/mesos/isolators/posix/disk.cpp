@@ -14,15 +14,24 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#include <signal.h>
+#ifndef __WINDOWS__
+#include <fnmatch.h>
+#include <fts.h>
+#endif // __WINDOWS__
 
-#ifdef __linux__
-#include <sys/prctl.h>
-#endif
+#include <sys/stat.h>
 #include <sys/types.h>
 
+#include <algorithm>
+#include <atomic>
 #include <deque>
-#include <tuple>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <system_error>
+#include <thread>
+#include <utility>
 
 #include <glog/logging.h>
 
@@ -31,26 +40,27 @@
 #include <process/defer.hpp>
 #include <process/delay.hpp>
 #include <process/id.hpp>
-#include <process/io.hpp>
-#include <process/subprocess.hpp>
 
 #include <stout/check.hpp>
+#include <stout/error.hpp>
 #include <stout/foreach.hpp>
 #include <stout/lambda.hpp>
-#include <stout/numify.hpp>
-#include <stout/strings.hpp>
 #include <stout/path.hpp>
+#include <stout/result.hpp>
 
-#include <stout/os/constants.hpp>
 #include <stout/os/exists.hpp>
-#include <stout/os/killtree.hpp>
+#include <stout/os/ls.hpp>
+#include <stout/os/realpath.hpp>
 #include <stout/os/stat.hpp>
+#include <stout/os/strerror.hpp>
 
 #include "common/protobuf_utils.hpp"
 
 #include "slave/containerizer/mesos/isolators/posix/disk.hpp"
 
-namespace io = process::io;
+#ifdef ENABLE_XFS_DISK_ISOLATOR
+#include "slave/containerizer/mesos/isolators/xfs/utils.hpp"
+#endif // ENABLE_XFS_DISK_ISOLATOR
 
 using std::deque;
 using std::string;
@@ -62,14 +72,11 @@ using process::Owned;
 using process::PID;
 using process::Process;
 using process::Promise;
-using process::Subprocess;
 
-using process::await;
 using process::defer;
 using process::delay;
 using process::dispatch;
 using process::spawn;
-using process::subprocess;
 using process::terminate;
 
 using mesos::slave::ContainerConfig;
@@ -84,8 +91,6 @@ namespace slave {
 
 Try<Isolator*> PosixDiskIsolatorProcess::create(const Flags& flags)
 {
-  // TODO(jieyu): Check the availability of command 'du'.
-
   return new MesosIsolator(process::Owned<MesosIsolatorProcess>(
         new PosixDiskIsolatorProcess(flags)));
 }
@@ -299,8 +304,9 @@ Future<Bytes> PosixDiskIsolatorProcess::collect(
     }
   }
 
-  // We append "/" at the end to make sure that 'du' runs on actual
-  // directory pointed by the symlink (and not the symlink itself).
+  // We append "/" at the end to make sure that the usage is collected
+  // for the actual directory pointed by the symlink (and not the
+  // symlink itself).
   string _path = path;
   if (path != info->directory && os::stat::islink(path)) {
     _path = path::join(path, "");
@@ -460,22 +466,304 @@ Future<Nothing> PosixDiskIsolatorProcess::cleanup(
 }
 
 
+#ifndef __WINDOWS__
+// The number of threads walking a directory tree concurrently.
+constexpr size_t DISK_USAGE_WALKERS = 4;
+
+
+// Inodes of files with more than one hard link which have already been
+// accounted for by a walk, so that (like `du`) the disk space used by
+// such a file is only counted once. This is shared by the concurrent
+// walkers of a directory tree.
+struct HardLinks
+{
+  std::mutex mutex;
+  std::set<std::pair<dev_t, ino_t>> inodes;
+};
+
+
+// Returns true if the path matches one of the patterns. Like the
+// `--exclude` option of `du`, a pattern matches a path if it matches
+// the whole path or any of its trailing components.
+static bool excluded(const string& path, const vector<string>& excludes)
+{
+  foreach (const string& pattern, excludes) {
+    size_t start = 0;
+
+    while (true) {
+      if (::fnmatch(pattern.c_str(), path.c_str() + start, 0) == 0) {
+        return true;
+      }
+
+      start = path.find('/', start);
+      if (start == string::npos) {
+        break;
+      }
+
+      ++start;
+    }
+  }
+
+  return false;
+}
+
+
+// Returns the disk space used by the given directory trees. Symbolic
+// links are not followed and excluded paths are skipped entirely.
+//
+// NOTE: This blocks the calling thread until the trees are walked.
+static Try<Bytes> walk(
+    const vector<string>& roots,
+    const vector<string>& excludes,
+    const std::shared_ptr<HardLinks>& hardLinks,
+    const std::shared_ptr<std::atomic_bool>& cancelled)
+{
+  vector<char*> paths;
+  foreach (const string& root, roots) {
+    paths.push_back(const_cast<char*>(root.c_str()));
+  }
+
+  paths.push_back(nullptr);
+
+  FTS* tree = ::fts_open(paths.data(), FTS_NOCHDIR | FTS_PHYSICAL, nullptr);
+  if (tree == nullptr) {
+    return ErrnoError("Failed to open directory trees");
+  }
+
+  // The number of 512-byte blocks, as reported by `stat`.
+  uint64_t blocks = 0;
+
+  while (true) {
+    errno = 0;
+
+    FTSENT* node = ::fts_read(tree);
+    if (node == nullptr) {
+      break;
+    }
+
+    if (cancelled->load()) {
+      ::fts_close(tree);
+      return Error("Cancelled");
+    }
+
+    switch (node->fts_info) {
+      case FTS_DP:
+        // Directories were accounted for when they were visited
+        // in preorder.
+        continue;
+      case FTS_DNR:
+      case FTS_ERR:
+      case FTS_NS:
+        // The files of a running container come and go while
+        // they are walked, which is not an error.
+        if (node->fts_errno == ENOENT) {
+          continue;
+        }
+
+        {
+          Error error(
+              "Failed to read '" + string(node->fts_path) + "': " +
+              os::strerror(node->fts_errno));
+
+          ::fts_close(tree);
+          return error;
+        }
+      default:
+        break;
+    }
+
+    if (excluded(node->fts_path, excludes)) {
+      ::fts_set(tree, node, FTS_SKIP);
+      continue;
+    }
+
+    const struct stat* s = node->fts_statp;
+
+    if (!S_ISDIR(s->st_mode) && s->st_nlink > 1) {
+      std::lock_guard<std::mutex> lock(hardLinks->mutex);
+      if (!hardLinks->inodes.emplace(s->st_dev, s->st_ino).second) {
+        continue;
+      }
+    }
+
+    blocks += s->st_blocks;
+  }
+
+  // `fts_read` returns `nullptr` with `errno` set on failure.
+  if (errno != 0) {
+    ErrnoError error("Failed to walk directory trees");
+    ::fts_close(tree);
+    return error;
+  }
+
+  ::fts_close(tree);
+
+  return Bytes(blocks * 512);
+}
+
+
+#ifdef ENABLE_XFS_DISK_ISOLATOR
+// Returns the disk space used by the directory from its XFS project
+// quota, or none if the directory is not the root of a project (e.g.,
+// sandboxes and persistent volumes are when the `disk/xfs` isolator is
+// also used). The kernel keeps track of the usage of each project, so
+// this does not need to walk the directory at all.
+static Result<Bytes> projectUsage(const string& path)
+{
+  if (!os::stat::isdir(path) || !xfs::isPathXfs(path)) {
+    return None();
+  }
+
+  Try<bool> enabled = xfs::isQuotaEnabled(path);
+  if (enabled.isError() || !enabled.get()) {
+    return None();
+  }
+
+  Result<string> realpath = os::realpath(path);
+  if (!realpath.isSome()) {
+    return None();
+  }
+
+  Result<prid_t> projectId = xfs::getProjectId(realpath.get());
+  if (!projectId.isSome()) {
+    return None();
+  }
+
+  // Directories inherit the project ID of their parent, in which case
+  // the usage of the project also includes files outside of the path.
+  Result<prid_t> parentId =
+    xfs::getProjectId(Path(realpath.get()).dirname());
+
+  if (parentId.isError() ||
+      (parentId.isSome() && parentId.get() == projectId.get())) {
+    return None();
+  }
+
+  Result<xfs::QuotaInfo> quota =
+    xfs::getProjectQuota(realpath.get(), projectId.get());
+
+  if (quota.isError()) {
+    return Error(quota.error());
+  } else if (quota.isNone()) {
+    return None();
+  }
+
+  return quota->used;
+}
+#endif // ENABLE_XFS_DISK_ISOLATOR
+
+
+// Walks the directory trees (see above) on a thread of its own, so that
+// the walk does not block a libprocess worker thread.
+static Future<Try<Bytes>> spawn(
+    const vector<string>& roots,
+    const vector<string>& excludes,
+    const std::shared_ptr<HardLinks>& hardLinks,
+    const std::shared_ptr<std::atomic_bool>& cancelled)
+{
+  std::shared_ptr<Promise<Try<Bytes>>> promise(new Promise<Try<Bytes>>());
+  Future<Try<Bytes>> future = promise->future();
+
+  // NOTE: The thread is detached since it only holds shared state. If
+  // the collector is terminated, the walk stops at the next entry.
+  try {
+    std::thread([=]() {
+      promise->set(walk(roots, excludes, hardLinks, cancelled));
+    }).detach();
+  } catch (const std::system_error& e) {
+    return Failure("Failed to create walker thread: " + string(e.what()));
+  }
+
+  return future;
+}
+
+
+// Returns the disk space used by the path like `du -s` would, which
+// means that symbolic links are not followed unless the path itself
+// is a symbolic link given with a trailing slash. The subdirectories
+// of the path are walked concurrently.
+static Future<Bytes> walk(
+    const string& path,
+    const vector<string>& excludes,
+    const std::shared_ptr<std::atomic_bool>& cancelled)
+{
+  struct stat s;
+
+  // NOTE: `lstat` follows a symbolic link given with a trailing slash.
+  if (::lstat(path.c_str(), &s) < 0) {
+    return Failure(ErrnoError("Failed to stat '" + path + "'").message);
+  }
+
+  const Bytes used(static_cast<uint64_t>(s.st_blocks) * 512);
+
+  if (!S_ISDIR(s.st_mode)) {
+    return used;
+  }
+
+  Try<std::list<string>> entries = os::ls(path);
+  if (entries.isError()) {
+    return Failure(
+        "Failed to list directory '" + path + "': " + entries.error());
+  }
+
+  // Distribute the entries of the directory among the walkers.
+  vector<vector<string>> roots(
+      std::min(DISK_USAGE_WALKERS, std::max<size_t>(entries->size(), 1)));
+
+  size_t index = 0;
+  foreach (const string& entry, entries.get()) {
+    roots[index++ % roots.size()].push_back(path::join(path, entry));
+  }
+
+  std::shared_ptr<HardLinks> hardLinks(new HardLinks());
+
+  vector<Future<Try<Bytes>>> futures;
+  foreach (const vector<string>& _roots, roots) {
+    if (!_roots.empty()) {
+      futures.push_back(spawn(_roots, excludes, hardLinks, cancelled));
+    }
+  }
+
+  return process::collect(futures)
+    .then([used](const vector<Try<Bytes>>& results) -> Future<Bytes> {
+      Bytes total = used;
+
+      foreach (const Try<Bytes>& result, results) {
+        if (result.isError()) {
+          return Failure(result.error());
+        }
+
+        total += result.get();
+      }
+
+      return total;
+    });
+}
+#else
+static Future<Bytes> walk(
+    const string& path,
+    const vector<string>& excludes,
+    const std::shared_ptr<std::atomic_bool>& cancelled)
+{
+  return Failure("Walking directory trees is not supported on Windows");
+}
+#endif // __WINDOWS__
+
+
 class DiskUsageCollectorProcess : public Process<DiskUsageCollectorProcess>
 {
 public:
   DiskUsageCollectorProcess(const Duration& _interval)
     : ProcessBase(process::ID::generate("posix-disk-usage-collector")),
-      interval(_interval) {}
+      interval(_interval),
+      cancelled(new std::atomic_bool(false)) {}
+
   ~DiskUsageCollectorProcess() override {}
 
   Future<Bytes> usage(
       const string& path,
       const vector<string>& excludes)
   {
-    // TODO(jieyu): 'excludes' is not supported on OSX. We should
-    // either return a Failure here, or does not allow 'excludes' to
-    // be specified on OSX.
-
     foreach (const Owned<Entry>& entry, entries) {
       if (entry->path == path) {
         return entry->promise.future();
@@ -499,11 +787,10 @@ protected:
 
   void finalize() override
   {
-    foreach (const Owned<Entry>& entry, entries) {
-      if (entry->du.isSome() && entry->du->status().isPending()) {
-        os::killtree(entry->du->pid(), SIGKILL);
-      }
+    // Stop the walks which are still in progress.
+    cancelled->store(true);
 
+    foreach (const Owned<Entry>& entry, entries) {
       entry->promise.fail("DiskUsageCollector is destroyed");
     }
   }
@@ -514,19 +801,20 @@ private:
   {
     explicit Entry(const string& _path, const vector<string>& _excludes)
       : path(_path),
-        excludes(_excludes) {}
+        excludes(_excludes),
+        started(false) {}
 
     string path;
     vector<string> excludes;
-    Option<Subprocess> du;
+    bool started;
     Promise<Bytes> promise;
   };
 
   void discard(const string& path)
   {
     for (auto it = entries.begin(); it != entries.end(); ++it) {
-      // We only cancel those checks whose 'du' haven't been launched.
-      if ((*it)->path == path && (*it)->du.isNone()) {
+      // We only cancel those checks which haven't been started.
+      if ((*it)->path == path && !(*it)->started) {
         (*it)->promise.discard();
         entries.erase(it);
         break;
@@ -534,9 +822,9 @@ private:
     }
   }
 
-  // Schedule a 'du' to be invoked. The current implementation does
-  // not allow multiple 'du's running concurrently. The minimal
-  // interval between two subsequent 'du's is controlled by 'interval'
+  // Schedule a check to be performed. The current implementation does
+  // not allow multiple checks running concurrently. The minimal
+  // interval between two subsequent checks is controlled by 'interval'
   // for throttling purpose.
   void schedule()
   {
@@ -546,117 +834,48 @@ private:
     }
 
     const Owned<Entry>& entry = entries.front();
+    entry->started = true;
+
+#ifdef ENABLE_XFS_DISK_ISOLATOR
+    // The excluded paths of a project are not part of its usage if
+    // they are persistent volumes which are projects of their own, so
+    // the project quota is only used if nothing needs to be excluded.
+    if (entry->excludes.empty()) {
+      Result<Bytes> used = projectUsage(entry->path);
+      if (used.isSome()) {
+        _schedule(used.get());
+        return;
+      }
 
-    // Invoke 'du' and report number of 1K-byte blocks. We fix the
-    // block size here so that we can get consistent results on all
-    // platforms (e.g., OS X uses 512 byte blocks).
-    //
-    // NOTE: The 'du' processes are run in the slave's cgroup and it
-    // will be that cgroup that is charged for (a) memory to cache the
-    // fs data structures, (b) disk I/O to read those structures, and
-    // (c) the cpu time to traverse.
-
-    // Construct the 'du' command.
-    vector<string> command = {
-      "du",
-      "-k", // Use 1K size blocks for consistent results across platforms.
-      "-s", // Use 'silent' output mode.
-    };
-
-#ifdef __linux__
-    // Add paths that need to be excluded.
-    foreach (const string& exclude, entry->excludes) {
-      command.push_back("--exclude");
-      command.push_back(exclude);
-    }
-#endif
-
-    // Add path on which 'du' must be run.
-    command.push_back(entry->path);
-
-    // NOTE: The supervisor childhook will watch the parent process and kill
-    // the 'du' process in case that the parent die.
-    Try<Subprocess> s = subprocess(
-        "du",
-        command,
-        Subprocess::PATH(os::DEV_NULL),
-        Subprocess::PIPE(),
-        Subprocess::PIPE(),
-        nullptr,
-        None(),
-        None(),
-        {},
-        {Subprocess::ChildHook::SUPERVISOR()});
-
-    if (s.isError()) {
-      entry->promise.fail("Failed to exec 'du': " + s.error());
-
-      entries.pop_front();
-      delay(interval, self(), &Self::schedule);
-      return;
+      if (used.isError()) {
+        LOG(WARNING) << "Failed to get the project quota usage of '"
+                     << entry->path << "': " << used.error();
+      }
     }
+#endif // ENABLE_XFS_DISK_ISOLATOR
 
-    entry->du = s.get();
-
-    await(s->status(),
-          io::read(s->out().get()),
-          io::read(s->err().get()))
+    // NOTE: The directory tree is walked by threads of the agent, so
+    // it is the agent's cgroup that is charged for (a) memory to cache
+    // the fs data structures, (b) disk I/O to read those structures,
+    // and (c) the cpu time to traverse.
+    walk(entry->path, entry->excludes, cancelled)
       .onAny(defer(self(), &Self::_schedule, lambda::_1));
   }
 
-  void _schedule(const Future<std::tuple<
-      Future<Option<int>>,
-      Future<string>,
-      Future<string>>>& future)
+  void _schedule(const Future<Bytes>& future)
   {
-    CHECK_READY(future);
     CHECK(!entries.empty());
 
     const Owned<Entry>& entry = entries.front();
-    CHECK_SOME(entry->du);
-
-    const Future<Option<int>>& status = std::get<0>(future.get());
+    CHECK(entry->started);
 
-    if (!status.isReady()) {
-      entry->promise.fail(
-          "Failed to perform 'du': " +
-          (status.isFailed() ? status.failure() : "discarded"));
-    } else if (status->isNone()) {
-      entry->promise.fail("Failed to reap the status of 'du'");
-    } else if (status->get() != 0) {
-      const Future<string>& error = std::get<2>(future.get());
-      if (!error.isReady()) {
-        entry->promise.fail(
-            "Failed to perform 'du'. Reading stderr failed: " +
-            (error.isFailed() ? error.failure() : "discarded"));
-      } else {
-        entry->promise.fail("Failed to perform 'du': " + error.get());
-      }
+    if (future.isReady()) {
+      // Notify the callers.
+      entry->promise.set(future.get());
     } else {
-      const Future<string>& output = std::get<1>(future.get());
-      if (!output.isReady()) {
-        entry->promise.fail(
-            "Failed to read stdout from 'du': " +
-            (output.isFailed() ? output.failure() : "discarded"));
-      } else {
-        // Parsing the output from 'du'. The following is a sample
-        // output. Tab is used as the delimiter between the number of
-        // blocks and the checked path.
-        // $ du /var/lib/mesos/.../runs/container_id
-        // 1024   /var/lib/mesos/.../runs/container_id
-        vector<string> tokens = strings::tokenize(output.get(), " \t");
-        if (tokens.empty()) {
-          entry->promise.fail("Unexpected output from 'du': " + output.get());
-        } else {
-          Try<size_t> value = numify<size_t>(tokens[0]);
-          if (value.isError()) {
-            entry->promise.fail("Unexpected output from 'du': " + output.get());
-          } else {
-            // Notify the callers.
-            entry->promise.set(Kilobytes(value.get()));
-          }
-        }
-      }
+      entry->promise.fail(
+          "Failed to collect the disk usage of '" + entry->path + "': " +
+          (future.isFailed() ? future.failure() : "discarded"));
     }
 
     entries.pop_front();
@@ -665,6 +884,9 @@ private:
 
   const Duration interval;
 
+  // Set when the process is terminated to stop the walks in progress.
+  const std::shared_ptr<std::atomic_bool> cancelled;
+
   // A queue of pending checks.
   deque<Owned<Entry>> entries;
 };
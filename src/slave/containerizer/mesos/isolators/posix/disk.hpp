@@ -38,7 +38,10 @@ class DiskUsageCollectorProcess;
 
 
 // Responsible for collecting disk usage for paths, while ensuring
-// that an interval elapses between each collection.
+// that an interval elapses between each collection. The usage of a
+// path is read from its XFS project quota when the path is the root
+// of a project, otherwise the directory tree is walked in-process by
+// a few threads (counting what `du -s` would).
 class DiskUsageCollector
 {
 public:
@@ -59,8 +62,8 @@ private:
 // This isolator monitors the disk usage for containers, and reports
 // ContainerLimitation when a container exceeds its disk quota. This
 // leverages the DiskUsageCollector to ensure that we don't induce too
-// much CPU usage and disk caching effects from running 'du' too
-// often.
+// much CPU usage and disk caching effects from walking the sandboxes
+// too often.
 //
 // NOTE: Currently all containers are processed in the same queue,
 // which means that when a container starts, it could take many disk
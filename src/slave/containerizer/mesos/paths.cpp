@@ -261,6 +261,16 @@ Result<unix::Address> getContainerIOSwitchboardAddress(
 }
 
 
+string getContainerIOSwitchboardStatisticsPath(
+    const string& runtimeDir,
+    const ContainerID& containerId)
+{
+  return path::join(
+      getContainerIOSwitchboardPath(runtimeDir, containerId),
+      STATISTICS_FILE);
+}
+
+
 string getHostProcMountPointPath(
     const string& runtimeDir,
     const ContainerID& containerId)
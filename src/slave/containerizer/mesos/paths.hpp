@@ -59,6 +59,7 @@ namespace paths {
 //           |-- io_switchboard
 //           |   |-- pid
 //           |   |-- socket
+//           |   |-- statistics
 //           |-- launch_info
 //           |-- mnt
 //           |   |-- host_proc
@@ -73,6 +74,7 @@ constexpr char CONTAINER_CONFIG_FILE[] = "config";
 constexpr char STATUS_FILE[] = "status";
 constexpr char TERMINATION_FILE[] = "termination";
 constexpr char SOCKET_FILE[] = "socket";
+constexpr char STATISTICS_FILE[] = "statistics";
 constexpr char FORCE_DESTROY_ON_RECOVERY_FILE[] = "force_destroy_on_recovery";
 constexpr char IO_SWITCHBOARD_DIRECTORY[] = "io_switchboard";
 constexpr char MNT_DIRECTORY[] = "mnt";
@@ -178,6 +180,12 @@ Result<process::network::unix::Address> getContainerIOSwitchboardAddress(
     const std::string& runtimeDir,
     const ContainerID& containerId);
 
+
+// The helper method to get the io switchboard statistics file path.
+std::string getContainerIOSwitchboardStatisticsPath(
+    const std::string& runtimeDir,
+    const ContainerID& containerId);
+
 // The helper method to get the host proc mount point path.
 std::string getHostProcMountPointPath(
     const std::string& runtimeDir,
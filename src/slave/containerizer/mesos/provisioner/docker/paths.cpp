@@ -100,6 +100,12 @@ string getImageLayerTarPath(const string& storeDir, const string& layerId)
 }
 
 
+string getImageLayerBlobPath(const string& layerPath, const string& digest)
+{
+  return path::join(layerPath, digest);
+}
+
+
 string getImageArchiveTarPath(const string& discoveryDir, const string& name)
 {
   return path::join(discoveryDir, name + ".tar");
@@ -42,6 +42,7 @@ namespace paths {
  *           |-- rootfs
  *           |-- json(manifest)
  *           |-- VERSION
+ *           |-- <digest> (layer tar ball, kept if shared with peers)
  *    |--storedImages (file holding on cached images)
  *    |--gc (dir holding marked layers to be sweeped)
  */
@@ -87,6 +88,11 @@ std::string getImageLayerTarPath(
     const std::string& layerId);
 
 
+std::string getImageLayerBlobPath(
+    const std::string& layerPath,
+    const std::string& digest);
+
+
 std::string getImageArchiveTarPath(
     const std::string& discoveryDir,
     const std::string& name);
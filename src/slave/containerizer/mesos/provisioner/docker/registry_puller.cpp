@@ -33,6 +33,8 @@
 
 #include "uri/schemes/docker.hpp"
 
+#include "slave/artifacts.hpp"
+
 #include "slave/containerizer/mesos/provisioner/docker/paths.hpp"
 #include "slave/containerizer/mesos/provisioner/docker/registry_puller.hpp"
 
@@ -65,7 +67,8 @@ public:
       const string& _storeDir,
       const http::URL& _defaultRegistryUrl,
       const Shared<uri::Fetcher>& _fetcher,
-      SecretResolver* _secretResolver);
+      SecretResolver* _secretResolver,
+      const Option<Owned<PeerFetcher>>& _peers);
 
   Future<Image> pull(
       const spec::ImageReference& reference,
@@ -121,6 +124,21 @@ private:
       const string& backend,
       const Option<Secret::Value>& config);
 
+  // Fetches the blob with the given digest into `directory`, from the
+  // peers of this agent if possible.
+  Future<Nothing> fetchBlob(
+      const URI& blobUri,
+      const string& digest,
+      const string& directory,
+      const Option<Secret::Value>& config);
+
+  // Removes a layer tar ball after its extraction, or keeps it in the
+  // layer directory to serve it to peers.
+  Try<Nothing> removeBlob(
+      const string& tar,
+      const string& digest,
+      const Option<string>& layerPath);
+
   RegistryPullerProcess(const RegistryPullerProcess&) = delete;
   RegistryPullerProcess& operator=(const RegistryPullerProcess&) = delete;
 
@@ -132,6 +150,9 @@ private:
 
   Shared<uri::Fetcher> fetcher;
   SecretResolver* secretResolver;
+
+  // Set if artifacts are distributed between agents.
+  const Option<Owned<PeerFetcher>> peers;
 };
 
 
@@ -150,12 +171,23 @@ Try<Owned<Puller>> RegistryPuller::create(
   VLOG(1) << "Creating registry puller with docker registry '"
           << flags.docker_registry << "'";
 
+  Option<Owned<PeerFetcher>> peers;
+  if (flags.artifact_peers.isSome()) {
+    Try<Owned<PeerFetcher>> peerFetcher = PeerFetcher::create(flags);
+    if (peerFetcher.isError()) {
+      return Error("Failed to create peer fetcher: " + peerFetcher.error());
+    }
+
+    peers = peerFetcher.get();
+  }
+
   Owned<RegistryPullerProcess> process(
       new RegistryPullerProcess(
           flags.docker_store_dir,
           defaultRegistryUrl.get(),
           fetcher,
-          secretResolver));
+          secretResolver,
+          peers));
 
   return Owned<Puller>(new RegistryPuller(process));
 }
@@ -195,12 +227,14 @@ RegistryPullerProcess::RegistryPullerProcess(
     const string& _storeDir,
     const http::URL& _defaultRegistryUrl,
     const Shared<uri::Fetcher>& _fetcher,
-    SecretResolver* _secretResolver)
+    SecretResolver* _secretResolver,
+    const Option<Owned<PeerFetcher>>& _peers)
   : ProcessBase(process::ID::generate("docker-provisioner-registry-puller")),
     storeDir(_storeDir),
     defaultRegistryUrl(_defaultRegistryUrl),
     fetcher(_fetcher),
-    secretResolver(_secretResolver) {}
+    secretResolver(_secretResolver),
+    peers(_peers) {}
 
 
 static spec::ImageReference normalize(
@@ -423,6 +457,9 @@ Future<Image> RegistryPullerProcess::___pull(
   vector<string> layerIds;
   vector<Future<Nothing>> futures;
 
+  // The layer directory each extracted tar ball can be kept in.
+  hashmap<string, string> blobLayers;
+
   // The order of `fslayers` should be [child, parent, ...].
   //
   // The content in the parent will be overwritten by the child if
@@ -454,6 +491,10 @@ Future<Image> RegistryPullerProcess::___pull(
     const string rootfs = paths::getImageLayerRootfsPath(layerPath, backend);
     const string json = paths::getImageLayerManifestPath(layerPath);
 
+    if (!blobLayers.contains(blobSum)) {
+      blobLayers[blobSum] = layerPath;
+    }
+
     VLOG(1) << "Extracting layer tar ball '" << tar
             << " to rootfs '" << rootfs << "'";
 
@@ -481,7 +522,7 @@ Future<Image> RegistryPullerProcess::___pull(
       foreach (const string& blobSum, blobSums) {
         const string tar = path::join(directory, blobSum);
 
-        Try<Nothing> rm = os::rm(tar);
+        Try<Nothing> rm = removeBlob(tar, blobSum, blobLayers.get(blobSum));
         if (rm.isError()) {
           return Failure(
               "Failed to remove '" + tar + "' "
@@ -511,6 +552,9 @@ Future<Image> RegistryPullerProcess::____pull(
   vector<string> layerIds;
   vector<Future<Nothing>> futures;
 
+  // The layer directory each extracted tar ball can be kept in.
+  hashmap<string, string> blobLayers;
+
   for (int i = 0; i < manifest.layers_size(); i++) {
     const string& digest = manifest.layers(i).digest();
     if (uniqueIds.contains(digest)) {
@@ -530,6 +574,8 @@ Future<Image> RegistryPullerProcess::____pull(
     const string tar = path::join(directory, digest + "-archive");
     const string rootfs = paths::getImageLayerRootfsPath(layerPath, backend);
 
+    blobLayers[digest] = layerPath;
+
     VLOG(1) << "Moving layer tar ball '" << originalTar
             << "' to '" << tar << "'";
 
@@ -566,7 +612,7 @@ Future<Image> RegistryPullerProcess::____pull(
 
         const string tar = path::join(directory, digest + "-archive");
 
-        Try<Nothing> rm = os::rm(tar);
+        Try<Nothing> rm = removeBlob(tar, digest, blobLayers.get(digest));
         if (rm.isError()) {
           return Failure(
               "Failed to remove '" + tar + "' after extraction: " + rm.error());
@@ -710,16 +756,65 @@ Future<hashset<string>> RegistryPullerProcess::fetchBlobs(
           port);
     }
 
-    futures.push_back(fetcher->fetch(
-        blobUri,
-        directory,
-        config.isSome() ? config->data() : Option<string>()));
+    futures.push_back(fetchBlob(blobUri, digest, directory, config));
   }
 
   return collect(futures)
     .then([digests]() -> hashset<string> { return digests; });
 }
 
+
+Future<Nothing> RegistryPullerProcess::fetchBlob(
+    const URI& blobUri,
+    const string& digest,
+    const string& directory,
+    const Option<Secret::Value>& config)
+{
+  Shared<uri::Fetcher> fetcher = this->fetcher;
+
+  auto origin = [=]() {
+    return fetcher->fetch(
+        blobUri,
+        directory,
+        config.isSome() ? config->data() : Option<string>());
+  };
+
+  if (peers.isNone()) {
+    return origin();
+  }
+
+  return peers.get()->fetch(digest, path::join(directory, digest))
+    .repair([=](const Future<Nothing>& future) {
+      VLOG(1) << "Fetching blob '" << digest << "' from the registry: "
+              << (future.isFailed() ? future.failure() : "discarded");
+
+      return origin();
+    });
+}
+
+
+Try<Nothing> RegistryPullerProcess::removeBlob(
+    const string& tar,
+    const string& digest,
+    const Option<string>& layerPath)
+{
+  if (peers.isSome() && layerPath.isSome()) {
+    // The store moves the whole layer directory, including the tar
+    // ball, into the store, from where `ArtifactServer` serves it.
+    const string blob = paths::getImageLayerBlobPath(layerPath.get(), digest);
+
+    Try<Nothing> rename = os::rename(tar, blob);
+    if (rename.isSome()) {
+      return Nothing();
+    }
+
+    LOG(WARNING) << "Failed to keep layer tar ball '" << tar << "' as '"
+                 << blob << "': " << rename.error();
+  }
+
+  return os::rm(tar);
+}
+
 } // namespace docker {
 } // namespace slave {
 } // namespace internal {
@@ -52,6 +52,10 @@ namespace paths {
 // There can be multiple backends due to the change of backend flags.
 // Under each backend a rootfs is identified by the 'rootfs_id' which
 // is a UUID.
+//
+// Rootfses provisioned ahead of time (see '--container_pool_config')
+// belong to containers with IDs 'pool-<uuid>' until they are claimed,
+// when the container directory is renamed after the claiming container.
 
 
 constexpr char LAYERS_FILE[] = "layers";
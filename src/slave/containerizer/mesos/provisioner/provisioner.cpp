@@ -38,6 +38,7 @@
 #include <stout/uuid.hpp>
 
 #include <stout/os/realpath.hpp>
+#include <stout/os/rename.hpp>
 
 #ifdef __linux__
 #include "linux/fs.hpp"
@@ -188,6 +189,37 @@ static Try<Nothing> validateBackend(
 }
 
 
+// Returns the key of the container pool for the image, or none if the
+// image cannot be pooled. Images are pooled by their reference only,
+// like they are cached by their stores.
+static Option<string> getPoolKey(const Image& image)
+{
+  if (!image.cached()) {
+    return None();
+  }
+
+  switch (image.type()) {
+    case Image::DOCKER:
+      return "DOCKER:" + image.docker().name();
+    case Image::APPC: {
+      string key = "APPC:" + image.appc().name();
+
+      if (image.appc().has_id()) {
+        key += "@" + image.appc().id();
+      }
+
+      foreach (const Label& label, image.appc().labels().labels()) {
+        key += ";" + label.key() + "=" + label.value();
+      }
+
+      return key;
+    }
+  }
+
+  return None();
+}
+
+
 Try<Owned<Provisioner>> Provisioner::create(
     const Flags& flags,
     SecretResolver* secretResolver)
@@ -217,6 +249,17 @@ Try<Owned<Provisioner>> Provisioner::create(
     return Error("Failed to create image stores: " + stores.error());
   }
 
+  if (flags.container_pool_config.isSome()) {
+    foreach (const ContainerPoolConfig::Entry& entry,
+             flags.container_pool_config->entries()) {
+      if (!stores->contains(entry.image().type())) {
+        return Error(
+            "Unsupported image type '" + stringify(entry.image().type()) +
+            "' in '--container_pool_config'");
+      }
+    }
+  }
+
   hashmap<string, Owned<Backend>> backends = Backend::create(flags);
   if (backends.empty()) {
     return Error("No usable provisioner backend created");
@@ -302,7 +345,8 @@ Try<Owned<Provisioner>> Provisioner::create(
           rootDir.get(),
           defaultBackend.get(),
           stores.get(),
-          backends))));
+          backends,
+          flags.container_pool_config))));
 }
 
 
@@ -367,12 +411,28 @@ ProvisionerProcess::ProvisionerProcess(
     const string& _rootDir,
     const string& _defaultBackend,
     const hashmap<Image::Type, Owned<Store>>& _stores,
-    const hashmap<string, Owned<Backend>>& _backends)
+    const hashmap<string, Owned<Backend>>& _backends,
+    const Option<ContainerPoolConfig>& poolConfig)
   : ProcessBase(process::ID::generate("mesos-provisioner")),
     rootDir(_rootDir),
     defaultBackend(_defaultBackend),
     stores(_stores),
-    backends(_backends) {}
+    backends(_backends)
+{
+  if (poolConfig.isSome()) {
+    foreach (const ContainerPoolConfig::Entry& entry, poolConfig->entries()) {
+      Option<string> key = getPoolKey(entry.image());
+      if (key.isNone()) {
+        LOG(WARNING) << "Ignoring image " << entry.image().ShortDebugString()
+                     << " which cannot be pooled";
+        continue;
+      }
+
+      pools[key.get()].image = entry.image();
+      pools[key.get()].size += entry.size();
+    }
+  }
+}
 
 
 Future<Nothing> ProvisionerProcess::recover(
@@ -494,10 +554,17 @@ Future<Nothing> ProvisionerProcess::recover(
   // in 'store', which might fail if there still exist unknown
   // containers holding references to them.
   return collect(cleanup, recover)
-    .then([=]() -> Future<Nothing> {
+    .then(defer(self(), [=]() -> Future<Nothing> {
       LOG(INFO) << "Provisioner recovery complete";
+
+      // The pools are filled once the rootfses pooled by a previous
+      // agent, if any, have been destroyed above.
+      foreachkey (const string& key, pools) {
+        refill(key);
+      }
+
       return Nothing();
-    });
+    }));
 }
 
 
@@ -509,20 +576,12 @@ Future<ProvisionInfo> ProvisionerProcess::provision(
   // is exclusive.
   return rwLock.read_lock()
     .then(defer(self(), [this, containerId, image]() -> Future<ProvisionInfo> {
-      if (!stores.contains(image.type())) {
-        return Failure(
-            "Unsupported container image type: " + stringify(image.type()));
+      Option<ProvisionInfo> provisionInfo = claim(containerId, image);
+      if (provisionInfo.isSome()) {
+        return provisionInfo.get();
       }
 
-      // Get and then provision image layers from the store.
-      return stores.get(image.type()).get()->get(image, defaultBackend)
-        .then(defer(
-            self(),
-            &Self::_provision,
-            containerId,
-            image,
-            defaultBackend,
-            lambda::_1));
+      return provisionImage(containerId, image);
     }))
     .onAny(defer(self(), [this](const Future<ProvisionInfo>&) {
       rwLock.read_unlock();
@@ -530,6 +589,27 @@ Future<ProvisionInfo> ProvisionerProcess::provision(
 }
 
 
+Future<ProvisionInfo> ProvisionerProcess::provisionImage(
+    const ContainerID& containerId,
+    const Image& image)
+{
+  if (!stores.contains(image.type())) {
+    return Failure(
+        "Unsupported container image type: " + stringify(image.type()));
+  }
+
+  // Get and then provision image layers from the store.
+  return stores.get(image.type()).get()->get(image, defaultBackend)
+    .then(defer(
+        self(),
+        &Self::_provision,
+        containerId,
+        image,
+        defaultBackend,
+        lambda::_1));
+}
+
+
 Future<ProvisionInfo> ProvisionerProcess::_provision(
     const ContainerID& containerId,
     const Image& image,
@@ -599,6 +679,143 @@ Future<ProvisionInfo> ProvisionerProcess::_provision(
 }
 
 
+Option<ProvisionInfo> ProvisionerProcess::claim(
+    const ContainerID& containerId,
+    const Image& image)
+{
+  const Option<string> key = getPoolKey(image);
+  if (key.isNone() || !pools.contains(key.get())) {
+    return None();
+  }
+
+  Pool& pool = pools.at(key.get());
+
+  const string containerDir =
+    provisioner::paths::getContainerDir(rootDir, containerId);
+
+  // Only the first image provisioned for a container can be claimed
+  // from a pool, since the container directory must not exist yet.
+  if (pool.ready.empty() ||
+      infos.contains(containerId) ||
+      os::exists(containerDir)) {
+    refill(key.get());
+    return None();
+  }
+
+  const ContainerID pooledContainerId = pool.ready.front().first;
+  ProvisionInfo provisionInfo = pool.ready.front().second;
+  pool.ready.pop_front();
+
+  refill(key.get());
+
+  CHECK(infos.contains(pooledContainerId));
+
+  const string pooledContainerDir =
+    provisioner::paths::getContainerDir(rootDir, pooledContainerId);
+
+  // NOTE: Mounts of the rootfs (e.g., by the overlay backend) are
+  // moved along with the directory.
+  Try<Nothing> mkdir = os::mkdir(Path(containerDir).dirname());
+  if (mkdir.isError()) {
+    LOG(WARNING) << "Failed to create the parent directory of '"
+                 << containerDir << "': " << mkdir.error();
+
+    destroy(pooledContainerId);
+    return None();
+  }
+
+  Try<Nothing> rename = os::rename(pooledContainerDir, containerDir);
+  if (rename.isError()) {
+    LOG(WARNING) << "Failed to move the pooled container directory '"
+                 << pooledContainerDir << "' to '" << containerDir
+                 << "': " << rename.error();
+
+    destroy(pooledContainerId);
+    return None();
+  }
+
+  Owned<Info> info = infos.at(pooledContainerId);
+  infos.erase(pooledContainerId);
+  infos.put(containerId, info);
+
+  CHECK_EQ(1u, info->rootfses.size());
+  CHECK_EQ(1u, info->rootfses.begin()->second.size());
+
+  provisionInfo.rootfs = provisioner::paths::getContainerRootfsDir(
+      rootDir,
+      containerId,
+      info->rootfses.begin()->first,
+      *info->rootfses.begin()->second.begin());
+
+  LOG(INFO) << "Claimed pooled image rootfs '" << provisionInfo.rootfs
+            << "' for container " << containerId;
+
+  ++metrics.pool_claims;
+
+  return provisionInfo;
+}
+
+
+void ProvisionerProcess::refill(const string& key)
+{
+  CHECK(pools.contains(key));
+
+  Pool& pool = pools.at(key);
+
+  while (pool.ready.size() + pool.pending < pool.size) {
+    ContainerID containerId;
+    containerId.set_value("pool-" + id::UUID::random().toString());
+
+    VLOG(1) << "Provisioning pooled image rootfs for container "
+            << containerId;
+
+    pool.pending++;
+
+    // NOTE: The pooled rootfses are provisioned directly rather than
+    // through `provision()`, so that they never claim from a pool.
+    rwLock.read_lock()
+      .then(defer(self(), &Self::provisionImage, containerId, pool.image))
+      .onAny(defer(self(), [this](const Future<ProvisionInfo>&) {
+        rwLock.read_unlock();
+      }))
+      .onAny(defer(self(), &Self::_refill, key, containerId, lambda::_1));
+  }
+}
+
+
+void ProvisionerProcess::_refill(
+    const string& key,
+    const ContainerID& containerId,
+    const Future<ProvisionInfo>& provisionInfo)
+{
+  CHECK(pools.contains(key));
+
+  Pool& pool = pools.at(key);
+
+  CHECK_GT(pool.pending, 0u);
+  pool.pending--;
+
+  if (!provisionInfo.isReady()) {
+    // The pool is refilled again when a container next asks for the
+    // image, so a failing image does not keep being provisioned.
+    LOG(WARNING) << "Failed to provision pooled image rootfs for container "
+                 << containerId << ": "
+                 << (provisionInfo.isFailed()
+                       ? provisionInfo.failure()
+                       : "discarded");
+
+    ++metrics.pool_refill_errors;
+
+    destroy(containerId);
+    return;
+  }
+
+  ++metrics.pool_refills;
+
+  pool.ready.push_back(std::make_pair(containerId, provisionInfo.get()));
+}
+
+
 Future<bool> ProvisionerProcess::destroy(const ContainerID& containerId)
 {
   // `destroy` and `provision` can happen concurrently, but `pruneImages`
@@ -797,15 +1014,27 @@ Future<Nothing> ProvisionerProcess::pruneImages(
 
 ProvisionerProcess::Metrics::Metrics()
   : remove_container_errors(
-      "containerizer/mesos/provisioner/remove_container_errors")
+      "containerizer/mesos/provisioner/remove_container_errors"),
+    pool_claims(
+      "containerizer/mesos/provisioner/pool_claims"),
+    pool_refills(
+      "containerizer/mesos/provisioner/pool_refills"),
+    pool_refill_errors(
+      "containerizer/mesos/provisioner/pool_refill_errors")
 {
   process::metrics::add(remove_container_errors);
+  process::metrics::add(pool_claims);
+  process::metrics::add(pool_refills);
+  process::metrics::add(pool_refill_errors);
 }
 
 
 ProvisionerProcess::Metrics::~Metrics()
 {
   process::metrics::remove(remove_container_errors);
+  process::metrics::remove(pool_claims);
+  process::metrics::remove(pool_refills);
+  process::metrics::remove(pool_refill_errors);
 }
 
 } // namespace slave {
@@ -17,6 +17,9 @@
 #ifndef __PROVISIONER_HPP__
 #define __PROVISIONER_HPP__
 
+#include <deque>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include <mesos/resources.hpp>
@@ -128,7 +131,8 @@ public:
       const std::string& rootDir,
       const std::string& defaultBackend,
       const hashmap<Image::Type, process::Owned<Store>>& stores,
-      const hashmap<std::string, process::Owned<Backend>>& backends);
+      const hashmap<std::string, process::Owned<Backend>>& backends,
+      const Option<ContainerPoolConfig>& poolConfig = None());
 
   process::Future<Nothing> recover(
       const hashset<ContainerID>& knownContainerIds);
@@ -142,13 +146,38 @@ public:
   process::Future<Nothing> pruneImages(
       const std::vector<Image>& excludedImages);
 
+  // Adds the provisioned rootfs to the pool with the given key.
+  // Public for testing.
+  void _refill(
+      const std::string& key,
+      const ContainerID& containerId,
+      const process::Future<ProvisionInfo>& provisionInfo);
+
 private:
+  // Gets the image from its store and provisions a new rootfs of it.
+  process::Future<ProvisionInfo> provisionImage(
+      const ContainerID& containerId,
+      const Image& image);
+
   process::Future<ProvisionInfo> _provision(
       const ContainerID& containerId,
       const Image& image,
       const std::string& backend,
       const ImageInfo& imageInfo);
 
+  // Hands a pooled rootfs of the image over to the container by moving
+  // the directory of the pooled container to that of the container.
+  // Returns none if there is no pooled rootfs for the container.
+  Option<ProvisionInfo> claim(
+      const ContainerID& containerId,
+      const Image& image);
+
+  // Provisions rootfses for the pool with the given key until it is
+  // full again. A pooled rootfs is provisioned for a container which
+  // is not known to the containerizer, so pooled rootfses left behind
+  // by a previous agent are destroyed during recovery.
+  void refill(const std::string& key);
+
   process::Future<bool> _destroy(
       const ContainerID& containerId,
       const std::vector<process::Future<bool>>& destroys);
@@ -189,12 +218,32 @@ private:
 
   hashmap<ContainerID, process::Owned<Info>> infos;
 
+  // The rootfses which are provisioned ahead of time for an image, see
+  // `--container_pool_config`.
+  struct Pool
+  {
+    Image image;
+    size_t size = 0;
+
+    // The pooled containers and their provisioned rootfses, in the
+    // order in which they were provisioned.
+    std::deque<std::pair<ContainerID, ProvisionInfo>> ready;
+
+    // The number of rootfses which are being provisioned.
+    size_t pending = 0;
+  };
+
+  hashmap<std::string, Pool> pools;
+
   struct Metrics
   {
     Metrics();
     ~Metrics();
 
     process::metrics::Counter remove_container_errors;
+    process::metrics::Counter pool_claims;
+    process::metrics::Counter pool_refills;
+    process::metrics::Counter pool_refill_errors;
   } metrics;
 
   // This `ReadWriteLock` instance is used to protect the critical
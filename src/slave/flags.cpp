@@ -191,6 +191,44 @@ mesos::internal::slave::Flags::Flags()
       "  \"excluded_images\": []\n"
       "}");
 
+  add(&Flags::container_pool_config,
+      "container_pool_config",
+      "JSON-formatted configuration of the container root filesystems which\n"
+      "the Mesos containerizer keeps provisioned ahead of time. A container\n"
+      "using one of the configured images claims a provisioned root\n"
+      "filesystem instead of waiting for the image to be provisioned, and\n"
+      "the pool is refilled in the background. This config can be provided\n"
+      "either as a path pointing to a local file, or as a JSON-formatted\n"
+      "string. See the ContainerPoolConfig message in `flags.proto` for the\n"
+      "expected format.\n"
+      "\n"
+      "In the following example, two root filesystems of the `busybox`\n"
+      "Docker image are kept provisioned:\n"
+      "{\n"
+      "  \"entries\": [\n"
+      "    {\n"
+      "      \"image\": {\n"
+      "        \"type\": \"DOCKER\",\n"
+      "        \"docker\": {\"name\": \"busybox\"}\n"
+      "      },\n"
+      "      \"size\": 2\n"
+      "    }\n"
+      "  ]\n"
+      "}",
+      [](const Option<ContainerPoolConfig>& config) -> Option<Error> {
+        if (config.isSome()) {
+          foreach (const ContainerPoolConfig::Entry& entry,
+                   config->entries()) {
+            if (!entry.image().cached()) {
+              return Error(
+                  "Images in `--container_pool_config` must be cached");
+            }
+          }
+        }
+
+        return None();
+      });
+
   add(&Flags::appc_simple_discovery_uri_prefix,
       "appc_simple_discovery_uri_prefix",
       "URI prefix to be used for simple discovery of appc images,\n"
@@ -245,15 +283,25 @@ mesos::internal::slave::Flags::Flags()
 
   add(&Flags::fetcher_cache_dir,
       "fetcher_cache_dir",
-      "Directory for the fetcher cache. The agent will clear this directory\n"
-      "on startup. It is recommended to set this value to a separate volume\n"
-      "for several reasons:\n"
-      "  * The cache directories are transient and not meant to be\n"
-      "    backed up. Upon restarting the agent, the cache is always empty.\n"
+      "Directory for the fetcher cache. The agent keeps an index of the\n"
+      "cache files in this directory, so that they are reused after the\n"
+      "agent restarts. Files which are not in the index (e.g., partial\n"
+      "downloads) are removed on startup. It is recommended to set this\n"
+      "value to a separate volume for several reasons:\n"
+      "  * The cache directories are not meant to be backed up.\n"
       "  * The cache and container sandboxes can potentially interfere with\n"
       "    each other when occupying a shared space (i.e. disk contention).",
       path::join(os::temp(), "mesos", "fetch"));
 
+  add(&Flags::fetcher_cache_hardlinks,
+      "fetcher_cache_hardlinks",
+      "Whether resources retrieved from the fetcher cache are hard linked\n"
+      "into the sandbox instead of being copied, if the sandbox is on the\n"
+      "same filesystem as the cache. Cache files are made read-only in\n"
+      "this case, since they are shared with the sandboxes. Executable\n"
+      "and extracted resources are always copied.",
+      false);
+
   add(&Flags::fetcher_stall_timeout,
       "fetcher_stall_timeout",
       "Amount of time for the fetcher to wait before considering a download\n"
@@ -263,6 +311,47 @@ mesos::internal::slave::Flags::Flags()
       "does not apply to HDFS.",
       DEFAULT_FETCHER_STALL_TIMEOUT);
 
+  add(&Flags::fetcher_parallelism,
+      "fetcher_parallelism",
+      "Maximum number of URIs the fetcher downloads concurrently for a\n"
+      "single container. Copying and extracting the downloaded resources\n"
+      "into the sandbox is still done in the order of the URIs.",
+      DEFAULT_FETCHER_PARALLELISM,
+      [](const size_t& value) -> Option<Error> {
+        if (value == 0) {
+          return Error("Expected `--fetcher_parallelism` to be positive");
+        }
+
+        return None();
+      });
+
+  add(&Flags::artifact_peers,
+      "artifact_peers",
+      "Comma-separated list of agents (`host:port`) which are asked for\n"
+      "fetcher cache files and Docker image layers before they are\n"
+      "downloaded from their origin. Only the fetcher URIs which specify\n"
+      "a digest are fetched from peers. If the value starts with\n"
+      "`file://`, the list is read from that file whenever peers are\n"
+      "looked up, so that it can be maintained by an external tool. If\n"
+      "set, this agent also serves its own fetcher cache files and Docker\n"
+      "image layers to its peers under the `/artifacts` endpoints, which\n"
+      "are authenticated like the other read-only endpoints of the agent.\n"
+      "This agent authenticates with its peers using `--credential`.");
+
+  add(&Flags::artifact_chunk_size,
+      "artifact_chunk_size",
+      "Size of the chunks in which an artifact is downloaded from its\n"
+      "peers. The chunks are downloaded from several peers concurrently.\n"
+      "See `--artifact_peers`.",
+      DEFAULT_ARTIFACT_CHUNK_SIZE,
+      [](const Bytes& value) -> Option<Error> {
+        if (value == Bytes(0)) {
+          return Error("Expected `--artifact_chunk_size` to be positive");
+        }
+
+        return None();
+      });
+
   add(&Flags::work_dir,
       "work_dir",
       "Path of the agent work directory. This is where executor sandboxes\n"
@@ -466,6 +555,16 @@ mesos::internal::slave::Flags::Flags()
       "terminations may occur.",
       DEFAULT_EXECUTOR_SHUTDOWN_GRACE_PERIOD);
 
+  add(&Flags::task_launch_batch_interval,
+      "task_launch_batch_interval",
+      "Amount of time for which the launches of tasks and task groups on\n"
+      "running executors are batched (e.g., 10ms, 100ms, etc). The launches\n"
+      "of a batch share the authorization of their framework principal, and\n"
+      "the launches for the same executor share a single update of the\n"
+      "executor's container. With the default, the launches which the agent\n"
+      "has already received by the time the first one is ready are batched.",
+      DEFAULT_TASK_LAUNCH_BATCH_INTERVAL);
+
 #ifdef USE_SSL_SOCKET
   add(&Flags::jwt_secret_key,
       "jwt_secret_key",
@@ -500,6 +599,37 @@ mesos::internal::slave::Flags::Flags()
       "and can still be used.",
       false);
 
+  add(&Flags::gc_parallelism,
+      "gc_parallelism",
+      "Maximum number of paths (e.g., executor sandboxes) the garbage\n"
+      "collector removes concurrently. When more paths are due for\n"
+      "removal, the sandboxes with the largest disk usage (as last\n"
+      "sampled with `--container_usage_collection_interval`) are\n"
+      "removed first.",
+      GC_PARALLELISM,
+      [](const size_t& value) -> Option<Error> {
+        if (value == 0) {
+          return Error("Expected `--gc_parallelism` to be positive");
+        }
+
+        return None();
+      });
+
+  add(&Flags::gc_max_operations_per_second,
+      "gc_max_operations_per_second",
+      "Maximum number of files and directories the garbage collector\n"
+      "removes per second, across all concurrent removals. This limits\n"
+      "the metadata I/O of garbage collection so that it does not starve\n"
+      "running tasks. If not specified, removals are not limited.");
+
+  add(&Flags::gc_max_bytes_per_second,
+      "gc_max_bytes_per_second",
+      "Maximum number of bytes of disk space the garbage collector\n"
+      "reclaims per second, across all concurrent removals. This limits\n"
+      "the I/O caused by freeing the blocks of large files so that it\n"
+      "does not starve running tasks. If not specified, removals are not\n"
+      "limited. This flag uses the Bytes type (defined in stout).");
+
   add(&Flags::disk_watch_interval,
       "disk_watch_interval",
       "Periodic time interval (e.g., 10secs, 2mins, etc)\n"
@@ -699,6 +829,25 @@ mesos::internal::slave::Flags::Flags()
       "than the `perf_interval`.",
       Seconds(10));
 
+  add(&Flags::perf_counters,
+      "perf_counters",
+      "Whether the perf_event isolator counts the `perf_events` with\n"
+      "counters opened by the agent via `perf_event_open(2)` rather than\n"
+      "by periodically running `perf stat`. The counters of each container\n"
+      "form a group on every online CPU, opened when the container is\n"
+      "launched and read on demand with a single `read(2)` per CPU, so the\n"
+      "reported statistics are cumulative since the container was launched\n"
+      "(or the agent recovered it) and `perf_interval` and `perf_duration`\n"
+      "are ignored. CPUs which come online later are counted from the next\n"
+      "read. The events of a group are scheduled onto the PMU together, so\n"
+      "the events should not need more hardware counters than the PMU has,\n"
+      "otherwise they are never counted and are not reported.\n"
+      "Each counter takes a file descriptor (i.e., events times CPUs per\n"
+      "container), and a container whose counters would exceed the agent's\n"
+      "`RLIMIT_NOFILE` fails to launch. Only the hardware, software and\n"
+      "hardware cache events of the PerfStatistics protobuf are supported.",
+      false);
+
   add(&Flags::revocable_cpu_low_priority,
       "revocable_cpu_low_priority",
       "Run containers with revocable CPU at a lower priority than\n"
@@ -1165,6 +1314,19 @@ mesos::internal::slave::Flags::Flags()
       "isolator.",
       false);
 
+  add(&Flags::network_enable_bpf_port_mapping,
+      "network_enable_bpf_port_mapping",
+      "Whether the 'network/port_mapping' isolator should redirect the\n"
+      "incoming IP packets on the host public and loopback interfaces to\n"
+      "the containers with a BPF program which looks up the destination\n"
+      "port in a BPF map, instead of with one u32 filter per port range\n"
+      "of each container. This keeps the cost of the classification of a\n"
+      "packet independent of the number of containers. Requires Linux 4.11\n"
+      "or newer and the BPF file system mounted at '/sys/fs/bpf'. This\n"
+      "flag must not be changed while there are running containers, the\n"
+      "isolator fails to be created if it is.",
+      false);
+
 #endif // ENABLE_PORT_MAPPING_ISOLATOR
 
 #ifdef ENABLE_NETWORK_PORTS_ISOLATOR
@@ -1393,6 +1555,16 @@ mesos::internal::slave::Flags::Flags()
       "flag.",
       Seconds(15));
 
+  add(&Flags::container_usage_collection_interval,
+      "container_usage_collection_interval",
+      "If set, the agent samples the resource usage of all containers in\n"
+      "a single pass every `container_usage_collection_interval` and serves\n"
+      "the `/monitor/statistics` and `/containers` endpoints as well as the\n"
+      "resource estimator and QoS controller from the most recent samples,\n"
+      "rather than querying the containerizer for every container on every\n"
+      "request. The `timestamp` of the returned statistics is the time at\n"
+      "which the sample was taken.");
+
   add(&Flags::master_detector,
       "master_detector",
       "The symbol name of the master detector to use. This symbol\n"
@@ -53,6 +53,7 @@ public:
   Option<std::string> image_providers;
   Option<std::string> image_provisioner_backend;
   Option<ImageGcConfig> image_gc_config;
+  Option<ContainerPoolConfig> container_pool_config;
 
   std::string appc_simple_discovery_uri_prefix;
   std::string appc_store_dir;
@@ -65,7 +66,11 @@ public:
   Option<std::string> attributes;
   Bytes fetcher_cache_size;
   std::string fetcher_cache_dir;
+  bool fetcher_cache_hardlinks;
   Duration fetcher_stall_timeout;
+  size_t fetcher_parallelism;
+  Option<std::string> artifact_peers;
+  Bytes artifact_chunk_size;
   std::string work_dir;
   std::string runtime_dir;
   std::string launcher_dir;
@@ -87,12 +92,16 @@ public:
   Duration executor_reregistration_timeout;
   Option<Duration> executor_reregistration_retry_interval;
   Duration executor_shutdown_grace_period;
+  Duration task_launch_batch_interval;
 #ifdef USE_SSL_SOCKET
   Option<Path> jwt_secret_key;
 #endif // USE_SSL_SOCKET
   Duration gc_delay;
   double gc_disk_headroom;
   bool gc_non_executor_container_sandboxes;
+  size_t gc_parallelism;
+  Option<uint64_t> gc_max_operations_per_second;
+  Option<Bytes> gc_max_bytes_per_second;
   Duration disk_watch_interval;
 
   Option<std::string> container_logger;
@@ -118,6 +127,7 @@ public:
   Option<std::string> perf_events;
   Duration perf_interval;
   Duration perf_duration;
+  bool perf_counters;
   bool revocable_cpu_low_priority;
   bool systemd_enable_support;
   std::string systemd_runtime_directory;
@@ -153,6 +163,7 @@ public:
   bool network_enable_socket_statistics_summary;
   bool network_enable_socket_statistics_details;
   bool network_enable_snmp_statistics;
+  bool network_enable_bpf_port_mapping;
 #endif // ENABLE_PORT_MAPPING_ISOLATOR
 
 #ifdef ENABLE_NETWORK_PORTS_ISOLATOR
@@ -185,6 +196,7 @@ public:
   Option<std::string> qos_controller;
   Duration qos_correction_interval_min;
   Duration oversubscribed_resources_interval;
+  Option<Duration> container_usage_collection_interval;
   Option<std::string> master_detector;
 #if ENABLE_XFS_DISK_ISOLATOR
   std::string xfs_project_range;
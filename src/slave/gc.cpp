@@ -16,7 +16,17 @@
 
 #include "slave/gc.hpp"
 
+#ifndef __WINDOWS__
+#include <fts.h>
+#endif // __WINDOWS__
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <list>
+#include <memory>
+#include <system_error>
+#include <thread>
 
 #include <process/check.hpp>
 #include <process/defer.hpp>
@@ -28,8 +38,11 @@
 #include <stout/adaptor.hpp>
 #include <stout/foreach.hpp>
 #include <stout/lambda.hpp>
+#include <stout/stringify.hpp>
 
+#include <stout/os/exists.hpp>
 #include <stout/os/rmdir.hpp>
+#include <stout/os/strerror.hpp>
 
 #include "logging/logging.hpp"
 
@@ -45,6 +58,7 @@ using process::wait; // Necessary on some OS's to disambiguate.
 
 using std::list;
 using std::map;
+using std::shared_ptr;
 using std::string;
 
 using process::metrics::Counter;
@@ -53,6 +67,177 @@ namespace mesos {
 namespace internal {
 namespace slave {
 
+#ifndef __WINDOWS__
+// Recursively removes the path like `os::rmdir` (continuing on
+// errors), except that each removal operation is paced by the
+// throttle and the removal is abandoned once `stopped` is set.
+// Returns the bytes of disk space reclaimed by the removal.
+static Try<Bytes> removePath(
+    const string& path,
+    const shared_ptr<GarbageCollectorProcess::Throttle>& throttle,
+    const shared_ptr<std::atomic_bool>& stopped)
+{
+  // NOTE: `fts_open` will not always return `nullptr` if the path does
+  // not exist, so this is checked explicitly.
+  if (!os::exists(path)) {
+    return ErrnoError(ENOENT);
+  }
+
+  char* paths[] = {const_cast<char*>(path.c_str()), nullptr};
+
+  FTS* tree = ::fts_open(paths, FTS_NOCHDIR | FTS_PHYSICAL, nullptr);
+  if (tree == nullptr) {
+    return ErrnoError();
+  }
+
+  unsigned int errorCount = 0;
+
+  // The number of 512-byte blocks reclaimed, as reported by `stat`.
+  uint64_t blocks = 0;
+
+  while (true) {
+    if (stopped->load()) {
+      ::fts_close(tree);
+      return Error("Garbage collector is destroyed");
+    }
+
+    errno = 0;
+
+    FTSENT* node = ::fts_read(tree);
+    if (node == nullptr) {
+      break;
+    }
+
+    switch (node->fts_info) {
+      case FTS_DP: {
+        const uint64_t _blocks = node->fts_statp->st_blocks;
+
+        throttle->acquire(Bytes(_blocks * 512), *stopped);
+
+        if (::rmdir(node->fts_path) == 0) {
+          blocks += _blocks;
+        } else if (errno != ENOENT) {
+          LOG(ERROR) << "Failed to delete directory '" << node->fts_path
+                     << "': " << os::strerror(errno);
+          ++errorCount;
+        }
+        break;
+      }
+      case FTS_DEFAULT:
+      case FTS_F:
+      case FTS_SL:
+      case FTS_SLNONE: {
+        // The blocks of a file with other hard links are not freed.
+        const uint64_t _blocks =
+          node->fts_statp->st_nlink > 1 ? 0 : node->fts_statp->st_blocks;
+
+        throttle->acquire(Bytes(_blocks * 512), *stopped);
+
+        if (::unlink(node->fts_path) == 0) {
+          blocks += _blocks;
+        } else if (errno != ENOENT) {
+          LOG(ERROR) << "Failed to delete path '" << node->fts_path
+                     << "': " << os::strerror(errno);
+          ++errorCount;
+        }
+        break;
+      }
+      default:
+        break;
+    }
+  }
+
+  if (errno != 0) {
+    Error error = ErrnoError("fts_read failed");
+    ::fts_close(tree);
+    return error;
+  }
+
+  if (::fts_close(tree) < 0) {
+    return ErrnoError();
+  }
+
+  if (errorCount > 0) {
+    return Error("Failed to delete " + stringify(errorCount) + " paths");
+  }
+
+  return Bytes(blocks * 512);
+}
+#endif // __WINDOWS__
+
+
+GarbageCollectorProcess::Throttle::Throttle(
+    const Option<uint64_t>& _maxOperationsPerSecond,
+    const Option<Bytes>& _maxBytesPerSecond)
+  : maxOperationsPerSecond(_maxOperationsPerSecond),
+    maxBytesPerSecond(_maxBytesPerSecond),
+    next(Clock::now()) {}
+
+
+void GarbageCollectorProcess::Throttle::acquire(
+    const Bytes& bytes,
+    const std::atomic_bool& stopped)
+{
+  if (maxOperationsPerSecond.isNone() && maxBytesPerSecond.isNone()) {
+    return;
+  }
+
+  // The time the operation takes out of the budget.
+  Duration cost = Duration::zero();
+
+  if (maxOperationsPerSecond.isSome() && maxOperationsPerSecond.get() > 0) {
+    cost = std::max(cost, Seconds(1) / maxOperationsPerSecond.get());
+  }
+
+  if (maxBytesPerSecond.isSome() && maxBytesPerSecond->bytes() > 0) {
+    cost = std::max(
+        cost,
+        Seconds(1) * (static_cast<double>(bytes.bytes()) /
+                      maxBytesPerSecond->bytes()));
+  }
+
+  Time start;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    start = std::max(next, Clock::now());
+    next = start + cost;
+  }
+
+  // NOTE: The budget is measured with the libprocess clock so that it
+  // can be controlled in tests. The thread sleeps in slices, so that
+  // it notices when the clock is advanced, and so that a removal which
+  // is waiting for a large budget can still be stopped.
+  while (!stopped.load()) {
+    const Time now = Clock::now();
+
+    if (now >= start) {
+      break;
+    }
+
+    std::this_thread::sleep_for(std::chrono::nanoseconds(
+        std::min<Duration>(start - now, Milliseconds(100)).ns()));
+  }
+}
+
+
+GarbageCollectorProcess::GarbageCollectorProcess(
+    const string& _workDir,
+    size_t _parallelism,
+    const Option<uint64_t>& maxOperationsPerSecond,
+    const Option<Bytes>& maxBytesPerSecond)
+  : ProcessBase(process::ID::generate("agent-garbage-collector")),
+    metrics(this),
+    workDir(_workDir),
+    throttle(new Throttle(maxOperationsPerSecond, maxBytesPerSecond)),
+    stopped(new std::atomic_bool(false)),
+    parallelism(_parallelism)
+{
+  CHECK_GT(parallelism, 0u);
+}
+
+
 GarbageCollectorProcess::Metrics::Metrics(GarbageCollectorProcess *gc)
   : path_removals_succeeded("gc/path_removals_succeeded"),
     path_removals_failed("gc/path_removals_failed"),
@@ -61,11 +246,21 @@ GarbageCollectorProcess::Metrics::Metrics(GarbageCollectorProcess *gc)
       // basically has to be tracked as a member variable, which means we
       // can safely do concurrent reads while the map is being updated.
       return static_cast<double>(gc->paths.size());
-    })
+    }),
+    bytes_removed("gc/bytes_removed"),
+    bytes_pending(
+        "gc/bytes_pending",
+        defer(gc, &GarbageCollectorProcess::_bytes_pending)),
+    bytes_removed_per_second(
+        "gc/bytes_removed_per_second",
+        defer(gc, &GarbageCollectorProcess::_bytes_removed_per_second))
 {
   process::metrics::add(path_removals_succeeded);
   process::metrics::add(path_removals_failed);
   process::metrics::add(path_removals_pending);
+  process::metrics::add(bytes_removed);
+  process::metrics::add(bytes_pending);
+  process::metrics::add(bytes_removed_per_second);
 }
 
 
@@ -73,15 +268,22 @@ GarbageCollectorProcess::Metrics::~Metrics()
 {
   process::metrics::remove(path_removals_succeeded);
   process::metrics::remove(path_removals_failed);
+  process::metrics::remove(bytes_removed);
 
   // Wait for the metric to be removed to protect against asynchronous
   // evaluation referencing a deleted object.
   process::metrics::remove(path_removals_pending).await();
+  process::metrics::remove(bytes_pending).await();
+  process::metrics::remove(bytes_removed_per_second).await();
 }
 
 
 GarbageCollectorProcess::~GarbageCollectorProcess()
 {
+  // Abandon the removals in progress. Their threads only hold shared
+  // state, so they can outlive the garbage collector.
+  stopped->store(true);
+
   foreachvalue (const Owned<PathInfo>& info, paths) {
     info->promise.discard();
   }
@@ -90,7 +292,8 @@ GarbageCollectorProcess::~GarbageCollectorProcess()
 
 Future<Nothing> GarbageCollectorProcess::schedule(
     const Duration& d,
-    const string& path)
+    const string& path,
+    const Option<Bytes>& usage)
 {
   LOG(INFO) << "Scheduling '" << path << "' for gc " << d << " in the future";
 
@@ -102,14 +305,15 @@ Future<Nothing> GarbageCollectorProcess::schedule(
           self(),
           &Self::schedule,
           d,
-          path));
+          path,
+          usage));
   }
 
   Timeout removalTime = Timeout::in(d);
 
   timeouts[path] = removalTime;
 
-  Owned<PathInfo> info(new PathInfo(path));
+  Owned<PathInfo> info(new PathInfo(path, usage));
 
   paths.put(removalTime, info);
 
@@ -168,13 +372,20 @@ Future<bool> GarbageCollectorProcess::unschedule(const string& path)
 void GarbageCollectorProcess::reset()
 {
   Clock::cancel(timer); // Cancel the existing timer, if any.
-  if (!paths.empty()) {
-    Timeout removalTime = (*paths.begin()).first; // Get the first entry.
 
-    timer = delay(removalTime.remaining(), self(), &Self::remove, removalTime);
-  } else {
-    timer = Timer(); // Reset the timer.
+  // Paths which are being removed are skipped so that the timer does
+  // not fire repeatedly while their removal is in progress.
+  foreachpair (const Timeout& removalTime,
+               const Owned<PathInfo>& info,
+               paths) {
+    if (!info->removing) {
+      timer =
+        delay(removalTime.remaining(), self(), &Self::remove, removalTime);
+      return;
+    }
   }
+
+  timer = Timer(); // Reset the timer.
 }
 
 
@@ -196,14 +407,17 @@ void GarbageCollectorProcess::remove(const Timeout& removalTime)
       info->removing = true;
     }
 
-    Counter _succeeded = metrics.path_removals_succeeded;
+    if (infos.empty()) {
+      reset();
+      return;
+    }
+
     Counter _failed = metrics.path_removals_failed;
     const string _workDir = workDir;
 
-    auto rmdirs =
-      [_succeeded, _failed, _workDir, infos]() mutable -> Future<Nothing> {
-      // Make mutable copies of the counters to work around MESOS-7907.
-      Counter succeeded = _succeeded;
+    auto prepare =
+      [_failed, _workDir, infos]() mutable -> list<Owned<PathInfo>> {
+      // Make a mutable copy of the counter to work around MESOS-7907.
       Counter failed = _failed;
 
 #ifdef __linux__
@@ -220,7 +434,7 @@ void GarbageCollectorProcess::remove(const Timeout& removalTime)
           ++failed;
         }
 
-        return Failure(mountTable.error());
+        return list<Owned<PathInfo>>();
       }
 
       foreach (const fs::MountInfoTable::Entry& entry,
@@ -263,42 +477,14 @@ void GarbageCollectorProcess::remove(const Timeout& removalTime)
       }
 #endif // __linux__
 
-      foreach (const Owned<PathInfo>& info, infos) {
-        // Run the removal operation with 'continueOnError = true'.
-        // It's possible for tasks and isolators to lay down files
-        // that are not deletable by GC. In the face of such errors
-        // GC needs to free up disk space wherever it can because the
-        // disk space has already been re-offered to frameworks.
-        LOG(INFO) << "Deleting " << info->path;
-        Try<Nothing> rmdir = os::rmdir(info->path, true, true, true);
-
-        if (rmdir.isError()) {
-          // TODO(zhitao): Change return value type of `rmdir` to
-          // `Try<Nothing, ErrnoError>` and check error type instead.
-          if (rmdir.error() == ErrnoError(ENOENT).message) {
-            LOG(INFO) << "Skipped '" << info->path << "' which does not exist";
-          } else {
-            LOG(WARNING) << "Failed to delete '" << info->path << "': "
-                         << rmdir.error();
-            info->promise.fail(rmdir.error());
-
-            ++failed;
-          }
-        } else {
-          LOG(INFO) << "Deleted '" << info->path << "'";
-          info->promise.set(rmdir.get());
-
-          ++succeeded;
-        }
-      }
-
-      return Nothing();
+      return infos;
     };
 
-    // NOTE: All `rmdirs` calls are dispatched to one executor so that:
+    // NOTE: All preparations are dispatched to one executor and the
+    // removals run on a bounded number of threads of their own so that:
     //   1. They do not block other dispatches (MESOS-6549).
-    //   2. They do not occupy all worker threads (MESOS-7964).
-    executor.execute(rmdirs)
+    //   2. They do not occupy libprocess worker threads (MESOS-7964).
+    executor.execute(prepare)
       .onAny(defer(self(), &Self::_remove, lambda::_1, infos));
   } else {
     // This occurs when either:
@@ -311,19 +497,161 @@ void GarbageCollectorProcess::remove(const Timeout& removalTime)
 }
 
 
-void GarbageCollectorProcess::_remove(const Future<Nothing>& result,
-                                      const list<Owned<PathInfo>> infos)
+void GarbageCollectorProcess::_remove(
+    const Future<list<Owned<PathInfo>>>& prepared,
+    const list<Owned<PathInfo>> infos)
 {
-  // Remove path records from `paths` and `timeouts` data structures.
+  CHECK_READY(prepared);
+
   foreach (const Owned<PathInfo>& info, infos) {
-    CHECK(paths.remove(timeouts[info->path], info));
-    CHECK_EQ(timeouts.erase(info->path), 1u);
+    if (std::find(prepared->begin(), prepared->end(), info) ==
+        prepared->end()) {
+      // The removal failed during preparation.
+      erase(info);
+      continue;
+    }
+
+    // Keep the queue sorted by known disk usage.
+    const Bytes usage = info->usage.getOrElse(Bytes(0));
+
+    auto it = std::find_if(
+        queue.begin(),
+        queue.end(),
+        [&usage](const Owned<PathInfo>& queued) {
+          return queued->usage.getOrElse(Bytes(0)) < usage;
+        });
+
+    queue.insert(it, info);
+    pendingBytes += usage;
   }
 
+  next();
   reset();
 }
 
 
+void GarbageCollectorProcess::next()
+{
+  while (!queue.empty() && workers < parallelism) {
+    const Owned<PathInfo> info = queue.front();
+    queue.pop_front();
+
+    if (workers++ == 0) {
+      busySince = Clock::now();
+    }
+
+    const string path = info->path;
+    const Option<Bytes> usage = info->usage;
+    const shared_ptr<Throttle> _throttle = throttle;
+    const shared_ptr<std::atomic_bool> _stopped = stopped;
+
+    auto rmdir = [path, usage, _throttle, _stopped]() -> Try<Bytes> {
+      // Run the removal operation with 'continueOnError = true'.
+      // It's possible for tasks and isolators to lay down files
+      // that are not deletable by GC. In the face of such errors
+      // GC needs to free up disk space wherever it can because the
+      // disk space has already been re-offered to frameworks.
+      LOG(INFO) << "Deleting " << path;
+
+#ifdef __WINDOWS__
+      Try<Nothing> rmdir = os::rmdir(path, true, true, true);
+      if (rmdir.isError()) {
+        return Error(rmdir.error());
+      }
+
+      return usage.getOrElse(Bytes(0));
+#else
+      return removePath(path, _throttle, _stopped);
+#endif // __WINDOWS__
+    };
+
+    shared_ptr<Promise<Try<Bytes>>> promise(new Promise<Try<Bytes>>());
+
+    promise->future()
+      .onAny(defer(self(), &Self::__remove, info, lambda::_1));
+
+    try {
+      std::thread([promise, rmdir]() { promise->set(rmdir()); }).detach();
+    } catch (const std::system_error& e) {
+      promise->set(Try<Bytes>(
+          Error("Failed to create removal thread: " + string(e.what()))));
+    }
+  }
+}
+
+
+void GarbageCollectorProcess::__remove(
+    const Owned<PathInfo>& info,
+    const Future<Try<Bytes>>& result)
+{
+  pendingBytes -= info->usage.getOrElse(Bytes(0));
+
+  if (--workers == 0) {
+    CHECK_SOME(busySince);
+    busyTime += Clock::now() - busySince.get();
+    busySince = None();
+  }
+
+  CHECK_READY(result);
+
+  const Try<Bytes>& rmdir = result.get();
+
+  if (rmdir.isError()) {
+    // TODO(zhitao): Change return value type of `rmdir` to
+    // `Try<Nothing, ErrnoError>` and check error type instead.
+    if (rmdir.error() == ErrnoError(ENOENT).message) {
+      LOG(INFO) << "Skipped '" << info->path << "' which does not exist";
+    } else {
+      LOG(WARNING) << "Failed to delete '" << info->path << "': "
+                   << rmdir.error();
+      info->promise.fail(rmdir.error());
+
+      ++metrics.path_removals_failed;
+    }
+  } else {
+    LOG(INFO) << "Deleted '" << info->path << "'";
+    info->promise.set(Nothing());
+
+    ++metrics.path_removals_succeeded;
+
+    removedBytes += rmdir.get();
+    metrics.bytes_removed += rmdir->bytes();
+  }
+
+  erase(info);
+  next();
+  reset();
+}
+
+
+void GarbageCollectorProcess::erase(const Owned<PathInfo>& info)
+{
+  CHECK(paths.remove(timeouts[info->path], info));
+  CHECK_EQ(timeouts.erase(info->path), 1u);
+}
+
+
+double GarbageCollectorProcess::_bytes_pending()
+{
+  return static_cast<double>(pendingBytes.bytes());
+}
+
+
+double GarbageCollectorProcess::_bytes_removed_per_second()
+{
+  Duration elapsed = busyTime;
+  if (busySince.isSome()) {
+    elapsed += Clock::now() - busySince.get();
+  }
+
+  if (elapsed <= Duration::zero()) {
+    return 0.0;
+  }
+
+  return removedBytes.bytes() / elapsed.secs();
+}
+
+
 void GarbageCollectorProcess::prune(const Duration& d)
 {
   foreach (const Timeout& removalTime, paths.keys()) {
@@ -336,9 +664,15 @@ void GarbageCollectorProcess::prune(const Duration& d)
 }
 
 
-GarbageCollector::GarbageCollector(const string& workDir)
+GarbageCollector::GarbageCollector(
+    const string& workDir,
+    size_t parallelism,
+    const Option<uint64_t>& maxOperationsPerSecond,
+    const Option<Bytes>& maxBytesPerSecond)
 {
-  process = new GarbageCollectorProcess(workDir);
+  process = new GarbageCollectorProcess(
+      workDir, parallelism, maxOperationsPerSecond, maxBytesPerSecond);
+
   spawn(process);
 }
 
@@ -353,9 +687,11 @@ GarbageCollector::~GarbageCollector()
 
 Future<Nothing> GarbageCollector::schedule(
     const Duration& d,
-    const string& path)
+    const string& path,
+    const Option<Bytes>& usage)
 {
-  return dispatch(process, &GarbageCollectorProcess::schedule, d, path);
+  return dispatch(
+      process, &GarbageCollectorProcess::schedule, d, path, usage);
 }
 
 
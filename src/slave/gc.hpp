@@ -22,8 +22,12 @@
 
 #include <process/future.hpp>
 
+#include <stout/bytes.hpp>
 #include <stout/duration.hpp>
 #include <stout/nothing.hpp>
+#include <stout/option.hpp>
+
+#include "slave/constants.hpp"
 
 namespace mesos {
 namespace internal {
@@ -39,10 +43,22 @@ class GarbageCollectorProcess;
 // "more" permanent storage (or provide any other hooks that might be
 // useful, e.g., emailing users some time before their files are
 // scheduled for removal).
+//
+// Paths which are due for removal are removed by up to `parallelism`
+// worker threads concurrently, the paths with the largest disk usage
+// (as far as it is known when they are scheduled) first. The removal
+// operations of all workers can be limited to a
+// number of files and directories, and a number of reclaimed bytes,
+// per second so that garbage collection does not starve the I/O of
+// running tasks.
 class GarbageCollector
 {
 public:
-  explicit GarbageCollector(const std::string& workDir);
+  explicit GarbageCollector(
+      const std::string& workDir,
+      size_t parallelism = GC_PARALLELISM,
+      const Option<uint64_t>& maxOperationsPerSecond = None(),
+      const Option<Bytes>& maxBytesPerSecond = None());
   virtual ~GarbageCollector();
 
   // Schedules the specified path for removal after the specified
@@ -55,9 +71,13 @@ public:
   // was rescheduled.
   // Note that you currently cannot discard a returned future, instead
   // you must call unschedule.
+  // The optional `usage` is the disk space last known to be used by
+  // the path (e.g., a sample of the usage collector), which is used to
+  // prioritize the removal. Paths of unknown usage are removed last.
   virtual process::Future<Nothing> schedule(
       const Duration& d,
-      const std::string& path);
+      const std::string& path,
+      const Option<Bytes>& usage = None());
 
   // Unschedules the specified path for removal.
   // The future will be true if the path has been unscheduled.
@@ -17,7 +17,10 @@
 #ifndef __SLAVE_GC_PROCESS_HPP__
 #define __SLAVE_GC_PROCESS_HPP__
 
+#include <atomic>
 #include <list>
+#include <memory>
+#include <mutex>
 #include <string>
 
 #include <process/executor.hpp>
@@ -25,16 +28,19 @@
 #include <process/id.hpp>
 #include <process/owned.hpp>
 #include <process/process.hpp>
+#include <process/time.hpp>
 #include <process/timeout.hpp>
 #include <process/timer.hpp>
 
 #include <process/metrics/counter.hpp>
 #include <process/metrics/pull_gauge.hpp>
 
+#include <stout/bytes.hpp>
 #include <stout/duration.hpp>
 #include <stout/hashmap.hpp>
 #include <stout/multimap.hpp>
 #include <stout/nothing.hpp>
+#include <stout/option.hpp>
 #include <stout/try.hpp>
 
 namespace mesos {
@@ -45,21 +51,48 @@ class GarbageCollectorProcess :
     public process::Process<GarbageCollectorProcess>
 {
 public:
-  explicit GarbageCollectorProcess(const std::string& _workDir)
-    : ProcessBase(process::ID::generate("agent-garbage-collector")),
-      metrics(this),
-      workDir(_workDir) {}
+  GarbageCollectorProcess(
+      const std::string& _workDir,
+      size_t _parallelism,
+      const Option<uint64_t>& maxOperationsPerSecond,
+      const Option<Bytes>& maxBytesPerSecond);
 
   ~GarbageCollectorProcess() override;
 
   process::Future<Nothing> schedule(
       const Duration& d,
-      const std::string& path);
+      const std::string& path,
+      const Option<Bytes>& usage);
 
   process::Future<bool> unschedule(const std::string& path);
 
   void prune(const Duration& d);
 
+  // Paces the removal operations (i.e., `unlink` and `rmdir` calls)
+  // of all concurrent path removals so that they stay within a budget
+  // of operations and reclaimed bytes per second.
+  class Throttle
+  {
+  public:
+    Throttle(
+        const Option<uint64_t>& _maxOperationsPerSecond,
+        const Option<Bytes>& _maxBytesPerSecond);
+
+    // Accounts for an operation reclaiming the given bytes. Blocks the
+    // calling thread until the operation is within budget, or until
+    // `stopped` is set.
+    void acquire(const Bytes& bytes, const std::atomic_bool& stopped);
+
+  private:
+    const Option<uint64_t> maxOperationsPerSecond;
+    const Option<Bytes> maxBytesPerSecond;
+
+    std::mutex mutex;
+
+    // The earliest time at which the next operation is within budget.
+    process::Time next;
+  };
+
 private:
   void reset();
 
@@ -67,8 +100,8 @@ private:
 
   struct PathInfo
   {
-    PathInfo(const std::string& _path)
-      : path(_path) {}
+    PathInfo(const std::string& _path, const Option<Bytes>& _usage)
+      : path(_path), usage(_usage) {}
 
     bool operator==(const PathInfo& that) const
     {
@@ -81,13 +114,32 @@ private:
     process::Promise<Nothing> promise;
 
     bool removing = false;
+
+    // The disk space last known to be used by the path, if any.
+    const Option<Bytes> usage;
   };
 
-  // Callback for `remove` for bookkeeping after path removal.
+  // Callback for `remove` once the paths due for removal have been
+  // prepared (i.e., dangling mount points have been unmounted).
   void _remove(
-      const process::Future<Nothing>& result,
+      const process::Future<std::list<process::Owned<PathInfo>>>& prepared,
       const std::list<process::Owned<PathInfo>> infos);
 
+  // Starts the removal of queued paths until all workers are busy.
+  void next();
+
+  // Callback for `next` for bookkeeping after path removal. The result
+  // holds the bytes reclaimed by the removal.
+  void __remove(
+      const process::Owned<PathInfo>& info,
+      const process::Future<Try<Bytes>>& result);
+
+  // Removes the path from `paths` and `timeouts`.
+  void erase(const process::Owned<PathInfo>& info);
+
+  double _bytes_pending();
+  double _bytes_removed_per_second();
+
   struct Metrics
   {
     explicit Metrics(GarbageCollectorProcess *gc);
@@ -96,6 +148,10 @@ private:
     process::metrics::Counter path_removals_succeeded;
     process::metrics::Counter path_removals_failed;
     process::metrics::PullGauge path_removals_pending;
+
+    process::metrics::Counter bytes_removed;
+    process::metrics::PullGauge bytes_pending;
+    process::metrics::PullGauge bytes_removed_per_second;
   } metrics;
 
   const std::string workDir;
@@ -111,8 +167,34 @@ private:
 
   process::Timer timer;
 
-  // For executing path removals in a separate actor.
+  // Paths which are due for removal and wait for an idle worker,
+  // sorted by known disk usage in descending order.
+  std::list<process::Owned<PathInfo>> queue;
+
+  // Known disk usage of the queued paths and the paths which are
+  // being removed.
+  Bytes pendingBytes;
+
+  // Bytes reclaimed by removals, and the time spent removing, i.e.,
+  // during which at least one worker was busy.
+  Bytes removedBytes;
+  Duration busyTime;
+  Option<process::Time> busySince;
+
+  const std::shared_ptr<Throttle> throttle;
+
+  // Set when the garbage collector is destroyed to stop the removals
+  // in progress.
+  const std::shared_ptr<std::atomic_bool> stopped;
+
+  // For preparing path removals in a separate actor.
   process::Executor executor;
+
+  // The maximum number of concurrent path removals, each of which is
+  // executed on a thread of its own since it blocks while walking the
+  // tree and while waiting for the throttle.
+  const size_t parallelism;
+  size_t workers = 0;
 };
 
 } // namespace slave {
@@ -2215,7 +2215,7 @@ Future<JSON::Array> Http::__containers(
 
           metadata->push_back(entry);
           statusFutures.push_back(slave->containerizer->status(containerId));
-          statsFutures.push_back(slave->containerizer->usage(containerId));
+          statsFutures.push_back(slave->containerUsage(containerId));
         }
       }
 
@@ -2273,7 +2273,7 @@ Future<JSON::Array> Http::__containers(
 
         metadata->push_back(entry);
         statusFutures.push_back(slave->containerizer->status(containerId));
-        statsFutures.push_back(slave->containerizer->usage(containerId));
+        statsFutures.push_back(slave->containerUsage(containerId));
       }
 
       return await(await(statusFutures), await(statsFutures)).then(
@@ -74,6 +74,7 @@
 
 #include "module/manager.hpp"
 
+#include "slave/artifacts.hpp"
 #include "slave/gc.hpp"
 #include "slave/slave.hpp"
 #include "slave/task_status_update_manager.hpp"
@@ -466,7 +467,12 @@ int main(int argc, char** argv)
 #endif // __linux__
 
   Fetcher* fetcher = new Fetcher(flags);
-  GarbageCollector* gc = new GarbageCollector(flags.work_dir);
+
+  GarbageCollector* gc = new GarbageCollector(
+      flags.work_dir,
+      flags.gc_parallelism,
+      flags.gc_max_operations_per_second,
+      flags.gc_max_bytes_per_second);
 
   // Initialize SecretResolver.
   Try<SecretResolver*> secretResolver =
@@ -551,6 +557,17 @@ int main(int argc, char** argv)
   }
 
   Files* files = new Files(READONLY_HTTP_AUTHENTICATION_REALM, authorizer_);
+
+  // Serve the fetcher cache files and Docker image layers to peers if
+  // artifacts are distributed between agents.
+  ArtifactServer* artifactServer = nullptr;
+  if (flags.artifact_peers.isSome()) {
+    artifactServer = new ArtifactServer(
+        flags,
+        READONLY_HTTP_AUTHENTICATION_REALM,
+        authorizer_);
+  }
+
   TaskStatusUpdateManager* taskStatusUpdateManager =
     new TaskStatusUpdateManager(flags);
 
@@ -626,6 +643,8 @@ int main(int argc, char** argv)
 
   delete taskStatusUpdateManager;
 
+  delete artifactServer;
+
   delete files;
 
   if (authorizer_.isSome()) {
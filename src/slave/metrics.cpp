@@ -91,7 +91,19 @@ Metrics::Metrics(const Slave& slave)
         "slave/executor_directory_max_allowed_age_secs",
         defer(slave, &Slave::_executor_directory_max_allowed_age_secs)),
     container_launch_errors(
-        "slave/container_launch_errors")
+        "slave/container_launch_errors"),
+    task_launch_unschedule(
+        "slave/task_launch/unschedule", Hours(1)),
+    task_launch_authorization(
+        "slave/task_launch/authorization", Hours(1)),
+    task_launch_checkpoint(
+        "slave/task_launch/checkpoint", Hours(1)),
+    task_launch_batching(
+        "slave/task_launch/batching", Hours(1)),
+    task_launch_container_update(
+        "slave/task_launch/container_update", Hours(1)),
+    task_launches_batched(
+        "slave/task_launches_batched")
 {
   // TODO(dhamon): Check return values for metric registration.
   process::metrics::add(uptime_secs);
@@ -127,6 +139,13 @@ Metrics::Metrics(const Slave& slave)
 
   process::metrics::add(container_launch_errors);
 
+  process::metrics::add(task_launch_unschedule);
+  process::metrics::add(task_launch_authorization);
+  process::metrics::add(task_launch_checkpoint);
+  process::metrics::add(task_launch_batching);
+  process::metrics::add(task_launch_container_update);
+  process::metrics::add(task_launches_batched);
+
   // Create resource gauges.
   // TODO(dhamon): Set these up dynamically when creating a slave
   // based on the resources it exposes.
@@ -214,6 +233,13 @@ Metrics::~Metrics()
 
   process::metrics::remove(container_launch_errors);
 
+  process::metrics::remove(task_launch_unschedule);
+  process::metrics::remove(task_launch_authorization);
+  process::metrics::remove(task_launch_checkpoint);
+  process::metrics::remove(task_launch_batching);
+  process::metrics::remove(task_launch_container_update);
+  process::metrics::remove(task_launches_batched);
+
   foreach (const PullGauge& gauge, resources_total) {
     process::metrics::remove(gauge);
   }
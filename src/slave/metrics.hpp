@@ -21,6 +21,9 @@
 
 #include <process/metrics/counter.hpp>
 #include <process/metrics/pull_gauge.hpp>
+#include <process/metrics/timer.hpp>
+
+#include <stout/duration.hpp>
 
 
 namespace mesos {
@@ -71,6 +74,18 @@ struct Metrics
 
   process::metrics::Counter container_launch_errors;
 
+  // The time a task or task group launch spends in each stage of the
+  // launch pipeline, see `Slave::run()`.
+  process::metrics::Timer<Milliseconds> task_launch_unschedule;
+  process::metrics::Timer<Milliseconds> task_launch_authorization;
+  process::metrics::Timer<Milliseconds> task_launch_checkpoint;
+  process::metrics::Timer<Milliseconds> task_launch_batching;
+  process::metrics::Timer<Milliseconds> task_launch_container_update;
+
+  // The number of launches of which the containerizer updates were
+  // combined with those of other launches.
+  process::metrics::Counter task_launches_batched;
+
   // Non-revocable resources.
   std::vector<process::metrics::PullGauge> resources_total;
   std::vector<process::metrics::PullGauge> resources_used;
@@ -229,7 +229,8 @@ Slave::Slave(const string& id,
     secretGenerator(_secretGenerator),
     volumeGidManager(_volumeGidManager),
     authorizer(_authorizer),
-    resourceVersion(protobuf::createUUID()) {}
+    resourceVersion(protobuf::createUUID()),
+    launchWindowOpen(false) {}
 
 
 Slave::~Slave()
@@ -403,6 +404,19 @@ void Slave::initialize()
       << " for --gc_disk_headroom. Must be between 0.0 and 1.0";
   }
 
+  if (flags.container_usage_collection_interval.isSome()) {
+    if (flags.container_usage_collection_interval.get() <= Duration::zero()) {
+      EXIT(EXIT_FAILURE)
+        << "Invalid value '"
+        << flags.container_usage_collection_interval.get() << "'"
+        << " for --container_usage_collection_interval. Must be positive";
+    }
+
+    usageCollector.reset(new UsageCollector(
+        containerizer,
+        flags.container_usage_collection_interval.get()));
+  }
+
   Try<Nothing> initialize =
     resourceEstimator->initialize(defer(self(), &Self::usage));
 
@@ -673,6 +687,10 @@ void Slave::initialize()
       &SlaveReregisteredMessage::reconciliations,
       &SlaveReregisteredMessage::connection);
 
+  install<SlaveReregistrationThrottledMessage>(
+      &Slave::reregistrationThrottled,
+      &SlaveReregistrationThrottledMessage::retry_after);
+
   install<RunTaskMessage>(
       &Slave::handleRunTaskMessage);
 
@@ -933,6 +951,8 @@ void Slave::finalize()
   // Explicitly tear down the resource provider manager to ensure that the
   // wrapped process is terminated and releases the underlying storage.
   resourceProviderManager.reset();
+
+  usageCollector.reset();
 }
 
 
@@ -1719,6 +1739,41 @@ void Slave::reregistered(
 }
 
 
+void Slave::reregistrationThrottled(
+    const UPID& from,
+    const DurationInfo& retryAfter)
+{
+  if (master != from) {
+    LOG(WARNING) << "Ignoring throttled re-registration message from " << from
+                 << " because it is not the expected master: "
+                 << (master.isSome() ? stringify(master.get()) : "None");
+    return;
+  }
+
+  if (state != DISCONNECTED) {
+    LOG(INFO) << "Ignoring throttled re-registration message from " << from
+              << " because the agent is in " << state << " state";
+    return;
+  }
+
+  // The delay is spread out so that the throttled agents do not all
+  // retry at once.
+  Duration delay = Nanoseconds(retryAfter.nanoseconds()) *
+    (1 + static_cast<double>(os::random()) / RAND_MAX);
+
+  LOG(INFO) << "Master " << from << " throttled the re-registration;"
+            << " retrying in " << delay;
+
+  Clock::cancel(agentRegistrationTimer);
+
+  agentRegistrationTimer = process::delay(
+      delay,
+      self(),
+      &Slave::doReliableRegistration,
+      flags.registration_backoff_factor * 2);
+}
+
+
 void Slave::doReliableRegistration(Duration maxBackoff)
 {
   if (master.isNone()) {
@@ -2227,7 +2282,8 @@ void Slave::run(
 
   // `taskLaunch` encapsulates each task's launch steps from this point
   // to the end of `_run` (the completion of task authorization).
-  Future<Nothing> taskLaunch = collect(unschedules)
+  Future<Nothing> taskLaunch =
+    metrics.task_launch_unschedule.time(collect(unschedules))
     // Handle the failure iff unschedule GC fails.
     .repair(defer(self(), onUnscheduleGCFailure))
     // If unschedule GC succeeds, trigger the next continuation.
@@ -2406,14 +2462,12 @@ Future<Nothing> Slave::_run(
   // Authorize the task or tasks (as in a task group) to ensure that the
   // task user is allowed to launch tasks on the agent. If authorization
   // fails, the task (or all tasks in a task group) are not launched.
-  vector<Future<bool>> authorizations;
-
   LOG(INFO) << "Authorizing " << taskOrTaskGroup(task, taskGroup)
             << " for framework " << frameworkId;
 
-  foreach (const TaskInfo& _task, tasks) {
-    authorizations.push_back(authorizeTask(_task, frameworkInfo));
-  }
+  Future<vector<bool>> authorizations =
+    metrics.task_launch_authorization.time(
+        authorizeTasks(tasks, frameworkInfo));
 
   auto onTaskAuthorizationFailure =
     [=](const string& error, Framework* _framework) {
@@ -2450,7 +2504,7 @@ Future<Nothing> Slave::_run(
       }
   };
 
-  return collect(authorizations)
+  return authorizations
     .repair(defer(self(),
       [=](const Future<vector<bool>>& future) -> Future<vector<bool>> {
         Framework* _framework = getFramework(frameworkId);
@@ -3064,9 +3118,13 @@ void Slave::__run(
     }
     case Executor::REGISTERING:
       if (executor->checkpoint) {
+        metrics.task_launch_checkpoint.start();
+
         foreach (const TaskInfo& _task, tasks) {
           executor->checkpointTask(_task);
         }
+
+        metrics.task_launch_checkpoint.stop();
       }
 
       if (taskGroup.isSome()) {
@@ -3083,9 +3141,13 @@ void Slave::__run(
       break;
     case Executor::RUNNING: {
       if (executor->checkpoint) {
+        metrics.task_launch_checkpoint.start();
+
         foreach (const TaskInfo& _task, tasks) {
           executor->checkpointTask(_task);
         }
+
+        metrics.task_launch_checkpoint.stop();
       }
 
       // Queue tasks until the containerizer is updated
@@ -3101,29 +3163,27 @@ void Slave::__run(
       LOG(INFO) << "Queued " << taskOrTaskGroup(task, taskGroup)
                 << " for executor " << *executor;
 
-      const ContainerID& containerId = executor->containerId;
-      const Resources& resources = executor->allocatedResources();
+      // The container is updated with the resources of all the tasks
+      // queued within the current launch window at once, and the tasks
+      // are then sent to the executor together, see `closeLaunchWindow()`.
+      if (!launchBatches.contains(executor->containerId)) {
+        launchBatches[executor->containerId].reset(
+            new LaunchBatch(frameworkId, executorId));
+      }
 
-      publishResources(containerId, resources)
-        .then(defer(self(), [this, containerId, resources] {
-          // NOTE: The executor struct could have been removed before
-          // containerizer update, so we use the captured container ID and
-          // resources here. If this happens, the containerizer would simply
-          // skip updating a destroyed container.
-          return containerizer->update(containerId, resources);
-        }))
-        .onAny(defer(self(),
-                     &Self::___run,
-                     lambda::_1,
-                     frameworkId,
-                     executorId,
-                     executor->containerId,
-                     task.isSome()
-                       ? vector<TaskInfo>({task.get()})
-                       : vector<TaskInfo>(),
-                     taskGroup.isSome()
-                       ? vector<TaskGroupInfo>({taskGroup.get()})
-                       : vector<TaskGroupInfo>()));
+      Owned<LaunchBatch> batch = launchBatches.at(executor->containerId);
+
+      if (taskGroup.isSome()) {
+        batch->taskGroups.push_back(taskGroup.get());
+      } else {
+        batch->tasks.push_back(task.get());
+      }
+
+      batch->launches++;
+
+      metrics.task_launch_batching.time(batch->flushed.future());
+
+      openLaunchWindow();
 
       break;
     }
@@ -6767,7 +6827,7 @@ void Slave::removeExecutor(Framework* framework, Executor* executor)
   }
 
   os::utime(path); // Update the modification time.
-  garbageCollect(path)
+  garbageCollect(path, executor->containerId)
     .onAny(defer(self(), &Self::detachFile, path))
     .onAny(defer(
         self(),
@@ -8009,7 +8069,9 @@ void Slave::recoverFramework(
 }
 
 
-Future<Nothing> Slave::garbageCollect(const string& path)
+Future<Nothing> Slave::garbageCollect(
+    const string& path,
+    const Option<ContainerID>& containerId)
 {
   Try<long> mtime = os::stat::mtime(path);
   if (mtime.isError()) {
@@ -8027,7 +8089,26 @@ Future<Nothing> Slave::garbageCollect(const string& path)
   // GC based on the modification time.
   Duration delay = flags.gc_delay - (Clock::now() - time.get());
 
-  return gc->schedule(delay, path);
+  if (containerId.isNone() || usageCollector.get() == nullptr) {
+    return gc->schedule(delay, path);
+  }
+
+  // NOTE: The container has been destroyed, so its usage is only known
+  // if it is still cached by the usage collector.
+  return usageCollector->usage(containerId.get())
+    .then([](const ResourceStatistics& statistics) -> Option<Bytes> {
+      if (!statistics.has_disk_used_bytes()) {
+        return None();
+      }
+
+      return Bytes(statistics.disk_used_bytes());
+    })
+    .repair([](const Future<Option<Bytes>>&) -> Option<Bytes> {
+      return None();
+    })
+    .then(defer(self(), [=](const Option<Bytes>& usage) {
+      return gc->schedule(delay, path, usage);
+    }));
 }
 
 
@@ -9118,7 +9199,7 @@ Future<ResourceUsage> Slave::usage()
         }
       }
 
-      futures.push_back(containerizer->usage(executor->containerId));
+      futures.push_back(containerUsage(executor->containerId));
     }
   }
 
@@ -9152,6 +9233,16 @@ Future<ResourceUsage> Slave::usage()
 }
 
 
+Future<ResourceStatistics> Slave::containerUsage(const ContainerID& containerId)
+{
+  if (usageCollector.get() != nullptr) {
+    return usageCollector->usage(containerId);
+  }
+
+  return containerizer->usage(containerId);
+}
+
+
 // As a principle, we do not need to re-authorize actions that have already
 // been authorized by the master. However, we re-authorize the RUN_TASK action
 // on the agent even though the master has already authorized it because:
@@ -9160,34 +9251,134 @@ Future<ResourceUsage> Slave::usage()
 // b) compared to other actions such as killing a task and shutting down a
 //    framework, it's a greater security risk if malicious tasks are launched
 //    as a superuser on the agent.
-Future<bool> Slave::authorizeTask(
-    const TaskInfo& task,
+Future<vector<bool>> Slave::authorizeTasks(
+    const vector<TaskInfo>& tasks,
     const FrameworkInfo& frameworkInfo)
 {
   if (authorizer.isNone()) {
-    return true;
+    return vector<bool>(tasks.size(), true);
+  }
+
+  const Option<string> principal = frameworkInfo.has_principal()
+    ? Option<string>(frameworkInfo.principal())
+    : None();
+
+  // The object approver of the principal is shared by the launches
+  // within the current launch window, so that a burst of launches
+  // does not result in a request to the authorizer per task.
+  if (!taskApprovers.contains(principal)) {
+    Option<authorization::Subject> subject;
+    if (principal.isSome()) {
+      subject = authorization::Subject();
+      subject->set_value(principal.get());
+    }
+
+    LOG(INFO)
+      << "Authorizing framework principal '" << principal.getOrElse("ANY")
+      << "' to launch tasks";
+
+    taskApprovers[principal] = authorizer.get()->getObjectApprover(
+        subject, authorization::RUN_TASK);
+
+    openLaunchWindow();
+  }
+
+  return taskApprovers.at(principal)
+    .then([tasks, frameworkInfo](
+        const Owned<ObjectApprover>& approver) -> Future<vector<bool>> {
+      vector<bool> authorizations;
+
+      foreach (const TaskInfo& task, tasks) {
+        Try<bool> approved =
+          approver->approved(ObjectApprover::Object(task, frameworkInfo));
+
+        if (approved.isError()) {
+          return Failure(approved.error());
+        }
+
+        authorizations.push_back(approved.get());
+      }
+
+      return authorizations;
+    });
+}
+
+
+void Slave::openLaunchWindow()
+{
+  if (launchWindowOpen) {
+    return;
   }
 
-  // Authorize the task.
-  authorization::Request request;
+  launchWindowOpen = true;
 
-  if (frameworkInfo.has_principal()) {
-    request.mutable_subject()->set_value(frameworkInfo.principal());
+  // NOTE: A zero interval still batches the launches which are ready
+  // before the dispatched event is processed.
+  if (flags.task_launch_batch_interval == Duration::zero()) {
+    dispatch(self(), &Self::closeLaunchWindow);
+  } else {
+    delay(flags.task_launch_batch_interval, self(), &Self::closeLaunchWindow);
   }
+}
+
+
+void Slave::closeLaunchWindow()
+{
+  CHECK(launchWindowOpen);
+
+  launchWindowOpen = false;
+  taskApprovers.clear();
+
+  hashmap<ContainerID, Owned<LaunchBatch>> batches;
+  std::swap(batches, launchBatches);
+
+  foreachpair (const ContainerID& containerId,
+               const Owned<LaunchBatch>& batch,
+               batches) {
+    batch->flushed.set(Nothing());
 
-  request.set_action(authorization::RUN_TASK);
+    if (batch->launches > 1) {
+      metrics.task_launches_batched += batch->launches;
+    }
+
+    // If the executor is gone or no longer running, there is no need
+    // to update its container. `___run()` takes care of the tasks.
+    Executor* executor = getExecutor(batch->frameworkId, batch->executorId);
+    if (executor == nullptr ||
+        executor->containerId != containerId ||
+        executor->state != Executor::RUNNING) {
+      ___run(
+          Nothing(),
+          batch->frameworkId,
+          batch->executorId,
+          containerId,
+          batch->tasks,
+          batch->taskGroups);
 
-  authorization::Object* object = request.mutable_object();
+      continue;
+    }
 
-  object->mutable_task_info()->CopyFrom(task);
-  object->mutable_framework_info()->CopyFrom(frameworkInfo);
+    const Resources resources = executor->allocatedResources();
 
-  LOG(INFO)
-    << "Authorizing framework principal '"
-    << (frameworkInfo.has_principal() ? frameworkInfo.principal() : "ANY")
-    << "' to launch task " << task.task_id();
+    Future<Nothing> update = publishResources(containerId, resources)
+      .then(defer(self(), [this, containerId, resources] {
+        // NOTE: The executor struct could have been removed before
+        // containerizer update, so we use the captured container ID and
+        // resources here. If this happens, the containerizer would simply
+        // skip updating a destroyed container.
+        return containerizer->update(containerId, resources);
+      }));
 
-  return authorizer.get()->authorized(request);
+    metrics.task_launch_container_update.time(update)
+      .onAny(defer(self(),
+                   &Self::___run,
+                   lambda::_1,
+                   batch->frameworkId,
+                   batch->executorId,
+                   containerId,
+                   batch->tasks,
+                   batch->taskGroups));
+  }
 }
 
 
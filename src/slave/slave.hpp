@@ -33,6 +33,8 @@
 
 #include <mesos/authentication/secret_generator.hpp>
 
+#include <mesos/authorizer/authorizer.hpp>
+
 #include <mesos/executor/executor.hpp>
 
 #include <mesos/master/detector.hpp>
@@ -88,6 +90,7 @@
 #include "slave/metrics.hpp"
 #include "slave/paths.hpp"
 #include "slave/state.hpp"
+#include "slave/usage_collector.hpp"
 
 #include "status_update_manager/operation.hpp"
 
@@ -101,7 +104,6 @@
 namespace mesos {
 
 // Forward declarations.
-class Authorizer;
 class DiskProfileAdaptor;
 
 namespace internal {
@@ -146,6 +148,12 @@ public:
       const std::vector<ReconcileTasksMessage>& reconciliations,
       const MasterSlaveConnection& connection);
 
+  // Reschedules the re-registration with the master, which did not
+  // admit it because too many agents are reregistering.
+  void reregistrationThrottled(
+      const process::UPID& from,
+      const DurationInfo& retryAfter);
+
   void doReliableRegistration(Duration maxBackoff);
 
   // TODO(mzhu): Combine this with `runTask()' and replace all `runTask()'
@@ -596,8 +604,13 @@ public:
   // Made 'virtual' for Slave mocking.
   virtual void removeFramework(Framework* framework);
 
-  // Schedules a 'path' for gc based on its modification time.
-  process::Future<Nothing> garbageCollect(const std::string& path);
+  // Schedules a 'path' for gc based on its modification time. If the
+  // path is the sandbox of a container whose usage has been sampled by
+  // the usage collector, the sampled disk usage is passed on to the
+  // garbage collector to prioritize the removal.
+  process::Future<Nothing> garbageCollect(
+      const std::string& path,
+      const Option<ContainerID>& containerId = None());
 
   // Called when the slave was signaled from the specified user.
   void signaled(int signal, int uid);
@@ -613,6 +626,12 @@ public:
   // Returns the resource usage information for all executors.
   virtual process::Future<ResourceUsage> usage();
 
+  // Returns the resource statistics of the container. These are served
+  // from the usage collector when `--container_usage_collection_interval`
+  // is set, otherwise the containerizer is queried directly.
+  process::Future<ResourceStatistics> containerUsage(
+      const ContainerID& containerId);
+
   // Handle the second phase of shutting down an executor for those
   // executors that have not properly shutdown within a timeout.
   void shutdownExecutorTimeout(
@@ -639,10 +658,23 @@ private:
   Try<Nothing> syncCheckpointedResources(
       const Resources& newCheckpointedResources);
 
-  process::Future<bool> authorizeTask(
-      const TaskInfo& task,
+  // Authorizes the launch of the given tasks. The launches authorized
+  // within the same launch window share one object approver per
+  // framework principal, see `openLaunchWindow()`.
+  process::Future<std::vector<bool>> authorizeTasks(
+      const std::vector<TaskInfo>& tasks,
       const FrameworkInfo& frameworkInfo);
 
+  // Opens a launch window unless one is open already. The window is
+  // closed after `--task_launch_batch_interval`, or once the agent has
+  // processed the events it has already received if the interval is
+  // zero.
+  void openLaunchWindow();
+
+  // Sends the launches batched within the current launch window to
+  // their executors, after a single update of each executor container.
+  void closeLaunchWindow();
+
   process::Future<bool> authorizeSandboxAccess(
       const Option<process::http::authentication::Principal>& principal,
       const FrameworkID& frameworkId,
@@ -852,6 +884,10 @@ private:
   // (allocated and oversubscribable) resources.
   Option<Resources> oversubscribedResources;
 
+  // Periodically samples the usage of all containers, only set if
+  // `--container_usage_collection_interval` is specified.
+  process::Owned<UsageCollector> usageCollector;
+
   process::Owned<ResourceProviderManager> resourceProviderManager;
   process::Owned<LocalResourceProviderDaemon> localResourceProviderDaemon;
 
@@ -884,6 +920,35 @@ private:
 
   // Operations that are checkpointed by the agent.
   hashmap<UUID, Operation> checkpointedOperations;
+
+  // The tasks and task groups to be sent to a running executor once its
+  // container has been updated at the end of the current launch window.
+  struct LaunchBatch
+  {
+    LaunchBatch(const FrameworkID& _frameworkId, const ExecutorID& _executorId)
+      : frameworkId(_frameworkId), executorId(_executorId), launches(0) {}
+
+    const FrameworkID frameworkId;
+    const ExecutorID executorId;
+
+    std::vector<TaskInfo> tasks;
+    std::vector<TaskGroupInfo> taskGroups;
+    size_t launches;
+
+    // Completed when the batch is flushed, used to time the batching.
+    process::Promise<Nothing> flushed;
+  };
+
+  // Indicates if a launch window is open, see `openLaunchWindow()`.
+  bool launchWindowOpen;
+
+  // Launch batches keyed by the container of their executor.
+  hashmap<ContainerID, process::Owned<LaunchBatch>> launchBatches;
+
+  // The `RUN_TASK` object approvers of the framework principals whose
+  // tasks have been authorized within the current launch window.
+  hashmap<Option<std::string>, process::Future<process::Owned<ObjectApprover>>>
+    taskApprovers;
 };
 
 
@@ -0,0 +1,139 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "slave/usage_collector.hpp"
+
+#include <mesos/type_utils.hpp>
+
+#include <process/defer.hpp>
+#include <process/delay.hpp>
+#include <process/dispatch.hpp>
+#include <process/id.hpp>
+#include <process/process.hpp>
+
+#include <stout/hashmap.hpp>
+#include <stout/hashset.hpp>
+#include <stout/nothing.hpp>
+
+#include "slave/containerizer/containerizer.hpp"
+
+using process::defer;
+using process::delay;
+using process::Future;
+using process::Process;
+
+using process::wait; // Necessary on some OS's to disambiguate.
+
+namespace mesos {
+namespace internal {
+namespace slave {
+
+class UsageCollectorProcess : public Process<UsageCollectorProcess>
+{
+public:
+  UsageCollectorProcess(
+      Containerizer* _containerizer,
+      const Duration& _interval)
+    : ProcessBase(process::ID::generate("usage-collector")),
+      containerizer(_containerizer),
+      interval(_interval) {}
+
+  Future<ResourceStatistics> usage(const ContainerID& containerId)
+  {
+    if (samples.contains(containerId)) {
+      return samples.at(containerId);
+    }
+
+    return containerizer->usage(containerId);
+  }
+
+protected:
+  void initialize() override
+  {
+    collect();
+  }
+
+private:
+  // Samples the usage of every container in one pass. The next pass
+  // is only scheduled once the current one has completed so that
+  // slow isolators can not cause passes to pile up.
+  void collect()
+  {
+    containerizer->containers()
+      .then(defer(self(), &Self::_collect, lambda::_1))
+      .onAny(defer(self(), &Self::__collect, lambda::_1));
+  }
+
+  Future<Nothing> _collect(const hashset<ContainerID>& containerIds)
+  {
+    // Query the containerizer once for all the containers rather than
+    // once per container, see `Containerizer::usages()`.
+    return containerizer->usages(containerIds)
+      .then(defer(self(), [=](
+          const hashmap<ContainerID, ResourceStatistics>& statistics) {
+        // Replace all samples so that containers which have been
+        // destroyed since the last pass are dropped from the cache.
+        samples = statistics;
+
+        return Nothing();
+      }));
+  }
+
+  void __collect(const Future<Nothing>& future)
+  {
+    if (!future.isReady()) {
+      LOG(WARNING) << "Failed to collect resource statistics of containers: "
+                   << (future.isFailed() ? future.failure() : "discarded");
+    }
+
+    delay(interval, self(), &Self::collect);
+  }
+
+  Containerizer* containerizer;
+  const Duration interval;
+
+  // The most recent sample of each container. Failed samples are not
+  // cached so that their errors are surfaced to the caller.
+  hashmap<ContainerID, ResourceStatistics> samples;
+};
+
+
+UsageCollector::UsageCollector(
+    Containerizer* containerizer,
+    const Duration& interval)
+  : process(new UsageCollectorProcess(containerizer, interval))
+{
+  spawn(process);
+}
+
+
+UsageCollector::~UsageCollector()
+{
+  terminate(process);
+  wait(process);
+  delete process;
+}
+
+
+Future<ResourceStatistics> UsageCollector::usage(
+    const ContainerID& containerId)
+{
+  return dispatch(process, &UsageCollectorProcess::usage, containerId);
+}
+
+} // namespace slave {
+} // namespace internal {
+} // namespace mesos {
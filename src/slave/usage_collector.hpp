@@ -0,0 +1,64 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __SLAVE_USAGE_COLLECTOR_HPP__
+#define __SLAVE_USAGE_COLLECTOR_HPP__
+
+#include <mesos/mesos.hpp>
+
+#include <process/future.hpp>
+
+#include <stout/duration.hpp>
+
+namespace mesos {
+namespace internal {
+namespace slave {
+
+// Forward declarations.
+class Containerizer;
+class UsageCollectorProcess;
+
+
+// Periodically samples the resource usage of all containers known to
+// the containerizer in a single pass (one batched call to the
+// containerizer from its own actor, i.e., off of the agent actor) and
+// caches the results. Consumers of container
+// usage (the `/monitor/statistics` and `/containers` endpoints, the
+// resource estimator and the QoS controller) are then served from the
+// same samples rather than each of them querying every isolator for
+// every container on every request.
+class UsageCollector
+{
+public:
+  UsageCollector(Containerizer* containerizer, const Duration& interval);
+  ~UsageCollector();
+
+  // Returns the most recently collected sample for the container. The
+  // `timestamp` of the returned statistics is the time at which the
+  // sample was taken. If no sample has been collected for the
+  // container yet (e.g., it was launched after the last collection)
+  // the containerizer is queried directly.
+  process::Future<ResourceStatistics> usage(const ContainerID& containerId);
+
+private:
+  UsageCollectorProcess* process;
+};
+
+} // namespace slave {
+} // namespace internal {
+} // namespace mesos {
+
+#endif // __SLAVE_USAGE_COLLECTOR_HPP__
@@ -94,6 +94,8 @@ public:
   Future<bool> expunge(const Entry& entry);
   Future<std::set<string>> names();
 
+  Future<Option<Entry>> follow(const string& name);
+
 protected:
   void finalize() override;
 
@@ -104,8 +106,24 @@ private:
       const Log::Position& beginning,
       const Log::Position& position);
 
-  // Helper for applying log entries.
-  Future<Nothing> apply(const list<Log::Entry>& entries);
+  // Helpers for reading the log without a writer.
+  Future<Nothing> _follow(const Log::Position& ending);
+  Future<Nothing> __follow(
+      const Log::Position& beginning,
+      const Log::Position& ending);
+
+  // Helper for reading and applying the log entries past 'index' up
+  // to 'ending', given the current beginning of the log.
+  Future<Nothing> read(
+      const Log::Position& beginning,
+      const Log::Position& ending);
+
+  // Helper for applying the log entries read up to 'ending' while the
+  // snapshots were at 'generation'.
+  Future<Nothing> apply(
+      uint64_t generation,
+      const Log::Position& ending,
+      const list<Log::Entry>& entries);
 
   // Helper for performing truncation.
   void truncate();
@@ -149,6 +167,11 @@ private:
   // Last position in the log up to which we've truncated.
   Option<Log::Position> truncated;
 
+  // Incremented whenever the snapshots are dropped to read the log
+  // again (see 'read'), so that the entries of reads that were in
+  // flight at the time are not applied to the new snapshots.
+  uint64_t generation;
+
   // Note that while it would be nice to just use Operation::Snapshot
   // modified to include a required field called 'position' we don't
   // know the position (nor can we determine it) before we've done the
@@ -226,7 +249,8 @@ LogStorageProcess::LogStorageProcess(Log* log, size_t diffsBetweenSnapshots)
   : ProcessBase(process::ID::generate("log-storage")),
     reader(log),
     writer(log),
-    diffsBetweenSnapshots(diffsBetweenSnapshots) {}
+    diffsBetweenSnapshots(diffsBetweenSnapshots),
+    generation(0) {}
 
 
 LogStorageProcess::~LogStorageProcess() {}
@@ -271,23 +295,12 @@ Future<Nothing> LogStorageProcess::_start(
 
   // Now read and apply log entries. Since 'start' can be called
   // multiple times (i.e., since we reset 'starting' after getting a
-  // None position returned after 'set', 'expunge', etc) we need to
-  // check and see if we've already successfully read the log at least
-  // once by checking 'index'. If we haven't yet read the log (i.e.,
-  // this is the first call to 'start' and 'index' is None) then we
-  // get the beginning of the log first so we can read from that up to
-  // what ever position was known at the time we started the
-  // writer. Note that it should always be safe to read a truncated
-  // entry since a subsequent operation in the log should invalidate
-  // that entry when we read it instead.
-  if (index.isSome()) {
-    // If we've started before (i.e., have an 'index' position) we
-    // should also expect to know the last 'truncated' position.
-    CHECK_SOME(truncated);
-    return reader.read(index.get(), position.get())
-      .then(defer(self(), &Self::apply, lambda::_1));
-  }
-
+  // None position returned after 'set', 'expunge', etc) or the log
+  // might have been followed before, we only read the entries past
+  // 'index' (see 'read'), up to what ever position was known at the
+  // time we started the writer. Note that it should always be safe to
+  // read a truncated entry since a subsequent operation in the log
+  // should invalidate that entry when we read it instead.
   return reader.beginning()
     .then(defer(self(), &Self::__start, lambda::_1, position.get()));
 }
@@ -299,15 +312,88 @@ Future<Nothing> LogStorageProcess::__start(
 {
   CHECK_SOME(starting);
 
-  truncated = beginning; // Cache for future truncations.
+  return read(beginning, position);
+}
 
-  return reader.read(beginning, position)
-    .then(defer(self(), &Self::apply, lambda::_1));
+
+Future<Option<Entry>> LogStorageProcess::follow(const string& name)
+{
+  // Once the writer is started, the entries are read by `start()`.
+  if (starting.isSome()) {
+    return get(name);
+  }
+
+  // Catch up the local replica with the log first, since it might
+  // not have learned all positions written by the leading writer.
+  // The entries are applied past 'index' only, so reading the same
+  // positions again here or in 'start()' is safe.
+  return reader.catchup()
+    .then(defer(self(), &Self::_follow, lambda::_1))
+    .then(defer(self(), &Self::_get, name));
 }
 
 
-Future<Nothing> LogStorageProcess::apply(const list<Log::Entry>& entries)
+Future<Nothing> LogStorageProcess::_follow(const Log::Position& ending)
 {
+  if (index.isSome() && index.get() >= ending) {
+    return Nothing();
+  }
+
+  return reader.beginning()
+    .then(defer(self(), &Self::__follow, lambda::_1, ending));
+}
+
+
+Future<Nothing> LogStorageProcess::__follow(
+    const Log::Position& beginning,
+    const Log::Position& ending)
+{
+  return read(beginning, ending);
+}
+
+
+Future<Nothing> LogStorageProcess::read(
+    const Log::Position& beginning,
+    const Log::Position& ending)
+{
+  // The log might have been truncated past 'index' by another writer
+  // since we last read it, e.g., when following the log of the leading
+  // master which has written new snapshots in the meantime. The
+  // entries past 'index' can then no longer be read, so we drop what
+  // we have applied and read all the entries in the log instead, which
+  // include the latest snapshots.
+  if (index.isSome() && index.get() < beginning) {
+    VLOG(2) << "Log has been truncated past position " << index->identity()
+            << ", reading it from position " << beginning.identity();
+
+    index = None();
+    snapshots.clear();
+    generation++;
+  }
+
+  truncated = max(truncated, beginning); // Cache for future truncations.
+
+  return reader.read(index.isSome() ? index.get() : beginning, ending)
+    .then(defer(self(), &Self::apply, generation, ending, lambda::_1));
+}
+
+
+Future<Nothing> LogStorageProcess::apply(
+    uint64_t generation,
+    const Log::Position& ending,
+    const list<Log::Entry>& entries)
+{
+  // The snapshots have been dropped since the entries were read (e.g.,
+  // 'start()' found the log truncated while 'follow()' was reading),
+  // so the entries might not apply to them. Read them again instead.
+  if (generation != this->generation) {
+    VLOG(2) << "Dropping " << entries.size() << " entries read before the "
+            << "log was read again";
+
+    return reader.beginning()
+      .then(defer(self(), &Self::read, lambda::_1, ending));
+  }
+
   VLOG(2) << "Applying operations (" << entries.size() << " entries)";
 
   // Only read and apply entries past our index.
@@ -676,6 +762,12 @@ Future<Option<Entry>> LogStorage::get(const string& name)
 }
 
 
+Future<Option<Entry>> LogStorage::follow(const string& name)
+{
+  return dispatch(process, &LogStorageProcess::follow, name);
+}
+
+
 Future<bool> LogStorage::set(const Entry& entry, const id::UUID& uuid)
 {
   return dispatch(process, &LogStorageProcess::set, entry, uuid);
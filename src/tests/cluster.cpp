@@ -426,7 +426,11 @@ Try<process::Owned<Slave>> Slave::create(
 
   // If the garbage collector is not provided, create a default one.
   if (gc.isNone()) {
-    slave->gc.reset(new slave::GarbageCollector(flags.work_dir));
+    slave->gc.reset(new slave::GarbageCollector(
+        flags.work_dir,
+        flags.gc_parallelism,
+        flags.gc_max_operations_per_second,
+        flags.gc_max_bytes_per_second));
   }
 
   // If the flag `--volume_gid_range` is specified, create a volume gid manager.
@@ -534,6 +538,17 @@ Try<process::Owned<Slave>> Slave::create(
     slave->setAuthorizationCallbacks(providedAuthorizer.get());
   }
 
+  // If artifacts are distributed between agents, serve the artifacts
+  // of this agent. The ID is unique since several agents might be run
+  // in the same process.
+  if (flags.artifact_peers.isSome()) {
+    slave->artifactServer.reset(new slave::ArtifactServer(
+        flags,
+        slave::READONLY_HTTP_AUTHENTICATION_REALM,
+        authorizer,
+        process::ID::generate(slave::ARTIFACT_SERVER_ID)));
+  }
+
   // If the resource estimator is not provided, create a default one.
   if (resourceEstimator.isNone()) {
     Try<mesos::slave::ResourceEstimator*> _resourceEstimator =
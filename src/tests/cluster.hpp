@@ -56,6 +56,7 @@
 #include "master/flags.hpp"
 #include "master/master.hpp"
 
+#include "slave/artifacts.hpp"
 #include "slave/constants.hpp"
 #include "slave/flags.hpp"
 #include "slave/gc.hpp"
@@ -229,6 +230,11 @@ private:
 
   // Dependencies that are created by the factory method.
   process::Owned<Authorizer> authorizer;
+
+  // NOTE: This is declared after `authorizer` since it is destroyed
+  // before the authorizer it uses.
+  process::Owned<slave::ArtifactServer> artifactServer;
+
   process::Owned<slave::Containerizer> ownedContainerizer;
   process::Owned<slave::Fetcher> fetcher;
   process::Owned<slave::GarbageCollector> gc;
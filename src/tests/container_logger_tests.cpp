@@ -20,6 +20,8 @@
 
 #include <gmock/gmock.h>
 
+#include <mesos/module/container_logger.hpp>
+
 #include <mesos/slave/container_logger.hpp>
 #include <mesos/slave/containerizer.hpp>
 
@@ -27,6 +29,7 @@
 #include <process/future.hpp>
 #include <process/gtest.hpp>
 #include <process/owned.hpp>
+#include <process/subprocess.hpp>
 
 #include <stout/bytes.hpp>
 #include <stout/gtest.hpp>
@@ -34,6 +37,7 @@
 #include <stout/path.hpp>
 #include <stout/strings.hpp>
 #include <stout/try.hpp>
+#include <stout/uuid.hpp>
 
 #include <stout/os/constants.hpp>
 #include <stout/os/exists.hpp>
@@ -46,6 +50,8 @@
 
 #include "master/master.hpp"
 
+#include "module/manager.hpp"
+
 #include "slave/flags.hpp"
 #include "slave/paths.hpp"
 #include "slave/slave.hpp"
@@ -82,6 +88,8 @@ using mesos::internal::slave::state::SlaveState;
 
 using mesos::master::detector::MasterDetector;
 
+using mesos::slave::ContainerConfig;
+using mesos::slave::ContainerIO;
 using mesos::slave::ContainerLogger;
 using mesos::slave::Isolator;
 
@@ -628,6 +636,186 @@ TEST_F(ContainerLoggerTest, LOGROTATE_ModuleFDOwnership)
 }
 
 
+// Tests that the logrotate container logger writes and rotates the
+// logs of a container in the multiplexed mode.
+TEST_F(ContainerLoggerTest, LOGROTATE_Multiplexed)
+{
+  const string stateDir = path::join(sandbox.get(), "state");
+  const string directory = path::join(sandbox.get(), "sandbox");
+  ASSERT_SOME(os::mkdir(directory));
+
+  Parameters parameters;
+  Parameter* parameter = parameters.add_parameter();
+  parameter->set_key("launcher_dir");
+  parameter->set_value(getLauncherDir());
+
+  parameter = parameters.add_parameter();
+  parameter->set_key("multiplexed");
+  parameter->set_value("true");
+
+  parameter = parameters.add_parameter();
+  parameter->set_key("state_dir");
+  parameter->set_value(stateDir);
+
+  parameter = parameters.add_parameter();
+  parameter->set_key("max_stdout_size");
+  parameter->set_value("1MB");
+
+  parameter = parameters.add_parameter();
+  parameter->set_key("logrotate_stdout_options");
+  parameter->set_value("rotate 2");
+
+  Try<ContainerLogger*> _logger =
+    modules::ModuleManager::create<ContainerLogger>(
+        LOGROTATE_CONTAINER_LOGGER_NAME, parameters);
+
+  ASSERT_SOME(_logger);
+  Owned<ContainerLogger> logger(_logger.get());
+  ASSERT_SOME(logger->initialize());
+
+  ContainerID containerId;
+  containerId.set_value(id::UUID::random().toString());
+
+  ContainerConfig containerConfig;
+  containerConfig.mutable_command_info();
+  containerConfig.set_directory(directory);
+
+  {
+    Future<ContainerIO> containerIO =
+      logger->prepare(containerId, containerConfig);
+
+    AWAIT_READY(containerIO);
+
+    // Write 3 MB to stdout, which fills the leading and two rotated
+    // log files.
+    Try<Subprocess> s = subprocess(
+        "i=0; while [ $i -lt 3072 ]; do printf '%01023d\\n' $i; "
+        "i=$((i+1)); done",
+        Subprocess::PATH(os::DEV_NULL),
+        containerIO->out,
+        containerIO->err);
+
+    ASSERT_SOME(s);
+    AWAIT_EXPECT_WEXITSTATUS_EQ(0, s->status());
+  }
+
+  // Stopping the logger writes out the output left in the named pipes
+  // and removes the named pipes of the terminated containers.
+  logger.reset();
+
+  const string state =
+    path::join(stateDir, stringify(containerId), "stdout.state");
+
+  ASSERT_FALSE(os::exists(state));
+
+  for (int i = 0; i < 3; i++) {
+    const string stdoutPath = path::join(
+        directory, i == 0 ? "stdout" : "stdout." + stringify(i));
+
+    Try<Bytes> stdoutSize = os::stat::size(stdoutPath);
+    ASSERT_SOME(stdoutSize);
+    EXPECT_EQ(Megabytes(1), stdoutSize.get());
+  }
+
+  EXPECT_FALSE(os::exists(path::join(directory, "stdout.3")));
+
+  // The first line was written to the oldest log file.
+  Try<string> read = os::read(path::join(directory, "stdout.2"));
+  ASSERT_SOME(read);
+  EXPECT_TRUE(strings::startsWith(read.get(), string(1023, '0') + "\n"));
+}
+
+
+// Tests that the logrotate container logger keeps the output of a
+// container in the multiplexed mode while the logger is restarted.
+TEST_F(ContainerLoggerTest, LOGROTATE_MultiplexedRecover)
+{
+  const string stateDir = path::join(sandbox.get(), "state");
+  const string directory = path::join(sandbox.get(), "sandbox");
+  ASSERT_SOME(os::mkdir(directory));
+
+  Parameters parameters;
+  Parameter* parameter = parameters.add_parameter();
+  parameter->set_key("launcher_dir");
+  parameter->set_value(getLauncherDir());
+
+  parameter = parameters.add_parameter();
+  parameter->set_key("multiplexed");
+  parameter->set_value("true");
+
+  parameter = parameters.add_parameter();
+  parameter->set_key("state_dir");
+  parameter->set_value(stateDir);
+
+  Try<ContainerLogger*> _logger =
+    modules::ModuleManager::create<ContainerLogger>(
+        LOGROTATE_CONTAINER_LOGGER_NAME, parameters);
+
+  ASSERT_SOME(_logger);
+  Owned<ContainerLogger> logger(_logger.get());
+  ASSERT_SOME(logger->initialize());
+
+  ContainerID containerId;
+  containerId.set_value(id::UUID::random().toString());
+
+  ContainerConfig containerConfig;
+  containerConfig.mutable_command_info();
+  containerConfig.set_directory(directory);
+
+  Option<ContainerIO> containerIO;
+
+  {
+    Future<ContainerIO> prepare =
+      logger->prepare(containerId, containerConfig);
+
+    AWAIT_READY(prepare);
+    containerIO = prepare.get();
+  }
+
+  Try<Subprocess> s = subprocess(
+      "echo first",
+      Subprocess::PATH(os::DEV_NULL),
+      containerIO->out,
+      containerIO->err);
+
+  ASSERT_SOME(s);
+  AWAIT_EXPECT_WEXITSTATUS_EQ(0, s->status());
+
+  // Stop the logger while the container is still running. The output
+  // written in the meantime stays in the named pipe.
+  logger.reset();
+
+  s = subprocess(
+      "echo second",
+      Subprocess::PATH(os::DEV_NULL),
+      containerIO->out,
+      containerIO->err);
+
+  ASSERT_SOME(s);
+  AWAIT_EXPECT_WEXITSTATUS_EQ(0, s->status());
+
+  _logger = modules::ModuleManager::create<ContainerLogger>(
+      LOGROTATE_CONTAINER_LOGGER_NAME, parameters);
+
+  ASSERT_SOME(_logger);
+  logger.reset(_logger.get());
+  ASSERT_SOME(logger->initialize());
+
+  // Terminate the "container" by closing its end of the named pipes.
+  containerIO = None();
+
+  // Stopping the logger writes out the output left in the named pipes
+  // and removes the named pipes of the terminated containers.
+  logger.reset();
+
+  const string state =
+    path::join(stateDir, stringify(containerId), "stdout.state");
+
+  ASSERT_FALSE(os::exists(state));
+  EXPECT_SOME_EQ("first\nsecond\n", os::read(path::join(directory, "stdout")));
+}
+
+
 // These tests are parameterized by the boolean `--switch-user` agent flag.
 class UserContainerLoggerTest
   : public ContainerLoggerTest, public WithParamInterface<bool> {};
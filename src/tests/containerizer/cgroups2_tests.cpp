@@ -0,0 +1,289 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <mesos/resources.hpp>
+
+#include <mesos/slave/isolator.hpp>
+
+#include <process/future.hpp>
+#include <process/gtest.hpp>
+#include <process/owned.hpp>
+#include <process/subprocess.hpp>
+
+#include <stout/bytes.hpp>
+#include <stout/duration.hpp>
+#include <stout/gtest.hpp>
+#include <stout/hashmap.hpp>
+#include <stout/path.hpp>
+#include <stout/strings.hpp>
+#include <stout/uuid.hpp>
+
+#include "linux/cgroups2.hpp"
+
+#include "slave/containerizer/mesos/isolators/cgroups2/cgroups2.hpp"
+
+#include "tests/mesos.hpp"
+
+using mesos::internal::slave::Cgroups2IsolatorProcess;
+
+using mesos::slave::ContainerConfig;
+using mesos::slave::Isolator;
+
+using process::Future;
+using process::Owned;
+using process::Subprocess;
+
+using std::string;
+
+namespace mesos {
+namespace internal {
+namespace tests {
+
+TEST(Cgroups2Test, ParseFlatKeyed)
+{
+  const string content =
+    "usage_usec 1500000\n"
+    "user_usec 1000000\n"
+    "system_usec 500000\n";
+
+  Try<hashmap<string, uint64_t>> values = cgroups2::parseFlatKeyed(content);
+  ASSERT_SOME(values);
+
+  EXPECT_EQ(3u, values->size());
+  EXPECT_EQ(1500000u, values->at("usage_usec"));
+  EXPECT_EQ(1000000u, values->at("user_usec"));
+  EXPECT_EQ(500000u, values->at("system_usec"));
+
+  EXPECT_ERROR(cgroups2::parseFlatKeyed("usage_usec\n"));
+  EXPECT_ERROR(cgroups2::parseFlatKeyed("usage_usec abc\n"));
+}
+
+
+TEST(Cgroups2Test, ParseIOStat)
+{
+  const string content =
+    "8:16 rbytes=1459200 wbytes=314773504 rios=192 wios=353 "
+    "dbytes=0 dios=0\n"
+    "8:0 rbytes=90430464 wbytes=299008000 rios=8950 wios=1252 "
+    "dbytes=50331648 dios=3021\n";
+
+  Try<hashmap<string, cgroups2::io::Stats>> stats =
+    cgroups2::io::parseStat(content);
+
+  ASSERT_SOME(stats);
+  ASSERT_EQ(2u, stats->size());
+
+  ASSERT_TRUE(stats->contains("8:16"));
+  EXPECT_EQ(1459200u, stats->at("8:16").rbytes);
+  EXPECT_EQ(314773504u, stats->at("8:16").wbytes);
+  EXPECT_EQ(192u, stats->at("8:16").rios);
+  EXPECT_EQ(353u, stats->at("8:16").wios);
+
+  ASSERT_TRUE(stats->contains("8:0"));
+  EXPECT_EQ(50331648u, stats->at("8:0").dbytes);
+  EXPECT_EQ(3021u, stats->at("8:0").dios);
+
+  EXPECT_ERROR(cgroups2::io::parseStat("8:0 rbytes\n"));
+  EXPECT_ERROR(cgroups2::io::parseStat("8:0 rbytes=abc\n"));
+}
+
+
+TEST(Cgroups2Test, ParseIOStatUnknownKeys)
+{
+  // With `io.cost` enabled the kernel appends the "cost.*" keys, some
+  // of which are not integers.
+  const string content =
+    "8:0 rbytes=4096 wbytes=8192 rios=1 wios=2 dbytes=0 dios=0 "
+    "cost.vrate=100.00 cost.usage=1234 cost.wait=0 cost.indebt=0 "
+    "cost.indelay=0\n";
+
+  Try<hashmap<string, cgroups2::io::Stats>> stats =
+    cgroups2::io::parseStat(content);
+
+  ASSERT_SOME(stats);
+  ASSERT_TRUE(stats->contains("8:0"));
+  EXPECT_EQ(4096u, stats->at("8:0").rbytes);
+  EXPECT_EQ(8192u, stats->at("8:0").wbytes);
+  EXPECT_EQ(1u, stats->at("8:0").rios);
+  EXPECT_EQ(2u, stats->at("8:0").wios);
+}
+
+
+TEST(Cgroups2Test, ParsePressure)
+{
+  Try<cgroups2::pressure::Pressure> pressure = cgroups2::pressure::parse(
+      "some avg10=1.53 avg60=0.87 avg300=0.20 total=2000000\n"
+      "full avg10=0.50 avg60=0.25 avg300=0.05 total=1000000\n");
+
+  ASSERT_SOME(pressure);
+
+  EXPECT_DOUBLE_EQ(1.53, pressure->some.avg10);
+  EXPECT_DOUBLE_EQ(0.87, pressure->some.avg60);
+  EXPECT_DOUBLE_EQ(0.20, pressure->some.avg300);
+  EXPECT_EQ(Seconds(2), pressure->some.total);
+
+  ASSERT_SOME(pressure->full);
+  EXPECT_DOUBLE_EQ(0.50, pressure->full->avg10);
+  EXPECT_EQ(Seconds(1), pressure->full->total);
+
+  // Older kernels do not report "full" for the cpu controller.
+  pressure = cgroups2::pressure::parse(
+      "some avg10=0.00 avg60=0.00 avg300=0.00 total=0\n");
+
+  ASSERT_SOME(pressure);
+  EXPECT_NONE(pressure->full);
+
+  EXPECT_ERROR(cgroups2::pressure::parse(""));
+  EXPECT_ERROR(cgroups2::pressure::parse("some avg10=abc\n"));
+  EXPECT_ERROR(cgroups2::pressure::parse(
+      "partial avg10=0.00 avg60=0.00 avg300=0.00 total=0\n"));
+}
+
+
+class Cgroups2IsolatorTest : public MesosTest
+{
+protected:
+  void TearDown() override
+  {
+    // The isolator creates `flags.cgroups_root` which is unique to
+    // each test, see `MesosTest::CreateSlaveFlags()`.
+    if (cgroups_root.isSome() &&
+        cgroups2::exists(cgroups2::ROOT, cgroups_root.get())) {
+      EXPECT_SOME(cgroups2::remove(cgroups2::ROOT, cgroups_root.get()));
+    }
+
+    MesosTest::TearDown();
+  }
+
+  slave::Flags CreateSlaveFlags() override
+  {
+    slave::Flags flags = MesosTest::CreateSlaveFlags();
+    flags.isolation = "cgroups2";
+
+    cgroups_root = flags.cgroups_root;
+
+    return flags;
+  }
+
+  Option<string> cgroups_root;
+};
+
+
+// Verifies that the isolator sets the cpu and memory controls of the
+// container's cgroup and that, like the cgroups v1 memory subsystem,
+// a lowered memory allocation only lowers `memory.high`.
+TEST_F(Cgroups2IsolatorTest, ROOT_CGROUPS2_Update)
+{
+  slave::Flags flags = CreateSlaveFlags();
+
+  Try<Isolator*> _isolator = Cgroups2IsolatorProcess::create(flags);
+  ASSERT_SOME(_isolator);
+
+  Owned<Isolator> isolator(_isolator.get());
+
+  ContainerID containerId;
+  containerId.set_value(id::UUID::random().toString());
+
+  ContainerConfig containerConfig;
+  containerConfig.mutable_resources()->CopyFrom(
+      Resources::parse("cpus:1;mem:128").get());
+
+  AWAIT_READY(isolator->prepare(containerId, containerConfig));
+
+  const string cgroup = path::join(flags.cgroups_root, containerId.value());
+  ASSERT_TRUE(cgroups2::exists(cgroups2::ROOT, cgroup));
+
+  auto read = [&](const string& control) -> Try<string> {
+    Try<string> content = cgroups2::read(cgroups2::ROOT, cgroup, control);
+    if (content.isError()) {
+      return content;
+    }
+
+    return strings::trim(content.get());
+  };
+
+  EXPECT_SOME_EQ("100", read("cpu.weight"));
+  EXPECT_SOME_EQ(stringify(Megabytes(128).bytes()), read("memory.high"));
+  EXPECT_SOME_EQ(stringify(Megabytes(128).bytes()), read("memory.max"));
+
+  AWAIT_READY(isolator->update(
+      containerId,
+      Resources::parse("cpus:2;mem:64").get()));
+
+  EXPECT_SOME_EQ("200", read("cpu.weight"));
+  EXPECT_SOME_EQ(stringify(Megabytes(64).bytes()), read("memory.high"));
+  EXPECT_SOME_EQ(stringify(Megabytes(128).bytes()), read("memory.max"));
+
+  AWAIT_READY(isolator->update(
+      containerId,
+      Resources::parse("cpus:2;mem:256").get()));
+
+  EXPECT_SOME_EQ(stringify(Megabytes(256).bytes()), read("memory.high"));
+  EXPECT_SOME_EQ(stringify(Megabytes(256).bytes()), read("memory.max"));
+
+  AWAIT_READY(isolator->cleanup(containerId));
+
+  EXPECT_FALSE(cgroups2::exists(cgroups2::ROOT, cgroup));
+}
+
+
+// Verifies that the isolator reports the statistics of an isolated
+// process and kills it when the container is cleaned up.
+TEST_F(Cgroups2IsolatorTest, ROOT_CGROUPS2_Usage)
+{
+  slave::Flags flags = CreateSlaveFlags();
+
+  Try<Isolator*> _isolator = Cgroups2IsolatorProcess::create(flags);
+  ASSERT_SOME(_isolator);
+
+  Owned<Isolator> isolator(_isolator.get());
+
+  ContainerID containerId;
+  containerId.set_value(id::UUID::random().toString());
+
+  ContainerConfig containerConfig;
+  containerConfig.mutable_resources()->CopyFrom(
+      Resources::parse("cpus:1;mem:128").get());
+
+  AWAIT_READY(isolator->prepare(containerId, containerConfig));
+
+  Try<Subprocess> s = process::subprocess("sleep 1000");
+  ASSERT_SOME(s);
+
+  AWAIT_READY(isolator->isolate(containerId, s->pid()));
+
+  Future<ResourceStatistics> usage = isolator->usage(containerId);
+  AWAIT_READY(usage);
+
+  EXPECT_EQ(1u, usage->processes());
+  EXPECT_EQ(Megabytes(128).bytes(), usage->mem_limit_bytes());
+
+  AWAIT_READY(isolator->cleanup(containerId));
+
+  // The process is killed as part of the cleanup.
+  AWAIT_EXPECT_WTERMSIG_EQ(SIGKILL, s->status());
+
+  const string cgroup = path::join(flags.cgroups_root, containerId.value());
+  EXPECT_FALSE(cgroups2::exists(cgroups2::ROOT, cgroup));
+}
+
+} // namespace tests {
+} // namespace internal {
+} // namespace mesos {
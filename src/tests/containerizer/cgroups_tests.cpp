@@ -1046,6 +1046,62 @@ TEST_F(CgroupsAnyHierarchyWithPerfEventTest, ROOT_CGROUPS_PERF_PerfTest)
 }
 
 
+// Tests that the counters opened with perf_event_open(2) count the
+// processes in the cgroup without running `perf`.
+TEST_F(CgroupsAnyHierarchyWithPerfEventTest, ROOT_CGROUPS_PerfCounters)
+{
+  string hierarchy = path::join(baseHierarchy, "perf_event");
+  ASSERT_SOME(cgroups::create(hierarchy, TEST_CGROUPS_ROOT));
+
+  // Only count software events so that this test does not depend on
+  // the availability of hardware counters. Both events are counted in
+  // the group on each CPU.
+  Try<Owned<perf::Counters>> counters = perf::Counters::open(
+      {"task-clock", "cpu-clock"},
+      path::join(hierarchy, TEST_CGROUPS_ROOT));
+
+  ASSERT_SOME(counters);
+
+  pid_t pid = ::fork();
+  ASSERT_NE(-1, pid);
+
+  if (pid == 0) {
+    // In child process.
+    while (true) {
+      // Don't sleep so that the counters count something.
+    }
+
+    ABORT("Child should not reach here");
+  }
+
+  // In parent.
+  ASSERT_SOME(cgroups::assign(hierarchy, TEST_CGROUPS_ROOT, pid));
+
+  os::sleep(Milliseconds(500));
+
+  Try<mesos::PerfStatistics> statistics = counters.get()->read();
+  ASSERT_SOME(statistics);
+
+  ASSERT_TRUE(statistics->has_task_clock());
+  EXPECT_LT(0.0, statistics->task_clock());
+  ASSERT_TRUE(statistics->has_cpu_clock());
+  EXPECT_LT(0.0, statistics->cpu_clock());
+  EXPECT_LT(0.0, statistics->duration());
+
+  // Kill the child process.
+  ASSERT_NE(-1, ::kill(pid, SIGKILL));
+
+  // Wait for the child process.
+  AWAIT_EXPECT_WTERMSIG_EQ(SIGKILL, reap(pid));
+
+  // Close the counters before destroying the cgroup.
+  counters->reset();
+
+  Future<Nothing> destroy = cgroups::destroy(hierarchy, TEST_CGROUPS_ROOT);
+  AWAIT_READY(destroy);
+}
+
+
 class CgroupsAnyHierarchyMemoryPressureTest
   : public CgroupsAnyHierarchyTest
 {
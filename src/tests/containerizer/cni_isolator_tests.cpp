@@ -1217,6 +1217,146 @@ TEST_F(CniIsolatorTest, ROOT_DynamicAddDelofCniConfig)
 }
 
 
+// This test verifies that the `network/cni` isolator picks up the
+// changes to the configuration of a CNI network which it has already
+// cached, i.e., the configuration file is modified in place.
+TEST_F(CniIsolatorTest, ROOT_ModifyCniConfig)
+{
+  master::Flags masterFlags = CreateMasterFlags();
+
+  Try<Owned<cluster::Master>> master = StartMaster(masterFlags);
+  ASSERT_SOME(master);
+
+  slave::Flags slaveFlags = CreateSlaveFlags();
+
+  slaveFlags.network_cni_plugins_dir = cniPluginDir;
+  slaveFlags.network_cni_config_dir = cniConfigDir;
+
+  Owned<MasterDetector> detector = master.get()->createDetector();
+
+  Try<Owned<cluster::Slave>> slave = StartSlave(detector.get(), slaveFlags);
+  ASSERT_SOME(slave);
+
+  MockScheduler sched;
+
+  // We use the filter explicitly here so that the resources will not
+  // be filtered for 5 seconds (the default).
+  Filters filters;
+  filters.set_refuse_seconds(0);
+
+  MesosSchedulerDriver driver(
+      &sched,
+      DEFAULT_FRAMEWORK_INFO,
+      master.get()->pid,
+      DEFAULT_CREDENTIAL);
+
+  EXPECT_CALL(sched, registered(_, _, _));
+
+  Future<vector<Offer>> offers;
+  EXPECT_CALL(sched, resourceOffers(&driver, _))
+    .WillOnce(FutureArg<1>(&offers))
+    .WillRepeatedly(DeclineOffers()); // Ignore subsequent offers.
+
+  driver.start();
+
+  AWAIT_READY(offers);
+  ASSERT_EQ(1u, offers->size());
+
+  const Offer& offer1 = offers.get()[0];
+
+  CommandInfo command = createCommandInfo("sleep 1000");
+
+  TaskInfo task = createTask(
+      offer1.slave_id(),
+      Resources::parse("cpus:0.1;mem:128").get(),
+      command);
+
+  ContainerInfo* container = task.mutable_container();
+  container->set_type(ContainerInfo::MESOS);
+  container->add_network_infos()->set_name("__MESOS_TEST__");
+
+  Future<TaskStatus> statusStarting;
+  Future<TaskStatus> statusRunning;
+  EXPECT_CALL(sched, statusUpdate(&driver, _))
+    .WillOnce(FutureArg<1>(&statusStarting))
+    .WillOnce(FutureArg<1>(&statusRunning));
+
+  Future<Nothing> ackRunning =
+    FUTURE_DISPATCH(_, &Slave::_statusUpdateAcknowledgement);
+
+  Future<Nothing> ackStarting =
+    FUTURE_DISPATCH(_, &Slave::_statusUpdateAcknowledgement);
+
+  driver.launchTasks(offer1.id(), {task}, filters);
+
+  AWAIT_READY_FOR(statusStarting, Seconds(60));
+  EXPECT_EQ(task.task_id(), statusStarting->task_id());
+  EXPECT_EQ(TASK_STARTING, statusStarting->state());
+
+  AWAIT_READY(ackStarting);
+
+  AWAIT_READY_FOR(statusRunning, Seconds(60));
+  EXPECT_EQ(task.task_id(), statusRunning->task_id());
+  EXPECT_EQ(TASK_RUNNING, statusRunning->state());
+
+  // To avoid having the agent resending the `TASK_RUNNING` update, which can
+  // happen due to clock manipulation below, wait for the status update
+  // acknowledgement to reach the agent.
+  AWAIT_READY(ackRunning);
+
+  // Modify the CNI config in place such that the network can no
+  // longer be joined, since the 'org.apache.mesos' args are reserved.
+  Try<Nothing> write = os::write(
+      path::join(cniConfigDir, MESOS_MOCK_CNI_CONFIG),
+      R"~(
+      {
+        "name": "__MESOS_TEST__",
+        "type": "mockPlugin",
+        "args": {
+          "org.apache.mesos": {}
+        }
+      })~");
+
+  ASSERT_SOME(write);
+
+  EXPECT_CALL(sched, resourceOffers(&driver, _))
+    .WillOnce(FutureArg<1>(&offers))
+    .WillRepeatedly(DeclineOffers()); // Ignore subsequent offers.
+
+  Clock::pause();
+  Clock::advance(masterFlags.allocation_interval);
+  Clock::settle();
+  Clock::resume();
+
+  AWAIT_READY(offers);
+  ASSERT_EQ(1u, offers->size());
+
+  const Offer& offer2 = offers.get()[0];
+
+  task = createTask(
+      offer2.slave_id(),
+      Resources::parse("cpus:0.1;mem:128").get(),
+      command);
+
+  container = task.mutable_container();
+  container->set_type(ContainerInfo::MESOS);
+  container->add_network_infos()->set_name("__MESOS_TEST__");
+
+  Future<TaskStatus> statusFailed;
+  EXPECT_CALL(sched, statusUpdate(&driver, _))
+    .WillOnce(FutureArg<1>(&statusFailed));
+
+  driver.launchTasks(offer2.id(), {task}, filters);
+
+  AWAIT_READY_FOR(statusFailed, Seconds(60));
+  EXPECT_EQ(task.task_id(), statusFailed->task_id());
+  EXPECT_EQ(TASK_FAILED, statusFailed->state());
+
+  driver.stop();
+  driver.join();
+}
+
+
 // This test verifies that the hostname of the container can be
 // overridden by setting hostname field in ContainerInfo.
 TEST_F(CniIsolatorTest, ROOT_OverrideHostname)
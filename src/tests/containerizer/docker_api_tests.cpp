@@ -0,0 +1,224 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <signal.h>
+
+#include <atomic>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <process/address.hpp>
+#include <process/future.hpp>
+#include <process/gtest.hpp>
+#include <process/http.hpp>
+#include <process/owned.hpp>
+#include <process/socket.hpp>
+
+#include <stout/duration.hpp>
+#include <stout/gtest.hpp>
+#include <stout/nothing.hpp>
+#include <stout/os.hpp>
+#include <stout/path.hpp>
+
+#include <stout/tests/utils.hpp>
+
+#include "docker/docker.hpp"
+
+namespace http = process::http;
+namespace unix = process::network::unix;
+
+using process::Future;
+using process::Owned;
+using process::Promise;
+
+using std::string;
+using std::vector;
+
+namespace mesos {
+namespace internal {
+namespace tests {
+
+// The output of the stub daemon for a container which has not started
+// yet, and for the same container once it has started.
+static const string CREATED_CONTAINER =
+  "{\"Id\":\"0123456789ab\",\"Name\":\"/mesos-test\","
+  "\"State\":{\"Pid\":0,\"StartedAt\":\"0001-01-01T00:00:00Z\"},"
+  "\"NetworkSettings\":{\"IPAddress\":\"\"}}";
+
+static const string STARTED_CONTAINER =
+  "{\"Id\":\"0123456789ab\",\"Name\":\"/mesos-test\","
+  "\"State\":{\"Pid\":42,\"StartedAt\":\"2019-01-01T00:00:00Z\"},"
+  "\"NetworkSettings\":{\"IPAddress\":\"\"}}";
+
+
+// Tests the Engine API client of `Docker` against a stub daemon
+// serving on a unix domain socket in the sandbox.
+class DockerAPITest : public TemporaryDirectoryTest
+{
+protected:
+  void SetUp() override
+  {
+    TemporaryDirectoryTest::SetUp();
+
+    socket = path::join(sandbox.get(), "docker.sock");
+
+    Try<unix::Address> address = unix::Address::create(socket);
+    ASSERT_SOME(address);
+
+    Try<http::Server> _server = http::Server::create(
+        address.get(),
+        [this](const process::network::Socket&, const http::Request& request) {
+          return handle(request);
+        });
+
+    ASSERT_SOME(_server);
+
+    server.reset(new http::Server(std::move(_server.get())));
+    run = server->run();
+  }
+
+  void TearDown() override
+  {
+    if (events.future().isReady()) {
+      http::Pipe::Writer writer = events.future().get();
+      writer.close();
+    }
+
+    AWAIT_READY(server->stop());
+    AWAIT_READY(run);
+
+    TemporaryDirectoryTest::TearDown();
+  }
+
+  Future<http::Response> handle(const http::Request& request)
+  {
+    const string method = request.method;
+    const string path = request.url.path;
+
+    if (method == "GET" && path == "/containers/mesos-test/json") {
+      if (++inspects == 1) {
+        inspected.set(Nothing());
+      }
+
+      return http::OK(started ? STARTED_CONTAINER : CREATED_CONTAINER);
+    } else if (method == "GET" && path == "/containers/json") {
+      return http::OK("[{\"Names\":[\"/mesos-test\"]},{\"Names\":[\"/x\"]}]");
+    } else if (method == "POST" && path == "/containers/mesos-test/stop") {
+      return request.url.query.get("t") == string("5")
+        ? http::Response(http::Status::NO_CONTENT)
+        : http::BadRequest();
+    } else if (method == "POST" && path == "/containers/mesos-test/kill") {
+      return request.url.query.get("signal") == string("9")
+        ? http::Response(http::Status::NO_CONTENT)
+        : http::BadRequest();
+    } else if (method == "DELETE" && path == "/containers/mesos-test") {
+      return request.url.query.get("v") == string("1")
+        ? http::Response(http::Status::NO_CONTENT)
+        : http::BadRequest();
+    } else if (method == "GET" && path == "/events") {
+      http::Pipe pipe;
+      events.set(pipe.writer());
+
+      http::OK ok;
+      ok.type = http::Response::PIPE;
+      ok.reader = pipe.reader();
+      return ok;
+    }
+
+    return http::NotFound("{\"message\":\"No such container\"}");
+  }
+
+  string socket;
+
+  Owned<http::Server> server;
+  Future<Nothing> run;
+
+  std::atomic<bool> started{false};
+  std::atomic<int> inspects{0};
+  Promise<Nothing> inspected;
+  Promise<http::Pipe::Writer> events;
+};
+
+
+TEST_F(DockerAPITest, Operations)
+{
+  Try<Owned<Docker>> docker = Docker::create("docker", socket, false);
+  ASSERT_SOME(docker);
+
+  started = true;
+
+  Future<Docker::Container> container = docker.get()->inspect("mesos-test");
+  AWAIT_READY(container);
+  EXPECT_EQ("0123456789ab", container->id);
+  EXPECT_EQ("/mesos-test", container->name);
+  EXPECT_SOME_EQ(42, container->pid);
+
+  AWAIT_FAILED(docker.get()->inspect("unknown"));
+
+  Future<vector<Docker::Container>> containers =
+    docker.get()->ps(true, string("mesos-"));
+
+  AWAIT_READY(containers);
+  ASSERT_EQ(1u, containers->size());
+  EXPECT_EQ("0123456789ab", containers->front().id);
+
+  AWAIT_READY(docker.get()->stop("mesos-test", Seconds(5)));
+  AWAIT_READY(docker.get()->kill("mesos-test", SIGKILL));
+  AWAIT_READY(docker.get()->rm("mesos-test"));
+
+  AWAIT_FAILED(docker.get()->rm("unknown"));
+}
+
+
+// Tests that inspecting a container until it starts waits for the
+// start event of the daemon rather than polling.
+TEST_F(DockerAPITest, InspectWaitsForStart)
+{
+  Try<Owned<Docker>> docker = Docker::create("docker", socket, false);
+  ASSERT_SOME(docker);
+
+  // The retry interval is longer than the test timeout, so the inspect
+  // can only complete due to the event.
+  Future<Docker::Container> container =
+    docker.get()->inspect("mesos-test", Minutes(10));
+
+  AWAIT_READY(events.future());
+
+  http::Pipe::Writer writer = events.future().get();
+
+  // Wait for the container to be inspected before it starts.
+  AWAIT_READY(inspected.future());
+
+  EXPECT_TRUE(container.isPending());
+
+  started = true;
+
+  writer.write(
+      "{\"Type\":\"container\",\"Action\":\"start\","
+      "\"Actor\":{\"ID\":\"0123456789ab\","
+      "\"Attributes\":{\"name\":\"mesos-test\"}}}\n");
+
+  AWAIT_READY(container);
+  EXPECT_TRUE(container->started);
+  EXPECT_EQ(2, inspects);
+}
+
+} // namespace tests {
+} // namespace internal {
+} // namespace mesos {
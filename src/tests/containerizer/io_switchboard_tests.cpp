@@ -23,6 +23,7 @@
 #include <process/address.hpp>
 #include <process/future.hpp>
 #include <process/http.hpp>
+#include <process/io.hpp>
 #include <process/owned.hpp>
 
 #include <stout/json.hpp>
@@ -45,6 +46,8 @@
 
 #include "messages/messages.hpp"
 
+#include "slave/state.hpp"
+
 #include "slave/containerizer/mesos/paths.hpp"
 
 #include "slave/containerizer/mesos/io/switchboard.hpp"
@@ -264,6 +267,239 @@ TEST_F(IOSwitchboardServerTest, RedirectLog)
 }
 
 
+// Tests that the io switchboard server redirects the output of a
+// container to a pipe and a file, and checkpoints the statistics of
+// the redirected data.
+TEST_F(IOSwitchboardServerTest, RedirectStatistics)
+{
+  Try<int> nullFd = os::open(os::DEV_NULL, O_RDWR);
+  ASSERT_SOME(nullFd);
+
+  Try<std::array<int_fd, 2>> stdoutPipe_ = os::pipe();
+  ASSERT_SOME(stdoutPipe_);
+
+  const std::array<int_fd, 2>& stdoutPipe = stdoutPipe_.get();
+
+  Try<std::array<int_fd, 2>> stderrPipe_ = os::pipe();
+  ASSERT_SOME(stderrPipe_);
+
+  const std::array<int_fd, 2>& stderrPipe = stderrPipe_.get();
+
+  // The stdout is redirected to a pipe, like the one of a container
+  // logger, and the stderr to a file.
+  Try<std::array<int_fd, 2>> loggerPipe_ = os::pipe();
+  ASSERT_SOME(loggerPipe_);
+
+  const std::array<int_fd, 2>& loggerPipe = loggerPipe_.get();
+
+  string stderrPath = path::join(sandbox.get(), "stderr");
+  Try<int> stderrFd = os::open(
+      stderrPath,
+      O_RDWR | O_CREAT,
+      S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+
+  ASSERT_SOME(stderrFd);
+
+  string socketPath = path::join(sandbox.get(), "mesos-io-switchboard");
+  string statisticsPath = path::join(sandbox.get(), "statistics");
+
+  Try<Owned<IOSwitchboardServer>> server = IOSwitchboardServer::create(
+      false,
+      nullFd.get(),
+      stdoutPipe[0],
+      loggerPipe[1],
+      stderrPipe[0],
+      stderrFd.get(),
+      socketPath,
+      false,
+      None(),
+      statisticsPath);
+
+  ASSERT_SOME(server);
+
+  Future<string> logged = process::io::read(loggerPipe[0]);
+
+  Future<Nothing> runServer = server.get()->run();
+
+  string data =
+    "Lorem ipsum dolor sit amet, consectetur adipisicing elit, sed do "
+    "eiusmod tempor incididunt ut labore et dolore magna aliqua. Ut enim "
+    "ad minim veniam, quis nostrud exercitation ullamco laboris nisi ut "
+    "aliquip ex ea commodo consequat. Duis aute irure dolor in "
+    "reprehenderit in voluptate velit esse cillum dolore eu fugiat nulla "
+    "pariatur. Excepteur sint occaecat cupidatat non proident, sunt in "
+    "culpa qui officia deserunt mollit anim id est laborum.";
+
+  while (Bytes(data.size()) < Megabytes(1)) {
+    data.append(data);
+  }
+
+  Try<Nothing> write = os::write(stdoutPipe[1], data);
+  ASSERT_SOME(write);
+
+  write = os::write(stderrPipe[1], data);
+  ASSERT_SOME(write);
+
+  os::close(stdoutPipe[1]);
+  os::close(stderrPipe[1]);
+
+  AWAIT_ASSERT_READY(runServer);
+
+  os::close(loggerPipe[1]);
+
+  AWAIT_EXPECT_EQ(data, logged);
+
+  os::close(nullFd.get());
+  os::close(stdoutPipe[0]);
+  os::close(stderrPipe[0]);
+  os::close(loggerPipe[0]);
+  os::close(stderrFd.get());
+
+  Try<string> read = os::read(stderrPath);
+  ASSERT_SOME(read);
+
+  EXPECT_EQ(data, read.get());
+
+  Result<IOSwitchboardStatistics> statistics =
+    slave::state::read<IOSwitchboardStatistics>(statisticsPath);
+
+  ASSERT_SOME(statistics);
+  EXPECT_EQ(data.size(), statistics->stdout_bytes());
+  EXPECT_EQ(data.size(), statistics->stderr_bytes());
+  EXPECT_EQ(0u, statistics->output_records());
+
+#ifdef __linux__
+  // Without attached clients, all data is spliced.
+  EXPECT_EQ(2 * data.size(), statistics->zero_copy_bytes());
+#endif // __linux__
+}
+
+
+// Tests that the io switchboard server sends the output of a container
+// to both an attached client and a pipe, and checkpoints the statistics
+// of the batches sent to the client.
+TEST_F(IOSwitchboardServerTest, RedirectStatisticsAttachOutput)
+{
+  Try<int> nullFd = os::open(os::DEV_NULL, O_RDWR);
+  ASSERT_SOME(nullFd);
+
+  Try<std::array<int_fd, 2>> stdoutPipe_ = os::pipe();
+  ASSERT_SOME(stdoutPipe_);
+
+  const std::array<int_fd, 2>& stdoutPipe = stdoutPipe_.get();
+
+  Try<std::array<int_fd, 2>> loggerPipe_ = os::pipe();
+  ASSERT_SOME(loggerPipe_);
+
+  const std::array<int_fd, 2>& loggerPipe = loggerPipe_.get();
+
+  string socketPath = path::join(sandbox.get(), "mesos-io-switchboard");
+  string statisticsPath = path::join(sandbox.get(), "statistics");
+
+  // The server waits for the client to attach before it redirects the
+  // output, so that all of the output is duplicated with `tee`.
+  Try<Owned<IOSwitchboardServer>> server = IOSwitchboardServer::create(
+      false,
+      nullFd.get(),
+      stdoutPipe[0],
+      loggerPipe[1],
+      nullFd.get(),
+      nullFd.get(),
+      socketPath,
+      true,
+      None(),
+      statisticsPath);
+
+  ASSERT_SOME(server);
+
+  Future<string> logged = process::io::read(loggerPipe[0]);
+
+  Future<Nothing> runServer = server.get()->run();
+
+  ContainerID containerId;
+  containerId.set_value(id::UUID::random().toString());
+
+  Try<unix::Address> address = unix::Address::create(socketPath);
+  ASSERT_SOME(address);
+
+  Future<http::Connection> _connection =
+    http::connect(address.get(), http::Scheme::HTTP);
+
+  AWAIT_READY(_connection);
+  http::Connection connection = _connection.get();
+
+  Future<http::Response> response = attachOutput(containerId, connection);
+
+  AWAIT_EXPECT_RESPONSE_STATUS_EQ(http::OK().status, response);
+  ASSERT_EQ(http::Response::PIPE, response->type);
+  ASSERT_SOME(response->reader);
+
+  Future<tuple<string, string>> received =
+    getProcessIOData(response->reader.get());
+
+  string data =
+    "Lorem ipsum dolor sit amet, consectetur adipisicing elit, sed do "
+    "eiusmod tempor incididunt ut labore et dolore magna aliqua. Ut enim "
+    "ad minim veniam, quis nostrud exercitation ullamco laboris nisi ut "
+    "aliquip ex ea commodo consequat. Duis aute irure dolor in "
+    "reprehenderit in voluptate velit esse cillum dolore eu fugiat nulla "
+    "pariatur. Excepteur sint occaecat cupidatat non proident, sunt in "
+    "culpa qui officia deserunt mollit anim id est laborum.";
+
+  while (Bytes(data.size()) < Megabytes(1)) {
+    data.append(data);
+  }
+
+  // NOTE: The data is larger than the logger pipe, so the server has
+  // to wait for the pipe to be read while the data is being sent.
+  Try<Nothing> write = os::write(stdoutPipe[1], data);
+  ASSERT_SOME(write);
+
+  os::close(stdoutPipe[1]);
+
+  AWAIT_READY(received);
+
+  string stdoutReceived;
+  string stderrReceived;
+
+  tie(stdoutReceived, stderrReceived) = received.get();
+
+  EXPECT_EQ(data, stdoutReceived);
+  EXPECT_TRUE(stderrReceived.empty());
+
+  AWAIT_READY(connection.disconnect());
+  AWAIT_READY(connection.disconnected());
+
+  AWAIT_ASSERT_READY(runServer);
+
+  os::close(loggerPipe[1]);
+
+  AWAIT_EXPECT_EQ(data, logged);
+
+  os::close(nullFd.get());
+  os::close(stdoutPipe[0]);
+  os::close(loggerPipe[0]);
+
+  Result<IOSwitchboardStatistics> statistics =
+    slave::state::read<IOSwitchboardStatistics>(statisticsPath);
+
+  ASSERT_SOME(statistics);
+  EXPECT_EQ(data.size(), statistics->stdout_bytes());
+  EXPECT_EQ(0u, statistics->stderr_bytes());
+
+  // There is only stdout, so every batch holds a single record into
+  // which the chunks read in between flushes are coalesced.
+  EXPECT_LT(0u, statistics->output_batches());
+  EXPECT_EQ(statistics->output_batches(), statistics->output_records());
+
+#ifdef __linux__
+  // The data for the pipe is duplicated with `tee`, only the data for
+  // the client is copied.
+  EXPECT_EQ(data.size(), statistics->zero_copy_bytes());
+#endif // __linux__
+}
+
+
 TEST_F(IOSwitchboardServerTest, AttachOutput)
 {
   Try<int> nullFd = os::open(os::DEV_NULL, O_RDWR);
@@ -56,6 +56,25 @@ TEST_F(PerfTest, ROOT_PERF_Events)
 }
 
 
+TEST_F(PerfTest, CountersValid)
+{
+  EXPECT_TRUE(perf::Counters::valid({}));
+
+  // Hardware, software and hardware cache events.
+  EXPECT_TRUE(perf::Counters::valid(
+      {"cycles", "instructions", "task-clock", "LLC-load-misses"}));
+
+  EXPECT_TRUE(perf::Counters::valid({"dTLB-loads", "node-prefetch-misses"}));
+
+  // Events which have no field in PerfStatistics.
+  EXPECT_FALSE(perf::Counters::valid({"cycles", "invalid-event"}));
+  EXPECT_FALSE(perf::Counters::valid({"iTLB-stores"}));
+
+  // Raw events are not supported.
+  EXPECT_FALSE(perf::Counters::valid({"r003c"}));
+}
+
+
 TEST_F(PerfTest, ROOT_PERF_Sample)
 {
   // Sampling an empty set of cgroups should be a no-op.
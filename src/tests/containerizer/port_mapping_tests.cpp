@@ -17,6 +17,7 @@
 #include <cmath>
 #include <iostream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <gmock/gmock.h>
@@ -172,6 +173,12 @@ static void cleanup(const string& eth0, const string& lo)
     }
   }
 
+  // Remove the BPF map pinned by the isolator if it exists. The BPF
+  // filters using it are gone with the ingress qdiscs above.
+  if (os::exists(slave::PORT_MAPPING_BPF_MAP_PATH())) {
+    ASSERT_SOME(os::rm(slave::PORT_MAPPING_BPF_MAP_PATH()));
+  }
+
   if (os::exists(slave::PORT_MAPPING_BIND_MOUNT_ROOT())) {
     Try<list<string>> entries = os::ls(slave::PORT_MAPPING_BIND_MOUNT_ROOT());
     ASSERT_SOME(entries);
@@ -1019,6 +1026,165 @@ TEST_F(PortMappingIsolatorTest, ROOT_NC_HostToContainerTCP)
 }
 
 
+// Verifies that the kernel verifier accepts the BPF programs which
+// the isolator attaches to host eth0 and host lo when
+// `--network_enable_bpf_port_mapping` is set.
+TEST_F(PortMappingIsolatorTest, ROOT_BPFPortsProgram)
+{
+  Try<int> map = createPortsMap();
+  ASSERT_SOME(map);
+
+  Result<net::MAC> mac = net::mac(eth0);
+  ASSERT_SOME(mac);
+
+  Try<int> eth0Program =
+    loadPortsProgram(map.get(), std::make_pair(mac.get(), hostIP));
+
+  ASSERT_SOME(eth0Program);
+
+  Try<int> loProgram = loadPortsProgram(map.get(), None());
+  ASSERT_SOME(loProgram);
+
+  os::close(eth0Program.get());
+  os::close(loProgram.get());
+  os::close(map.get());
+}
+
+
+// Same as 'ROOT_NC_HostToContainerTCP', but with the BPF data path on
+// the ingress of host eth0 and host lo. Also verifies that the packets
+// redirected by the BPF programs are reported in the statistics.
+TEST_F(PortMappingIsolatorTest, ROOT_NC_HostToContainerTCPWithBPF)
+{
+  flags.network_enable_bpf_port_mapping = true;
+
+  Try<Isolator*> isolator = PortMappingIsolatorProcess::create(flags);
+  ASSERT_SOME(isolator);
+
+  EXPECT_TRUE(os::exists(slave::PORT_MAPPING_BPF_MAP_PATH()));
+
+  Try<Launcher*> launcher = LinuxLauncher::create(flags);
+  ASSERT_SOME(launcher);
+
+  // Set the executor's resources.
+  ExecutorInfo executorInfo;
+  executorInfo.mutable_resources()->CopyFrom(
+      Resources::parse(container1Ports).get());
+
+  ContainerID containerId;
+  containerId.set_value(id::UUID::random().toString());
+
+  // Use a relative temporary directory so it gets cleaned up
+  // automatically with the test.
+  Try<string> dir = os::mkdtemp(path::join(os::getcwd(), "XXXXXX"));
+  ASSERT_SOME(dir);
+
+  ContainerConfig containerConfig;
+  containerConfig.mutable_executor_info()->CopyFrom(executorInfo);
+  containerConfig.set_directory(dir.get());
+
+  Future<Option<ContainerLaunchInfo>> launchInfo =
+    isolator.get()->prepare(
+        containerId,
+        containerConfig);
+
+  AWAIT_READY(launchInfo);
+  ASSERT_SOME(launchInfo.get());
+  ASSERT_EQ(1, launchInfo.get()->pre_exec_commands().size());
+
+  ostringstream command1;
+
+  // Listen to 'localhost' and 'Port'.
+  command1 << "nc -l localhost " << validPort << " > " << trafficViaLoopback
+           << "&";
+
+  // Listen to 'public IP' and 'Port'.
+  command1 << "nc -l " << hostIP << " " << validPort << " > "
+           << trafficViaPublic << "&";
+
+  // Touch the guard file.
+  command1 << "touch " << container1Ready;
+
+  int pipes[2];
+  ASSERT_NE(-1, ::pipe(pipes));
+
+  Try<pid_t> pid = launchHelper(
+      launcher.get(),
+      pipes,
+      containerId,
+      command1.str(),
+      launchInfo.get());
+
+  ASSERT_SOME(pid);
+
+  // Reap the forked child.
+  Future<Option<int>> status = process::reap(pid.get());
+
+  // Continue in the parent.
+  ::close(pipes[0]);
+
+  // Isolate the forked child.
+  AWAIT_READY(isolator.get()->isolate(containerId, pid.get()));
+
+  // Now signal the child to continue.
+  char dummy;
+  ASSERT_LT(0, ::write(pipes[1], &dummy, sizeof(dummy)));
+  ::close(pipes[1]);
+
+  // Wait for the command to start.
+  ASSERT_TRUE(waitForFileCreation(container1Ready));
+
+  // Send to 'localhost' and 'port'.
+  ostringstream command2;
+  command2 << "printf hello1 | nc localhost " << validPort;
+  ASSERT_SOME(os::shell(command2.str()));
+
+  // Send to 'localhost' and 'invalidPort'. This should fail because TCP
+  // connection couldn't be established.
+  ostringstream command3;
+  command3 << "printf hello2 | nc localhost " << invalidPort;
+  ASSERT_ERROR(os::shell(command3.str()));
+
+  // Send to 'public IP' and 'port'.
+  ostringstream command4;
+  command4 << "printf hello3 | nc " << hostIP << " " << validPort;
+  ASSERT_SOME(os::shell(command4.str()));
+
+  EXPECT_SOME_EQ("hello1", os::read(trafficViaLoopback));
+  EXPECT_SOME_EQ("hello3", os::read(trafficViaPublic));
+
+  Future<ResourceStatistics> usage = isolator.get()->usage(containerId);
+  AWAIT_READY(usage);
+
+  Option<TrafficControlStatistics> bpf;
+  foreach (const TrafficControlStatistics& statistics,
+           usage->net_traffic_control_statistics()) {
+    if (statistics.id() == NET_ISOLATOR_INGRESS_BPF) {
+      bpf = statistics;
+    }
+  }
+
+  ASSERT_SOME(bpf);
+  EXPECT_LT(0u, bpf->packets());
+  EXPECT_LT(0u, bpf->bytes());
+
+  // The data path cannot be switched while the container is using it.
+  slave::Flags flagsWithoutBPF = flags;
+  flagsWithoutBPF.network_enable_bpf_port_mapping = false;
+
+  EXPECT_ERROR(PortMappingIsolatorProcess::create(flagsWithoutBPF));
+
+  // Ensure all processes are killed.
+  AWAIT_READY(launcher.get()->destroy(containerId));
+
+  // Let the isolator clean up.
+  AWAIT_READY(isolator.get()->cleanup(containerId));
+
+  delete isolator.get();
+  delete launcher.get();
+}
+
+
 // Test the scenario where a container issues ICMP requests to
 // external hosts.
 TEST_F(PortMappingIsolatorTest, ROOT_ContainerICMPExternal)
@@ -27,6 +27,7 @@
 #include <stout/os.hpp>
 #include <stout/path.hpp>
 #include <stout/stringify.hpp>
+#include <stout/strings.hpp>
 #include <stout/uuid.hpp>
 
 #include <stout/os/realpath.hpp>
@@ -60,6 +61,7 @@ using std::list;
 using std::string;
 using std::vector;
 
+using process::Clock;
 using process::Future;
 using process::Owned;
 using process::Process;
@@ -70,6 +72,7 @@ using testing::Return;
 using mesos::internal::slave::BIND_BACKEND;
 using mesos::internal::slave::COPY_BACKEND;
 using mesos::internal::slave::Fetcher;
+using mesos::internal::slave::OVERLAY_BACKEND;
 using mesos::internal::slave::Provisioner;
 using mesos::internal::slave::appc::Store;
 
@@ -278,7 +281,122 @@ TEST_F(AppcStoreTest, Recover)
 }
 
 
-class ProvisionerAppcTest : public AppcStoreTest {};
+class ProvisionerAppcTest : public AppcStoreTest
+{
+protected:
+  // Verifies that a container claims a rootfs provisioned with the
+  // given backend from the pool of rootfses which are provisioned
+  // ahead of time, that the pool is refilled afterwards, and that the
+  // pooled rootfses are cleaned up by the next provisioner.
+  void claimPooledRootfs(const string& backend)
+  {
+    Image image;
+    image.set_type(Image::APPC);
+    image.mutable_appc()->CopyFrom(getTestImage());
+
+    ContainerPoolConfig poolConfig;
+    poolConfig.add_entries()->mutable_image()->CopyFrom(image);
+
+    // Create provisioner.
+    slave::Flags flags;
+    flags.image_providers = "APPC";
+    flags.appc_store_dir = path::join(os::getcwd(), "store");
+    flags.image_provisioner_backend = backend;
+    flags.work_dir = path::join(sandbox.get(), "work_dir");
+    flags.container_pool_config = poolConfig;
+
+    Try<Owned<Provisioner>> provisioner = Provisioner::create(flags);
+    ASSERT_SOME(provisioner);
+
+    Try<string> createImage = createTestImage(
+        flags.appc_store_dir,
+        getManifest());
+
+    ASSERT_SOME(createImage);
+
+    // Recover. This is when the image in the store is loaded and the
+    // pool starts to be filled.
+    Future<Nothing> refilled =
+      FUTURE_DISPATCH(_, &slave::ProvisionerProcess::_refill);
+
+    AWAIT_READY(provisioner.get()->recover({}));
+    AWAIT_READY(refilled);
+
+    // Wait for the pooled rootfs to be added to the pool.
+    Clock::pause();
+    Clock::settle();
+    Clock::resume();
+
+    JSON::Object metrics = Metrics();
+    EXPECT_EQ(
+        1, metrics.values["containerizer/mesos/provisioner/pool_refills"]);
+
+    ContainerID containerId;
+    containerId.set_value(id::UUID::random().toString());
+
+    // The claimed rootfs is replaced in the pool.
+    refilled = FUTURE_DISPATCH(_, &slave::ProvisionerProcess::_refill);
+
+    Future<slave::ProvisionInfo> provisionInfo =
+      provisioner.get()->provision(containerId, image);
+    AWAIT_READY(provisionInfo);
+
+    metrics = Metrics();
+    EXPECT_EQ(
+        1, metrics.values["containerizer/mesos/provisioner/pool_claims"]);
+
+    const string provisionerDir =
+      slave::paths::getProvisionerDir(flags.work_dir);
+
+    const string containerDir =
+      slave::provisioner::paths::getContainerDir(
+          provisionerDir,
+          containerId);
+
+    // The pooled rootfs has been moved to the container.
+    EXPECT_TRUE(strings::startsWith(provisionInfo->rootfs, containerDir));
+    EXPECT_TRUE(os::exists(provisionInfo->rootfs));
+
+    AWAIT_READY(refilled);
+
+    Clock::pause();
+    Clock::settle();
+    Clock::resume();
+
+    metrics = Metrics();
+    EXPECT_EQ(
+        2, metrics.values["containerizer/mesos/provisioner/pool_refills"]);
+
+    Try<hashset<ContainerID>> containers =
+      slave::provisioner::paths::listContainers(provisionerDir);
+
+    ASSERT_SOME(containers);
+    EXPECT_EQ(2u, containers->size());
+    EXPECT_TRUE(containers->contains(containerId));
+
+    Future<bool> destroy = provisioner.get()->destroy(containerId);
+    AWAIT_READY(destroy);
+    EXPECT_TRUE(destroy.get());
+
+    // The container directory is successfully cleaned up.
+    EXPECT_FALSE(os::exists(containerDir));
+
+    provisioner->reset();
+
+    // A new provisioner without a pool destroys the pooled rootfs.
+    flags.container_pool_config = None();
+
+    provisioner = Provisioner::create(flags);
+    ASSERT_SOME(provisioner);
+
+    AWAIT_READY(provisioner.get()->recover({}));
+
+    containers = slave::provisioner::paths::listContainers(provisionerDir);
+
+    ASSERT_SOME(containers);
+    EXPECT_TRUE(containers->empty());
+  }
+};
 
 
 #ifdef __linux__
@@ -488,6 +606,32 @@ TEST_F(ProvisionerAppcTest, Recover)
 }
 
 
+// This test verifies that a container claims a rootfs from the pool
+// of rootfses which are provisioned ahead of time with the copy
+// backend.
+TEST_F(ProvisionerAppcTest, ClaimPooledRootfs)
+{
+  claimPooledRootfs(COPY_BACKEND);
+}
+
+
+#ifdef __linux__
+// Same as above but with the bind backend, whose rootfs is a mount
+// which is moved along with the pooled container directory.
+TEST_F(ProvisionerAppcTest, ROOT_ClaimPooledRootfsBindBackend)
+{
+  claimPooledRootfs(BIND_BACKEND);
+}
+
+
+// Same as above but with the overlay backend.
+TEST_F(ProvisionerAppcTest, ROOT_OVERLAYFS_ClaimPooledRootfsOverlayBackend)
+{
+  claimPooledRootfs(OVERLAY_BACKEND);
+}
+#endif // __linux__
+
+
 // This test verifies that the provisioner can recover the rootfses
 // for both parent and child containers.
 TEST_F(ProvisionerAppcTest, RecoverNestedContainer)
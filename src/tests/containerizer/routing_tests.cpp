@@ -17,6 +17,7 @@
 #include <signal.h>
 #include <unistd.h>
 
+#include <linux/pkt_cls.h>
 #include <linux/version.h>
 
 #include <sys/types.h>
@@ -36,6 +37,8 @@
 #include <stout/net.hpp>
 #include <stout/stringify.hpp>
 
+#include "linux/ebpf.hpp"
+
 #include "linux/routing/handle.hpp"
 #include "linux/routing/route.hpp"
 #include "linux/routing/utils.hpp"
@@ -43,6 +46,7 @@
 #include "linux/routing/diagnosis/diagnosis.hpp"
 
 #include "linux/routing/filter/basic.hpp"
+#include "linux/routing/filter/bpf.hpp"
 #include "linux/routing/filter/handle.hpp"
 #include "linux/routing/filter/icmp.hpp"
 #include "linux/routing/filter/ip.hpp"
@@ -1337,6 +1341,101 @@ TEST_F(RoutingVethTest, ROOT_IPFilterRemove)
 }
 
 
+TEST_F(RoutingVethTest, ROOT_BPFFilterCreate)
+{
+  ASSERT_SOME(link::veth::create(TEST_VETH_LINK, TEST_PEER_LINK, None()));
+
+  EXPECT_SOME_TRUE(link::exists(TEST_VETH_LINK));
+  EXPECT_SOME_TRUE(link::exists(TEST_PEER_LINK));
+
+  ASSERT_SOME_TRUE(ingress::create(TEST_VETH_LINK));
+
+  // A program which passes all packets on to the next filter.
+  ebpf::Assembler assembler;
+  assembler
+    .emit(ebpf::insn::movImm(BPF_REG_0, TC_ACT_UNSPEC))
+    .emit(ebpf::insn::exit());
+
+  Try<vector<bpf_insn>> instructions = assembler.assemble();
+  ASSERT_SOME(instructions);
+
+  Try<int> program = ebpf::load(
+      BPF_PROG_TYPE_SCHED_CLS,
+      instructions.get(),
+      "Apache-2.0");
+
+  ASSERT_SOME(program);
+
+  EXPECT_SOME_FALSE(bpf::update(
+      TEST_VETH_LINK,
+      ingress::HANDLE,
+      ETH_P_IP,
+      program.get(),
+      "test"));
+
+  EXPECT_SOME_TRUE(bpf::create(
+      TEST_VETH_LINK,
+      ingress::HANDLE,
+      ETH_P_IP,
+      None(),
+      program.get(),
+      "test"));
+
+  EXPECT_SOME_TRUE(bpf::exists(TEST_VETH_LINK, ingress::HANDLE, ETH_P_IP));
+
+  EXPECT_SOME_FALSE(bpf::create(
+      TEST_VETH_LINK,
+      ingress::HANDLE,
+      ETH_P_IP,
+      None(),
+      program.get(),
+      "test"));
+
+  EXPECT_SOME_TRUE(bpf::update(
+      TEST_VETH_LINK,
+      ingress::HANDLE,
+      ETH_P_IP,
+      program.get(),
+      "test"));
+
+  EXPECT_SOME_TRUE(bpf::remove(TEST_VETH_LINK, ingress::HANDLE, ETH_P_IP));
+  EXPECT_SOME_FALSE(bpf::exists(TEST_VETH_LINK, ingress::HANDLE, ETH_P_IP));
+
+  close(program.get());
+}
+
+
+TEST_F(RoutingTest, ROOT_BPFMap)
+{
+  Try<int> map = ebpf::createMap(
+      BPF_MAP_TYPE_HASH,
+      sizeof(uint32_t),
+      sizeof(uint64_t),
+      16);
+
+  ASSERT_SOME(map);
+
+  uint32_t key = 1;
+  uint64_t value = 0;
+
+  EXPECT_SOME_FALSE(ebpf::lookupElement(map.get(), &key, &value));
+  EXPECT_SOME_FALSE(ebpf::deleteElement(map.get(), &key));
+
+  value = 42;
+  EXPECT_SOME(ebpf::updateElement(map.get(), &key, &value, BPF_NOEXIST));
+  EXPECT_ERROR(ebpf::updateElement(map.get(), &key, &value, BPF_NOEXIST));
+
+  value = 0;
+  EXPECT_SOME_TRUE(ebpf::lookupElement(map.get(), &key, &value));
+  EXPECT_EQ(42u, value);
+
+  EXPECT_SOME_TRUE(ebpf::deleteElement(map.get(), &key));
+  EXPECT_SOME_FALSE(ebpf::lookupElement(map.get(), &key, &value));
+
+  close(map.get());
+}
+
+
 // Test the workaround introduced for MESOS-1617.
 TEST_F(RoutingVethTest, ROOT_HandleGeneration)
 {
@@ -172,6 +172,34 @@ TEST_F(DiskUsageCollectorTest, ExcludeRelativePath)
 #endif
 
 
+// This test verifies that the disk space used by a file with multiple
+// hard links is only counted once, even if the links are in different
+// subdirectories which are walked concurrently.
+TEST_F(DiskUsageCollectorTest, HardLink)
+{
+  string dir1 = path::join(os::getcwd(), "dir1");
+  string dir2 = path::join(os::getcwd(), "dir2");
+
+  ASSERT_SOME(os::mkdir(dir1));
+  ASSERT_SOME(os::mkdir(dir2));
+
+  string file = path::join(dir1, "file");
+  string link = path::join(dir2, "link");
+
+  // Create a 128k file and a hard link to it.
+  ASSERT_SOME(os::write(file, string(Kilobytes(128).bytes(), 'x')));
+  ASSERT_EQ(0, ::link(file.c_str(), link.c_str()));
+
+  DiskUsageCollector collector(Milliseconds(1));
+
+  Future<Bytes> usage = collector.usage(os::getcwd(), {});
+  AWAIT_READY(usage);
+
+  EXPECT_GE(usage.get(), Kilobytes(128));
+  EXPECT_LT(usage.get(), Kilobytes(192));
+}
+
+
 class DiskQuotaTest : public MesosTest {};
 
 
@@ -185,8 +213,8 @@ TEST_F(DiskQuotaTest, DiskUsageExceedsQuota)
   slave::Flags flags = CreateSlaveFlags();
   flags.isolation = "posix/cpu,posix/mem,disk/du";
 
-  // NOTE: We can't pause the clock because we need the reaper to reap
-  // the 'du' subprocess.
+  // NOTE: We can't pause the clock because the disk usage collector
+  // waits for the interval between two collections to elapse.
   flags.container_disk_watch_interval = Milliseconds(1);
   flags.enforce_container_disk_quota = true;
 
@@ -261,8 +289,8 @@ TEST_F(DiskQuotaTest, VolumeUsageExceedsQuota)
   slave::Flags slaveFlags = CreateSlaveFlags();
   slaveFlags.isolation = "posix/cpu,posix/mem,disk/du";
 
-  // NOTE: We can't pause the clock because we need the reaper to reap
-  // the 'du' subprocess.
+  // NOTE: We can't pause the clock because the disk usage collector
+  // waits for the interval between two collections to elapse.
   slaveFlags.container_disk_watch_interval = Milliseconds(1);
   slaveFlags.enforce_container_disk_quota = true;
   slaveFlags.resources = "cpus:2;mem:128;disk(role1):128";
@@ -361,8 +389,8 @@ TEST_F(DiskQuotaTest, NoQuotaEnforcement)
   slave::Flags flags = CreateSlaveFlags();
   flags.isolation = "posix/cpu,posix/mem,disk/du";
 
-  // NOTE: We can't pause the clock because we need the reaper to reap
-  // the 'du' subprocess.
+  // NOTE: We can't pause the clock because the disk usage collector
+  // waits for the interval between two collections to elapse.
   flags.container_disk_watch_interval = Milliseconds(1);
   flags.enforce_container_disk_quota = false;
 
@@ -469,8 +497,8 @@ TEST_F(DiskQuotaTest, ResourceStatistics)
 
   flags.resources = strings::format("disk(%s):10", DEFAULT_TEST_ROLE).get();
 
-  // NOTE: We can't pause the clock because we need the reaper to reap
-  // the 'du' subprocess.
+  // NOTE: We can't pause the clock because the disk usage collector
+  // waits for the interval between two collections to elapse.
   flags.container_disk_watch_interval = Milliseconds(1);
 
   Fetcher fetcher(flags);
@@ -733,8 +761,8 @@ TEST_F(DiskQuotaTest, SlaveRecovery)
   // Ensure the slave considers itself recovered.
   Clock::advance(flags.executor_reregistration_timeout);
 
-  // NOTE: We resume the clock because we need the reaper to reap the
-  // 'du' subprocess.
+  // NOTE: We resume the clock because the disk usage collector waits
+  // for the interval between two collections to elapse.
   Clock::resume();
 
   // Wait until disk usage can be retrieved.
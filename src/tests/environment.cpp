@@ -59,6 +59,7 @@
 
 #ifdef __linux__
 #include "linux/cgroups.hpp"
+#include "linux/cgroups2.hpp"
 #include "linux/fs.hpp"
 #include "linux/perf.hpp"
 #endif
@@ -218,6 +219,48 @@ private:
 };
 
 
+class Cgroups2Filter : public TestFilter
+{
+public:
+  Cgroups2Filter()
+  {
+#ifdef __linux__
+    if (!cgroups2::enabled()) {
+      error = Error("cgroups v2 is not supported by the kernel");
+    } else {
+      Try<bool> mounted = cgroups2::mounted();
+      if (mounted.isError()) {
+        error = Error(mounted.error());
+      } else if (!mounted.get()) {
+        error = Error(
+            "The cgroups v2 hierarchy is not mounted at '" +
+            cgroups2::ROOT + "'");
+      }
+    }
+#else
+    error = Error("cgroups v2 is only supported on Linux");
+#endif // __linux__
+
+    if (error.isSome()) {
+      std::cerr
+        << "-------------------------------------------------------------\n"
+        << "We cannot run any cgroups v2 tests because:\n"
+        << error->message << "\n"
+        << "-------------------------------------------------------------"
+        << std::endl;
+    }
+  }
+
+  bool disable(const ::testing::TestInfo* test) const override
+  {
+    return matches(test, "CGROUPS2_") && error.isSome();
+  }
+
+private:
+  Option<Error> error;
+};
+
+
 class CurlFilter : public TestFilter
 {
 public:
@@ -1090,6 +1133,7 @@ Environment::Environment(const Flags& _flags)
             std::make_shared<BenchmarkFilter>(),
             std::make_shared<CfsFilter>(),
             std::make_shared<CgroupsFilter>(),
+            std::make_shared<Cgroups2Filter>(),
             std::make_shared<CurlFilter>(),
             std::make_shared<DockerFilter>(),
             std::make_shared<DtypeFilter>(),
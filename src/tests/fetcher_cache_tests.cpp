@@ -1334,8 +1334,8 @@ TEST_F(FetcherCacheHttpTest, HttpMixed)
 }
 
 
-// Tests slave recovery of the fetcher cache. The cache must be
-// wiped clean on recovery, causing renewed downloads.
+// Tests slave recovery of the fetcher cache. The cache must survive
+// recovery, so that no renewed downloads are needed.
 // TODO(bernd-mesos): Debug flaky behavior reported in MESOS-2871,
 // then reenable this test.
 TEST_F(FetcherCacheHttpTest, DISABLED_HttpCachedRecovery)
@@ -1427,9 +1427,9 @@ TEST_F(FetcherCacheHttpTest, DISABLED_HttpCachedRecovery)
 
     verifyCacheMetrics();
 
-    // content-length requests: 1
-    // downloads: 1
-    EXPECT_EQ(2u, httpServer->countCommandRequests);
+    // content-length requests: 0
+    // downloads: 0
+    EXPECT_EQ(0u, httpServer->countCommandRequests);
   }
 }
 
@@ -44,9 +44,17 @@
 #include <mesos/fetcher/fetcher.hpp>
 #include <mesos/type_utils.hpp>
 
-#include "slave/containerizer/fetcher.hpp"
+#include "common/command_utils.hpp"
+
+#include "slave/artifacts.hpp"
+#include "slave/constants.hpp"
 #include "slave/flags.hpp"
 
+#include "slave/containerizer/fetcher.hpp"
+#include "slave/containerizer/fetcher_process.hpp"
+
+#include "slave/containerizer/mesos/provisioner/docker/paths.hpp"
+
 #include "tests/environment.hpp"
 #include "tests/flags.hpp"
 #include "tests/mesos.hpp"
@@ -66,6 +74,8 @@ using process::Future;
 using std::map;
 using std::string;
 
+using testing::_;
+
 
 namespace mesos {
 namespace internal {
@@ -182,6 +192,260 @@ TEST_F(FetcherTest, DuplicateFileURI)
 }
 
 
+// Verify that cache files with the same content are deduplicated and
+// that the cache is recovered when the fetcher is recreated.
+TEST_F(FetcherTest, DeduplicateAndRecoverCache)
+{
+  string fromDir = path::join(os::getcwd(), "from");
+  ASSERT_SOME(os::mkdir(fromDir));
+  string testFile1 = path::join(fromDir, "test1");
+  string testFile2 = path::join(fromDir, "test2");
+  EXPECT_SOME(os::write(testFile1, "data"));
+  EXPECT_SOME(os::write(testFile2, "data"));
+
+  slave::Flags flags = CreateSlaveFlags();
+
+  ContainerID containerId;
+  containerId.set_value(id::UUID::random().toString());
+
+  CommandInfo commandInfo;
+
+  commandInfo.add_uris()->set_value(uri::from_path(testFile1));
+  commandInfo.add_uris()->set_value(uri::from_path(testFile2));
+  commandInfo.mutable_uris(0)->set_cache(true);
+  commandInfo.mutable_uris(1)->set_cache(true);
+
+  const double size = os::stat::size(testFile1)->bytes();
+
+  {
+    Fetcher fetcher(flags);
+
+    // The cache files are deduplicated once their digests have been
+    // computed, after which the space of only one of them is used.
+    Future<Nothing> deduplicate1 =
+      FUTURE_DISPATCH(_, &slave::FetcherProcess::_deduplicate);
+
+    Future<Nothing> deduplicate2 =
+      FUTURE_DISPATCH(_, &slave::FetcherProcess::_deduplicate);
+
+    Future<Nothing> fetch = fetcher.fetch(
+        containerId, commandInfo, os::getcwd(), None());
+    AWAIT_READY(fetch);
+
+    EXPECT_TRUE(os::exists("test1"));
+    EXPECT_TRUE(os::exists("test2"));
+
+    AWAIT_READY(deduplicate1);
+    AWAIT_READY(deduplicate2);
+
+    // Wait for the fetcher to process the deduplications.
+    Clock::pause();
+    Clock::settle();
+    Clock::resume();
+
+    EXPECT_SOME_EQ(
+        size,
+        Metrics().at<JSON::Number>(
+            "containerizer/fetcher/cache_size_used_bytes"));
+  }
+
+  ASSERT_TRUE(os::exists(path::join(flags.fetcher_cache_dir, "index")));
+
+  ContainerID containerId2;
+  containerId2.set_value(id::UUID::random().toString());
+
+  string sandbox = path::join(os::getcwd(), "sandbox");
+  ASSERT_SOME(os::mkdir(sandbox));
+
+  // The files are removed from their origin, so the second fetch can
+  // only succeed using the recovered cache files.
+  ASSERT_SOME(os::rm(testFile1));
+  ASSERT_SOME(os::rm(testFile2));
+
+  Fetcher fetcher(flags);
+
+  EXPECT_SOME_EQ(
+      size,
+      Metrics().at<JSON::Number>(
+          "containerizer/fetcher/cache_size_used_bytes"));
+
+  Future<Nothing> fetch = fetcher.fetch(
+      containerId2, commandInfo, sandbox, None());
+  AWAIT_READY(fetch);
+
+  EXPECT_SOME_EQ("data", os::read(path::join(sandbox, "test1")));
+  EXPECT_SOME_EQ("data", os::read(path::join(sandbox, "test2")));
+}
+
+
+// Verify that a cache file is downloaded from a peer which holds it,
+// even if its origin is not available anymore, but only if the URI
+// specifies the digest which the content of the peer is verified with.
+TEST_F(FetcherTest, FetchCachedFromPeer)
+{
+  string fromDir = path::join(os::getcwd(), "from");
+  ASSERT_SOME(os::mkdir(fromDir));
+  string testFile = path::join(fromDir, "test");
+  EXPECT_SOME(os::write(testFile, "0123456789"));
+
+  Future<string> sha512 = command::sha512(Path(testFile));
+  AWAIT_READY(sha512);
+
+  const string digest = "sha512:" + sha512.get();
+
+  slave::Flags flags = CreateSlaveFlags();
+
+  CommandInfo commandInfo;
+  commandInfo.add_uris()->set_value(uri::from_path(testFile));
+  commandInfo.mutable_uris(0)->set_cache(true);
+
+  Fetcher fetcher(flags);
+
+  slave::ArtifactServer server(
+      flags,
+      slave::READONLY_HTTP_AUTHENTICATION_REALM,
+      None(),
+      process::ID::generate(slave::ARTIFACT_SERVER_ID));
+
+  ContainerID containerId;
+  containerId.set_value(id::UUID::random().toString());
+
+  AWAIT_READY(fetcher.fetch(containerId, commandInfo, os::getcwd(), None()));
+
+  // The cache file is only served once its digest has been computed.
+  Future<http::Response> response;
+  Duration waited = Duration::zero();
+  do {
+    response = http::get(
+        server.pid(),
+        "lookup",
+        http::query::encode({{"digest", digest}}),
+        createBasicAuthHeaders(DEFAULT_CREDENTIAL));
+
+    AWAIT_READY(response);
+
+    if (response->code == http::Status::OK) {
+      break;
+    }
+
+    os::sleep(Milliseconds(100));
+    waited += Milliseconds(100);
+  } while (waited < Seconds(15));
+
+  AWAIT_EXPECT_RESPONSE_STATUS_EQ(http::OK().status, response);
+
+  // Without its origin, the file can only be fetched from the peer.
+  ASSERT_SOME(os::rm(testFile));
+
+  slave::Flags peerFlags = CreateSlaveFlags();
+  peerFlags.fetcher_cache_dir = path::join(os::getcwd(), "peer");
+  peerFlags.artifact_peers = stringify(server.pid());
+
+  // Download the file in several chunks.
+  peerFlags.artifact_chunk_size = Bytes(3);
+
+  Fetcher peerFetcher(peerFlags);
+
+  string sandbox = path::join(os::getcwd(), "sandbox");
+  ASSERT_SOME(os::mkdir(sandbox));
+
+  ContainerID peerContainerId;
+  peerContainerId.set_value(id::UUID::random().toString());
+
+  // The content of the peer is not trusted if the URI does not specify
+  // its digest.
+  AWAIT_FAILED(
+      peerFetcher.fetch(peerContainerId, commandInfo, sandbox, None()));
+
+  commandInfo.mutable_uris(0)->set_digest(digest);
+
+  peerContainerId.set_value(id::UUID::random().toString());
+
+  AWAIT_READY(
+      peerFetcher.fetch(peerContainerId, commandInfo, sandbox, None()));
+
+  EXPECT_SOME_EQ("0123456789", os::read(path::join(sandbox, "test")));
+}
+
+
+// Tests that an artifact is served in chunks of exactly the requested
+// range, and that a peer pulls an artifact of several chunks.
+TEST_F(FetcherTest, PullArtifactInChunks)
+{
+  slave::Flags flags = CreateSlaveFlags();
+  flags.docker_store_dir = path::join(os::getcwd(), "store");
+
+  // Serve an image layer blob, which is named by its digest.
+  string data;
+  for (size_t i = 0; i < 10000; i++) {
+    data += static_cast<char>('a' + i % 26);
+  }
+
+  string blobFile = path::join(os::getcwd(), "blob");
+  ASSERT_SOME(os::write(blobFile, data));
+
+  Future<string> sha256 = command::sha256(Path(blobFile));
+  AWAIT_READY(sha256);
+
+  const string digest = "sha256:" + sha256.get();
+
+  const string layerPath =
+    slave::docker::paths::getImageLayerPath(flags.docker_store_dir, "layer");
+
+  ASSERT_SOME(os::mkdir(layerPath));
+  ASSERT_SOME(os::rename(
+      blobFile,
+      slave::docker::paths::getImageLayerBlobPath(layerPath, digest)));
+
+  slave::ArtifactServer server(
+      flags,
+      slave::READONLY_HTTP_AUTHENTICATION_REALM,
+      None(),
+      process::ID::generate(slave::ARTIFACT_SERVER_ID));
+
+  // Only the requested range of the artifact is sent.
+  Future<http::Response> response = http::get(
+      server.pid(),
+      "blob",
+      http::query::encode({
+          {"digest", digest},
+          {"offset", "4096"},
+          {"length", "4096"}}),
+      createBasicAuthHeaders(DEFAULT_CREDENTIAL));
+
+  AWAIT_EXPECT_RESPONSE_STATUS_EQ(http::OK().status, response);
+  AWAIT_EXPECT_RESPONSE_BODY_EQ(data.substr(4096, 4096), response);
+
+  // The last chunk is truncated to the size of the artifact.
+  response = http::get(
+      server.pid(),
+      "blob",
+      http::query::encode({
+          {"digest", digest},
+          {"offset", "8192"},
+          {"length", "4096"}}),
+      createBasicAuthHeaders(DEFAULT_CREDENTIAL));
+
+  AWAIT_EXPECT_RESPONSE_STATUS_EQ(http::OK().status, response);
+  AWAIT_EXPECT_RESPONSE_BODY_EQ(data.substr(8192), response);
+
+  slave::Flags peerFlags = CreateSlaveFlags();
+  peerFlags.artifact_peers = stringify(server.pid());
+  peerFlags.artifact_chunk_size = Bytes(4096);
+
+  Try<Owned<slave::PeerFetcher>> peerFetcher =
+    slave::PeerFetcher::create(peerFlags);
+
+  ASSERT_SOME(peerFetcher);
+
+  const string path = path::join(os::getcwd(), "pulled");
+
+  AWAIT_READY(peerFetcher.get()->fetch(digest, path));
+
+  EXPECT_SOME_EQ(data, os::read(path));
+}
+
+
 TEST_F(FetcherTest, LogSuccessToStderr)
 {
   // Valid test file with data.
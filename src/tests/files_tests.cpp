@@ -241,6 +241,122 @@ TEST_F(FilesTest, ReadTest)
 }
 
 
+// Tests that '/files/read' returns the raw data with `format=raw`.
+TEST_F(FilesTest, ReadRawTest)
+{
+  Files files;
+  process::UPID upid("files", process::address());
+
+  ASSERT_SOME(os::write("file", "body"));
+  AWAIT_EXPECT_READY(files.attach("file", "myname"));
+
+  Future<Response> response = process::http::get(
+      upid, "read", "path=myname&offset=1&length=2&format=raw");
+
+  AWAIT_EXPECT_RESPONSE_STATUS_EQ(OK().status, response);
+  AWAIT_EXPECT_RESPONSE_HEADER_EQ("bytes 1-2/4", "Content-Range", response);
+  AWAIT_EXPECT_RESPONSE_BODY_EQ("od", response);
+
+  // Without a length the file is read to the end.
+  response = process::http::get(upid, "read", "path=myname&format=raw");
+
+  AWAIT_EXPECT_RESPONSE_STATUS_EQ(OK().status, response);
+  AWAIT_EXPECT_RESPONSE_HEADER_EQ("bytes 0-3/4", "Content-Range", response);
+  AWAIT_EXPECT_RESPONSE_BODY_EQ("body", response);
+
+  // An offset of -1 returns the size of the file.
+  response =
+    process::http::get(upid, "read", "path=myname&offset=-1&format=raw");
+
+  AWAIT_EXPECT_RESPONSE_STATUS_EQ(OK().status, response);
+  AWAIT_EXPECT_RESPONSE_HEADER_EQ("bytes */4", "Content-Range", response);
+  AWAIT_EXPECT_RESPONSE_BODY_EQ("", response);
+
+  // The file is reopened once it has been replaced.
+  ASSERT_SOME(os::write("file2", "new body"));
+  ASSERT_SOME(os::rename("file2", "file"));
+
+  response = process::http::get(upid, "read", "path=myname&format=raw");
+
+  AWAIT_EXPECT_RESPONSE_STATUS_EQ(OK().status, response);
+  AWAIT_EXPECT_RESPONSE_BODY_EQ("new body", response);
+
+  // Unlike the JSON format, raw reads are not capped.
+  const string data(os::pagesize() * 40 + 1, 'a');
+  ASSERT_SOME(os::write("file", data));
+
+  response = process::http::get(upid, "read", "path=myname&format=raw");
+
+  AWAIT_EXPECT_RESPONSE_STATUS_EQ(OK().status, response);
+  AWAIT_EXPECT_RESPONSE_HEADER_EQ(
+      "bytes 0-" + stringify(data.size() - 1) + "/" + stringify(data.size()),
+      "Content-Range",
+      response);
+  AWAIT_EXPECT_RESPONSE_BODY_EQ(data, response);
+
+  response = process::http::get(upid, "read", "path=myname&format=xml");
+
+  AWAIT_EXPECT_RESPONSE_STATUS_EQ(BadRequest().status, response);
+  AWAIT_EXPECT_RESPONSE_BODY_EQ("Unsupported format 'xml'.\n", response);
+
+  AWAIT_EXPECT_RESPONSE_STATUS_EQ(
+      NotFound().status,
+      process::http::get(upid, "read", "path=missing&format=raw"));
+}
+
+
+// Tests that a '/files/read' request with `follow=true` returns once
+// the file grows, or once the timeout elapses.
+TEST_F(FilesTest, ReadFollowTest)
+{
+  Files files;
+  process::UPID upid("files", process::address());
+
+  ASSERT_SOME(os::write("file", "body"));
+  AWAIT_EXPECT_READY(files.attach("file", "myname"));
+
+  JSON::Object expected;
+  expected.values["offset"] = 4;
+  expected.values["data"] = "";
+
+  Future<Response> response = process::http::get(
+      upid, "read", "path=myname&offset=4&follow=true&timeout=10ms");
+
+  AWAIT_EXPECT_RESPONSE_STATUS_EQ(OK().status, response);
+  AWAIT_EXPECT_RESPONSE_BODY_EQ(stringify(expected), response);
+
+  response = process::http::get(
+      upid, "read", "path=myname&offset=4&follow=true&timeout=1mins");
+
+  ASSERT_SOME(os::write("file", "body and more"));
+
+  expected.values["data"] = " and more";
+
+  AWAIT_EXPECT_RESPONSE_STATUS_EQ(OK().status, response);
+  AWAIT_EXPECT_RESPONSE_BODY_EQ(stringify(expected), response);
+
+  // Several requests can follow the same file.
+  Future<Response> response1 = process::http::get(
+      upid, "read", "path=myname&offset=13&follow=true&timeout=1mins");
+
+  Future<Response> response2 = process::http::get(
+      upid, "read", "path=myname&offset=13&follow=true&timeout=1mins");
+
+  ASSERT_SOME(os::write("file", "body and more!"));
+
+  expected.values["offset"] = 13;
+  expected.values["data"] = "!";
+
+  AWAIT_EXPECT_RESPONSE_BODY_EQ(stringify(expected), response1);
+  AWAIT_EXPECT_RESPONSE_BODY_EQ(stringify(expected), response2);
+
+  response = process::http::get(
+      upid, "read", "path=myname&follow=true&timeout=abc");
+
+  AWAIT_EXPECT_RESPONSE_STATUS_EQ(BadRequest().status, response);
+}
+
+
 TEST_F(FilesTest, ResolveTest)
 {
   Files files;
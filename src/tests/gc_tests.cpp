@@ -14,6 +14,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <atomic>
 #include <list>
 #include <map>
 #include <string>
@@ -40,11 +41,13 @@
 #include <process/process.hpp>
 #include <process/timeout.hpp>
 
+#include <stout/bytes.hpp>
 #include <stout/duration.hpp>
 #include <stout/gtest.hpp>
 #include <stout/nothing.hpp>
 #include <stout/os.hpp>
 #include <stout/path.hpp>
+#include <stout/stopwatch.hpp>
 
 #include <stout/os/realpath.hpp>
 
@@ -288,6 +291,158 @@ TEST_F(GarbageCollectorTest, Prune)
 }
 
 
+// This test verifies that paths due at the same time are removed
+// concurrently, and that the reclaimed bytes are reported.
+TEST_F(GarbageCollectorTest, ParallelRemoval)
+{
+  // Each removal operation takes 500ms out of the budget of all
+  // workers, so the removals of the two paths interleave. The budget
+  // is measured with the (paused) libprocess clock.
+  GarbageCollector gc("work_dir", 2, 2);
+
+  const string& dir1 = "dir1";
+  const string& dir2 = "dir2";
+
+  const string file1 = path::join(dir1, "file");
+  const string file2 = path::join(dir2, "file");
+
+  ASSERT_SOME(os::mkdir(dir1));
+  ASSERT_SOME(os::mkdir(dir2));
+
+  ASSERT_SOME(os::write(file1, string(Kilobytes(128).bytes(), 'x')));
+  ASSERT_SOME(os::write(file2, string(Kilobytes(64).bytes(), 'x')));
+
+  Clock::pause();
+
+  Future<Nothing> schedule1 = gc.schedule(Seconds(10), dir1);
+  Future<Nothing> schedule2 = gc.schedule(Seconds(10), dir2);
+
+  // The file of a path is removed before its directory. If the paths
+  // were removed one after the other, the file of the second path
+  // would still exist once the first path has been removed.
+  process::Promise<bool> concurrent;
+  auto removed = [&concurrent, file1, file2]() {
+    concurrent.set(!os::exists(file1) && !os::exists(file2));
+  };
+
+  schedule1.onReady(removed);
+  schedule2.onReady(removed);
+
+  gc.prune(Seconds(10));
+
+  // Only the first removal operation is within the budget until the
+  // clock is advanced, so neither path can be removed yet.
+  Stopwatch stopwatch;
+  stopwatch.start();
+
+  while (os::exists(file1) && os::exists(file2)) {
+    ASSERT_GT(process::TEST_AWAIT_TIMEOUT, stopwatch.elapsed());
+    os::sleep(Milliseconds(10));
+  }
+
+  EXPECT_TRUE(schedule1.isPending());
+  EXPECT_TRUE(schedule2.isPending());
+
+  // The remaining three operations are within the budget after
+  // another 1.5 seconds.
+  Clock::advance(Milliseconds(1500));
+
+  AWAIT_READY(schedule1);
+  AWAIT_READY(schedule2);
+
+  AWAIT_EXPECT_TRUE(concurrent.future());
+
+  EXPECT_FALSE(os::exists(dir1));
+  EXPECT_FALSE(os::exists(dir2));
+
+  Clock::settle();
+
+  JSON::Object metrics = Metrics();
+
+  ASSERT_EQ(1u, metrics.values.count("gc/bytes_pending"));
+  ASSERT_EQ(1u, metrics.values.count("gc/bytes_removed"));
+
+  EXPECT_SOME_EQ(0u, metrics.at<JSON::Number>("gc/bytes_pending"));
+
+  // The reclaimed bytes are counted by the removals.
+  Result<JSON::Number> bytes = metrics.at<JSON::Number>("gc/bytes_removed");
+  ASSERT_SOME(bytes);
+  EXPECT_LE(Kilobytes(192).bytes(), bytes->as<uint64_t>());
+
+  Clock::resume();
+}
+
+
+// This test verifies that paths due at the same time are removed in
+// descending order of their known disk usage, and that the paths of
+// unknown usage are removed last.
+TEST_F(GarbageCollectorTest, RemovalPriority)
+{
+  GarbageCollector gc("work_dir", 1);
+
+  const vector<string> dirs = {"small", "unknown", "large", "medium"};
+
+  foreach (const string& dir, dirs) {
+    ASSERT_SOME(os::mkdir(dir));
+  }
+
+  Clock::pause();
+
+  vector<Future<Nothing>> schedules = {
+    gc.schedule(Seconds(10), "small", Kilobytes(1)),
+    gc.schedule(Seconds(10), "unknown"),
+    gc.schedule(Seconds(10), "large", Kilobytes(3)),
+    gc.schedule(Seconds(10), "medium", Kilobytes(2))
+  };
+
+  // The removals complete on the garbage collector actor, so the
+  // callbacks are not run concurrently.
+  vector<string> removed;
+  for (size_t i = 0; i < dirs.size(); i++) {
+    const string dir = dirs[i];
+    schedules[i].onReady([&removed, dir]() { removed.push_back(dir); });
+  }
+
+  gc.prune(Seconds(10));
+
+  AWAIT_READY(process::collect(schedules));
+
+  EXPECT_EQ(vector<string>({"large", "medium", "small", "unknown"}), removed);
+
+  Clock::resume();
+}
+
+
+// This test verifies that the throttle paces removal operations.
+TEST_F(GarbageCollectorTest, Throttle)
+{
+  GarbageCollectorProcess::Throttle throttle(10, None());
+  std::atomic_bool stopped(false);
+
+  Stopwatch stopwatch;
+  stopwatch.start();
+
+  // The first operation is admitted immediately, and each of the
+  // following ones after another 100ms.
+  for (int i = 0; i < 6; i++) {
+    throttle.acquire(Bytes(0), stopped);
+  }
+
+  EXPECT_LE(Milliseconds(500), stopwatch.elapsed());
+
+  // A stopped removal does not wait for its budget.
+  GarbageCollectorProcess::Throttle bandwidth(None(), Kilobytes(1));
+
+  stopped = true;
+  stopwatch.start();
+
+  bandwidth.acquire(Megabytes(1), stopped);
+  bandwidth.acquire(Megabytes(1), stopped);
+
+  EXPECT_GT(Seconds(10), stopwatch.elapsed());
+}
+
+
 class GarbageCollectorIntegrationTest : public MesosTest {};
 
 
@@ -27,6 +27,7 @@
 #include <process/async.hpp>
 #include <process/clock.hpp>
 #include <process/collect.hpp>
+#include <process/delay.hpp>
 #include <process/future.hpp>
 #include <process/loop.hpp>
 #include <process/pid.hpp>
@@ -39,6 +40,8 @@
 
 #include "common/protobuf_utils.hpp"
 
+#include "master/master.hpp"
+
 #include "tests/mesos.hpp"
 
 namespace http = process::http;
@@ -74,6 +77,7 @@ using std::tie;
 using std::tuple;
 using std::vector;
 
+using testing::_;
 using testing::WithParamInterface;
 
 namespace mesos {
@@ -148,9 +152,13 @@ public:
   void initialize() override
   {
     install<SlaveReregisteredMessage>(&Self::reregistered);
+    install<SlaveReregistrationThrottledMessage>(
+        &Self::throttled,
+        &SlaveReregistrationThrottledMessage::retry_after);
     install<PingSlaveMessage>(
         &Self::ping,
         &PingSlaveMessage::connected);
+    install<RunTaskMessage>(&Self::runTask);
 
     // Prepare `ReregisterSlaveMessage` which simulates the real world scenario:
     // TODO(xujyan): Notable things missing include:
@@ -198,10 +206,26 @@ public:
     }
   }
 
+  // Returns when the agent has reregistered with the master, i.e., a
+  // new re-registration is started on each call (e.g., after the
+  // master failed over).
   Future<Nothing> reregister()
   {
+    promise.reset(new Promise<Nothing>());
     send(masterPid, message);
-    return promise.future();
+    return promise->future();
+  }
+
+  // Returns when the agent has been asked to run `count` tasks.
+  Future<Nothing> launched(size_t count)
+  {
+    expectedTasks = count;
+
+    if (runTasks >= count) {
+      launchedPromise.set(Nothing());
+    }
+
+    return launchedPromise.future();
   }
 
   TestSlaveProcess(const TestSlaveProcess& other) = delete;
@@ -210,7 +234,21 @@ public:
 private:
   void reregistered(const SlaveReregisteredMessage&)
   {
-    promise.set(Nothing());
+    promise->set(Nothing());
+  }
+
+  // Like the real agent, retry once the master asks us to back off.
+  void throttled(const DurationInfo& retryAfter)
+  {
+    process::delay(
+        Nanoseconds(retryAfter.nanoseconds()),
+        self(),
+        &Self::resend);
+  }
+
+  void resend()
+  {
+    send(masterPid, message);
   }
 
   // We need to answer pings to keep the agent registered.
@@ -219,6 +257,16 @@ private:
     send(from, PongSlaveMessage());
   }
 
+  // The tasks are only counted, they are never run.
+  void runTask(const RunTaskMessage&)
+  {
+    runTasks++;
+
+    if (expectedTasks.isSome() && runTasks >= expectedTasks.get()) {
+      launchedPromise.set(Nothing());
+    }
+  }
+
   const UPID masterPid;
   const SlaveID slaveId;
   const size_t frameworksPerAgent;
@@ -227,7 +275,11 @@ private:
   const size_t tasksPerCompletedFramework;
 
   ReregisterSlaveMessage message;
-  Promise<Nothing> promise;
+  Owned<Promise<Nothing>> promise;
+
+  size_t runTasks = 0;
+  Option<size_t> expectedTasks;
+  Promise<Nothing> launchedPromise;
 };
 
 
@@ -263,11 +315,126 @@ public:
     return dispatch(process.get(), &TestSlaveProcess::reregister);
   }
 
+  Future<Nothing> launched(size_t count)
+  {
+    return dispatch(process.get(), &TestSlaveProcess::launched, count);
+  }
+
 private:
   Owned<TestSlaveProcess> process;
 };
 
 
+// A fake framework which launches tasks on the first offer it receives.
+class TestFrameworkProcess : public ProtobufProcess<TestFrameworkProcess>
+{
+public:
+  TestFrameworkProcess(const UPID& _masterPid, size_t _tasksPerOffer)
+    : ProcessBase(process::ID::generate("test-framework")),
+      masterPid(_masterPid),
+      tasksPerOffer(_tasksPerOffer) {}
+
+  void initialize() override
+  {
+    install<FrameworkRegisteredMessage>(&Self::registered);
+    install<ResourceOffersMessage>(&Self::resourceOffers);
+  }
+
+  Future<Nothing> subscribe()
+  {
+    RegisterFrameworkMessage message;
+    *message.mutable_framework() = DEFAULT_FRAMEWORK_INFO;
+
+    send(masterPid, message);
+    return subscribed.future();
+  }
+
+  // Returns the agent of the first offer.
+  Future<SlaveID> offered()
+  {
+    return offer.future()
+      .then([](const Offer& offer) { return offer.slave_id(); });
+  }
+
+  // Accepts the first offer with a LAUNCH operation.
+  void launch()
+  {
+    CHECK_READY(offer.future());
+
+    LaunchTasksMessage message;
+    *message.mutable_framework_id() = frameworkId;
+    *message.add_offer_ids() = offer.future()->id();
+    message.mutable_filters();
+
+    for (size_t i = 0; i < tasksPerOffer; i++) {
+      TaskInfo task = createTaskInfo(offer.future()->slave_id());
+      message.add_tasks()->Swap(&task);
+    }
+
+    send(masterPid, message);
+  }
+
+  TestFrameworkProcess(const TestFrameworkProcess& other) = delete;
+  TestFrameworkProcess& operator=(const TestFrameworkProcess& other) = delete;
+
+private:
+  void registered(const FrameworkRegisteredMessage& message)
+  {
+    frameworkId = message.framework_id();
+    subscribed.set(Nothing());
+  }
+
+  void resourceOffers(const ResourceOffersMessage& message)
+  {
+    if (!message.offers().empty()) {
+      offer.set(message.offers(0));
+    }
+  }
+
+  const UPID masterPid;
+  const size_t tasksPerOffer;
+
+  FrameworkID frameworkId;
+  Promise<Nothing> subscribed;
+  Promise<Offer> offer;
+};
+
+
+class TestFramework
+{
+public:
+  TestFramework(const UPID& masterPid, size_t tasksPerOffer)
+    : process(new TestFrameworkProcess(masterPid, tasksPerOffer))
+  {
+    spawn(process.get());
+  }
+
+  ~TestFramework()
+  {
+    terminate(process.get());
+    wait(process.get());
+  }
+
+  Future<Nothing> subscribe()
+  {
+    return dispatch(process.get(), &TestFrameworkProcess::subscribe);
+  }
+
+  Future<SlaveID> offered()
+  {
+    return dispatch(process.get(), &TestFrameworkProcess::offered);
+  }
+
+  void launch()
+  {
+    dispatch(process.get(), &TestFrameworkProcess::launch);
+  }
+
+private:
+  Owned<TestFrameworkProcess> process;
+};
+
+
 class MasterFailover_BENCHMARK_Test
   : public MesosTest,
     public WithParamInterface<tuple<size_t, size_t, size_t, size_t, size_t>> {};
@@ -356,6 +523,195 @@ TEST_P(MasterFailover_BENCHMARK_Test, AgentReregistrationDelay)
 }
 
 
+class MasterFailoverRecovery_BENCHMARK_Test
+  : public MesosTest,
+    public WithParamInterface<size_t> {};
+
+
+INSTANTIATE_TEST_CASE_P(
+    AgentCount,
+    MasterFailoverRecovery_BENCHMARK_Test,
+    ::testing::Values(10000U, 30000U, 50000U));
+
+
+// This test measures the time for a master to recover after a failover,
+// i.e., until all agents of the registry have reregistered, when all
+// agents reregister at once and the master throttles the
+// re-registrations beyond `--max_agent_reregistrations`.
+TEST_P(MasterFailoverRecovery_BENCHMARK_Test, ThrottledReregistration)
+{
+  const size_t agentCount = GetParam();
+
+  master::Flags masterFlags = CreateMasterFlags();
+  masterFlags.authenticate_agents = false;
+
+  // Use replicated log so it better simulates the production scenario
+  // and so that the agents are recovered from the registry by the
+  // failed over master.
+  masterFlags.registry = "replicated_log";
+
+  Try<Owned<cluster::Master>> master = StartMaster(masterFlags);
+  ASSERT_SOME(master);
+
+  vector<TestSlave> slaves;
+
+  for (size_t i = 0; i < agentCount; i++) {
+    SlaveID slaveId;
+    slaveId.set_value("agent" + stringify(i));
+
+    slaves.emplace_back(master.get()->pid, slaveId, 1, 5, 0, 0);
+  }
+
+  // Admit all agents to the registry of the first master.
+  vector<Future<Nothing>> registered;
+
+  foreach (TestSlave& slave, slaves) {
+    registered.push_back(slave.reregister());
+  }
+
+  AWAIT_READY(collect(registered));
+
+  // Fail over the master. The agents keep sending to the same PID as
+  // the restarted master has the same PID.
+  master->reset();
+
+  // Make sure the master has recovered the registry before we start
+  // the stopwatch.
+  Future<Nothing> recovered = FUTURE_DISPATCH(_, &master::Master::_recover);
+
+  master = StartMaster(masterFlags);
+  ASSERT_SOME(master);
+
+  AWAIT_READY(recovered);
+
+  vector<Future<Nothing>> reregistered;
+
+  Stopwatch watch;
+  watch.start();
+
+  foreach (TestSlave& slave, slaves) {
+    reregistered.push_back(slave.reregister());
+  }
+
+  await(reregistered).await();
+
+  watch.stop();
+
+  JSON::Object metrics = Metrics();
+
+  cout << "Recovered " << agentCount << " agents in " << watch.elapsed()
+       << " with "
+       << metrics.values["master/slave_reregistrations_throttled"]
+       << " throttled re-registrations" << endl;
+}
+
+
+class MasterAccept_BENCHMARK_Test
+  : public MesosTest,
+    public WithParamInterface<tuple<size_t, size_t>> {};
+
+
+// The value tuples are defined as:
+// - frameworkCount
+// - tasksPerFramework
+INSTANTIATE_TEST_CASE_P(
+    FrameworkTaskCount,
+    MasterAccept_BENCHMARK_Test,
+    ::testing::Values(
+        make_tuple(1, 100),
+        make_tuple(10, 100),
+        make_tuple(100, 100),
+        make_tuple(1000, 100)));
+
+
+// This test measures the throughput of ACCEPT calls as the number of
+// frameworks grows, from when all frameworks accept their offers to
+// when the agents have been asked to run all of the launched tasks.
+TEST_P(MasterAccept_BENCHMARK_Test, LaunchTasks)
+{
+  size_t frameworkCount;
+  size_t tasksPerFramework;
+
+  tie(frameworkCount, tasksPerFramework) = GetParam();
+
+  master::Flags masterFlags = CreateMasterFlags();
+  masterFlags.authenticate_agents = false;
+  masterFlags.authenticate_frameworks = false;
+
+  Try<Owned<cluster::Master>> master = StartMaster(masterFlags);
+  ASSERT_SOME(master);
+
+  vector<Owned<TestFramework>> frameworks;
+  vector<Future<Nothing>> subscribed;
+
+  for (size_t i = 0; i < frameworkCount; i++) {
+    frameworks.push_back(Owned<TestFramework>(
+        new TestFramework(master.get()->pid, tasksPerFramework)));
+
+    subscribed.push_back(frameworks.back()->subscribe());
+  }
+
+  await(subscribed).await();
+
+  // The agents are added once all frameworks have subscribed, so that
+  // each agent is offered to a different framework.
+  hashmap<SlaveID, Owned<TestSlave>> slaves;
+  vector<Future<Nothing>> reregistered;
+
+  for (size_t i = 0; i < frameworkCount; i++) {
+    SlaveID slaveId;
+    slaveId.set_value("agent" + stringify(i));
+
+    slaves[slaveId] =
+      Owned<TestSlave>(new TestSlave(master.get()->pid, slaveId, 0, 0, 0, 0));
+
+    reregistered.push_back(slaves[slaveId]->reregister());
+  }
+
+  await(reregistered).await();
+
+  vector<Future<SlaveID>> offered;
+
+  foreach (const Owned<TestFramework>& framework, frameworks) {
+    offered.push_back(framework->offered());
+  }
+
+  await(offered).await();
+
+  hashmap<SlaveID, size_t> tasks;
+
+  foreach (const Future<SlaveID>& slaveId, offered) {
+    ASSERT_TRUE(slaveId.isReady());
+    tasks[slaveId.get()] += tasksPerFramework;
+  }
+
+  vector<Future<Nothing>> launched;
+
+  foreachpair (const SlaveID& slaveId, size_t count, tasks) {
+    launched.push_back(slaves[slaveId]->launched(count));
+  }
+
+  // Measure the time for all agents to receive their tasks.
+  Stopwatch watch;
+  watch.start();
+
+  foreach (const Owned<TestFramework>& framework, frameworks) {
+    framework->launch();
+  }
+
+  await(launched).await();
+
+  watch.stop();
+
+  cout << "Accepted offers of " << frameworkCount << " frameworks with a"
+       << " total of " << frameworkCount * tasksPerFramework << " tasks in "
+       << watch.elapsed() << " ("
+       << frameworkCount / watch.elapsed().secs() << " ACCEPT calls and "
+       << frameworkCount * tasksPerFramework / watch.elapsed().secs()
+       << " tasks per second)" << endl;
+}
+
+
 class MasterStateQuery_BENCHMARK_Test
   : public MesosTest,
     public WithParamInterface<tuple<
@@ -0,0 +1,252 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <mesos/v1/scheduler/scheduler.hpp>
+
+#include <process/future.hpp>
+#include <process/gtest.hpp>
+#include <process/http.hpp>
+
+#include <stout/gtest.hpp>
+#include <stout/json.hpp>
+#include <stout/option.hpp>
+#include <stout/protobuf.hpp>
+#include <stout/stringify.hpp>
+#include <stout/strings.hpp>
+#include <stout/uuid.hpp>
+
+#include "common/http.hpp"
+
+#include "master/call_decoder.hpp"
+
+#include "tests/mesos.hpp"
+
+using mesos::internal::master::CallDecoder;
+
+using mesos::v1::scheduler::Call;
+
+using process::Future;
+
+using process::http::BadRequest;
+using process::http::NotAcceptable;
+using process::http::UnsupportedMediaType;
+
+using std::string;
+using std::vector;
+
+namespace mesos {
+namespace internal {
+namespace tests {
+
+// Returns a request of the call to the `/api/v1/scheduler` endpoint.
+static process::http::Request createRequest(
+    const Call& call,
+    const string& contentType,
+    const Option<string>& streamId = None())
+{
+  process::http::Request request;
+  request.method = "POST";
+  request.headers["Content-Type"] = contentType;
+  request.headers["Accept"] = contentType;
+
+  if (streamId.isSome()) {
+    request.headers["Mesos-Stream-Id"] = streamId.get();
+  }
+
+  request.body = contentType == APPLICATION_PROTOBUF
+    ? call.SerializeAsString()
+    : stringify(JSON::protobuf(call));
+
+  return request;
+}
+
+
+// This test verifies that the requests which cannot be decoded are
+// rejected with the same responses as when the master decoded them.
+TEST(CallDecoderTest, Reject)
+{
+  CallDecoder decoder(2);
+
+  Call subscribe;
+  subscribe.set_type(Call::SUBSCRIBE);
+  subscribe.mutable_subscribe()->mutable_framework_info()->CopyFrom(
+      v1::DEFAULT_FRAMEWORK_INFO);
+
+  // No 'Content-Type'.
+  {
+    process::http::Request request =
+      createRequest(subscribe, APPLICATION_JSON);
+    request.headers.erase("Content-Type");
+
+    Future<CallDecoder::Result> result = decoder.decode(request, None());
+    AWAIT_READY(result);
+
+    EXPECT_NONE(result->call);
+    ASSERT_SOME(result->response);
+    EXPECT_EQ(BadRequest().status, result->response->status);
+    EXPECT_EQ(
+        "Expecting 'Content-Type' to be present",
+        result->response->body);
+  }
+
+  // Malformed protobuf.
+  {
+    process::http::Request request =
+      createRequest(subscribe, APPLICATION_PROTOBUF);
+    request.body = "MALFORMED_CONTENT";
+
+    Future<CallDecoder::Result> result = decoder.decode(request, None());
+    AWAIT_READY(result);
+
+    EXPECT_NONE(result->call);
+    ASSERT_SOME(result->response);
+    EXPECT_EQ(BadRequest().status, result->response->status);
+    EXPECT_EQ(
+        "Failed to parse body into Call protobuf",
+        result->response->body);
+  }
+
+  // Malformed JSON.
+  {
+    process::http::Request request =
+      createRequest(subscribe, APPLICATION_JSON);
+    request.body = "MALFORMED_CONTENT";
+
+    Future<CallDecoder::Result> result = decoder.decode(request, None());
+    AWAIT_READY(result);
+
+    EXPECT_NONE(result->call);
+    ASSERT_SOME(result->response);
+    EXPECT_EQ(BadRequest().status, result->response->status);
+    EXPECT_TRUE(strings::startsWith(
+        result->response->body,
+        "Failed to parse body into JSON"));
+  }
+
+  // Valid JSON which is not a call.
+  {
+    process::http::Request request =
+      createRequest(subscribe, APPLICATION_JSON);
+    request.body = "{\"type\":\"UNKNOWN_CALL_TYPE\"}";
+
+    Future<CallDecoder::Result> result = decoder.decode(request, None());
+    AWAIT_READY(result);
+
+    EXPECT_NONE(result->call);
+    ASSERT_SOME(result->response);
+    EXPECT_EQ(BadRequest().status, result->response->status);
+    EXPECT_TRUE(strings::startsWith(
+        result->response->body,
+        "Failed to convert JSON into Call protobuf"));
+  }
+
+  // Unsupported 'Content-Type'.
+  {
+    process::http::Request request =
+      createRequest(subscribe, APPLICATION_JSON);
+    request.headers["Content-Type"] = "application/unknown-media-type";
+
+    Future<CallDecoder::Result> result = decoder.decode(request, None());
+    AWAIT_READY(result);
+
+    EXPECT_NONE(result->call);
+    ASSERT_SOME(result->response);
+    EXPECT_EQ(UnsupportedMediaType().status, result->response->status);
+    EXPECT_EQ(
+        string("Expecting 'Content-Type' of ") +
+          APPLICATION_JSON + " or " + APPLICATION_PROTOBUF,
+        result->response->body);
+  }
+
+  // Unsupported 'Accept' of a call which sends events.
+  {
+    process::http::Request request =
+      createRequest(subscribe, APPLICATION_PROTOBUF);
+    request.headers["Accept"] = "foo";
+
+    Future<CallDecoder::Result> result = decoder.decode(request, None());
+    AWAIT_READY(result);
+
+    EXPECT_NONE(result->call);
+    ASSERT_SOME(result->response);
+    EXPECT_EQ(NotAcceptable().status, result->response->status);
+    EXPECT_EQ(
+        string("Expecting 'Accept' to allow ") +
+          "'" + APPLICATION_PROTOBUF + "' or '" + APPLICATION_JSON + "'",
+        result->response->body);
+  }
+
+  // Invalid call. The decoded call is returned along with the response
+  // so that the master can account for it in its metrics.
+  {
+    Call decline;
+    decline.set_type(Call::DECLINE);
+
+    Future<CallDecoder::Result> result =
+      decoder.decode(createRequest(decline, APPLICATION_PROTOBUF), None());
+
+    AWAIT_READY(result);
+
+    ASSERT_SOME(result->call);
+    EXPECT_EQ(mesos::scheduler::Call::DECLINE, result->call->type());
+    ASSERT_SOME(result->response);
+    EXPECT_EQ(BadRequest().status, result->response->status);
+    EXPECT_TRUE(strings::startsWith(
+        result->response->body,
+        "Failed to validate scheduler::Call"));
+  }
+}
+
+
+// This test verifies that the calls on a stream are decoded in the
+// order they were sent, even though the decoder has multiple workers.
+TEST(CallDecoderTest, StreamOrder)
+{
+  CallDecoder decoder(8);
+
+  Call call;
+  call.set_type(Call::REVIVE);
+  call.mutable_framework_id()->set_value(id::UUID::random().toString());
+
+  const string streamId = id::UUID::random().toString();
+
+  std::atomic<int> decoded(0);
+
+  vector<Future<int>> futures;
+  for (int i = 0; i < 100; i++) {
+    futures.push_back(
+        decoder.decode(
+            createRequest(call, APPLICATION_JSON, streamId),
+            None())
+          .then([&decoded](const CallDecoder::Result& result) {
+            return decoded++;
+          }));
+  }
+
+  for (int i = 0; i < 100; i++) {
+    AWAIT_EXPECT_EQ(i, futures[i]);
+  }
+}
+
+} // namespace tests {
+} // namespace internal {
+} // namespace mesos {
@@ -32,6 +32,7 @@
 #include <mesos/scheduler/scheduler.hpp>
 
 #include <process/clock.hpp>
+#include <process/collect.hpp>
 #include <process/future.hpp>
 #include <process/gmock.hpp>
 #include <process/http.hpp>
@@ -52,6 +53,8 @@
 #include "common/build.hpp"
 #include "common/protobuf_utils.hpp"
 
+#include "master/compact_task.hpp"
+#include "master/constants.hpp"
 #include "master/flags.hpp"
 #include "master/master.hpp"
 #include "master/metrics.hpp"
@@ -3472,6 +3475,99 @@ TEST_F(MasterTest, RecoveredSlaveReregisters)
 }
 
 
+// This test verifies that after a master failover the agents whose
+// re-registration was throttled retry it and eventually reregister.
+TEST_F(MasterTest, ThrottledSlaveReregistrationsAreRetried)
+{
+  const size_t agentCount = 3;
+
+  // Only admit one re-registration at a time.
+  master::Flags masterFlags = CreateMasterFlags();
+  masterFlags.max_agent_reregistrations = 1;
+
+  Try<Owned<cluster::Master>> master = StartMaster(masterFlags);
+  ASSERT_SOME(master);
+
+  StandaloneMasterDetector detector(master.get()->pid);
+
+  vector<Owned<cluster::Slave>> slaves;
+
+  for (size_t i = 0; i < agentCount; i++) {
+    Future<SlaveRegisteredMessage> slaveRegisteredMessage =
+      FUTURE_PROTOBUF(SlaveRegisteredMessage(), master.get()->pid, _);
+
+    // Use a separate work directory for each agent.
+    Try<Owned<cluster::Slave>> slave =
+      StartSlave(&detector, CreateSlaveFlags());
+    ASSERT_SOME(slave);
+
+    AWAIT_READY(slaveRegisteredMessage);
+
+    slaves.push_back(slave.get());
+  }
+
+  Clock::pause();
+
+  // Restart the master with a mock authorizer so that the first
+  // re-registration stays in progress until we let it complete.
+  master->reset();
+
+  MockAuthorizer authorizer;
+  master = StartMaster(&authorizer, masterFlags);
+  ASSERT_SOME(master);
+
+  Future<Nothing> authorize;
+  Promise<bool> authorization;
+  EXPECT_CALL(authorizer, authorized(_))
+    .WillOnce(DoAll(FutureSatisfy(&authorize),
+                    Return(authorization.future())))
+    .WillRepeatedly(Return(true));
+
+  Future<SlaveReregistrationThrottledMessage> throttled =
+    FUTURE_PROTOBUF(SlaveReregistrationThrottledMessage(), _, _);
+
+  vector<Future<SlaveReregisteredMessage>> reregistered;
+  foreach (const Owned<cluster::Slave>& slave, slaves) {
+    reregistered.push_back(
+        FUTURE_PROTOBUF(SlaveReregisteredMessage(), _, slave->pid));
+  }
+
+  detector.appoint(master.get()->pid);
+
+  // All agents reregister within the registration backoff.
+  Clock::advance(slave::DEFAULT_REGISTRATION_BACKOFF_FACTOR);
+
+  AWAIT_READY(authorize);
+  AWAIT_READY(throttled);
+
+  authorization.set(true);
+
+  Clock::settle();
+
+  // Each retry admits at least one of the throttled agents. An agent
+  // retries within twice the retry interval.
+  for (size_t i = 1; i < agentCount; i++) {
+    Clock::advance(master::AGENT_REREGISTRATION_RETRY_INTERVAL * 2);
+    Clock::settle();
+  }
+
+  AWAIT_READY(process::collect(reregistered));
+
+  JSON::Object metrics = Metrics();
+
+  ASSERT_TRUE(
+      metrics.values["master/slave_reregistrations_throttled"]
+        .is<JSON::Number>());
+
+  EXPECT_LE(
+      1,
+      metrics.values["master/slave_reregistrations_throttled"]
+        .as<JSON::Number>().as<int>());
+
+  Clock::resume();
+}
+
+
 // This test checks that the master behaves correctly when a slave is
 // in the process of reregistering after master failover when the
 // agent failover timeout expires.
@@ -10925,6 +11021,63 @@ TEST_F(MasterTest, CollectAuthorizations)
   }
 }
 
+
+// Tests that a compact task expands to the original task, and that the
+// parts shared by tasks are interned.
+TEST(CompactTaskTest, Expand)
+{
+  master::TaskInterner interner;
+
+  SlaveID slaveId;
+  slaveId.set_value("agent");
+
+  TaskInfo taskInfo = createTask(
+      slaveId,
+      Resources::parse("cpus:1;mem:128").get(),
+      "sleep 1000");
+
+  taskInfo.mutable_labels()->add_labels()->CopyFrom(createLabel("k", "v"));
+
+  FrameworkID frameworkId;
+  frameworkId.set_value("framework");
+
+  Task task = protobuf::createTask(taskInfo, TASK_FINISHED, frameworkId);
+
+  master::CompactTask compact1(task, &interner);
+  EXPECT_EQ(task.task_id(), compact1.task_id());
+  EXPECT_EQ(task.slave_id(), compact1.slave_id());
+  EXPECT_EQ(TASK_FINISHED, compact1.state());
+
+  Task expanded = compact1.expand();
+  EXPECT_EQ(task.SerializeAsString(), expanded.SerializeAsString());
+
+  // The task without interned parts expands too.
+  task.clear_resources();
+  task.clear_labels();
+
+  master::CompactTask compact2(task, &interner);
+  EXPECT_EQ(task.SerializeAsString(), compact2.expand().SerializeAsString());
+}
+
+
+// Tests that equal parts are interned as a single shared copy.
+TEST(CompactTaskTest, Intern)
+{
+  master::TaskInterner interner;
+
+  std::shared_ptr<const string> part1 = interner.intern(string("part"));
+  std::shared_ptr<const string> part2 = interner.intern(string("part"));
+  std::shared_ptr<const string> part3 = interner.intern(string("other"));
+
+  ASSERT_NE(nullptr, part1);
+  EXPECT_EQ(part1.get(), part2.get());
+  EXPECT_NE(part1.get(), part3.get());
+  EXPECT_EQ("part", *part1);
+  EXPECT_EQ("other", *part3);
+
+  EXPECT_EQ(nullptr, interner.intern(string()));
+}
+
 } // namespace tests {
 } // namespace internal {
 } // namespace mesos {
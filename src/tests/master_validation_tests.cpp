@@ -2629,6 +2629,88 @@ TEST_F(TaskValidationTest, DuplicatedTaskID)
 }
 
 
+// Ensures that a duplicate task ID is reported before the errors
+// found by `validateStateless`, as the master validates the two
+// halves of a task separately.
+TEST_F(TaskValidationTest, DuplicatedTaskIDReportedBeforeStatelessError)
+{
+  Try<Owned<cluster::Master>> master = StartMaster();
+  ASSERT_SOME(master);
+
+  MockExecutor exec(DEFAULT_EXECUTOR_ID);
+  TestContainerizer containerizer(&exec);
+
+  Owned<MasterDetector> detector = master.get()->createDetector();
+  Try<Owned<cluster::Slave>> slave = StartSlave(detector.get(), &containerizer);
+  ASSERT_SOME(slave);
+
+  MockScheduler sched;
+  MesosSchedulerDriver driver(
+      &sched, DEFAULT_FRAMEWORK_INFO, master.get()->pid, DEFAULT_CREDENTIAL);
+
+  EXPECT_CALL(sched, registered(&driver, _, _));
+
+  Future<vector<Offer>> offers;
+  EXPECT_CALL(sched, resourceOffers(&driver, _))
+    .WillOnce(FutureArg<1>(&offers))
+    .WillRepeatedly(Return()); // Ignore subsequent offers.
+
+  driver.start();
+
+  AWAIT_READY(offers);
+  ASSERT_FALSE(offers->empty());
+
+  ExecutorInfo executor;
+  executor.mutable_executor_id()->set_value("default");
+  executor.mutable_command()->set_value("exit 1");
+
+  TaskInfo task1;
+  task1.set_name("");
+  task1.mutable_task_id()->set_value("1");
+  task1.mutable_slave_id()->MergeFrom(offers.get()[0].slave_id());
+  task1.mutable_resources()->MergeFrom(Resources::parse("cpus:1;mem:32").get());
+  task1.mutable_executor()->MergeFrom(executor);
+
+  // The second task has the same ID and an invalid kill policy.
+  TaskInfo task2 = task1;
+  task2.mutable_kill_policy()->mutable_grace_period()->set_nanoseconds(
+      Seconds(-1).ns());
+
+  vector<TaskInfo> tasks;
+  tasks.push_back(task1);
+  tasks.push_back(task2);
+
+  EXPECT_CALL(exec, registered(_, _, _, _));
+
+  // Grab the first task but don't send a status update.
+  Future<TaskInfo> task;
+  EXPECT_CALL(exec, launchTask(_, _))
+    .WillOnce(FutureArg<1>(&task));
+
+  Future<TaskStatus> status;
+  EXPECT_CALL(sched, statusUpdate(&driver, _))
+    .WillOnce(FutureArg<1>(&status));
+
+  driver.launchTasks(offers.get()[0].id(), tasks);
+
+  AWAIT_READY(task);
+  EXPECT_EQ(task1.task_id(), task->task_id());
+
+  AWAIT_READY(status);
+  EXPECT_EQ(TASK_ERROR, status->state());
+  EXPECT_EQ(TaskStatus::REASON_TASK_INVALID, status->reason());
+
+  EXPECT_TRUE(strings::startsWith(
+      status->message(), "Task has duplicate ID"));
+
+  EXPECT_CALL(exec, shutdown(_))
+    .Times(AtMost(1));
+
+  driver.stop();
+  driver.join();
+}
+
+
 // This test verifies that two tasks launched on the same slave with
 // the same executor id but different executor info are rejected.
 TEST_F(TaskValidationTest, ExecutorInfoDiffersOnSameSlave)
@@ -3122,6 +3204,69 @@ TEST_F(TaskValidationTest, TaskAndExecutorUseRevocableResources)
 }
 
 
+// Verifies that the parts of a task which do not depend on the state
+// of the master are validated without a framework or an agent.
+TEST_F(TaskValidationTest, ValidateStateless)
+{
+  TaskInfo task;
+  task.set_name("");
+  task.mutable_task_id()->set_value("task");
+  task.mutable_slave_id()->set_value("slave");
+  task.mutable_resources()->CopyFrom(Resources::parse("cpus:1;mem:32").get());
+  task.mutable_executor()->CopyFrom(DEFAULT_EXECUTOR_INFO);
+
+  EXPECT_NONE(task::validateStateless(task));
+
+  // A task with an invalid ID is invalid.
+  {
+    TaskInfo invalid = task;
+    invalid.mutable_task_id()->set_value("task/1");
+
+    EXPECT_SOME(task::validateStateless(invalid));
+  }
+
+  // A task with a negative kill policy grace period is invalid.
+  {
+    TaskInfo invalid = task;
+    invalid.mutable_kill_policy()->mutable_grace_period()->set_nanoseconds(
+        Seconds(-1).ns());
+
+    Option<Error> error = task::validateStateless(invalid);
+    ASSERT_SOME(error);
+    EXPECT_EQ(
+        "Task's 'kill_policy.grace_period' must be non-negative",
+        error->message);
+  }
+
+  // A task with both a `CommandInfo` and an `ExecutorInfo` is invalid.
+  {
+    TaskInfo invalid = task;
+    invalid.mutable_command()->set_value("exit 0");
+
+    EXPECT_SOME(task::validateStateless(invalid));
+  }
+
+  // A task with a 'DEFAULT' executor is invalid.
+  {
+    TaskInfo invalid = task;
+    invalid.mutable_executor()->set_type(ExecutorInfo::DEFAULT);
+
+    Option<Error> error = task::validateStateless(invalid);
+    ASSERT_SOME(error);
+    EXPECT_EQ("'ExecutorInfo.type' must be 'CUSTOM'", error->message);
+  }
+
+  // A task whose executor has shared resources is invalid.
+  {
+    TaskInfo invalid = task;
+    invalid.mutable_executor()->add_resources()->CopyFrom(createDiskResource(
+        "128", "role1", "1", "path1", None(), true)); // Shared.
+
+    EXPECT_SOME(task::validateStateless(invalid));
+  }
+}
+
+
 // Ensures that negative executor shutdown grace period in `ExecutorInfo`
 // is rejected during `TaskInfo` validation.
 TEST_F(TaskValidationTest, ExecutorShutdownGracePeriodIsNonNegative)
@@ -2538,6 +2538,7 @@ public:
       rescindInverseOffers,
       void(Mesos*, const typename Event::RescindInverseOffer&));
   MOCK_METHOD2_T(update, void(Mesos*, const typename Event::Update&));
+  MOCK_METHOD2_T(updates, void(Mesos*, const typename Event::Updates&));
   MOCK_METHOD2_T(
       updateOperationStatus,
       void(Mesos*, const typename Event::UpdateOperationStatus&));
@@ -2570,6 +2571,9 @@ public:
         case Event::UPDATE:
           update(mesos, event.update());
           break;
+        case Event::UPDATES:
+          updates(mesos, event.updates());
+          break;
         case Event::UPDATE_OPERATION_STATUS:
           updateOperationStatus(mesos, event.update_operation_status());
           break;
@@ -2585,6 +2589,10 @@ public:
         case Event::HEARTBEAT:
           heartbeat(mesos);
           break;
+        case Event::BATCH:
+          // 'BATCH' events are unpacked by the scheduler library.
+          LOG(FATAL) << "Received unexpected BATCH event";
+          break;
         case Event::UNKNOWN:
           LOG(FATAL) << "Received unexpected UNKNOWN event";
           break;
@@ -262,6 +262,30 @@ TEST_F(RegistrarTest, Admit)
 }
 
 
+// Tests that the registry can be followed through a storage without
+// a started writer, as done by a non-leading master.
+TEST_F(RegistrarTest, Follow)
+{
+  Registrar registrar(flags, state);
+  AWAIT_READY(registrar.recover(master));
+
+  AWAIT_TRUE(registrar.apply(Owned<RegistryOperation>(new AdmitSlave(slave))));
+
+  LogStorage followerStorage(log);
+  State followerState(&followerStorage);
+  Registrar follower(flags, &followerState);
+
+  Future<Registry> registry = follower.follow();
+  AWAIT_READY(registry);
+
+  ASSERT_EQ(1, registry->slaves().slaves().size());
+  EXPECT_EQ(slave, registry->slaves().slaves(0).info());
+
+  // The registry can not be followed once recovering.
+  AWAIT_FAILED(registrar.follow());
+}
+
+
 TEST_F(RegistrarTest, UpdateSlave)
 {
   // Add a new slave to the registry.
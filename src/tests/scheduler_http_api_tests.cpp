@@ -1136,6 +1136,135 @@ TEST_P(SchedulerHttpApiTest, MalformedUUID)
   }
 }
 
+
+
+// This test verifies that the events which the master sends to a
+// framework with the BATCH_EVENTS capability while processing one
+// call arrive in a single 'BATCH' event, and that a 'SUBSCRIBE' call
+// in a 'BATCH' call is rejected by the master.
+TEST_P(SchedulerHttpApiTest, Batch)
+{
+  Try<Owned<cluster::Master>> master = StartMaster();
+  ASSERT_SOME(master);
+
+  // Retrieve the parameter passed as content type to this test.
+  const string contentType = GetParam();
+
+  process::http::Headers headers = createBasicAuthHeaders(DEFAULT_CREDENTIAL);
+  headers["Accept"] = contentType;
+
+  v1::FrameworkInfo frameworkInfo = v1::DEFAULT_FRAMEWORK_INFO;
+  frameworkInfo.add_capabilities()->set_type(
+      v1::FrameworkInfo::Capability::BATCH_EVENTS);
+
+  Call call;
+  call.set_type(Call::SUBSCRIBE);
+
+  Call::Subscribe* subscribe = call.mutable_subscribe();
+  subscribe->mutable_framework_info()->CopyFrom(frameworkInfo);
+
+  Future<Response> response = process::http::streaming::post(
+      master.get()->pid,
+      "api/v1/scheduler",
+      headers,
+      serialize(call, contentType),
+      contentType);
+
+  AWAIT_EXPECT_RESPONSE_STATUS_EQ(OK().status, response);
+  ASSERT_EQ(Response::PIPE, response->type);
+  ASSERT_TRUE(response->headers.contains("Mesos-Stream-Id"));
+
+  headers["Mesos-Stream-Id"] = response->headers.at("Mesos-Stream-Id");
+
+  Option<Pipe::Reader> reader = response->reader;
+  ASSERT_SOME(reader);
+
+  auto deserializer = lambda::bind(
+      &SchedulerHttpApiTest::deserialize, this, contentType, lambda::_1);
+
+  Reader<Event> responseDecoder(Decoder<Event>(deserializer), reader.get());
+
+  Future<Result<Event>> event = responseDecoder.read();
+  AWAIT_READY(event);
+  ASSERT_SOME(event.get());
+
+  ASSERT_EQ(Event::SUBSCRIBED, event->get().type());
+
+  v1::FrameworkID frameworkId = event->get().subscribed().framework_id();
+
+  event = responseDecoder.read();
+  AWAIT_READY(event);
+  ASSERT_SOME(event.get());
+
+  ASSERT_EQ(Event::HEARTBEAT, event->get().type());
+
+  // The master sends an update for each of the unknown tasks while
+  // processing the explicit reconciliation.
+  {
+    Call call;
+    call.mutable_framework_id()->CopyFrom(frameworkId);
+    call.set_type(Call::RECONCILE);
+
+    for (int i = 0; i < 3; i++) {
+      Call::Reconcile::Task* task = call.mutable_reconcile()->add_tasks();
+      task->mutable_task_id()->set_value("task-" + stringify(i));
+      task->mutable_agent_id()->set_value("agent");
+    }
+
+    Future<Response> response = process::http::post(
+        master.get()->pid,
+        "api/v1/scheduler",
+        headers,
+        serialize(call, contentType),
+        contentType);
+
+    AWAIT_EXPECT_RESPONSE_STATUS_EQ(process::http::Accepted().status, response);
+  }
+
+  event = responseDecoder.read();
+  AWAIT_READY(event);
+  ASSERT_SOME(event.get());
+
+  ASSERT_EQ(Event::BATCH, event->get().type());
+  ASSERT_EQ(3, event->get().batch().events_size());
+
+  for (int i = 0; i < 3; i++) {
+    const Event& update = event->get().batch().events(i);
+
+    ASSERT_EQ(Event::UPDATE, update.type());
+    EXPECT_EQ(
+        "task-" + stringify(i),
+        update.update().status().task_id().value());
+  }
+
+  // The library rejects a 'SUBSCRIBE' call in a 'BATCH' call before
+  // sending it, so the call is posted to the master directly.
+  {
+    Call call;
+    call.mutable_framework_id()->CopyFrom(frameworkId);
+    call.set_type(Call::BATCH);
+
+    Call* subscribe = call.mutable_batch()->add_calls();
+    subscribe->mutable_framework_id()->CopyFrom(frameworkId);
+    subscribe->set_type(Call::SUBSCRIBE);
+    subscribe->mutable_subscribe()->mutable_framework_info()->CopyFrom(
+        frameworkInfo);
+
+    Future<Response> response = process::http::post(
+        master.get()->pid,
+        "api/v1/scheduler",
+        headers,
+        serialize(call, contentType),
+        contentType);
+
+    AWAIT_EXPECT_RESPONSE_STATUS_EQ(BadRequest().status, response);
+    AWAIT_EXPECT_RESPONSE_BODY_EQ(
+        "Failed to validate scheduler::Call: 'SUBSCRIBE' calls are not"
+        " allowed in a 'BATCH' call",
+        response);
+  }
+}
+
 } // namespace tests {
 } // namespace internal {
 } // namespace mesos {
@@ -52,6 +52,7 @@
 
 #include "master/detector/standalone.hpp"
 
+#include "tests/allocator.hpp"
 #include "tests/containerizer.hpp"
 #include "tests/mesos.hpp"
 
@@ -73,6 +74,7 @@ using process::Clock;
 using process::Future;
 using process::Owned;
 using process::PID;
+using process::Promise;
 using process::Queue;
 
 using process::http::OK;
@@ -85,6 +87,7 @@ using std::vector;
 using testing::_;
 using testing::AtMost;
 using testing::DoAll;
+using testing::InvokeWithoutArgs;
 using testing::Return;
 using testing::WithParamInterface;
 
@@ -930,6 +933,170 @@ TEST_P(SchedulerTest, ReconcileTask)
 }
 
 
+// This test verifies that the task statuses are sent in `UPDATES`
+// events if the scheduler requests batched reconciliation, and that
+// only the tasks which changed since the requested time are reported.
+TEST_P(SchedulerTest, ReconcileTaskBatch)
+{
+  Try<Owned<cluster::Master>> master = StartMaster();
+  ASSERT_SOME(master);
+
+  auto scheduler = std::make_shared<v1::MockHTTPScheduler>();
+  auto executor = std::make_shared<v1::MockHTTPExecutor>();
+
+  ExecutorID executorId = DEFAULT_EXECUTOR_ID;
+  TestContainerizer containerizer(executorId, executor);
+
+  Owned<MasterDetector> detector = master.get()->createDetector();
+  Try<Owned<cluster::Slave>> slave = StartSlave(detector.get(), &containerizer);
+  ASSERT_SOME(slave);
+
+  Future<Nothing> connected;
+  EXPECT_CALL(*scheduler, connected(_))
+    .WillOnce(FutureSatisfy(&connected));
+
+  ContentType contentType = GetParam();
+
+  v1::scheduler::TestMesos mesos(
+      master.get()->pid,
+      contentType,
+      scheduler);
+
+  AWAIT_READY(connected);
+
+  Future<Event::Subscribed> subscribed;
+  EXPECT_CALL(*scheduler, subscribed(_, _))
+    .WillOnce(FutureArg<1>(&subscribed));
+
+  EXPECT_CALL(*scheduler, heartbeat(_))
+    .WillRepeatedly(Return()); // Ignore heartbeats.
+
+  Future<Event::Offers> offers;
+  EXPECT_CALL(*scheduler, offers(_, _))
+    .WillOnce(FutureArg<1>(&offers));
+
+  {
+    Call call;
+    call.set_type(Call::SUBSCRIBE);
+
+    Call::Subscribe* subscribe = call.mutable_subscribe();
+    subscribe->mutable_framework_info()->CopyFrom(v1::DEFAULT_FRAMEWORK_INFO);
+
+    mesos.send(call);
+  }
+
+  AWAIT_READY(subscribed);
+
+  v1::FrameworkID frameworkId(subscribed->framework_id());
+
+  AWAIT_READY(offers);
+  ASSERT_FALSE(offers->offers().empty());
+
+  EXPECT_CALL(*executor, connected(_))
+    .WillOnce(v1::executor::SendSubscribe(frameworkId, evolve(executorId)));
+
+  EXPECT_CALL(*executor, subscribed(_, _));
+
+  EXPECT_CALL(*executor, launch(_, _))
+    .WillOnce(v1::executor::SendUpdateFromTask(
+        frameworkId, evolve(executorId), v1::TASK_RUNNING));
+
+  Future<Nothing> acknowledged;
+  EXPECT_CALL(*executor, acknowledged(_, _))
+    .WillOnce(FutureSatisfy(&acknowledged));
+
+  Future<Event::Update> update1;
+  EXPECT_CALL(*scheduler, update(_, _))
+    .WillOnce(FutureArg<1>(&update1));
+
+  const v1::Offer& offer = offers->offers(0);
+
+  v1::TaskInfo taskInfo =
+    evolve(createTask(devolve(offer), "", DEFAULT_EXECUTOR_ID));
+
+  {
+    Call call;
+    call.mutable_framework_id()->CopyFrom(frameworkId);
+    call.set_type(Call::ACCEPT);
+
+    Call::Accept* accept = call.mutable_accept();
+    accept->add_offer_ids()->CopyFrom(offer.id());
+
+    v1::Offer::Operation* operation = accept->add_operations();
+    operation->set_type(v1::Offer::Operation::LAUNCH);
+    operation->mutable_launch()->add_task_infos()->CopyFrom(taskInfo);
+
+    mesos.send(call);
+  }
+
+  AWAIT_READY(acknowledged);
+  AWAIT_READY(update1);
+
+  EXPECT_EQ(v1::TASK_RUNNING, update1->status().state());
+
+  Future<Event::Updates> updates;
+  EXPECT_CALL(*scheduler, updates(_, _))
+    .WillOnce(FutureArg<1>(&updates));
+
+  {
+    Call call;
+    call.mutable_framework_id()->CopyFrom(frameworkId);
+    call.set_type(Call::RECONCILE);
+    call.mutable_reconcile()->set_batch_size(10);
+
+    mesos.send(call);
+  }
+
+  AWAIT_READY(updates);
+
+  ASSERT_EQ(1, updates->statuses_size());
+  ASSERT_TRUE(updates->has_time());
+  EXPECT_FALSE(updates->statuses(0).has_uuid());
+  EXPECT_EQ(taskInfo.task_id(), updates->statuses(0).task_id());
+  EXPECT_EQ(offer.agent_id(), updates->statuses(0).agent_id());
+  EXPECT_EQ(v1::TASK_RUNNING, updates->statuses(0).state());
+  EXPECT_EQ(v1::TaskStatus::REASON_RECONCILIATION,
+            updates->statuses(0).reason());
+
+  // The master has not updated the task since the previous
+  // reconciliation, so it is not reported. Since the events are
+  // ordered, receiving the `UPDATE` event of the next reconciliation
+  // ensures that no `UPDATES` event has been sent.
+  Future<Event::Update> update2;
+  EXPECT_CALL(*scheduler, update(_, _))
+    .WillOnce(FutureArg<1>(&update2));
+
+  {
+    Call call;
+    call.mutable_framework_id()->CopyFrom(frameworkId);
+    call.set_type(Call::RECONCILE);
+    call.mutable_reconcile()->set_batch_size(10);
+    call.mutable_reconcile()->mutable_since()->CopyFrom(updates->time());
+
+    mesos.send(call);
+  }
+
+  {
+    Call call;
+    call.mutable_framework_id()->CopyFrom(frameworkId);
+    call.set_type(Call::RECONCILE);
+    call.mutable_reconcile();
+
+    mesos.send(call);
+  }
+
+  AWAIT_READY(update2);
+
+  EXPECT_EQ(v1::TASK_RUNNING, update2->status().state());
+
+  EXPECT_CALL(*executor, shutdown(_))
+    .Times(AtMost(1));
+
+  EXPECT_CALL(*executor, disconnected(_))
+    .Times(AtMost(1));
+}
+
+
 TEST_P(SchedulerTest, KillTask)
 {
   Try<Owned<cluster::Master>> master = StartMaster();
@@ -1571,6 +1738,223 @@ TEST_P(SchedulerTest, Revive)
 }
 
 
+// This test verifies that the calls in a 'BATCH' call are processed
+// in order, and that the events batched for a framework with the
+// BATCH_EVENTS capability are delivered one by one by the library.
+// See `SchedulerHttpApiTest.Batch` for the 'BATCH' events themselves.
+TEST_P(SchedulerTest, Batch)
+{
+  Try<Owned<cluster::Master>> master = StartMaster();
+  ASSERT_SOME(master);
+
+  Owned<MasterDetector> detector = master.get()->createDetector();
+  Try<Owned<cluster::Slave>> slave = StartSlave(detector.get());
+  ASSERT_SOME(slave);
+
+  auto scheduler = std::make_shared<v1::MockHTTPScheduler>();
+
+  Future<Nothing> connected;
+  EXPECT_CALL(*scheduler, connected(_))
+    .WillOnce(FutureSatisfy(&connected));
+
+  ContentType contentType = GetParam();
+
+  v1::scheduler::TestMesos mesos(
+      master.get()->pid,
+      contentType,
+      scheduler);
+
+  AWAIT_READY(connected);
+
+  Future<Event::Subscribed> subscribed;
+  EXPECT_CALL(*scheduler, subscribed(_, _))
+    .WillOnce(FutureArg<1>(&subscribed));
+
+  EXPECT_CALL(*scheduler, heartbeat(_))
+    .WillRepeatedly(Return()); // Ignore heartbeats.
+
+  Future<Event::Offers> offers1;
+  EXPECT_CALL(*scheduler, offers(_, _))
+    .WillOnce(FutureArg<1>(&offers1));
+
+  v1::FrameworkInfo frameworkInfo = v1::DEFAULT_FRAMEWORK_INFO;
+  frameworkInfo.add_capabilities()->set_type(
+      v1::FrameworkInfo::Capability::BATCH_EVENTS);
+
+  {
+    Call call;
+    call.set_type(Call::SUBSCRIBE);
+
+    Call::Subscribe* subscribe = call.mutable_subscribe();
+    subscribe->mutable_framework_info()->CopyFrom(frameworkInfo);
+
+    mesos.send(call);
+  }
+
+  AWAIT_READY(subscribed);
+
+  v1::FrameworkID frameworkId(subscribed->framework_id());
+
+  AWAIT_READY(offers1);
+  ASSERT_FALSE(offers1->offers().empty());
+
+  const v1::Offer& offer = offers1->offers(0);
+
+  Future<Event::Offers> offers2;
+  EXPECT_CALL(*scheduler, offers(_, _))
+    .WillOnce(FutureArg<1>(&offers2));
+
+  // The offer is declined with a 1hr filter which is then cleared by
+  // the revive call, so another offer is sent only if the calls are
+  // processed in order.
+  {
+    Call call;
+    call.mutable_framework_id()->CopyFrom(frameworkId);
+    call.set_type(Call::BATCH);
+
+    Call* decline = call.mutable_batch()->add_calls();
+    decline->mutable_framework_id()->CopyFrom(frameworkId);
+    decline->set_type(Call::DECLINE);
+    decline->mutable_decline()->add_offer_ids()->CopyFrom(offer.id());
+    decline->mutable_decline()->mutable_filters()->set_refuse_seconds(
+        Hours(1).secs());
+
+    Call* revive = call.mutable_batch()->add_calls();
+    revive->mutable_framework_id()->CopyFrom(frameworkId);
+    revive->set_type(Call::REVIVE);
+
+    mesos.send(call);
+  }
+
+  AWAIT_READY(offers2);
+  ASSERT_FALSE(offers2->offers().empty());
+  ASSERT_EQ(offer.resources(), offers2->offers(0).resources());
+
+  // The updates for the unknown tasks are sent in one 'BATCH' event,
+  // which the library unpacks into one 'UPDATE' event per task.
+  Future<Event::Update> update1;
+  Future<Event::Update> update2;
+  Future<Event::Update> update3;
+  EXPECT_CALL(*scheduler, update(_, _))
+    .WillOnce(FutureArg<1>(&update1))
+    .WillOnce(FutureArg<1>(&update2))
+    .WillOnce(FutureArg<1>(&update3));
+
+  {
+    Call call;
+    call.mutable_framework_id()->CopyFrom(frameworkId);
+    call.set_type(Call::RECONCILE);
+
+    for (int i = 1; i <= 3; i++) {
+      Call::Reconcile::Task* task = call.mutable_reconcile()->add_tasks();
+      task->mutable_task_id()->set_value("task-" + stringify(i));
+      task->mutable_agent_id()->set_value("agent");
+    }
+
+    mesos.send(call);
+  }
+
+  AWAIT_READY(update1);
+  AWAIT_READY(update2);
+  AWAIT_READY(update3);
+
+  EXPECT_EQ("task-1", update1->status().task_id().value());
+  EXPECT_EQ("task-2", update2->status().task_id().value());
+  EXPECT_EQ("task-3", update3->status().task_id().value());
+}
+
+
+// This test verifies that the master handles the calls of a framework
+// in the order they were sent, even though the calls are decoded off
+// the master actor.
+TEST_P(SchedulerTest, CallsHandledInOrder)
+{
+  TestAllocator<> allocator;
+
+  EXPECT_CALL(allocator, initialize(_, _, _));
+
+  Try<Owned<cluster::Master>> master = StartMaster(&allocator);
+  ASSERT_SOME(master);
+
+  auto scheduler = std::make_shared<v1::MockHTTPScheduler>();
+
+  Future<Nothing> connected;
+  EXPECT_CALL(*scheduler, connected(_))
+    .WillOnce(FutureSatisfy(&connected));
+
+  ContentType contentType = GetParam();
+
+  v1::scheduler::TestMesos mesos(
+      master.get()->pid,
+      contentType,
+      scheduler);
+
+  AWAIT_READY(connected);
+
+  Future<Event::Subscribed> subscribed;
+  EXPECT_CALL(*scheduler, subscribed(_, _))
+    .WillOnce(FutureArg<1>(&subscribed));
+
+  EXPECT_CALL(*scheduler, heartbeat(_))
+    .WillRepeatedly(Return()); // Ignore heartbeats.
+
+  {
+    Call call;
+    call.set_type(Call::SUBSCRIBE);
+
+    Call::Subscribe* subscribe = call.mutable_subscribe();
+    subscribe->mutable_framework_info()->CopyFrom(v1::DEFAULT_FRAMEWORK_INFO);
+
+    mesos.send(call);
+  }
+
+  AWAIT_READY(subscribed);
+
+  v1::FrameworkID frameworkId(subscribed->framework_id());
+
+  // The calls are handled by the master actor only, so the allocator
+  // is called sequentially.
+  const size_t count = 20;
+
+  vector<Call::Type> handled;
+  Promise<Nothing> promise;
+
+  auto handle = [&handled, &promise](Call::Type type) {
+    handled.push_back(type);
+
+    if (handled.size() == count) {
+      promise.set(Nothing());
+    }
+  };
+
+  EXPECT_CALL(allocator, suppressOffers(_, _))
+    .WillRepeatedly(InvokeWithoutArgs([&handle]() {
+      handle(Call::SUPPRESS);
+    }));
+
+  EXPECT_CALL(allocator, reviveOffers(_, _))
+    .WillRepeatedly(InvokeWithoutArgs([&handle]() {
+      handle(Call::REVIVE);
+    }));
+
+  vector<Call::Type> sent;
+
+  for (size_t i = 0; i < count; i++) {
+    Call call;
+    call.mutable_framework_id()->CopyFrom(frameworkId);
+    call.set_type(i % 3 == 0 ? Call::REVIVE : Call::SUPPRESS);
+
+    sent.push_back(call.type());
+
+    mesos.send(call);
+  }
+
+  AWAIT_READY(promise.future());
+
+  EXPECT_EQ(sent, handled);
+}
+
+
 TEST_P(SchedulerTest, Suppress)
 {
   const string ROLE = "foo";
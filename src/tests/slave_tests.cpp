@@ -1344,6 +1344,8 @@ TEST_F(SlaveTest, MetricsInMetricsEndpoint)
 
   EXPECT_EQ(1u, snapshot.values.count("slave/container_launch_errors"));
 
+  EXPECT_EQ(1u, snapshot.values.count("slave/task_launches_batched"));
+
   EXPECT_EQ(1u, snapshot.values.count("slave/cpus_total"));
   EXPECT_EQ(1u, snapshot.values.count("slave/cpus_used"));
   EXPECT_EQ(1u, snapshot.values.count("slave/cpus_percent"));
@@ -2298,6 +2300,130 @@ TEST_F(SlaveTest, StatisticsEndpointMissingStatistics)
 }
 
 
+// This test verifies that when `--container_usage_collection_interval`
+// is set the /monitor/statistics endpoint is served from the samples
+// taken by the usage collector rather than querying the containerizer
+// on every request.
+TEST_F(SlaveTest, StatisticsEndpointUsageCollector)
+{
+  // The clock is paused so that the collections only happen when the
+  // test advances the clock by the collection interval.
+  Clock::pause();
+
+  master::Flags masterFlags = CreateMasterFlags();
+  Try<Owned<cluster::Master>> master = StartMaster(masterFlags);
+  ASSERT_SOME(master);
+
+  MockExecutor exec(DEFAULT_EXECUTOR_ID);
+  TestContainerizer containerizer(&exec);
+  StandaloneMasterDetector detector(master.get()->pid);
+
+  slave::Flags flags = CreateSlaveFlags();
+  flags.container_usage_collection_interval = Seconds(10);
+
+  Try<Owned<cluster::Slave>> slave = StartSlave(
+      &detector,
+      &containerizer,
+      flags);
+
+  ASSERT_SOME(slave);
+
+  MockScheduler sched;
+  MesosSchedulerDriver driver(
+      &sched, DEFAULT_FRAMEWORK_INFO, master.get()->pid, DEFAULT_CREDENTIAL);
+
+  EXPECT_CALL(sched, registered(_, _, _));
+  EXPECT_CALL(exec, registered(_, _, _, _));
+
+  Future<vector<Offer>> offers;
+
+  EXPECT_CALL(sched, resourceOffers(&driver, _))
+    .WillOnce(FutureArg<1>(&offers))
+    .WillRepeatedly(Return()); // Ignore subsequent offers.
+
+  driver.start();
+
+  // Advance the clock to trigger both agent registration and a batch
+  // allocation.
+  Clock::advance(flags.registration_backoff_factor);
+  Clock::advance(masterFlags.allocation_interval);
+
+  AWAIT_READY(offers);
+  ASSERT_FALSE(offers->empty());
+
+  const Offer& offer = offers.get()[0];
+
+  TaskInfo task = createTask(
+      offer.slave_id(),
+      Resources::parse("cpus:0.1;mem:32").get(),
+      SLEEP_COMMAND(1000),
+      exec.id);
+
+  EXPECT_CALL(exec, launchTask(_, _))
+    .WillOnce(SendStatusUpdateFromTask(TASK_RUNNING));
+
+  Future<TaskStatus> status;
+  EXPECT_CALL(sched, statusUpdate(&driver, _))
+    .WillOnce(FutureArg<1>(&status));
+
+  driver.launchTasks(offer.id(), {task});
+
+  AWAIT_READY(status);
+  EXPECT_EQ(TASK_RUNNING, status->state());
+
+  ResourceStatistics statistics;
+  statistics.set_timestamp(42);
+  statistics.set_cpus_limit(8);
+
+  // The containerizer must only be queried once per collection, no
+  // matter how many times the endpoint is hit.
+  Future<Nothing> usage;
+  EXPECT_CALL(containerizer, usage(_))
+    .WillOnce(DoAll(FutureSatisfy(&usage),
+                    Return(statistics)));
+
+  Clock::advance(flags.container_usage_collection_interval.get());
+
+  AWAIT_READY(usage);
+
+  // Wait for the sample to be cached. The clock stays paused, so no
+  // further collection happens while the endpoint is queried.
+  Clock::settle();
+
+  for (int i = 0; i < 2; i++) {
+    Future<Response> response = process::http::get(
+        slave.get()->pid,
+        "monitor/statistics",
+        None(),
+        createBasicAuthHeaders(DEFAULT_CREDENTIAL));
+
+    AWAIT_EXPECT_RESPONSE_STATUS_EQ(OK().status, response);
+
+    Try<JSON::Value> value = JSON::parse(response->body);
+    ASSERT_SOME(value);
+
+    Try<JSON::Value> expected = JSON::parse(
+        "[{"
+            "\"statistics\":{"
+                "\"timestamp\":42,"
+                "\"cpus_limit\":8"
+            "}"
+        "}]");
+
+    ASSERT_SOME(expected);
+    EXPECT_TRUE(value->contains(expected.get()));
+  }
+
+  EXPECT_CALL(exec, shutdown(_))
+    .Times(AtMost(1));
+
+  driver.stop();
+  driver.join();
+
+  Clock::resume();
+}
+
+
 // This test verifies the correct response of /monitor/statistics endpoint
 // when ResourceUsage collection fails.
 TEST_F(SlaveTest, StatisticsEndpointGetResourceUsageFailed)
@@ -3226,6 +3352,117 @@ TEST_F(SlaveTest, TaskLaunchContainerizerUpdateFails)
 }
 
 
+// This test verifies that the tasks which are launched on a running
+// executor within the same launch window are sent to the executor
+// after a single update of its container.
+TEST_F(SlaveTest, BatchTaskLaunchesOnRunningExecutor)
+{
+  // Start a master.
+  Try<Owned<cluster::Master>> master = StartMaster();
+  ASSERT_SOME(master);
+
+  MockExecutor exec(DEFAULT_EXECUTOR_ID);
+  TestContainerizer containerizer(&exec);
+
+  slave::Flags flags = CreateSlaveFlags();
+  flags.task_launch_batch_interval = Seconds(1);
+
+  Owned<MasterDetector> detector = master.get()->createDetector();
+
+  // Start a slave.
+  Try<Owned<cluster::Slave>> slave =
+    StartSlave(detector.get(), &containerizer, flags);
+  ASSERT_SOME(slave);
+
+  MockScheduler sched;
+  MesosSchedulerDriver driver(
+      &sched, DEFAULT_FRAMEWORK_INFO, master.get()->pid, DEFAULT_CREDENTIAL);
+
+  EXPECT_CALL(sched, registered(_, _, _));
+
+  Future<vector<Offer>> offers1;
+  Future<vector<Offer>> offers2;
+  EXPECT_CALL(sched, resourceOffers(&driver, _))
+    .WillOnce(FutureArg<1>(&offers1))
+    .WillOnce(FutureArg<1>(&offers2))
+    .WillRepeatedly(Return()); // Ignore subsequent offers.
+
+  EXPECT_CALL(exec, registered(_, _, _, _));
+
+  EXPECT_CALL(exec, launchTask(_, _))
+    .WillRepeatedly(SendStatusUpdateFromTask(TASK_RUNNING));
+
+  Future<TaskStatus> status1;
+  Future<TaskStatus> status2;
+  Future<TaskStatus> status3;
+  Future<TaskStatus> status4;
+  EXPECT_CALL(sched, statusUpdate(&driver, _))
+    .WillOnce(FutureArg<1>(&status1))
+    .WillOnce(FutureArg<1>(&status2))
+    .WillOnce(FutureArg<1>(&status3))
+    .WillOnce(FutureArg<1>(&status4));
+
+  driver.start();
+
+  AWAIT_READY(offers1);
+  ASSERT_FALSE(offers1->empty());
+
+  // We use the filter explicitly here so that the remaining resources
+  // will not be filtered for 5 seconds (the default).
+  Filters filters;
+  filters.set_refuse_seconds(0);
+
+  // The first task launches the executor.
+  TaskInfo task;
+  task.set_name("test-task");
+  task.mutable_task_id()->set_value("1");
+  task.mutable_slave_id()->MergeFrom(offers1->at(0).slave_id());
+  task.mutable_resources()->MergeFrom(
+      Resources::parse("cpus:0.1;mem:32").get());
+  task.mutable_executor()->MergeFrom(DEFAULT_EXECUTOR_INFO);
+
+  driver.launchTasks(offers1->at(0).id(), {task}, filters);
+
+  AWAIT_READY(status1);
+  EXPECT_EQ(TASK_RUNNING, status1->state());
+
+  // The tasks launched on the running executor share a single update.
+  EXPECT_CALL(containerizer, update(_, _))
+    .WillOnce(Return(Nothing()));
+
+  AWAIT_READY(offers2);
+  ASSERT_FALSE(offers2->empty());
+
+  vector<TaskInfo> tasks;
+  for (int i = 2; i <= 4; i++) {
+    task.mutable_task_id()->set_value(stringify(i));
+    tasks.push_back(task);
+  }
+
+  driver.launchTasks(offers2->at(0).id(), tasks, filters);
+
+  AWAIT_READY(status2);
+  EXPECT_EQ(TASK_RUNNING, status2->state());
+
+  AWAIT_READY(status3);
+  EXPECT_EQ(TASK_RUNNING, status3->state());
+
+  AWAIT_READY(status4);
+  EXPECT_EQ(TASK_RUNNING, status4->state());
+
+  JSON::Object snapshot = Metrics();
+  EXPECT_EQ(3, snapshot.values["slave/task_launches_batched"]);
+  EXPECT_EQ(1u, snapshot.values.count("slave/task_launch/batching_ms"));
+  EXPECT_EQ(1u, snapshot.values.count("slave/task_launch/container_update_ms"));
+
+  EXPECT_CALL(exec, shutdown(_))
+    .Times(AtMost(1));
+
+  driver.stop();
+  driver.join();
+}
+
+
 // This test ensures that the slave will reregister with the master
 // if it does not receive any pings after registering.
 TEST_F(SlaveTest, PingTimeoutNoPings)
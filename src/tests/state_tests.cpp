@@ -692,6 +692,86 @@ TEST_F(LogStateTest, Diff)
 }
 
 
+// Tests that the log can be followed without a writer after it has
+// been truncated past the position up to which it was followed.
+TEST_F(LogStateTest, FollowAfterTruncation)
+{
+  // Never write diffs, so that every store writes a new snapshot and
+  // truncates the log up to it.
+  mesos::state::LogStorage leaderStorage(log, 0);
+  State leader(&leaderStorage);
+
+  mesos::state::LogStorage followerStorage(log, 1024);
+  mesos::state::State follower(&followerStorage);
+
+  Future<Variable<Slaves>> future1 = leader.fetch<Slaves>("slaves");
+  AWAIT_READY(future1);
+
+  Variable<Slaves> variable = future1.get();
+
+  Slaves slaves;
+  slaves.add_slaves()->mutable_info()->set_hostname("localhost0");
+
+  Future<Option<Variable<Slaves>>> future2 =
+    leader.store(variable.mutate(slaves));
+
+  AWAIT_READY(future2);
+  ASSERT_SOME(future2.get());
+
+  variable = future2->get();
+
+  Future<mesos::state::Variable> followed = follower.follow("slaves");
+  AWAIT_READY(followed);
+
+  Slaves parsed;
+  ASSERT_TRUE(parsed.ParseFromString(followed->value()));
+  ASSERT_EQ(1, parsed.slaves_size());
+  EXPECT_EQ("localhost0", parsed.slaves(0).info().hostname());
+
+  // Wait for the truncation following the store (see the 'Diff' test).
+  Clock::pause();
+  Clock::settle();
+  Clock::resume();
+
+  Log::Reader reader(log);
+
+  Future<Log::Position> beginning1 = reader.beginning();
+  AWAIT_READY(beginning1);
+
+  slaves.mutable_slaves(0)->mutable_info()->set_hostname("localhost1");
+
+  future2 = leader.store(variable.mutate(slaves));
+  AWAIT_READY(future2);
+  ASSERT_SOME(future2.get());
+
+  Clock::pause();
+  Clock::settle();
+  Clock::resume();
+
+  // The log is now truncated past the position the follower has read.
+  Future<Log::Position> beginning2 = reader.beginning();
+  AWAIT_READY(beginning2);
+  ASSERT_TRUE(beginning1.get() < beginning2.get());
+
+  followed = follower.follow("slaves");
+  AWAIT_READY(followed);
+
+  ASSERT_TRUE(parsed.ParseFromString(followed->value()));
+  ASSERT_EQ(1, parsed.slaves_size());
+  EXPECT_EQ("localhost1", parsed.slaves(0).info().hostname());
+
+  // Once elected, the follower only reads the entries past the ones it
+  // has followed, which must not fail either.
+  State elected(&followerStorage);
+
+  future1 = elected.fetch<Slaves>("slaves");
+  AWAIT_READY(future1);
+
+  ASSERT_EQ(1, future1->get().slaves_size());
+  EXPECT_EQ("localhost1", future1->get().slaves(0).info().hostname());
+}
+
+
 #ifdef MESOS_HAS_JAVA
 class ZooKeeperStateTest : public tests::ZooKeeperTest
 {